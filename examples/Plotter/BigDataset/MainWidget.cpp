@@ -19,11 +19,13 @@
 
 #include "MainWidget.h"
 
-#include "KChartAbstractDiagram_p.h"
 #include "KChartChart.h"
+#include "KChartInstrumentation.h"
 #include "KChartPlotter.h"
 
+#include <QDebug>
 #include <QHBoxLayout>
+#include <QTimer>
 
 #include <cmath>
 
@@ -41,7 +43,7 @@ MainWidget::MainWidget()
 
     m_plotter = new KChart::Plotter;
     m_plotter->setModel( &m_model );
-    KChart::AbstractDiagram::Private::get( m_plotter )->doDumpPaintTime = true;
+    KChart::Instrumentation::setEnabled( true );
     chart->coordinatePlane()->replaceDiagram( m_plotter );
 
     KChart::CartesianCoordinatePlane* cPlane
@@ -77,6 +79,10 @@ MainWidget::MainWidget()
     foreach ( QPushButton* b, m_addPointsButtons ) {
         connect( b, SIGNAL(clicked(bool)), SLOT(addPointsButtonClicked()) );
     }
+
+    QTimer* dumpTimer = new QTimer( this );
+    connect( dumpTimer, SIGNAL(timeout()), SLOT(dumpPaintTime()) );
+    dumpTimer->start( 1000 );
 }
 
 // slot
@@ -97,3 +103,17 @@ void MainWidget::addPointsButtonClicked()
     Q_ASSERT( idx >= 0 );
     m_model.appendPoints( pow( qreal( 10 ), qreal( idx + 3 ) ) );
 }
+
+// slot
+void MainWidget::dumpPaintTime()
+{
+    const KChart::Instrumentation::Statistics stats = KChart::Instrumentation::statistics( m_plotter );
+    const int paints = stats.stageCalls( "paint" );
+    if ( paints ) {
+        qDebug() << "Painting the diagram" << paints << "times took"
+                 << stats.stageTime( "paint" ) / 1000000 << "milliseconds,"
+                 << stats.counter( KChart::Instrumentation::PointsCompressed ) << "points after compression,"
+                 << stats.counter( KChart::Instrumentation::PrimitivesDrawn ) << "primitives drawn";
+    }
+    KChart::Instrumentation::reset();
+}
@@ -45,6 +45,7 @@ public:
 private slots:
     void functionToggled( bool checked );
     void addPointsButtonClicked();
+    void dumpPaintTime();
 
 private:
     QWidget* m_controlsContainer;
@@ -0,0 +1,495 @@
+/**
+ * Copyright (C) 2026 The KDiagram developers
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Rendering benchmarks for the KChart diagram types.
+ *
+ * Every diagram type is measured stage by stage, so a regression can be
+ * attributed to the part of the pipeline that causes it:
+ *   layout       data boundaries and plane layout (layoutDiagrams())
+ *   fetch        reading every value through the diagram's attributes model
+ *   compression  CartesianDiagramDataCompressor (cartesian diagrams only)
+ *   transform    mapping every data point to plane coordinates
+ *   paint        Chart::paint() with data value labels hidden
+ *   labels       Chart::paint() with data value labels shown; the label
+ *                cost is the difference to the paint stage
+ *
+ * Radar charts are additionally painted with a range of axis and dataset
+ * counts (benchmarkRadar), since their cost grows with both.
+ *
+ * The number of data points is taken from the environment:
+ *   KCHART_BENCHMARK_SIZES        comma separated point counts (default 1000)
+ *   KCHART_BENCHMARK_RADAR_AXES   comma separated radar axis counts
+ *                                 (default 8,64,360)
+ *
+ * For machine readable results use the QtTest output formats, e.g.
+ *   KCHART_BENCHMARK_SIZES=1000,10000,100000,1000000,10000000 Benchmarks -o results.xml,xml
+ *
+ * The data is generated on demand by a table model, so even the largest
+ * sizes do not need memory for the values themselves.
+ */
+
+#include <QtTest/QtTest>
+#include <QAbstractTableModel>
+#include <QImage>
+#include <QPainter>
+
+#include <KChartChart>
+#include <KChartGlobal>
+#include <KChartAbstractCoordinatePlane>
+#include <KChartCartesianCoordinatePlane>
+#include <KChartPolarCoordinatePlane>
+#include <KChartRadarCoordinatePlane>
+#include <KChartLeveyJenningsCoordinatePlane>
+#include <KChartTernaryCoordinatePlane>
+#include <KChartLineDiagram>
+#include <KChartBarDiagram>
+#include <KChartPlotter>
+#include <KChartStockDiagram>
+#include <KChartPieDiagram>
+#include <KChartRingDiagram>
+#include <KChartPolarDiagram>
+#include <KChartRadarDiagram>
+#include <KChartLeveyJenningsDiagram>
+#include <KChartTernaryPointDiagram>
+#include <KChartDataValueAttributes>
+#include <KChartAttributesModel>
+
+#include <KChartCartesianDiagramDataCompressor_p.h>
+
+#include <cmath>
+
+using namespace KChart;
+
+enum DiagramType {
+    Line,
+    Bar,
+    Plot,
+    Stock,
+    Pie,
+    Ring,
+    Polar,
+    Radar,
+    LeveyJennings,
+    Ternary
+};
+
+Q_DECLARE_METATYPE( DiagramType )
+
+static const char* const diagramTypeNames[] = {
+    "Line", "Bar", "Plotter", "Stock", "Pie", "Ring", "Polar", "Radar", "LeveyJennings", "Ternary"
+};
+
+/*
+ * Read-only table model that computes its values from the row and column,
+ * laid out the way the respective diagram type expects its data.
+ */
+class BenchmarkModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    BenchmarkModel( DiagramType type, int points, int datasets = 1, QObject* parent = nullptr )
+        : QAbstractTableModel( parent ),
+          m_type( type ),
+          m_points( points ),
+          m_datasets( datasets ),
+          m_start( QDate( 2026, 1, 5 ), QTime( 8, 0 ) )
+    {
+    }
+
+    int rowCount( const QModelIndex& parent = QModelIndex() ) const Q_DECL_OVERRIDE
+    {
+        if ( parent.isValid() )
+            return 0;
+        return ( m_type == Pie || m_type == Ring ) ? 1 : m_points;
+    }
+
+    int columnCount( const QModelIndex& parent = QModelIndex() ) const Q_DECL_OVERRIDE
+    {
+        if ( parent.isValid() )
+            return 0;
+        switch ( m_type ) {
+        case Pie:
+        case Ring:
+            return m_points;
+        case Plot:
+            return 2;
+        case Ternary:
+            return 3;
+        case Stock:
+            return 4;
+        case LeveyJennings:
+            return 6;
+        default:
+            return m_datasets;
+        }
+    }
+
+    QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const Q_DECL_OVERRIDE
+    {
+        if ( !index.isValid() || ( role != Qt::DisplayRole && role != Qt::EditRole ) )
+            return QVariant();
+        const int row = index.row();
+        const int column = index.column();
+        const qreal wave = 50.0 + 40.0 * std::sin( row * 0.01 ) + ( row * 7919 % 101 ) * 0.1;
+        switch ( m_type ) {
+        case Pie:
+        case Ring:
+            return 1.0 + column % 10;
+        case Plot:
+            return column == 0 ? qreal( row ) : wave;
+        case Ternary:
+            return 1.0 + ( row + column * 37 ) % 100;
+        case Stock:
+            // open, high, low, close
+            switch ( column ) {
+            case 0: return wave;
+            case 1: return wave + 5.0;
+            case 2: return wave - 5.0;
+            default: return wave + 2.0;
+            }
+        case LeveyJennings:
+            switch ( column ) {
+            case 0: return row / 100;
+            case 1: return wave;
+            case 2: return true;
+            case 3: return m_start.addSecs( qint64( row ) * 3600 );
+            case 4: return 50.0;
+            default: return 20.0;
+            }
+        default:
+            return wave + column;
+        }
+    }
+
+    /* Tells the views that all values changed, so cached boundaries are dropped. */
+    void touch()
+    {
+        Q_EMIT dataChanged( index( 0, 0 ), index( rowCount() - 1, columnCount() - 1 ) );
+    }
+
+private:
+    DiagramType m_type;
+    int m_points;
+    int m_datasets;
+    QDateTime m_start;
+};
+
+class Benchmarks : public QObject {
+    Q_OBJECT
+public:
+    Benchmarks()
+        : m_chart( nullptr ),
+          m_plane( nullptr ),
+          m_diagram( nullptr ),
+          m_model( nullptr )
+    {
+        m_sizes = countsFromEnvironment( "KCHART_BENCHMARK_SIZES", QList<int>() << 1000 );
+        m_radarAxes = countsFromEnvironment( "KCHART_BENCHMARK_RADAR_AXES", QList<int>() << 8 << 64 << 360 );
+    }
+
+private:
+    static QList<int> countsFromEnvironment( const char* name, const QList<int>& defaultCounts )
+    {
+        QList<int> result;
+        const QList<QByteArray> counts = qgetenv( name ).split( ',' );
+        Q_FOREACH( const QByteArray& count, counts ) {
+            bool ok;
+            const int n = count.trimmed().toInt( &ok );
+            if ( ok && n > 0 )
+                result << n;
+        }
+        return result.isEmpty() ? defaultCounts : result;
+    }
+
+    void addRows()
+    {
+        QTest::addColumn<DiagramType>( "type" );
+        QTest::addColumn<int>( "points" );
+        for ( int type = Line; type <= Ternary; ++type ) {
+            Q_FOREACH( int points, m_sizes ) {
+                const QByteArray name = QByteArray( diagramTypeNames[ type ] ) + '/' + QByteArray::number( points );
+                QTest::newRow( name.constData() ) << DiagramType( type ) << points;
+            }
+        }
+    }
+
+    /* Creates the chart for the current data row and paints it once, so
+     * that the planes are laid out before a stage is measured. */
+    void setupChart( bool showLabels = false )
+    {
+        QFETCH( DiagramType, type );
+        QFETCH( int, points );
+        createChart( type, points, 1, showLabels );
+    }
+
+    void createChart( DiagramType type, int points, int datasets, bool showLabels )
+    {
+        m_chart = new Chart;
+        m_chart->resize( 800, 600 );
+        m_model = new BenchmarkModel( type, points, datasets, m_chart );
+
+        switch ( type ) {
+        case Line:
+            m_plane = m_chart->coordinatePlane();
+            m_diagram = new LineDiagram;
+            break;
+        case Bar:
+            m_plane = m_chart->coordinatePlane();
+            m_diagram = new BarDiagram;
+            break;
+        case Plot:
+            m_plane = m_chart->coordinatePlane();
+            m_diagram = new Plotter;
+            break;
+        case Stock: {
+            m_plane = m_chart->coordinatePlane();
+            StockDiagram* stock = new StockDiagram;
+            stock->setType( StockDiagram::OpenHighLowClose );
+            m_diagram = stock;
+            break;
+        }
+        case Pie:
+            m_plane = new PolarCoordinatePlane( m_chart );
+            m_diagram = new PieDiagram;
+            break;
+        case Ring:
+            m_plane = new PolarCoordinatePlane( m_chart );
+            m_diagram = new RingDiagram;
+            break;
+        case Polar:
+            m_plane = new PolarCoordinatePlane( m_chart );
+            m_diagram = new PolarDiagram;
+            break;
+        case Radar:
+            m_plane = new RadarCoordinatePlane( m_chart );
+            m_diagram = new RadarDiagram;
+            break;
+        case LeveyJennings: {
+            m_plane = new LeveyJenningsCoordinatePlane( m_chart );
+            LeveyJenningsDiagram* lj = new LeveyJenningsDiagram;
+            lj->setExpectedMeanValue( 50 );
+            lj->setExpectedStandardDeviation( 20 );
+            m_diagram = lj;
+            break;
+        }
+        case Ternary:
+            m_plane = new TernaryCoordinatePlane( m_chart );
+            m_diagram = new TernaryPointDiagram;
+            break;
+        }
+        if ( m_plane != m_chart->coordinatePlane() )
+            m_chart->replaceCoordinatePlane( m_plane );
+
+        m_diagram->setModel( m_model );
+        DataValueAttributes dva = m_diagram->dataValueAttributes();
+        dva.setVisible( showLabels );
+        m_diagram->setDataValueAttributes( dva );
+        m_plane->replaceDiagram( m_diagram );
+
+        m_image = QImage( m_chart->size(), QImage::Format_ARGB32_Premultiplied );
+        paintChart();
+    }
+
+    void paintChart()
+    {
+        m_image.fill( Qt::white );
+        QPainter painter( &m_image );
+        m_chart->paint( &painter, m_image.rect() );
+    }
+
+    QModelIndex attributesRoot() const
+    {
+        return m_diagram->attributesModel()->mapFromSource( m_diagram->rootIndex() );
+    }
+
+    void cleanupChart()
+    {
+        delete m_chart;
+        m_chart = nullptr;
+        m_plane = nullptr;
+        m_diagram = nullptr;
+        m_model = nullptr;
+    }
+
+    QList<int> m_sizes;
+    QList<int> m_radarAxes;
+    Chart* m_chart;
+    AbstractCoordinatePlane* m_plane;
+    AbstractDiagram* m_diagram;
+    BenchmarkModel* m_model;
+    QImage m_image;
+
+private slots:
+    void cleanup()
+    {
+        cleanupChart();
+    }
+
+    void benchmarkLayout_data()
+    {
+        addRows();
+    }
+
+    void benchmarkLayout()
+    {
+        setupChart();
+        QBENCHMARK {
+            m_model->touch();
+            m_plane->layoutDiagrams();
+        }
+    }
+
+    void benchmarkDataFetch_data()
+    {
+        addRows();
+    }
+
+    void benchmarkDataFetch()
+    {
+        setupChart();
+        const QAbstractItemModel* model = m_diagram->attributesModel();
+        const QModelIndex root = attributesRoot();
+        const int rows = model->rowCount( root );
+        const int columns = model->columnCount( root );
+        qreal sum = 0.0;
+        QBENCHMARK {
+            for ( int row = 0; row < rows; ++row ) {
+                for ( int column = 0; column < columns; ++column ) {
+                    sum += model->data( model->index( row, column, root ) ).toReal();
+                }
+            }
+        }
+        QVERIFY( sum > 0.0 );
+    }
+
+    void benchmarkCompression_data()
+    {
+        addRows();
+    }
+
+    void benchmarkCompression()
+    {
+        QFETCH( DiagramType, type );
+        if ( type != Line && type != Bar && type != Plot && type != Stock )
+            QSKIP( "This diagram type does not compress its data" );
+
+        setupChart();
+        CartesianDiagramDataCompressor compressor;
+        compressor.setDatasetDimension( type == Plot ? 2 : 1 );
+        compressor.setModel( m_diagram->attributesModel() );
+        compressor.setRootIndex( attributesRoot() );
+        compressor.setResolution( m_plane->geometry().width(), m_plane->geometry().height() );
+        qreal sum = 0.0;
+        QBENCHMARK {
+            compressor.rebuildCache();
+            const int rows = compressor.modelDataRows();
+            const int columns = compressor.modelDataColumns();
+            for ( int column = 0; column < columns; ++column ) {
+                for ( int row = 0; row < rows; ++row ) {
+                    sum += compressor.data( CartesianDiagramDataCompressor::CachePosition( row, column ) ).value;
+                }
+            }
+        }
+        QVERIFY( sum > 0.0 );
+    }
+
+    void benchmarkTransform_data()
+    {
+        addRows();
+    }
+
+    void benchmarkTransform()
+    {
+        setupChart();
+        const QAbstractItemModel* model = m_diagram->attributesModel();
+        const QModelIndex root = attributesRoot();
+        const int rows = model->rowCount( root );
+        const int columns = model->columnCount( root );
+        // the values are fetched once up front, only the mapping is measured
+        QVector<QPointF> values;
+        values.reserve( rows * columns );
+        for ( int row = 0; row < rows; ++row ) {
+            for ( int column = 0; column < columns; ++column ) {
+                values << QPointF( row, model->data( model->index( row, column, root ) ).toReal() );
+            }
+        }
+        qreal sum = 0.0;
+        QBENCHMARK {
+            Q_FOREACH( const QPointF& value, values ) {
+                sum += m_plane->translate( value ).y();
+            }
+        }
+        Q_UNUSED( sum );
+    }
+
+    void benchmarkPaint_data()
+    {
+        addRows();
+    }
+
+    void benchmarkPaint()
+    {
+        setupChart();
+        QBENCHMARK {
+            paintChart();
+        }
+    }
+
+    void benchmarkLabels_data()
+    {
+        addRows();
+    }
+
+    void benchmarkLabels()
+    {
+        setupChart( true );
+        QBENCHMARK {
+            paintChart();
+        }
+    }
+
+    void benchmarkRadar_data()
+    {
+        QTest::addColumn<int>( "axes" );
+        QTest::addColumn<int>( "datasets" );
+        const QList<int> datasetCounts = QList<int>() << 1 << 16;
+        Q_FOREACH( int axes, m_radarAxes ) {
+            Q_FOREACH( int datasets, datasetCounts ) {
+                const QByteArray name = QByteArray::number( axes ) + " axes/"
+                                        + QByteArray::number( datasets ) + " datasets";
+                QTest::newRow( name.constData() ) << axes << datasets;
+            }
+        }
+    }
+
+    void benchmarkRadar()
+    {
+        QFETCH( int, axes );
+        QFETCH( int, datasets );
+        // one row per axis, one column per dataset
+        createChart( Radar, axes, datasets, false );
+        QBENCHMARK {
+            paintChart();
+        }
+    }
+};
+
+QTEST_MAIN(Benchmarks)
+
+#include "main.moc"
@@ -22,7 +22,11 @@
 #include <QtTest/QtTest>
 #include <QStandardItem>
 #include <QStandardItemModel>
+#include <QPainter>
 
+#include <KChartChart>
+#include <KChartCartesianCoordinatePlane>
+#include <KChartLineDiagram>
 #include <KChartCartesianDiagramDataCompressor_p.h>
 
 typedef KChart::CartesianDiagramDataCompressor::CachePosition CachePosition;
@@ -37,6 +41,26 @@ struct Match {
     QModelIndex index;
 };
 
+// counts how often the display data of the cells is asked for
+class CountingModel : public QStandardItemModel
+{
+public:
+    CountingModel( int rows, int columns )
+        : QStandardItemModel( rows, columns ),
+          displayDataFetched( 0 )
+    {
+    }
+
+    QVariant data( const QModelIndex& index, int role ) const Q_DECL_OVERRIDE
+    {
+        if ( role == Qt::DisplayRole )
+            ++displayDataFetched;
+        return QStandardItemModel::data( index, role );
+    }
+
+    mutable int displayDataFetched;
+};
+
 class CartesianDiagramDataCompressorTests : public QObject
 {
     Q_OBJECT
@@ -190,11 +214,213 @@ private slots:
                   "datasetDimension == 1 should restore the old column count" );
     }
 
+    void stockAggregationTest()
+    {
+        // 8 rows of open, high, low and close values, compressed to 2 pixels of 4 rows each
+        const qreal values[ 8 ][ 4 ] = {
+            { 10, 12,  9, 11 }, { 11, 15, 10, 14 }, { 14, 14,  8,  9 }, {  9, 10,  9, 10 },
+            { 20, 21, 19, 20 }, { 20, 22, 20, 21 }, { 21, 30, 21, 29 }, { 29, 29, 18, 19 }
+        };
+        QStandardItemModel stockModel( 8, 4 );
+        for ( int row = 0; row < 8; ++row )
+            for ( int column = 0; column < 4; ++column )
+                stockModel.setData( stockModel.index( row, column ), values[ row ][ column ] );
+
+        KChart::CartesianDiagramDataCompressor stockCompressor;
+        stockCompressor.setModel( &stockModel );
+        stockCompressor.setDatasetDimension( 3 );
+        stockCompressor.setAggregationMode( KChart::CartesianDiagramDataCompressor::OpenHighLowCloseAggregation );
+        stockCompressor.setResolution( 2, 100 );
+        QVERIFY2( stockCompressor.modelDataRows() == 2,
+                  "stock aggregation should compress the rows to the x resolution" );
+        QVERIFY2( stockCompressor.modelDataColumns() == 4, "stock aggregation should keep every column" );
+
+        const qreal expected[ 2 ][ 4 ] = { { 10, 15, 8, 10 }, { 20, 30, 18, 19 } };
+        for ( int row = 0; row < 2; ++row ) {
+            for ( int column = 0; column < 4; ++column ) {
+                const KChart::CartesianDiagramDataCompressor::DataPoint point
+                        = stockCompressor.data( CachePosition( row, column ) );
+                QCOMPARE( point.value, expected[ row ][ column ] );
+                QCOMPARE( point.key, row * 4 + 1.5 );
+            }
+        }
+        QVERIFY2( stockCompressor.data( CachePosition( 0, 1 ) ).index == stockModel.index( 1, 1 ),
+                  "the index of an aggregated value should be the one of the row it came from" );
+
+        // changing a single value must update the index of the column
+        stockModel.setData( stockModel.index( 2, 1 ), 40 );
+        QCOMPARE( stockCompressor.data( CachePosition( 0, 1 ) ).value, qreal( 40 ) );
+        stockModel.setData( stockModel.index( 6, 2 ), 1 );
+        QCOMPARE( stockCompressor.data( CachePosition( 1, 2 ) ).value, qreal( 1 ) );
+    }
+
+    void stockRangeIndexUpdateTest()
+    {
+        // enough rows that a change of a few of them updates the range indexes
+        // in place instead of dropping them
+        const int rows = 256;
+        QStandardItemModel stockModel( rows, 4 );
+        for ( int row = 0; row < rows; ++row ) {
+            const qreal open = 50 + ( row * 37 ) % 41;
+            const qreal close = 50 + ( row * 53 ) % 43;
+            stockModel.setData( stockModel.index( row, 0 ), open );
+            stockModel.setData( stockModel.index( row, 1 ), qMax( open, close ) + ( row * 7 ) % 11 );
+            stockModel.setData( stockModel.index( row, 2 ), qMin( open, close ) - ( row * 5 ) % 13 );
+            stockModel.setData( stockModel.index( row, 3 ), close );
+        }
+
+        KChart::CartesianDiagramDataCompressor stockCompressor;
+        stockCompressor.setModel( &stockModel );
+        stockCompressor.setDatasetDimension( 3 );
+        stockCompressor.setAggregationMode( KChart::CartesianDiagramDataCompressor::OpenHighLowCloseAggregation );
+        stockCompressor.setResolution( 8, 100 );
+        QCOMPARE( stockCompressor.modelDataRows(), 8 );
+        // builds the range indexes
+        compareWithRebuilt( &stockCompressor, &stockModel );
+
+        // take away the current extremes of a pixel, so that the next one has to be found,
+        // make new extremes, and change values that are neither
+        const QModelIndex highest = stockCompressor.data( CachePosition( 2, 1 ) ).index;
+        stockModel.setData( highest, 0 );
+        compareWithRebuilt( &stockCompressor, &stockModel );
+        const QModelIndex lowest = stockCompressor.data( CachePosition( 5, 2 ) ).index;
+        stockModel.setData( lowest, 1000 );
+        compareWithRebuilt( &stockCompressor, &stockModel );
+        stockModel.setData( stockModel.index( 100, 1 ), 1000 );
+        stockModel.setData( stockModel.index( 101, 2 ), -1000 );
+        compareWithRebuilt( &stockCompressor, &stockModel );
+        stockModel.setData( stockModel.index( 200, 1 ), 60 );
+        stockModel.setData( stockModel.index( 33, 2 ), 45 );
+        compareWithRebuilt( &stockCompressor, &stockModel );
+        for ( int row = 0; row < rows; row += 17 ) {
+            stockModel.setData( stockModel.index( row, 1 ), 40 + row % 70 );
+            stockModel.setData( stockModel.index( row, 2 ), 30 + row % 50 );
+        }
+        compareWithRebuilt( &stockCompressor, &stockModel );
+    }
+
+    void sharedModelCacheTest()
+    {
+        // compressors of the same model share their model data, every one of them
+        // needs to see the changes no matter which one fetched the data first
+        QStandardItemModel sharedModel( 4, 2 );
+        for ( int row = 0; row < 4; ++row )
+            for ( int column = 0; column < 2; ++column )
+                sharedModel.setData( sharedModel.index( row, column ), row + column );
+
+        KChart::CartesianDiagramDataCompressor first;
+        first.setModel( &sharedModel );
+        first.setResolution( 4, 100 );
+        QCOMPARE( first.data( CachePosition( 2, 1 ) ).value, qreal( 3 ) );
+
+        {
+            KChart::CartesianDiagramDataCompressor second;
+            second.setModel( &sharedModel );
+            second.setResolution( 4, 100 );
+            QCOMPARE( second.data( CachePosition( 2, 1 ) ).value, qreal( 3 ) );
+
+            sharedModel.setData( sharedModel.index( 2, 1 ), 7 );
+            QCOMPARE( first.data( CachePosition( 2, 1 ) ).value, qreal( 7 ) );
+            QCOMPARE( second.data( CachePosition( 2, 1 ) ).value, qreal( 7 ) );
+
+            sharedModel.insertRow( 0 );
+            sharedModel.setData( sharedModel.index( 0, 1 ), 5 );
+            first.setResolution( 5, 100 );
+            second.setResolution( 5, 100 );
+            QCOMPARE( first.data( CachePosition( 0, 1 ) ).value, qreal( 5 ) );
+            QCOMPARE( second.data( CachePosition( 3, 1 ) ).value, qreal( 7 ) );
+        }
+
+        // the remaining compressor keeps receiving the changes
+        sharedModel.setData( sharedModel.index( 3, 1 ), 9 );
+        QCOMPARE( first.data( CachePosition( 3, 1 ) ).value, qreal( 9 ) );
+    }
+
+    void sharedDiagramModelCacheTest()
+    {
+        // every diagram has an attributes model of its own, the diagrams of one model
+        // still share the data they fetched from it
+        CountingModel sharedModel( 4, 2 );
+        for ( int row = 0; row < 4; ++row )
+            for ( int column = 0; column < 2; ++column )
+                sharedModel.setData( sharedModel.index( row, column ), row + column );
+
+        KChart::Chart chart;
+        KChart::CartesianCoordinatePlane* plane
+                = static_cast< KChart::CartesianCoordinatePlane* >( chart.coordinatePlane() );
+        KChart::LineDiagram* first = new KChart::LineDiagram;
+        first->setModel( &sharedModel );
+        plane->replaceDiagram( first );
+        KChart::LineDiagram* second = new KChart::LineDiagram;
+        second->setModel( &sharedModel );
+        plane->addDiagram( second );
+        QVERIFY( first->attributesModel() != second->attributesModel() );
+
+        chart.resize( 400, 300 );
+        QImage image( chart.size(), QImage::Format_ARGB32_Premultiplied );
+        QPainter painter( &image );
+        chart.paint( &painter, image.rect() );
+        QCOMPARE( first->dataBoundaries().second.y(), qreal( 4 ) );
+        QCOMPARE( second->dataBoundaries().second.y(), qreal( 4 ) );
+
+        // a changed value is fetched once, for the diagram that asks first
+        sharedModel.setData( sharedModel.index( 2, 1 ), 7 );
+        sharedModel.displayDataFetched = 0;
+        QCOMPARE( first->dataBoundaries().second.y(), qreal( 7 ) );
+        QCOMPARE( sharedModel.displayDataFetched, 1 );
+        QCOMPARE( second->dataBoundaries().second.y(), qreal( 7 ) );
+        QCOMPARE( sharedModel.displayDataFetched, 1 );
+
+        // both attributes models forward the same inserted and removed rows and columns,
+        // they are applied once
+        sharedModel.insertRow( 0 );
+        sharedModel.setData( sharedModel.index( 0, 1 ), 9 );
+        QCOMPARE( first->dataBoundaries().second.y(), qreal( 9 ) );
+        QCOMPARE( second->dataBoundaries().second.y(), qreal( 9 ) );
+        sharedModel.insertColumn( 0 );
+        sharedModel.setData( sharedModel.index( 4, 0 ), 11 );
+        QCOMPARE( first->dataBoundaries().second.y(), qreal( 11 ) );
+        QCOMPARE( second->dataBoundaries().second.y(), qreal( 11 ) );
+        QVERIFY( sharedModel.removeRows( 3, 2 ) );
+        QVERIFY( sharedModel.removeColumns( 0, 1 ) );
+        QCOMPARE( first->dataBoundaries().second.y(), qreal( 9 ) );
+        QCOMPARE( second->dataBoundaries().second.y(), qreal( 9 ) );
+
+        // the remaining diagram keeps receiving the changes
+        plane->takeDiagram( first );
+        delete first;
+        sharedModel.setData( sharedModel.index( 1, 1 ), 13 );
+        QCOMPARE( second->dataBoundaries().second.y(), qreal( 13 ) );
+    }
+
     void cleanupTestCase()
     {
     }
 
 private:
+    // compares all points of \a compressor with those of a compressor that has
+    // not seen any changes of \a model
+    void compareWithRebuilt( KChart::CartesianDiagramDataCompressor* compressor, QAbstractItemModel* model )
+    {
+        KChart::CartesianDiagramDataCompressor rebuilt;
+        rebuilt.setModel( model );
+        rebuilt.setDatasetDimension( 3 );
+        rebuilt.setAggregationMode( KChart::CartesianDiagramDataCompressor::OpenHighLowCloseAggregation );
+        rebuilt.setResolution( 8, 100 );
+        QCOMPARE( compressor->modelDataRows(), rebuilt.modelDataRows() );
+        for ( int row = 0; row < rebuilt.modelDataRows(); ++row ) {
+            for ( int column = 0; column < rebuilt.modelDataColumns(); ++column ) {
+                const KChart::CartesianDiagramDataCompressor::DataPoint expected
+                        = rebuilt.data( CachePosition( row, column ) );
+                const KChart::CartesianDiagramDataCompressor::DataPoint actual
+                        = compressor->data( CachePosition( row, column ) );
+                QCOMPARE( actual.value, expected.value );
+                QCOMPARE( actual.key, expected.key );
+                QCOMPARE( actual.index, expected.index );
+            }
+        }
+    }
+
     KChart::CartesianDiagramDataCompressor compressor;
     QStandardItemModel model;
     static const int RowCount;
@@ -22,8 +22,10 @@
 #include <QPointF>
 #include <QPair>
 #include <QString>
+#include <QPainter>
 #include <KChartChart>
 #include <KChartCartesianCoordinatePlane>
+#include <KChartCartesianAxis>
 #include <KChartBarDiagram>
 #include <KChartPlotter>
 #include <KChartGridAttributes>
@@ -31,6 +33,25 @@
 
 using namespace KChart;
 
+// counts how often the axis is asked for its labels, which it caches along with its ticks
+class CountingAxis : public CartesianAxis
+{
+public:
+    explicit CountingAxis( AbstractCartesianDiagram* diagram )
+        : CartesianAxis( diagram ),
+          labelsCustomized( 0 )
+    {
+    }
+
+    const QString customizedLabel( const QString& label ) const Q_DECL_OVERRIDE
+    {
+        ++labelsCustomized;
+        return label;
+    }
+
+    mutable int labelsCustomized;
+};
+
 class NumericDataModel : public QStandardItemModel
 {
     Q_OBJECT
@@ -88,9 +109,12 @@ private slots:
     void testGlobalGridAttributesSettings();
     void testGridAttributesSettings();
     void testAxesCalcModesSettings();
+    void testAxisTickCache();
 
 private:
     void doTestRangeSettings( AbstractCartesianDiagram *diagram, const QPointF &min, const QPointF &max );
+    static void paint( Chart *chart, QImage *image );
+    static QImage paintFresh( QAbstractItemModel *model, const QSize &size, qreal zoomFactorX );
 
     Chart *m_chart;
     BarDiagram *m_bars;
@@ -289,6 +313,94 @@ void TestCartesianPlanes::testAxesCalcModesSettings()
     QCOMPARE( m_plane->axesCalcModeY(), AbstractCoordinatePlane::Linear );
 }
 
+void TestCartesianPlanes::testAxisTickCache()
+{
+    QStandardItemModel model( 6, 2 );
+    for ( int row = 0; row < model.rowCount(); row++ ) {
+        model.setHeaderData( row, Qt::Vertical, QString::fromLatin1( "Row %1" ).arg( row ) );
+        for ( int column = 0; column < model.columnCount(); column++ ) {
+            model.setData( model.index( row, column ), 10 + row * ( column + 3 ) );
+        }
+    }
+
+    Chart chart;
+    chart.resize( 400, 300 );
+    CartesianCoordinatePlane *plane = new CartesianCoordinatePlane( &chart );
+    chart.replaceCoordinatePlane( plane );
+    BarDiagram *bars = new BarDiagram;
+    bars->setModel( &model );
+    // the axes add themselves to the diagram
+    CountingAxis *xAxis = new CountingAxis( bars );
+    xAxis->setPosition( CartesianAxis::Bottom );
+    CountingAxis *yAxis = new CountingAxis( bars );
+    yAxis->setPosition( CartesianAxis::Left );
+    plane->replaceDiagram( bars );
+
+    // one image for all paints, the axes recalculate their labels for another paint device
+    QImage image( chart.size(), QImage::Format_ARGB32_Premultiplied );
+    paint( &chart, &image );
+    QCOMPARE( image, paintFresh( &model, chart.size(), 1.0 ) );
+    QVERIFY( xAxis->labelsCustomized > 0 );
+    QVERIFY( yAxis->labelsCustomized > 0 );
+
+    // nothing changed, so the cached labels are used
+    int xLabels = xAxis->labelsCustomized;
+    int yLabels = yAxis->labelsCustomized;
+    const QImage unchanged = image;
+    paint( &chart, &image );
+    QCOMPARE( image, unchanged );
+    QCOMPARE( xAxis->labelsCustomized, xLabels );
+    QCOMPARE( yAxis->labelsCustomized, yLabels );
+
+    // header data are the labels of the x axis
+    model.setHeaderData( 2, Qt::Vertical, QString::fromLatin1( "Changed" ) );
+    paint( &chart, &image );
+    QVERIFY( xAxis->labelsCustomized > xLabels );
+    QVERIFY( image != unchanged );
+    QCOMPARE( image, paintFresh( &model, chart.size(), 1.0 ) );
+
+    // zooming keeps the ticks but moves them, so they must be placed again
+    const QImage unzoomed = image;
+    plane->setZoomFactorX( 2.0 );
+    paint( &chart, &image );
+    QVERIFY( image != unzoomed );
+    QCOMPARE( image, paintFresh( &model, chart.size(), 2.0 ) );
+
+    // and resizing changes how many labels fit
+    chart.resize( 600, 450 );
+    image = QImage( chart.size(), QImage::Format_ARGB32_Premultiplied );
+    paint( &chart, &image );
+    QCOMPARE( image, paintFresh( &model, chart.size(), 2.0 ) );
+}
+
+void TestCartesianPlanes::paint( Chart *chart, QImage *image )
+{
+    image->fill( Qt::white );
+    QPainter painter( image );
+    chart->paint( &painter, image->rect() );
+}
+
+// paints \a model with axes that did not paint before
+QImage TestCartesianPlanes::paintFresh( QAbstractItemModel *model, const QSize &size, qreal zoomFactorX )
+{
+    Chart chart;
+    chart.resize( size );
+    CartesianCoordinatePlane *plane = new CartesianCoordinatePlane( &chart );
+    chart.replaceCoordinatePlane( plane );
+    BarDiagram *bars = new BarDiagram;
+    bars->setModel( model );
+    CartesianAxis *xAxis = new CartesianAxis( bars );
+    xAxis->setPosition( CartesianAxis::Bottom );
+    CartesianAxis *yAxis = new CartesianAxis( bars );
+    yAxis->setPosition( CartesianAxis::Left );
+    plane->replaceDiagram( bars );
+    plane->setZoomFactorX( zoomFactorX );
+
+    QImage image( size, QImage::Format_ARGB32_Premultiplied );
+    paint( &chart, &image );
+    return image;
+}
+
 
 QTEST_MAIN(TestCartesianPlanes)
 
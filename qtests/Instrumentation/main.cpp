@@ -0,0 +1,171 @@
+/**
+ * Copyright (C) 2026 The KDiagram developers
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QBuffer>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QStandardItemModel>
+
+#include <KChartChart>
+#include <KChartGlobal>
+#include <KChartInstrumentation>
+#include <KChartLineDiagram>
+#include <KChartCartesianCoordinatePlane>
+
+using namespace KChart;
+
+class TestInstrumentation: public QObject {
+    Q_OBJECT
+private slots:
+
+    void initTestCase()
+    {
+        m_chart = new Chart(nullptr);
+        m_chart->resize( 400, 300 );
+        m_model = new QStandardItemModel( 50, 2, this );
+        for ( int row = 0; row < m_model->rowCount(); ++row ) {
+            for ( int column = 0; column < m_model->columnCount(); ++column ) {
+                m_model->setData( m_model->index( row, column ), row * ( column + 1 ) );
+            }
+        }
+        m_lines = new LineDiagram();
+        m_lines->setModel( m_model );
+        m_chart->coordinatePlane()->replaceDiagram( m_lines );
+    }
+
+    void cleanup()
+    {
+        Instrumentation::setEnabled( false );
+        Instrumentation::setTraceEnabled( false );
+        Instrumentation::reset();
+    }
+
+    void testDisabled()
+    {
+        QVERIFY( !Instrumentation::isEnabled() );
+        paint();
+        QCOMPARE( Instrumentation::totalStatistics().stages().count(), 0 );
+        QCOMPARE( Instrumentation::totalStatistics().counter( Instrumentation::PrimitivesDrawn ), qint64( 0 ) );
+    }
+
+    void testStatistics()
+    {
+        Instrumentation::setEnabled( true );
+        paint();
+        paint();
+
+        const Instrumentation::Statistics chart = Instrumentation::statistics( m_chart );
+        QCOMPARE( chart.stageCalls( "paint" ), 2 );
+        QCOMPARE( chart.stageCalls( "layout" ), 2 );
+
+        const Instrumentation::Statistics plane = Instrumentation::statistics( m_chart->coordinatePlane() );
+        QCOMPARE( plane.stageCalls( "paint" ), 2 );
+        QCOMPARE( plane.stageCalls( "grid" ), 2 );
+        QVERIFY( plane.stageTime( "paint" ) >= plane.stageTime( "grid" ) );
+
+        const Instrumentation::Statistics diagram = Instrumentation::statistics( m_lines );
+        QCOMPARE( diagram.stageCalls( "paint" ), 2 );
+        QVERIFY( diagram.counter( Instrumentation::PointsCompressed ) > 0 );
+        QVERIFY( diagram.counter( Instrumentation::PrimitivesDrawn ) > 0 );
+
+        const Instrumentation::Statistics total = Instrumentation::totalStatistics();
+        QVERIFY( total.counter( Instrumentation::PointsCompressed ) >= diagram.counter( Instrumentation::PointsCompressed ) );
+        QVERIFY( total.stageTime( "paint" ) >= chart.stageTime( "paint" ) );
+
+        Instrumentation::reset();
+        QCOMPARE( Instrumentation::statistics( m_lines ).stageCalls( "paint" ), 0 );
+        QCOMPARE( Instrumentation::totalStatistics().counter( Instrumentation::PointsCompressed ), qint64( 0 ) );
+    }
+
+    void testDestroyedOwner()
+    {
+        Instrumentation::setEnabled( true );
+        LineDiagram* lines = new LineDiagram();
+        lines->setModel( m_model );
+        m_chart->coordinatePlane()->addDiagram( lines );
+        paint();
+        QCOMPARE( Instrumentation::statistics( lines ).stageCalls( "paint" ), 1 );
+        const qint64 primitives = Instrumentation::totalStatistics().counter( Instrumentation::PrimitivesDrawn );
+
+        // the statistics of a destroyed object go away, the totals stay
+        const QObject* const dead = lines;
+        m_chart->coordinatePlane()->takeDiagram( lines );
+        delete lines;
+        QCOMPARE( Instrumentation::statistics( dead ).stageCalls( "paint" ), 0 );
+        QCOMPARE( Instrumentation::totalStatistics().counter( Instrumentation::PrimitivesDrawn ), primitives );
+        QVERIFY( Instrumentation::statistics( m_lines ).stageCalls( "paint" ) > 0 );
+    }
+
+    void testChromeTrace()
+    {
+        Instrumentation::setEnabled( true );
+        paint();
+        QCOMPARE( QJsonDocument::fromJson( Instrumentation::chromeTrace() ).object()
+                  .value( QStringLiteral( "traceEvents" ) ).toArray().count(), 0 );
+
+        Instrumentation::setTraceEnabled( true );
+        paint();
+        QBuffer buffer;
+        buffer.open( QIODevice::WriteOnly );
+        QVERIFY( Instrumentation::writeChromeTrace( &buffer ) );
+
+        QJsonParseError error;
+        const QJsonDocument trace = QJsonDocument::fromJson( buffer.data(), &error );
+        QCOMPARE( error.error, QJsonParseError::NoError );
+        const QJsonArray events = trace.object().value( QStringLiteral( "traceEvents" ) ).toArray();
+        QVERIFY( !events.isEmpty() );
+        bool foundDiagram = false;
+        Q_FOREACH( const QJsonValue& value, events ) {
+            const QJsonObject event = value.toObject();
+            QCOMPARE( event.value( QStringLiteral( "ph" ) ).toString(), QStringLiteral( "X" ) );
+            QVERIFY( event.value( QStringLiteral( "dur" ) ).toDouble() >= 0.0 );
+            if ( event.value( QStringLiteral( "name" ) ).toString() == QLatin1String( "KChart::LineDiagram::paint" ) ) {
+                foundDiagram = true;
+                QVERIFY( event.value( QStringLiteral( "args" ) ).toObject()
+                         .value( QStringLiteral( "primitivesDrawn" ) ).toDouble() > 0 );
+            }
+        }
+        QVERIFY( foundDiagram );
+    }
+
+    void cleanupTestCase()
+    {
+        delete m_chart;
+    }
+
+private:
+    void paint()
+    {
+        QImage image( m_chart->size(), QImage::Format_ARGB32_Premultiplied );
+        QPainter painter( &image );
+        m_chart->paint( &painter, image.rect() );
+    }
+
+    Chart *m_chart;
+    QStandardItemModel *m_model;
+    LineDiagram *m_lines;
+};
+
+QTEST_MAIN(TestInstrumentation)
+
+#include "main.moc"
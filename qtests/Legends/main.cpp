@@ -26,6 +26,8 @@
 #include <KChartLineDiagram>
 #include <KChartCartesianCoordinatePlane>
 #include <KChartLegend>
+#include <KChartLayoutItems>
+#include <KChartMarkerAttributes>
 
 #include <TableModel.h>
 
@@ -132,12 +134,167 @@ private slots:
        QVERIFY( l->legendStyle() == Legend::LinesOnly );
     }
 
+    void testVisibleEntries()
+    {
+        QStandardItemModel model( 3, 1000 );
+        LineDiagram* diagram = new LineDiagram();
+        diagram->setModel( &model );
+        Legend* l = new Legend( diagram, m_chart );
+        QCOMPARE( l->maximumVisibleEntries(), 0 );
+        l->needSizeHint();
+        QCOMPARE( l->entryCount(), 1000 );
+        const int fullHeight = l->sizeHint().height();
+
+        l->setMaximumVisibleEntries( 10 );
+        l->needSizeHint();
+        QCOMPARE( l->entryCount(), 1000 );
+        const int windowHeight = l->sizeHint().height();
+        QVERIFY( windowHeight < fullHeight );
+
+        l->setFirstVisibleEntry( 5000 );
+        l->needSizeHint();
+        QCOMPARE( l->firstVisibleEntry(), 990 );
+        QCOMPARE( l->sizeHint().height(), windowHeight );
+
+        l->showPreviousEntries();
+        l->needSizeHint();
+        QCOMPARE( l->firstVisibleEntry(), 980 );
+        l->showNextEntries();
+        l->showNextEntries();
+        QCOMPARE( l->firstVisibleEntry(), 990 );
+
+        // fractions of a wheel step add up to one
+        l->setFirstVisibleEntry( 500 );
+        const int lines = QApplication::wheelScrollLines();
+        sendWheelEvent( l, 40 );
+        sendWheelEvent( l, 40 );
+        QCOMPARE( l->firstVisibleEntry(), 500 );
+        sendWheelEvent( l, 40 );
+        QCOMPARE( l->firstVisibleEntry(), 500 - lines );
+        sendWheelEvent( l, -60 );
+        sendWheelEvent( l, -60 );
+        QCOMPARE( l->firstVisibleEntry(), 500 );
+        sendWheelEvent( l, 240 );
+        QCOMPARE( l->firstVisibleEntry(), 500 - 2 * lines );
+
+        delete l;
+        delete diagram;
+    }
+
+    void testEntryReuse()
+    {
+        QStandardItemModel model( 3, 4 );
+        for ( int column = 0; column < model.columnCount(); ++column ) {
+            model.setHeaderData( column, Qt::Horizontal, QString::fromLatin1( "Dataset %1" ).arg( column ) );
+        }
+        LineDiagram* diagram = new LineDiagram();
+        diagram->setModel( &model );
+        Legend* l = new Legend( diagram, m_chart );
+        l->forceRebuild();
+        QCOMPARE( l->entryCount(), 4 );
+        verifyEntries( l );
+
+        // rebuilding without a change keeps all items
+        QList< QLayoutItem* > markers = entryMarkers( l );
+        QList< TextLayoutItem* > labels = entryLabels( l );
+        l->forceRebuild();
+        QCOMPARE( entryMarkers( l ), markers );
+        QCOMPARE( entryLabels( l ), labels );
+
+        // another text only updates the label
+        l->setText( 1, QString::fromLatin1( "Renamed" ) );
+        model.setHeaderData( 0, Qt::Horizontal, QString::fromLatin1( "First" ) );
+        l->forceRebuild();
+        QCOMPARE( entryMarkers( l ), markers );
+        QCOMPARE( entryLabels( l ), labels );
+        QCOMPARE( labels.at( 1 )->text(), QString::fromLatin1( "Renamed" ) );
+        QCOMPARE( labels.at( 0 )->text(), QString::fromLatin1( "First" ) );
+        verifyEntries( l );
+
+        // other marker attributes replace only that marker
+        MarkerAttributes ma = l->markerAttributes( 2 );
+        ma.setMarkerStyle( MarkerAttributes::MarkerDiamond );
+        l->setMarkerAttributes( 2, ma );
+        l->forceRebuild();
+        QList< QLayoutItem* > changedMarkers = entryMarkers( l );
+        QVERIFY( changedMarkers.at( 2 ) != markers.at( 2 ) );
+        changedMarkers[ 2 ] = markers.at( 2 );
+        QCOMPARE( changedMarkers, markers );
+        QCOMPARE( entryLabels( l ), labels );
+        markers = entryMarkers( l );
+
+        // a new dataset adds an entry and keeps the others
+        model.insertColumn( 4 );
+        model.setHeaderData( 4, Qt::Horizontal, QString::fromLatin1( "Added" ) );
+        l->forceRebuild();
+        QCOMPARE( l->entryCount(), 5 );
+        QCOMPARE( entryMarkers( l ).mid( 0, 4 ), markers );
+        QCOMPARE( entryLabels( l ).mid( 0, 4 ), labels );
+        QCOMPARE( entryLabels( l ).at( 4 )->text(), QString::fromLatin1( "Added" ) );
+        verifyEntries( l );
+
+        // removed datasets drop the entries at the end, the remaining labels show the datasets now there
+        labels = entryLabels( l );
+        model.removeColumns( 1, 2 );
+        l->forceRebuild();
+        QCOMPARE( l->entryCount(), 3 );
+        QCOMPARE( entryLabels( l ), labels.mid( 0, 3 ) );
+        QCOMPARE( entryLabels( l ).at( 2 )->text(), QString::fromLatin1( "Added" ) );
+        verifyEntries( l );
+
+        delete l;
+        delete diagram;
+    }
 
     void cleanupTestCase()
     {
     }
 
 private:
+    // the item in \a column of the row of entry \a i in a vertical legend: 1 is the marker, 3 the label
+    static QLayoutItem* entryItem( Legend* l, int i, int column )
+    {
+        QGridLayout* layout = qobject_cast< QGridLayout* >( l->layout() );
+        return layout ? layout->itemAtPosition( 2 + i * 2, column ) : nullptr;
+    }
+
+    static QList< QLayoutItem* > entryMarkers( Legend* l )
+    {
+        QList< QLayoutItem* > markers;
+        for ( int i = 0; i < l->entryCount(); ++i ) {
+            markers << entryItem( l, i, 1 );
+        }
+        return markers;
+    }
+
+    static QList< TextLayoutItem* > entryLabels( Legend* l )
+    {
+        QList< TextLayoutItem* > labels;
+        for ( int i = 0; i < l->entryCount(); ++i ) {
+            labels << dynamic_cast< TextLayoutItem* >( entryItem( l, i, 3 ) );
+        }
+        return labels;
+    }
+
+    // every entry has a marker and a label showing its text, and there are no others
+    static void verifyEntries( Legend* l )
+    {
+        for ( int i = 0; i < l->entryCount(); ++i ) {
+            QVERIFY( entryItem( l, i, 1 ) );
+            TextLayoutItem* label = dynamic_cast< TextLayoutItem* >( entryItem( l, i, 3 ) );
+            QVERIFY( label );
+            QCOMPARE( label->text(), l->text( i ) );
+        }
+        QVERIFY( !entryItem( l, l->entryCount(), 3 ) );
+    }
+
+    static void sendWheelEvent( QWidget* widget, int delta )
+    {
+        QWheelEvent event( QPointF(), QPointF(), QPoint(), QPoint( 0, delta ), delta, Qt::Vertical,
+                           Qt::NoButton, Qt::NoModifier );
+        QApplication::sendEvent( widget, &event );
+    }
+
     Chart *m_chart;
     BarDiagram *m_bars;
     LineDiagram *m_lines;
@@ -0,0 +1,307 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QStandardItemModel>
+#include <KChartChart>
+#include <KChartLeveyJenningsDiagram>
+#include <KChartLeveyJenningsCoordinatePlane>
+
+#include <cmath>
+#include <limits>
+
+using namespace KChart;
+
+typedef QPair< QDateTime, QDateTime > TimeRange;
+
+// A QStandardItemModel that can move rows, which it does not implement itself
+class MovableRowsModel : public QStandardItemModel {
+public:
+    explicit MovableRowsModel( QObject* parent )
+        : QStandardItemModel( 0, 4, parent )
+    {
+    }
+
+    // moves \a row one row up, emitting only rowsMoved()
+    void moveRowUp( int row )
+    {
+        beginMoveRows( QModelIndex(), row, row, QModelIndex(), row - 1 );
+        const bool blocked = blockSignals( true );
+        for ( int column = 0; column < columnCount(); ++column ) {
+            QStandardItem* above = takeItem( row - 1, column );
+            setItem( row - 1, column, takeItem( row, column ) );
+            setItem( row, column, above );
+        }
+        blockSignals( blocked );
+        endMoveRows();
+    }
+};
+
+class TestLeveyJennings: public QObject {
+    Q_OBJECT
+private slots:
+
+    void init()
+    {
+        m_chart = new Chart( nullptr );
+        m_plane = new LeveyJenningsCoordinatePlane;
+        m_chart->replaceCoordinatePlane( m_plane );
+        m_model = new MovableRowsModel( this );
+        m_diagram = new LeveyJenningsDiagram;
+        m_diagram->setModel( m_model );
+        m_plane->replaceDiagram( m_diagram );
+        m_start = QDateTime( QDate( 2007, 7, 6 ), QTime( 9, 0 ), Qt::UTC );
+    }
+
+    void cleanup()
+    {
+        delete m_chart;
+        delete m_model;
+    }
+
+    void testCalculatedValues()
+    {
+        QVERIFY( std::isnan( m_diagram->calculatedMeanValue() ) );
+        QVERIFY( std::isnan( m_diagram->calculatedStandardDeviation() ) );
+
+        appendRow( 200, hours( 0 ) );
+        QCOMPARE( m_diagram->calculatedMeanValue(), 200.0f );
+        QVERIFY( std::isnan( m_diagram->calculatedStandardDeviation() ) );
+
+        const qreal values[] = { 195, 210, 188, 205, 199, 201 };
+        for ( int i = 0; i < 6; ++i ) {
+            appendRow( values[ i ], hours( 12 * ( i + 1 ) ) );
+        }
+        verifyStatistics();
+    }
+
+    void testUpdates()
+    {
+        for ( int i = 0; i < 20; ++i ) {
+            appendRow( 100 + ( i * 7 ) % 13, hours( 12 * i ) );
+        }
+        verifyStatistics();
+
+        // change a value, then the time of a row
+        m_model->setData( m_model->index( 5, 1 ), 150 );
+        verifyStatistics();
+        m_model->setData( m_model->index( 6, 3 ), hours( 12 * 6 + 1 ) );
+        verifyStatistics();
+
+        // insert in the middle and at the start
+        insertRow( 10, 120, hours( 12 * 9 + 6 ) );
+        insertRow( 0, 90, hours( -12 ) );
+        verifyStatistics();
+
+        QVERIFY( m_model->removeRows( 3, 4 ) );
+        verifyStatistics();
+        QVERIFY( m_model->removeRows( 0, m_model->rowCount() ) );
+        QVERIFY( std::isnan( m_diagram->calculatedMeanValue() ) );
+        QVERIFY( std::isnan( m_diagram->calculatedMeanValue( TimeRange() ) ) );
+    }
+
+    void testInvalidValuesAndTimes()
+    {
+        for ( int i = 0; i < 10; ++i ) {
+            appendRow( 100 + i, hours( 12 * i ) );
+        }
+        // rows without a value, and a row without a time, which is not in any window
+        insertRow( 3, std::numeric_limits< qreal >::quiet_NaN(), hours( 12 * 2 + 6 ) );
+        insertRow( 6, 500, QDateTime() );
+        appendRow( std::numeric_limits< qreal >::quiet_NaN(), QDateTime() );
+        verifyStatistics();
+
+        // the value of the row without a time still counts in the overall statistics
+        QVERIFY( m_diagram->calculatedMeanValue() > m_diagram->calculatedMeanValue( TimeRange() ) );
+
+        // giving the row a time puts it into the windows
+        m_model->setData( m_model->index( 6, 3 ), hours( 12 * 4 + 6 ) );
+        verifyStatistics();
+        QVERIFY( fuzzyEqual( m_diagram->calculatedMeanValue( TimeRange() ), m_diagram->calculatedMeanValue() ) );
+
+        // and taking it away again removes it
+        m_model->setData( m_model->index( 6, 3 ), QDateTime() );
+        verifyStatistics();
+    }
+
+    void testUnsortedTimes()
+    {
+        for ( int i = 0; i < 10; ++i ) {
+            appendRow( 100 + ( i * 5 ) % 7, hours( 12 * i ) );
+        }
+        verifyStatistics();
+        appendRow( 50, hours( 6 ) );
+        verifyStatistics();
+        insertRow( 2, 70, hours( 12 * 20 ) );
+        verifyStatistics();
+        QVERIFY( m_model->removeRows( 0, 2 ) );
+        verifyStatistics();
+    }
+
+    void testMovedRows()
+    {
+        for ( int i = 0; i < 10; ++i ) {
+            appendRow( 100 + i * i, hours( 12 * i ) );
+        }
+        verifyStatistics();
+
+        // after a move, later changes must find the values of the rows where they are now
+        m_model->moveRowUp( 7 );
+        verifyStatistics();
+        m_model->setData( m_model->index( 6, 1 ), 20 );
+        m_model->setData( m_model->index( 7, 3 ), hours( 1 ) );
+        verifyStatistics();
+        QVERIFY( m_model->removeRows( 6, 1 ) );
+        verifyStatistics();
+
+        // sorting changes the layout
+        m_model->sort( 1, Qt::DescendingOrder );
+        verifyStatistics();
+        m_model->setData( m_model->index( 0, 1 ), 40 );
+        m_model->setData( m_model->index( 2, 3 ), hours( 500 ) );
+        verifyStatistics();
+        QVERIFY( m_model->removeRows( 1, 2 ) );
+        verifyStatistics();
+    }
+
+    void testPrecision()
+    {
+        // a large mean with a small variance loses all precision in a plain sum of squares
+        for ( int i = 0; i < 100; ++i ) {
+            appendRow( 1.0e7 + ( i % 2 ? 0.5 : -0.5 ), hours( i ) );
+        }
+        const qreal sd = std::sqrt( 0.25 * 100 / 99 );
+        QVERIFY( qAbs( m_diagram->calculatedStandardDeviation() - sd ) < 1.0e-3 );
+        QVERIFY( qAbs( m_diagram->calculatedStandardDeviation( TimeRange( hours( 10 ), hours( 89 ) ) ) - sd ) < 1.0e-3 );
+        verifyStatistics();
+    }
+
+private:
+    QDateTime hours( int h ) const
+    {
+        return m_start.addSecs( h * 3600 );
+    }
+
+    QList< QStandardItem* > makeRow( qreal value, const QDateTime& time ) const
+    {
+        QList< QStandardItem* > items;
+        items << new QStandardItem( QString::number( 1 ) );
+        QStandardItem* valueItem = new QStandardItem;
+        if ( !std::isnan( value ) ) {
+            valueItem->setData( value, Qt::DisplayRole );
+        }
+        items << valueItem;
+        QStandardItem* okItem = new QStandardItem;
+        okItem->setData( true, Qt::DisplayRole );
+        items << okItem;
+        QStandardItem* timeItem = new QStandardItem;
+        if ( time.isValid() ) {
+            timeItem->setData( time, Qt::DisplayRole );
+        }
+        items << timeItem;
+        return items;
+    }
+
+    void appendRow( qreal value, const QDateTime& time )
+    {
+        m_model->appendRow( makeRow( value, time ) );
+    }
+
+    void insertRow( int row, qreal value, const QDateTime& time )
+    {
+        m_model->insertRow( row, makeRow( value, time ) );
+    }
+
+    // the mean and standard deviation of the rows in \a range, computed in two passes
+    void expectedStatistics( const TimeRange* range, qreal* mean, qreal* sd ) const
+    {
+        QVector< qreal > values;
+        for ( int row = 0; row < m_model->rowCount(); ++row ) {
+            const QVariant value = m_model->data( m_model->index( row, 1 ) );
+            const QDateTime time = m_model->data( m_model->index( row, 3 ) ).toDateTime();
+            if ( !value.isValid() ) {
+                continue;
+            }
+            if ( range && ( !time.isValid()
+                            || ( range->first.isValid() && time < range->first )
+                            || ( range->second.isValid() && time > range->second ) ) ) {
+                continue;
+            }
+            values.append( value.toReal() );
+        }
+        qreal sum = 0.0;
+        Q_FOREACH( qreal value, values ) {
+            sum += value;
+        }
+        *mean = values.isEmpty() ? std::numeric_limits< qreal >::quiet_NaN() : sum / values.count();
+        qreal squares = 0.0;
+        Q_FOREACH( qreal value, values ) {
+            squares += ( value - *mean ) * ( value - *mean );
+        }
+        *sd = values.count() > 1 ? std::sqrt( squares / ( values.count() - 1 ) )
+                                 : std::numeric_limits< qreal >::quiet_NaN();
+    }
+
+    static bool fuzzyEqual( qreal actual, qreal expected )
+    {
+        if ( std::isnan( expected ) ) {
+            return std::isnan( actual );
+        }
+        return qAbs( actual - expected ) <= 1.0e-4 * qMax( qreal( 1.0 ), qAbs( expected ) );
+    }
+
+    void verifyRange( const TimeRange& range )
+    {
+        qreal mean;
+        qreal sd;
+        expectedStatistics( &range, &mean, &sd );
+        QVERIFY( fuzzyEqual( m_diagram->calculatedMeanValue( range ), mean ) );
+        QVERIFY( fuzzyEqual( m_diagram->calculatedStandardDeviation( range ), sd ) );
+    }
+
+    void verifyStatistics()
+    {
+        qreal mean;
+        qreal sd;
+        expectedStatistics( nullptr, &mean, &sd );
+        QVERIFY( fuzzyEqual( m_diagram->calculatedMeanValue(), mean ) );
+        QVERIFY( fuzzyEqual( m_diagram->calculatedStandardDeviation(), sd ) );
+
+        // open ends, single rows, inner windows and windows outside of all rows
+        verifyRange( TimeRange() );
+        verifyRange( TimeRange( hours( 30 ), QDateTime() ) );
+        verifyRange( TimeRange( QDateTime(), hours( 30 ) ) );
+        verifyRange( TimeRange( hours( 24 ), hours( 24 ) ) );
+        verifyRange( TimeRange( hours( 13 ), hours( 23 ) ) );
+        for ( int first = -24; first < 300; first += 17 ) {
+            verifyRange( TimeRange( hours( first ), hours( first + 40 ) ) );
+        }
+        verifyRange( TimeRange( hours( 1000 ), hours( 2000 ) ) );
+    }
+
+    Chart* m_chart;
+    LeveyJenningsCoordinatePlane* m_plane;
+    LeveyJenningsDiagram* m_diagram;
+    MovableRowsModel* m_model;
+    QDateTime m_start;
+};
+
+QTEST_MAIN(TestLeveyJennings)
+
+#include "main.moc"
@@ -24,9 +24,15 @@
 #include <KChartPieAttributes>
 #include <KChartThreeDPieAttributes>
 #include <KChartPolarCoordinatePlane>
+#include <KChartDataValueAttributes>
+
+#include <QStandardItemModel>
+#include <QPainter>
 
 #include <TableModel.h>
 
+#include <cmath>
+
 using namespace KChart;
 
 class TestPieDiagrams: public QObject {
@@ -142,11 +148,176 @@ private slots:
         QVERIFY( m_pie->threeDPieAttributes().useShadowColors() == false );
     }
 
+    void testLabelCollisionAvoidance()
+    {
+        // many thin slices in one quadrant of the pie, next to one big slice
+        const int thinSlices = 30;
+        QStandardItemModel model( 1, thinSlices + 1 );
+        for ( int column = 0; column < thinSlices; column++ ) {
+            model.setData( model.index( 0, column ), 1.0 );
+        }
+        model.setData( model.index( 0, thinSlices ), 3.0 * thinSlices );
+
+        Chart chart;
+        PolarCoordinatePlane* plane = new PolarCoordinatePlane( &chart );
+        chart.replaceCoordinatePlane( plane );
+        PieDiagram* pie = new PieDiagram;
+        pie->setModel( &model );
+        DataValueAttributes dva( pie->dataValueAttributes() );
+        dva.setVisible( true );
+        pie->setDataValueAttributes( dva );
+        pie->setAllowOverlappingDataValueTexts( true );
+        pie->setLabelCollisionAvoidanceEnabled( true );
+        plane->replaceDiagram( pie );
+
+        QImage image( 800, 600, QImage::Format_ARGB32_Premultiplied );
+        QPainter painter( &image );
+        chart.paint( &painter, image.rect() );
+
+        // the label of a slice is mapped after the slice itself, so it is what visualRegion() returns
+        QVector< QRegion > labels;
+        for ( int column = 0; column <= thinSlices; column++ ) {
+            const QRegion label = pie->visualRegion( model.index( 0, column ) );
+            QVERIFY( !label.isEmpty() );
+            labels.append( label );
+        }
+        for ( int i = 0; i < labels.size(); i++ ) {
+            for ( int j = i + 1; j < labels.size(); j++ ) {
+                QVERIFY2( !labels[ i ].intersects( labels[ j ] ),
+                          qPrintable( QString::fromLatin1( "labels %1 and %2 overlap" ).arg( i ).arg( j ) ) );
+            }
+        }
+    }
+
+    void testSliceGeometryCache()
+    {
+        QStandardItemModel model( 1, 5 );
+        for ( int column = 0; column < model.columnCount(); column++ ) {
+            model.setData( model.index( 0, column ), 1.0 + column );
+        }
+        Chart chart;
+        chart.resize( 300, 300 );
+        PieDiagram* pie = createPie( &chart, &model );
+
+        // painting again reuses the slices, painting a new pie calculates them
+        const QImage image = paint( &chart );
+        QCOMPARE( paint( &chart ), image );
+        QCOMPARE( image, paintFresh( &model ) );
+
+        // both must give the same result after a change of the data...
+        model.setData( model.index( 0, 2 ), 12.0 );
+        const QImage changedData = paint( &chart );
+        QVERIFY( changedData != image );
+        QCOMPARE( changedData, paintFresh( &model ) );
+
+        // ...and of the attributes
+        PieAttributes pa( pie->pieAttributes( 1 ) );
+        pa.setExplode( true );
+        pa.setExplodeFactor( 0.2 );
+        pie->setPieAttributes( 1, pa );
+        const QImage exploded = paint( &chart );
+        QVERIFY( exploded != changedData );
+        QCOMPARE( exploded, paintFresh( &model, 1, pa ) );
+    }
+
+    void testArcsFollowPainterScale()
+    {
+        QStandardItemModel model( 1, 2 );
+        model.setData( model.index( 0, 0 ), 1.0 );
+        model.setData( model.index( 0, 1 ), 1.0 );
+        Chart chart;
+        chart.resize( 60, 60 );
+        createPie( &chart, &model );
+        // unscaled first, so the slices of the scaled paint can not come from an earlier one
+        paint( &chart );
+
+        const int scale = 40;
+        QImage image( chart.size() * scale, QImage::Format_ARGB32_Premultiplied );
+        image.fill( Qt::white );
+        {
+            QPainter painter( &image );
+            painter.scale( scale, scale );
+            chart.paint( &painter, QRect( QPoint(), chart.size() ) );
+        }
+
+        QRect pieRect;
+        for ( int y = 0; y < image.height(); y++ ) {
+            for ( int x = 0; x < image.width(); x++ ) {
+                if ( isPie( image, QPoint( x, y ) ) ) {
+                    pieRect |= QRect( x, y, 1, 1 );
+                }
+            }
+        }
+        const QPointF center = QRectF( pieRect ).center();
+        const qreal radius = pieRect.width() / 2.0;
+        QVERIFY( radius > 200.0 );
+
+        // the outline of a coarsely tessellated pie would be a few pixels closer
+        // to the center between the corners of its polygon than at them
+        qreal minRadius = radius;
+        qreal maxRadius = 0.0;
+        for ( qreal angle = 0.0; angle < 360.0; angle += 0.5 ) {
+            const QPointF direction( cos( angle * M_PI / 180.0 ), sin( angle * M_PI / 180.0 ) );
+            qreal r = radius / 2.0;
+            while ( isPie( image, ( center + direction * r ).toPoint() ) ) {
+                r += 0.25;
+            }
+            minRadius = qMin( minRadius, r );
+            maxRadius = qMax( maxRadius, r );
+        }
+        QVERIFY2( maxRadius - minRadius < 1.5,
+                  qPrintable( QString::fromLatin1( "outline radius between %1 and %2" )
+                              .arg( minRadius ).arg( maxRadius ) ) );
+    }
+
     void cleanupTestCase()
     {
     }
 
 private:
+    static PieDiagram* createPie( Chart* chart, QAbstractItemModel* model )
+    {
+        PolarCoordinatePlane* plane = new PolarCoordinatePlane( chart );
+        chart->replaceCoordinatePlane( plane );
+        PieDiagram* pie = new PieDiagram;
+        pie->setModel( model );
+        plane->replaceDiagram( pie );
+        return pie;
+    }
+
+    static QImage paint( Chart* chart )
+    {
+        QImage image( chart->size(), QImage::Format_ARGB32_Premultiplied );
+        image.fill( Qt::white );
+        QPainter painter( &image );
+        chart->paint( &painter, image.rect() );
+        return image;
+    }
+
+    // paints \a model with a pie that did not paint before, optionally with
+    // the attributes \a pa for \a column
+    static QImage paintFresh( QAbstractItemModel* model, int column = -1,
+                              const PieAttributes& pa = PieAttributes() )
+    {
+        Chart chart;
+        chart.resize( 300, 300 );
+        PieDiagram* pie = createPie( &chart, model );
+        if ( column >= 0 ) {
+            pie->setPieAttributes( column, pa );
+        }
+        return paint( &chart );
+    }
+
+    static bool isPie( const QImage& image, const QPoint& point )
+    {
+        if ( !image.rect().contains( point ) ) {
+            return false;
+        }
+        const QRgb pixel = image.pixel( point );
+        return qRed( pixel ) + qGreen( pixel ) + qBlue( pixel ) < 3 * 192;
+    }
+
+
     Chart *m_chart;
     PieDiagram *m_pie;
     TableModel *m_model;
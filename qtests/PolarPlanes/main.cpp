@@ -19,6 +19,7 @@
 
 #include <QtTest/QtTest>
 #include <QStandardItemModel>
+#include <QPainter>
 
 #include <KChartChart>
 #include <KChartGlobal>
@@ -33,6 +34,21 @@
 
 using namespace KChart;
 
+// remembers where the plane put one value while the datasets were drawn
+class TranslatingPolarDiagram : public PolarDiagram {
+public:
+    void paint( PaintContext* paintContext, bool calculateListAndReturnScale,
+                qreal& newZoomX, qreal& newZoomY ) Q_DECL_OVERRIDE
+    {
+        PolarDiagram::paint( paintContext, calculateListAndReturnScale, newZoomX, newZoomY );
+        if ( !calculateListAndReturnScale ) {
+            translated = coordinatePlane()->translate( QPointF( 1.0, 1.0 ) );
+        }
+    }
+
+    QPointF translated;
+};
+
 class TestPolarPlanes: public QObject {
     Q_OBJECT
 private slots:
@@ -143,11 +159,71 @@ private slots:
         QVERIFY( m_plane->hasOwnGridAttributes( false ) == false );
     }
 
+    void testStartPositionWithCachedPoints()
+    {
+        QStandardItemModel model( 4, 2 );
+        for ( int row = 0; row < model.rowCount(); ++row ) {
+            for ( int column = 0; column < model.columnCount(); ++column ) {
+                model.setData( model.index( row, column ), 1 + row * ( column + 1 ) );
+            }
+        }
+        Chart chart;
+        chart.resize( 300, 300 );
+        PolarCoordinatePlane* plane = new PolarCoordinatePlane;
+        chart.replaceCoordinatePlane( plane );
+        TranslatingPolarDiagram* diagram = new TranslatingPolarDiagram;
+        diagram->setModel( &model );
+        plane->replaceDiagram( diagram );
+
+        const QImage before = paint( &chart );
+        const QPointF translatedBefore = diagram->translated;
+        QCOMPARE( paint( &chart ), before );
+
+        // the diagram must not draw the points it kept from the last paint
+        plane->setStartPosition( 90 );
+        const QImage rotated = paint( &chart );
+        QVERIFY( diagram->translated != translatedBefore );
+        QVERIFY( rotated != before );
+        QCOMPARE( rotated, paintFresh( &model, 90 ) );
+
+        plane->setStartPosition( 0 );
+        QCOMPARE( paint( &chart ), before );
+        QCOMPARE( diagram->translated, translatedBefore );
+
+        // neither the points of changed values
+        model.setData( model.index( 2, 1 ), 12 );
+        QCOMPARE( paint( &chart ), paintFresh( &model, 0 ) );
+    }
+
     void cleanupTestCase()
     {
     }
 
 private:
+    static QImage paint( Chart* chart )
+    {
+        QImage image( chart->size(), QImage::Format_ARGB32_Premultiplied );
+        image.fill( Qt::white );
+        QPainter painter( &image );
+        chart->paint( &painter, image.rect() );
+        return image;
+    }
+
+    // paints \a model with a diagram that did not paint before
+    static QImage paintFresh( QAbstractItemModel* model, qreal startPosition )
+    {
+        Chart chart;
+        chart.resize( 300, 300 );
+        PolarCoordinatePlane* plane = new PolarCoordinatePlane;
+        chart.replaceCoordinatePlane( plane );
+        PolarDiagram* diagram = new PolarDiagram;
+        diagram->setModel( model );
+        plane->replaceDiagram( diagram );
+        plane->setStartPosition( startPosition );
+        return paint( &chart );
+    }
+
+
     Chart *m_chart;
     PieDiagram *m_pie;
     PolarDiagram *m_polar;
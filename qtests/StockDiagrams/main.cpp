@@ -0,0 +1,174 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QStandardItemModel>
+#include <QPainter>
+
+#include <KChartChart>
+#include <KChartCartesianCoordinatePlane>
+#include <KChartStockDiagram>
+#include <KChartThreeDBarAttributes>
+
+using namespace KChart;
+
+class TestStockDiagrams: public QObject {
+    Q_OBJECT
+private slots:
+
+    void testMergedBars()
+    {
+        // many more rows than pixels; each row on its own falls, but the rows of one pixel rise
+        const int rowCount = 10000;
+        const int spikeRow = 7000;
+        const int dipRow = 6000;
+        QStandardItemModel model( rowCount, 4 );
+        for ( int row = 0; row < rowCount; ++row ) {
+            model.setData( model.index( row, 0 ), row + 5 );
+            model.setData( model.index( row, 1 ), row == spikeRow ? row + 3000 : row + 10 );
+            model.setData( model.index( row, 2 ), row == dipRow ? row - 4000 : row - 10 );
+            model.setData( model.index( row, 3 ), row - 5 );
+        }
+
+        Chart chart;
+        chart.resize( 400, 300 );
+        CartesianCoordinatePlane* plane = new CartesianCoordinatePlane( &chart );
+        chart.replaceCoordinatePlane( plane );
+        StockDiagram* diagram = createDiagram( &model );
+        plane->replaceDiagram( diagram );
+
+        QImage image( chart.size(), QImage::Format_ARGB32_Premultiplied );
+        paint( &chart, &image );
+
+        // merged bars open like their first row and close like their last one
+        int upPixels = 0;
+        int downPixels = 0;
+        for ( int y = 0; y < image.height(); ++y ) {
+            for ( int x = 0; x < image.width(); ++x ) {
+                upPixels += image.pixel( x, y ) == upColor();
+                downPixels += image.pixel( x, y ) == downColor();
+            }
+        }
+        QVERIFY( upPixels > 0 );
+        QCOMPARE( downPixels, 0 );
+
+        // and reach from the lowest low to the highest high of their rows, and no further
+        const QPointF spike = plane->translate( QPointF( spikeRow + 0.5, spikeRow + 3000 ) );
+        const QPointF dip = plane->translate( QPointF( dipRow + 0.5, dipRow - 4000 ) );
+        QVERIFY( topOfBars( image, qRound( spike.x() ) - 3, qRound( spike.x() ) + 3 ) <= spike.y() + 2 );
+        QVERIFY( topOfBars( image, 0, image.width() - 1 ) >= spike.y() - 2 );
+        QVERIFY( bottomOfBars( image, qRound( dip.x() ) - 3, qRound( dip.x() ) + 3 ) >= dip.y() - 2 );
+    }
+
+    void testThreeDOverTwoD()
+    {
+        // two rising datasets at the same rows, the first one taller than the second one
+        const qreal values[ 2 ][ 4 ] = { { 10, 95, 5, 90 }, { 40, 65, 35, 60 } };
+        QStandardItemModel model( 3, 8 );
+        for ( int row = 0; row < 3; ++row ) {
+            for ( int column = 0; column < 8; ++column ) {
+                model.setData( model.index( row, column ), values[ column / 4 ][ column % 4 ] );
+            }
+        }
+
+        Chart chart;
+        chart.resize( 400, 300 );
+        CartesianCoordinatePlane* plane = new CartesianCoordinatePlane( &chart );
+        chart.replaceCoordinatePlane( plane );
+        StockDiagram* diagram = createDiagram( &model );
+        diagram->setUpTrendCandlestickPen( QPen( Qt::black ) );
+        // only the second dataset is 3D; its attributes are looked up by the column of the low value
+        ThreeDBarAttributes threeDAttrs;
+        threeDAttrs.setEnabled( true );
+        threeDAttrs.setDepth( 20 );
+        threeDAttrs.setAngle( 45 );
+        threeDAttrs.setUseShadowColors( true );
+        diagram->setThreeDBarAttributes( 6, threeDAttrs );
+        QVERIFY( diagram->threeDBarAttributes( 6 ).isEnabled() );
+        QVERIFY( !diagram->threeDBarAttributes( 2 ).isEnabled() );
+        plane->replaceDiagram( diagram );
+
+        QImage image( chart.size(), QImage::Format_ARGB32_Premultiplied );
+        paint( &chart, &image );
+
+        for ( int row = 0; row < 3; ++row ) {
+            // the flat candlestick of the first dataset is painted before the 3D one of the second
+            // dataset, so the shaded top of the 3D candlestick covers it
+            const QPointF top = plane->translate( QPointF( row + 0.5, 60 ) );
+            const QColor shade = image.pixel( qRound( top.x() ) - 6, qRound( top.y() ) - 4 );
+            QVERIFY2( shade.blue() > 0 && shade.blue() < 255 && shade.red() == 0 && shade.green() == 0,
+                      qPrintable( QString::fromLatin1( "row %1 has %2 on top" ).arg( row ).arg( shade.name() ) ) );
+            const QPointF front = plane->translate( QPointF( row + 0.5, 80 ) );
+            QCOMPARE( image.pixel( front.toPoint() ), upColor() );
+        }
+    }
+
+private:
+    static QRgb upColor() { return qRgb( 0, 0, 255 ); }
+    static QRgb downColor() { return qRgb( 255, 0, 0 ); }
+
+    // a candlestick diagram painting rising bars in upColor() and falling bars in downColor()
+    static StockDiagram* createDiagram( QAbstractItemModel* model )
+    {
+        StockDiagram* diagram = new StockDiagram;
+        diagram->setType( StockDiagram::Candlestick );
+        diagram->setModel( model );
+        diagram->setUpTrendCandlestickBrush( QColor( upColor() ) );
+        diagram->setUpTrendCandlestickPen( QPen( QColor( upColor() ) ) );
+        diagram->setDownTrendCandlestickBrush( QColor( downColor() ) );
+        diagram->setDownTrendCandlestickPen( QPen( QColor( downColor() ) ) );
+        return diagram;
+    }
+
+    static void paint( Chart* chart, QImage* image )
+    {
+        image->fill( Qt::white );
+        QPainter painter( image );
+        chart->paint( &painter, image->rect() );
+    }
+
+    // the topmost and bottommost row with bar pixels in columns \a left to \a right
+    static int topOfBars( const QImage& image, int left, int right )
+    {
+        for ( int y = 0; y < image.height(); ++y ) {
+            for ( int x = qMax( 0, left ); x <= qMin( right, image.width() - 1 ); ++x ) {
+                if ( image.pixel( x, y ) == upColor() ) {
+                    return y;
+                }
+            }
+        }
+        return image.height();
+    }
+
+    static int bottomOfBars( const QImage& image, int left, int right )
+    {
+        for ( int y = image.height() - 1; y >= 0; --y ) {
+            for ( int x = qMax( 0, left ); x <= qMin( right, image.width() - 1 ); ++x ) {
+                if ( image.pixel( x, y ) == upColor() ) {
+                    return y;
+                }
+            }
+        }
+        return -1;
+    }
+};
+
+QTEST_MAIN(TestStockDiagrams)
+
+#include "main.moc"
@@ -0,0 +1,258 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QStandardItemModel>
+#include <QPainter>
+
+#include <KChartChart>
+#include <KChartTernaryCoordinatePlane>
+#include <KChartTernaryPointDiagram>
+#include <KChartTernaryLineDiagram>
+#include <KChartDataValueAttributes>
+#include <KChartMarkerAttributes>
+#include <KChartTextAttributes>
+
+#include <cmath>
+
+using namespace KChart;
+
+class TestTernaryDiagrams: public QObject {
+    Q_OBJECT
+private slots:
+
+    void testProjection()
+    {
+        // unnormalized values, a row without data and one with only zeros
+        const qreal values[ 6 ][ 3 ] = {
+            { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 2, 1, 1 }, { 0, 0, 0 }, { 3, 5, 2 }
+        };
+        QStandardItemModel model( 7, 3 );
+        for ( int row = 0; row < 6; ++row ) {
+            for ( int column = 0; column < 3; ++column ) {
+                model.setData( model.index( row, column ), values[ row ][ column ] );
+            }
+        }
+
+        Chart chart;
+        chart.resize( 400, 400 );
+        TernaryCoordinatePlane* plane = new TernaryCoordinatePlane;
+        chart.replaceCoordinatePlane( plane );
+        TernaryPointDiagram* diagram = new TernaryPointDiagram;
+        diagram->setModel( &model );
+        showMarkers( diagram );
+        plane->replaceDiagram( diagram );
+        paint( &chart );
+
+        for ( int row = 0; row < 6; ++row ) {
+            const QRect marker = diagram->visualRect( model.index( row, 0 ) );
+            const qreal total = values[ row ][ 0 ] + values[ row ][ 1 ] + values[ row ][ 2 ];
+            if ( total == 0.0 ) {
+                QVERIFY( marker.isEmpty() );
+                continue;
+            }
+            QVERIFY( !marker.isEmpty() );
+            // a is the share of the top corner, b the one of the bottom left corner
+            const qreal a = values[ row ][ 0 ] / total;
+            const qreal b = values[ row ][ 1 ] / total;
+            const QPointF expected = plane->translate( QPointF( 1.0 - b - 0.5 * a, 0.5 * sqrt( 3.0 ) * a ) );
+            const QPointF offset = QRectF( marker ).center() - expected;
+            QVERIFY2( qAbs( offset.x() ) <= 1.0 && qAbs( offset.y() ) <= 1.0,
+                      qPrintable( QString::fromLatin1( "row %1 is off by (%2, %3)" )
+                                  .arg( row ).arg( offset.x() ).arg( offset.y() ) ) );
+        }
+        QVERIFY( diagram->visualRect( model.index( 6, 0 ) ).isEmpty() );
+    }
+
+    void testMarkerSprites()
+    {
+        // enough points to use the marker sprites, compared to the same points painted
+        // by two diagrams that each have too few points for them
+        const int rows = 1000;
+        QStandardItemModel all( rows, 3 );
+        QStandardItemModel firstHalf( rows / 2, 3 );
+        QStandardItemModel secondHalf( rows / 2, 3 );
+        for ( int row = 0; row < rows; ++row ) {
+            QStandardItemModel* half = row < rows / 2 ? &firstHalf : &secondHalf;
+            for ( int column = 0; column < 3; ++column ) {
+                const qreal value = 1 + ( row * ( 7 + 4 * column ) ) % ( 23 + column );
+                all.setData( all.index( row, column ), value );
+                half->setData( half->index( row % ( rows / 2 ), column ), value );
+            }
+        }
+
+        Chart sprites;
+        sprites.resize( 400, 400 );
+        TernaryCoordinatePlane* plane = new TernaryCoordinatePlane;
+        sprites.replaceCoordinatePlane( plane );
+        TernaryPointDiagram* diagram = new TernaryPointDiagram;
+        diagram->setModel( &all );
+        showMarkers( diagram );
+        plane->replaceDiagram( diagram );
+
+        Chart direct;
+        direct.resize( 400, 400 );
+        plane = new TernaryCoordinatePlane;
+        direct.replaceCoordinatePlane( plane );
+        diagram = new TernaryPointDiagram;
+        diagram->setModel( &firstHalf );
+        showMarkers( diagram );
+        plane->replaceDiagram( diagram );
+        diagram = new TernaryPointDiagram;
+        diagram->setModel( &secondHalf );
+        showMarkers( diagram );
+        plane->addDiagram( diagram );
+
+        // sprites are placed on whole pixels, so the markers may move by half a pixel
+        const QImage spriteImage = paint( &sprites );
+        const QImage directImage = paint( &direct );
+        QVERIFY( coveredBy( spriteImage, directImage ) );
+        QVERIFY( coveredBy( directImage, spriteImage ) );
+        const int spritePixels = markerPixels( spriteImage );
+        const int directPixels = markerPixels( directImage );
+        QVERIFY( spritePixels > 0 );
+        QVERIFY( qAbs( spritePixels - directPixels ) < directPixels / 10 );
+
+        // the sprites are kept, painting again gives the same result
+        QCOMPARE( paint( &sprites ), spriteImage );
+    }
+
+    void testLineConnectivity()
+    {
+        // two datasets that do not cross; the second row of the first one has no data
+        const qreal values[ 4 ][ 6 ] = {
+            { 8, 1, 1, 5, 2, 3 }, { 0, 0, 0, 6, 1, 3 }, { 1, 8, 1, 4, 2, 4 }, { 1, 1, 8, 5, 1, 4 }
+        };
+        QStandardItemModel model( 4, 6 );
+        for ( int row = 0; row < 4; ++row ) {
+            for ( int column = 0; column < 6; ++column ) {
+                if ( row != 1 || column >= 3 ) {
+                    model.setData( model.index( row, column ), values[ row ][ column ] );
+                }
+            }
+        }
+
+        Chart chart;
+        chart.resize( 400, 400 );
+        TernaryCoordinatePlane* plane = new TernaryCoordinatePlane;
+        chart.replaceCoordinatePlane( plane );
+        TernaryLineDiagram* diagram = new TernaryLineDiagram;
+        diagram->setModel( &model );
+        plane->replaceDiagram( diagram );
+        // the segment leading to a point is drawn with the pen of that point
+        diagram->setPen( QPen( Qt::blue, 3 ) );
+        diagram->setPen( model.index( 2, 0 ), QPen( Qt::red, 3 ) );
+        diagram->setPen( 1, QPen( Qt::green, 3 ) );
+        const QImage image = paint( &chart );
+
+        QVector< QPointF > first;
+        QVector< QPointF > second;
+        for ( int row = 0; row < 4; ++row ) {
+            if ( row != 1 ) {
+                first << QRectF( diagram->visualRect( model.index( row, 0 ) ) ).center();
+            }
+            second << QRectF( diagram->visualRect( model.index( row, 3 ) ) ).center();
+        }
+
+        // the first dataset goes across the row without data, and changes the pen twice
+        QCOMPARE( colorBetween( image, first[ 0 ], first[ 1 ] ), QColor( Qt::red ) );
+        QCOMPARE( colorBetween( image, first[ 1 ], first[ 2 ] ), QColor( Qt::blue ) );
+        for ( int i = 0; i + 1 < second.size(); ++i ) {
+            QCOMPARE( colorBetween( image, second[ i ], second[ i + 1 ] ), QColor( Qt::green ) );
+        }
+        // and the datasets are not connected to each other
+        const QColor gap = colorBetween( image, first.last(), second.first() );
+        QVERIFY( gap != QColor( Qt::green ) && gap != QColor( Qt::blue ) && gap != QColor( Qt::red ) );
+    }
+
+private:
+    static void showMarkers( AbstractDiagram* diagram )
+    {
+        DataValueAttributes dva( diagram->dataValueAttributes() );
+        dva.setVisible( true );
+        TextAttributes ta( dva.textAttributes() );
+        ta.setVisible( false );
+        dva.setTextAttributes( ta );
+        MarkerAttributes ma( dva.markerAttributes() );
+        ma.setVisible( true );
+        ma.setMarkerStyle( MarkerAttributes::MarkerCircle );
+        ma.setMarkerSize( QSizeF( 6, 6 ) );
+        dva.setMarkerAttributes( ma );
+        diagram->setDataValueAttributes( dva );
+    }
+
+    static QImage paint( Chart* chart )
+    {
+        QImage image( chart->size(), QImage::Format_ARGB32_Premultiplied );
+        image.fill( Qt::white );
+        QPainter painter( &image );
+        chart->paint( &painter, image.rect() );
+        return image;
+    }
+
+    // the color of the first dataset, which the markers are painted with
+    static bool isMarker( QRgb pixel )
+    {
+        const QColor color = QColor( pixel );
+        return color.red() > 128 && color.green() < 128 && color.blue() < 128;
+    }
+
+    static int markerPixels( const QImage& image )
+    {
+        int count = 0;
+        for ( int y = 0; y < image.height(); ++y ) {
+            for ( int x = 0; x < image.width(); ++x ) {
+                count += isMarker( image.pixel( x, y ) ) ? 1 : 0;
+            }
+        }
+        return count;
+    }
+
+    // whether every marker pixel of \a image has a marker pixel next to it in \a other
+    static bool coveredBy( const QImage& image, const QImage& other )
+    {
+        for ( int y = 1; y < image.height() - 1; ++y ) {
+            for ( int x = 1; x < image.width() - 1; ++x ) {
+                if ( !isMarker( image.pixel( x, y ) ) ) {
+                    continue;
+                }
+                bool covered = false;
+                for ( int dy = -1; dy <= 1 && !covered; ++dy ) {
+                    for ( int dx = -1; dx <= 1 && !covered; ++dx ) {
+                        covered = isMarker( other.pixel( x + dx, y + dy ) );
+                    }
+                }
+                if ( !covered ) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // the color in the middle between two markers, which is not covered by them
+    static QColor colorBetween( const QImage& image, const QPointF& from, const QPointF& to )
+    {
+        return QColor( image.pixel( ( ( from + to ) / 2.0 ).toPoint() ) );
+    }
+};
+
+QTEST_MAIN(TestTernaryDiagrams)
+
+#include "main.moc"
@@ -20,6 +20,7 @@
 #include "KChartNormalPlotter_p.h"
 #include "KChartPlotter.h"
 #include "PaintingHelpers_p.h"
+#include "KChartInstrumentation.h"
 
 #include <limits>
 
@@ -64,6 +65,7 @@ void NormalPlotter::paint( PaintContext* ctx )
             for ( PlotterDiagramCompressor::Iterator it = plotterCompressor().begin( dataset ); it != plotterCompressor().end( dataset ); ++ it )
             {
                 const PlotterDiagramCompressor::DataPoint point = *it;
+                Instrumentation::count( Instrumentation::PointsCompressed );
 
                 const QModelIndex sourceIndex = attributesModel()->mapToSource( point.index );
                 LineAttributes laCell = diagram()->lineAttributes( sourceIndex );
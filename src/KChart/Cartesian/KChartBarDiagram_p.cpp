@@ -22,6 +22,7 @@
 
 #include "KChartDataValueAttributes.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartInstrumentation.h"
 
 using namespace KChart;
 
@@ -66,6 +67,7 @@ void BarDiagram::BarDiagramType::paintBars( PaintContext* ctx, const QModelIndex
         } else {
             reverseMapper().addRect( index.row(), index.column(), isoRect );
             ctx->painter()->drawRect( isoRect );
+            Instrumentation::count( Instrumentation::PrimitivesDrawn );
             if ( !( type() == BarDiagram::Percent && isoRect.height() == 0 ) ) {
                 topPoints << bar.topLeft() << bar.topRight() << isoRect.topRight() << isoRect.topLeft();
             }
@@ -93,6 +95,7 @@ void BarDiagram::BarDiagramType::paintBars( PaintContext* ctx, const QModelIndex
                 }
                 reverseMapper().addPolygon( index.row(), index.column(), topPoints );
                 ctx->painter()->drawPolygon( topPoints );
+                Instrumentation::count( Instrumentation::PrimitivesDrawn );
             }
         }
 
@@ -106,12 +109,14 @@ void BarDiagram::BarDiagramType::paintBars( PaintContext* ctx, const QModelIndex
                        << isoRect.bottomRight() << bar.bottomRight();
             reverseMapper().addPolygon( index.row(), index.column(), sidePoints );
             ctx->painter()->drawPolygon( sidePoints );
+            Instrumentation::count( Instrumentation::PrimitivesDrawn );
         }
     }
 
     if ( bar.height() != 0 ) {
         reverseMapper().addRect( index.row(), index.column(), bar );
         ctx->painter()->drawRect( bar );
+        Instrumentation::count( Instrumentation::PrimitivesDrawn );
     }
 }
 
@@ -424,6 +424,7 @@ bool CartesianAxis::compare( const CartesianAxis* other ) const
 
 void CartesianAxis::coordinateSystemChanged()
 {
+    d->clearTickCache();
     layoutPlanes();
 }
 
@@ -655,6 +656,116 @@ bool CartesianAxis::Private::isVertical() const
     return axis()->isAbscissa() == AbstractDiagram::Private::get( diagram() )->isTransposed();
 }
 
+CartesianAxis::Private::TickCacheKey::TickCacheKey()
+    : centerTicks( false )
+    , autoAdjust( 0 )
+    , paintDevice( nullptr )
+{
+}
+
+bool CartesianAxis::Private::TickCacheKey::operator==( const TickCacheKey& other ) const
+{
+    return dimension == other.dimension &&
+           centerTicks == other.centerTicks &&
+           gridAttributes == other.gridAttributes &&
+           autoAdjust == other.autoAdjust &&
+           textAttributes == other.textAttributes &&
+           rulerAttributes == other.rulerAttributes &&
+           labels == other.labels &&
+           shortLabels == other.shortLabels &&
+           labelFont == other.labelFont &&
+           paintDevice == other.paintDevice;
+}
+
+void CartesianAxis::Private::validateTickCache( CartesianCoordinatePlane* plane, bool centerTicks ) const
+{
+    const bool vertical = isVertical();
+    XySwitch geoXy( vertical );
+
+    TickCacheKey key;
+    key.dimension = geoXy( plane->gridDimensionsList().first(), plane->gridDimensionsList().last() );
+    key.centerTicks = centerTicks;
+    key.gridAttributes = plane->gridAttributes( geoXy( Qt::Horizontal, Qt::Vertical ) );
+    key.autoAdjust = geoXy( plane->autoAdjustHorizontalRangeToData(), plane->autoAdjustVerticalRangeToData() );
+    key.textAttributes = mAxis->textAttributes();
+    key.rulerAttributes = mAxis->rulerAttributes();
+    key.labels = mAxis->labels();
+    key.shortLabels = mAxis->shortLabels();
+    key.labelFont = key.textAttributes.calculatedFont( plane->parent(), KChartEnums::MeasureOrientationMinimum );
+    key.paintDevice = GlobalMeasureScaling::paintDevice();
+
+    if ( key != tickCacheKey ) {
+        clearTickCache();
+        tickCacheKey = key;
+    }
+}
+
+const CartesianAxis::Private::CachedTickList& CartesianAxis::Private::ticks( CartesianCoordinatePlane* plane,
+                                                                             uint labelThinningFactor,
+                                                                             const TextAttributes& labelTA,
+                                                                             bool centerTicks ) const
+{
+    const QPair< uint, int > cacheKey( labelThinningFactor, labelTA.rotation() );
+    QHash< QPair< uint, int >, CachedTickList >::iterator cached = tickCache.find( cacheKey );
+    if ( cached != tickCache.end() ) {
+        return cached.value();
+    }
+
+    XySwitch geoXy( isVertical() );
+    const RulerAttributes rulerAttr = mAxis->rulerAttributes();
+    TextLayoutItem tickLabel( QString(), labelTA, plane->parent(),
+                              KChartEnums::MeasureOrientationMinimum, Qt::AlignLeft );
+
+    CachedTickList list;
+    for ( TickIterator it( axis(), plane, labelThinningFactor, centerTicks ); !it.isAtEnd(); ++it ) {
+        CachedTick tick;
+        tick.position = it.position();
+        tick.type = it.type();
+        tick.hasLabel = !it.text().isEmpty();
+        tick.labelMargin = 0.0;
+
+        if ( tick.hasLabel ) {
+            tick.text = it.text();
+            if ( it.type() == TickIterator::MajorTick ) {
+                // add unit prefixes and suffixes, then customize
+                tick.text = customizedLabelText( tick.text, geoXy( Qt::Horizontal, Qt::Vertical ), it.position() );
+            } else if ( it.type() == TickIterator::MajorTickHeaderDataLabel ) {
+                // unit prefixes and suffixes have already been added in this case - only customize
+                tick.text = axis()->customizedLabel( tick.text );
+            }
+
+            if ( labelTA.isVisible() ) {
+                tickLabel.setText( tick.text );
+                tick.labelSize = tickLabel.sizeHint();
+                tick.labelPolygon = tickLabel.boundingPolygon();
+
+                tick.labelMargin = rulerAttr.labelMargin();
+                if ( tick.labelMargin < 0 ) {
+                    tick.labelMargin = QFontMetricsF( tickLabel.realFont() ).height() * 0.5;
+                }
+                tick.labelMargin -= tickLabel.marginWidth(); // make up for the margin that's already there
+            }
+        }
+        list.append( tick );
+    }
+    return tickCache.insert( cacheKey, list ).value();
+}
+
+void CartesianAxis::Private::clearTickCache() const
+{
+    tickCache.clear();
+    clearPaintCache();
+}
+
+void CartesianAxis::Private::clearPaintCache() const
+{
+    Q_FOREACH( const PaintedTick& tick, paintedTicks ) {
+        delete tick.label;
+    }
+    paintedTicks.clear();
+    paintCacheValid = false;
+}
+
 void CartesianAxis::paintCtx( PaintContext* context )
 {
     Q_ASSERT_X ( d->diagram(), "CartesianAxis::paint",
@@ -682,6 +793,7 @@ void CartesianAxis::paintCtx( PaintContext* context )
     // the next one describes an additional shift in screen space; it is unfortunately required to
     // make axis sharing work, which uses the areaGeometry() to override the position of the axis.
     qreal transverseScreenSpaceShift = signalingNaN;
+    QLineF axisLine;
     {
         // determine the unadulterated position in screen space
 
@@ -732,6 +844,7 @@ void CartesianAxis::paintCtx( PaintContext* context )
 
         geoXy.lvalue( transStart.ry(), transStart.rx() ) += transverseScreenSpaceShift;
         geoXy.lvalue( transEnd.ry(), transEnd.rx() ) += transverseScreenSpaceShift;
+        axisLine = QLineF( transStart, transEnd );
 
         if ( rulerAttributes().showRulerLine() ) {
             bool clipSaved = context->painter()->hasClipping();
@@ -741,172 +854,160 @@ void CartesianAxis::paintCtx( PaintContext* context )
         }
     }
 
-    // paint ticks and labels
+    // lay out ticks and labels, unless nothing has changed since the last time
 
-    TextAttributes labelTA = textAttributes();
-    RulerAttributes rulerAttr = rulerAttributes();
+    d->validateTickCache( plane, centerTicks );
+    if ( !d->paintCacheValid || d->paintCacheAxisLine != axisLine || d->paintCacheGeometry != areaGeometry() ) {
+        d->clearPaintCache();
 
-    int labelThinningFactor = 1;
-    // TODO: label thinning also when grid line distance < 4 pixels, not only when labels collide
-    TextLayoutItem *tickLabel = new TextLayoutItem( QString(), labelTA, plane->parent(),
-                                                    KChartEnums::MeasureOrientationMinimum, Qt::AlignLeft );
-    TextLayoutItem *prevTickLabel = new TextLayoutItem( QString(), labelTA, plane->parent(),
-                                                        KChartEnums::MeasureOrientationMinimum, Qt::AlignLeft );
-    QPointF prevTickLabelPos;
-    enum {
-        Layout = 0,
-        Painting,
-        Done
-    };
-    for ( int step = labelTA.isVisible() ? Layout : Painting; step < Done; step++ ) {
-        bool skipFirstTick = !rulerAttr.showFirstTick();
-        bool isFirstLabel = true;
-        for ( TickIterator it( this, plane, labelThinningFactor, centerTicks ); !it.isAtEnd(); ++it ) {
-            if ( skipFirstTick ) {
-                skipFirstTick = false;
-                continue;
-            }
+        TextAttributes labelTA = textAttributes();
+        const RulerAttributes rulerAttr = rulerAttributes();
+        const bool isOutwardsPositive = position() == Bottom || position() == Right;
+        const bool hasShorterLabels = !labels().isEmpty() && shortLabels().count() == labels().count();
 
-            const qreal drawPos = it.position() + ( centerTicks ? 0.5 : 0. );
-            QPointF onAxis = plane->translate( geoXy( QPointF( drawPos, transversePosition ) ,
-                                                      QPointF( transversePosition, drawPos ) ) );
-            geoXy.lvalue( onAxis.ry(), onAxis.rx() ) += transverseScreenSpaceShift;
-            const bool isOutwardsPositive = position() == Bottom || position() == Right;
-
-            // paint the tick mark
-
-            QPointF tickEnd = onAxis;
-            qreal tickLen = it.type() == TickIterator::CustomTick ?
-                            d->customTickLength : tickLength( it.type() == TickIterator::MinorTick );
-            geoXy.lvalue( tickEnd.ry(), tickEnd.rx() ) += isOutwardsPositive ? tickLen : -tickLen;
-
-            // those adjustments are required to paint the ticks exactly on the axis and of the right length
-            if ( position() == Top ) {
-                onAxis.ry() += 1;
-                tickEnd.ry() += 1;
-            } else if ( position() == Left ) {
-                tickEnd.rx() += 1;
-            }
+        int axisAngle = 0;
+        switch ( position() ) {
+        case Bottom:
+            axisAngle = 0; break;
+        case Top:
+            axisAngle = 180; break;
+        case Right:
+            axisAngle = 270; break;
+        case Left:
+            axisAngle = 90; break;
+        default:
+            Q_ASSERT( false );
+        }
 
-            if ( step == Painting ) {
-                painter->save();
-                if ( rulerAttr.hasTickMarkPenAt( it.position() ) ) {
-                    painter->setPen( rulerAttr.tickMarkPen( it.position() ) );
-                } else {
-                    painter->setPen( it.type() == TickIterator::MinorTick ? rulerAttr.minorTickMarkPen()
-                                                                          : rulerAttr.majorTickMarkPen() );
+        uint labelThinningFactor = 1;
+        // TODO: label thinning also when grid line distance < 4 pixels, not only when labels collide
+        QPolygon prevLabelPoly;
+        QPointF prevLabelPos;
+        enum {
+            Layout = 0,
+            Recording,
+            Done
+        };
+        for ( int step = labelTA.isVisible() ? Layout : Recording; step < Done; step++ ) {
+            const Private::CachedTickList& tickList = d->ticks( plane, labelThinningFactor, labelTA, centerTicks );
+            bool isFirstLabel = true;
+            for ( int i = rulerAttr.showFirstTick() ? 0 : 1; i < tickList.count(); i++ ) {
+                const Private::CachedTick& tick = tickList.at( i );
+
+                const qreal drawPos = tick.position + ( centerTicks ? 0.5 : 0. );
+                QPointF onAxis = plane->translate( geoXy( QPointF( drawPos, transversePosition ) ,
+                                                          QPointF( transversePosition, drawPos ) ) );
+                geoXy.lvalue( onAxis.ry(), onAxis.rx() ) += transverseScreenSpaceShift;
+
+                // the tick mark
+
+                QPointF tickEnd = onAxis;
+                qreal tickLen = tick.type == TickIterator::CustomTick ?
+                                d->customTickLength : tickLength( tick.type == TickIterator::MinorTick );
+                geoXy.lvalue( tickEnd.ry(), tickEnd.rx() ) += isOutwardsPositive ? tickLen : -tickLen;
+
+                // those adjustments are required to paint the ticks exactly on the axis and of the right length
+                if ( position() == Top ) {
+                    onAxis.ry() += 1;
+                    tickEnd.ry() += 1;
+                } else if ( position() == Left ) {
+                    tickEnd.rx() += 1;
                 }
-                painter->drawLine( onAxis, tickEnd );
-                painter->restore();
-            }
 
-            if ( it.text().isEmpty() || !labelTA.isVisible() ) {
-                // the following code in the loop is only label painting, so skip it
-                continue;
-            }
-
-            // paint the label
+                Private::PaintedTick painted;
+                if ( step == Recording ) {
+                    painted.line = QLineF( onAxis, tickEnd );
+                    if ( rulerAttr.hasTickMarkPenAt( tick.position ) ) {
+                        painted.pen = rulerAttr.tickMarkPen( tick.position );
+                    } else {
+                        painted.pen = tick.type == TickIterator::MinorTick ? rulerAttr.minorTickMarkPen()
+                                                                           : rulerAttr.majorTickMarkPen();
+                    }
+                    painted.label = nullptr;
+                }
 
-            QString text = it.text();
-            if ( it.type() == TickIterator::MajorTick ) {
-                // add unit prefixes and suffixes, then customize
-                text = d->customizedLabelText( text, geoXy( Qt::Horizontal, Qt::Vertical ), it.position() );
-            } else if ( it.type() == TickIterator::MajorTickHeaderDataLabel ) {
-                // unit prefixes and suffixes have already been added in this case - only customize
-                text = customizedLabel( text );
-            }
+                if ( !tick.hasLabel || !labelTA.isVisible() ) {
+                    // the following code in the loop is only about the label, so skip it
+                    if ( step == Recording ) {
+                        d->paintedTicks.append( painted );
+                    }
+                    continue;
+                }
 
-            tickLabel->setText( text );
-            QSizeF size = QSizeF( tickLabel->sizeHint() );
-            QPolygon labelPoly = tickLabel->boundingPolygon();
-            Q_ASSERT( labelPoly.count() == 4 );
-
-            // for alignment, find the label polygon edge "most parallel" and closest to the axis
-
-            int axisAngle = 0;
-            switch ( position() ) {
-            case Bottom:
-                axisAngle = 0; break;
-            case Top:
-                axisAngle = 180; break;
-            case Right:
-                axisAngle = 270; break;
-            case Left:
-                axisAngle = 90; break;
-            default:
-                Q_ASSERT( false );
-            }
-            // the left axis is not actually pointing down and the top axis not actually pointing
-            // left, but their corresponding closest edges of a rectangular unrotated label polygon are.
+                // the label
 
-            int relAngle = axisAngle - labelTA.rotation() + 45;
-            if ( relAngle < 0 ) {
-                relAngle += 360;
-            }
-            int polyCorner1 = relAngle / 90;
-            QPoint p1 = labelPoly.at( polyCorner1 );
-            QPoint p2 = labelPoly.at( polyCorner1 == 3 ? 0 : ( polyCorner1 + 1 ) );
+                const QSize size = tick.labelSize;
+                const QPolygon& labelPoly = tick.labelPolygon;
+                Q_ASSERT( labelPoly.count() == 4 );
 
-            QPointF labelPos = tickEnd;
+                // for alignment, find the label polygon edge "most parallel" and closest to the axis.
+                // the left axis is not actually pointing down and the top axis not actually pointing
+                // left, but their corresponding closest edges of a rectangular unrotated label polygon are.
 
-            qreal labelMargin = rulerAttr.labelMargin();
-            if ( labelMargin < 0 ) {
-                labelMargin = QFontMetricsF( tickLabel->realFont() ).height() * 0.5;
-            }
-            labelMargin -= tickLabel->marginWidth(); // make up for the margin that's already there
+                int relAngle = axisAngle - labelTA.rotation() + 45;
+                if ( relAngle < 0 ) {
+                    relAngle += 360;
+                }
+                int polyCorner1 = relAngle / 90;
+                QPoint p1 = labelPoly.at( polyCorner1 );
+                QPoint p2 = labelPoly.at( polyCorner1 == 3 ? 0 : ( polyCorner1 + 1 ) );
 
-            switch ( position() ) {
-            case Left:
-                labelPos += QPointF( -size.width() - labelMargin,
-                                     -0.45 * size.height() - 0.5 * ( p1.y() + p2.y() ) );
-                break;
-            case Right:
-                labelPos += QPointF( labelMargin,
-                                     -0.45 * size.height() - 0.5 * ( p1.y() + p2.y() ) );
-                break;
-            case Top:
-                labelPos += QPointF( -0.45 * size.width() - 0.5 * ( p1.x() + p2.x() ),
-                                     -size.height() - labelMargin );
-                break;
-            case Bottom:
-                labelPos += QPointF( -0.45 * size.width() - 0.5 * ( p1.x() + p2.x() ),
-                                     labelMargin );
-                break;
-            }
+                QPointF labelPos = tickEnd;
+                const qreal labelMargin = tick.labelMargin;
 
-            tickLabel->setGeometry( QRect( labelPos.toPoint(), size.toSize() ) );
+                switch ( position() ) {
+                case Left:
+                    labelPos += QPointF( -size.width() - labelMargin,
+                                         -0.45 * size.height() - 0.5 * ( p1.y() + p2.y() ) );
+                    break;
+                case Right:
+                    labelPos += QPointF( labelMargin,
+                                         -0.45 * size.height() - 0.5 * ( p1.y() + p2.y() ) );
+                    break;
+                case Top:
+                    labelPos += QPointF( -0.45 * size.width() - 0.5 * ( p1.x() + p2.x() ),
+                                         -size.height() - labelMargin );
+                    break;
+                case Bottom:
+                    labelPos += QPointF( -0.45 * size.width() - 0.5 * ( p1.x() + p2.x() ),
+                                         labelMargin );
+                    break;
+                }
 
-            if ( step == Painting ) {
-                tickLabel->paint( painter );
-            }
+                if ( step == Recording ) {
+                    painted.label = new TextLayoutItem( tick.text, labelTA, plane->parent(),
+                                                        KChartEnums::MeasureOrientationMinimum, Qt::AlignLeft );
+                    painted.label->setGeometry( QRect( labelPos.toPoint(), size ) );
+                    d->paintedTicks.append( painted );
+                    continue;
+                }
 
-            // collision check the current label against the previous one
+                // collision check the current label against the previous one
 
-            // like in the old code, we don't shorten or decimate labels if they are already the
-            // manual short type, or if they are the manual long type and on the vertical axis
-            // ### they can still collide though, especially when they're rotated!
-            if ( step == Layout ) {
+                // like in the old code, we don't shorten or decimate labels if they are already the
+                // manual short type, or if they are the manual long type and on the vertical axis
+                // ### they can still collide though, especially when they're rotated!
                 int spaceSavingRotation = geoXy( 270, 0 );
                 bool canRotate = labelTA.autoRotate() && labelTA.rotation() != spaceSavingRotation;
-                const bool canShortenLabels = !geoXy.isY && it.type() == TickIterator::MajorTickManualLong &&
-                                              it.hasShorterLabels();
+                const bool canShortenLabels = !geoXy.isY && tick.type == TickIterator::MajorTickManualLong &&
+                                              hasShorterLabels;
                 bool collides = false;
-                if ( it.type() == TickIterator::MajorTick || it.type() == TickIterator::MajorTickHeaderDataLabel
+                if ( tick.type == TickIterator::MajorTick || tick.type == TickIterator::MajorTickHeaderDataLabel
                      || canShortenLabels || canRotate ) {
                     if ( isFirstLabel ) {
                         isFirstLabel = false;
                     } else {
-                        collides = tickLabel->intersects( *prevTickLabel, labelPos, prevTickLabelPos );
-                        qSwap( prevTickLabel, tickLabel );
+                        // same as TextLayoutItem::intersects(), on the cached polygons
+                        const QRegion labelRegion( labelPoly.translated( labelPos.toPoint() - prevLabelPos.toPoint() ) );
+                        collides = labelRegion.intersects( QRegion( prevLabelPoly ) );
                     }
-                    prevTickLabelPos = labelPos;
+                    prevLabelPoly = labelPoly;
+                    prevLabelPos = labelPos;
                 }
                 if ( collides ) {
                     // to make room, we try in order: shorten, rotate, decimate
                     if ( canRotate && !canShortenLabels ) {
                         labelTA.setRotation( spaceSavingRotation );
-                        // tickLabel will be reused in the next round
-                        tickLabel->setTextAttributes( labelTA );
                     } else {
                         labelThinningFactor++;
                     }
@@ -915,11 +1016,23 @@ void CartesianAxis::paintCtx( PaintContext* context )
                 }
             }
         }
+
+        d->paintCacheValid = true;
+        d->paintCacheAxisLine = axisLine;
+        d->paintCacheGeometry = areaGeometry();
+    }
+
+    // paint ticks and labels
+
+    Q_FOREACH( const Private::PaintedTick& tick, d->paintedTicks ) {
+        painter->save();
+        painter->setPen( tick.pen );
+        painter->drawLine( tick.line );
+        painter->restore();
+        if ( tick.label ) {
+            tick.label->paint( painter );
+        }
     }
-    delete tickLabel;
-    tickLabel = nullptr;
-    delete prevTickLabel;
-    prevTickLabel = nullptr;
 
     if ( ! titleText().isEmpty() ) {
         d->drawTitleText( painter, plane, geometry() );
@@ -955,6 +1068,7 @@ Qt::Orientations CartesianAxis::expandingDirections() const
 void CartesianAxis::setCachedSizeDirty() const
 {
     d->cachedMaximumSize = QSize();
+    d->clearTickCache();
 }
 
 /* pure virtual in QLayoutItem */
@@ -998,36 +1112,22 @@ QSize CartesianAxis::Private::calculateMaximumSize() const
         qreal lowestLabelLongitudinalSize = signalingNaN;
         qreal highestLabelLongitudinalSize = signalingNaN;
 
-        TextLayoutItem tickLabel( QString(), mAxis->textAttributes(), refArea,
-                                  KChartEnums::MeasureOrientationMinimum, Qt::AlignLeft );
         const RulerAttributes rulerAttr = mAxis->rulerAttributes();
 
-        bool showFirstTick = rulerAttr.showFirstTick();
-        for ( TickIterator it( axis(), plane, 1, centerTicks ); !it.isAtEnd(); ++it ) {
-            const qreal drawPos = it.position() + ( centerTicks ? 0.5 : 0. );
-            if ( !showFirstTick ) {
-                showFirstTick = true;
-                continue;
-            }
+        validateTickCache( plane, centerTicks );
+        const CachedTickList& tickList = ticks( plane, 1, mAxis->textAttributes(), centerTicks );
+        for ( int i = rulerAttr.showFirstTick() ? 0 : 1; i < tickList.count(); i++ ) {
+            const CachedTick& tick = tickList.at( i );
+            const qreal drawPos = tick.position + ( centerTicks ? 0.5 : 0. );
 
             qreal labelSizeTransverse = 0.0;
             qreal labelMargin = 0.0;
-            QString text = it.text();
-            if ( !text.isEmpty() ) {
+            if ( tick.hasLabel ) {
                 QPointF labelPosition = plane->translate( QPointF( geoXy( drawPos, 1.0 ),
                                                                    geoXy( 1.0, drawPos ) ) );
                 highestLabelPosition = geoXy( labelPosition.x(), labelPosition.y() );
 
-                if ( it.type() == TickIterator::MajorTick ) {
-                    // add unit prefixes and suffixes, then customize
-                    text = customizedLabelText( text, geoXy( Qt::Horizontal, Qt::Vertical ), it.position() );
-                } else if ( it.type() == TickIterator::MajorTickHeaderDataLabel ) {
-                    // unit prefixes and suffixes have already been added in this case - only customize
-                    text = axis()->customizedLabel( text );
-                }
-                tickLabel.setText( text );
-
-                QSize sz = tickLabel.sizeHint();
+                const QSize sz = tick.labelSize;
                 highestLabelLongitudinalSize = geoXy( sz.width(), sz.height() );
                 if ( ISNAN( lowestLabelLongitudinalSize ) ) {
                     lowestLabelLongitudinalSize = highestLabelLongitudinalSize;
@@ -1035,14 +1135,10 @@ QSize CartesianAxis::Private::calculateMaximumSize() const
                 }
 
                 labelSizeTransverse = geoXy( sz.height(), sz.width() );
-                labelMargin = rulerAttr.labelMargin();
-                if ( labelMargin < 0 ) {
-                    labelMargin = QFontMetricsF( tickLabel.realFont() ).height() * 0.5;
-                }
-                labelMargin -= tickLabel.marginWidth(); // make up for the margin that's already there
+                labelMargin = tick.labelMargin;
             }
-            qreal tickLength = it.type() == TickIterator::CustomTick ?
-                               customTickLength : axis()->tickLength( it.type() == TickIterator::MinorTick );
+            qreal tickLength = tick.type == TickIterator::CustomTick ?
+                               customTickLength : axis()->tickLength( tick.type == TickIterator::MinorTick );
             size = qMax( size, tickLength + labelMargin + labelSizeTransverse );
         }
 
@@ -35,68 +35,18 @@
 #include "KChartAbstractCartesianDiagram.h"
 #include "KChartAbstractAxis_p.h"
 #include "KChartMath_p.h"
+#include "KChartGridAttributes.h"
+#include "KChartRulerAttributes.h"
 
+#include <QHash>
+#include <QPen>
+#include <QPolygon>
+#include <QVector>
 
-namespace KChart {
-
-/**
-  * \internal
-  */
-class Q_DECL_HIDDEN CartesianAxis::Private : public AbstractAxis::Private
-{
-    friend class CartesianAxis;
 
-public:
-    Private( AbstractCartesianDiagram* diagram, CartesianAxis* axis )
-        : AbstractAxis::Private( diagram, axis )
-        , useDefaultTextAttributes( true )
-        , cachedHeaderLabels( QStringList() )
-        , cachedLabelHeight( 0.0 )
-        , cachedFontHeight( 0 )
-        , axisTitleSpace( 1.0 )
-    {}
-    ~Private() {}
-
-    static const Private *get( const CartesianAxis *axis ) { return axis->d_func(); };
-
-    CartesianAxis* axis() const { return static_cast<CartesianAxis *>( mAxis ); }
-    void drawTitleText( QPainter*, CartesianCoordinatePlane* plane, const QRect& areaGeoRect ) const;
-    const TextAttributes titleTextAttributesWithAdjustedRotation() const;
-    QSize calculateMaximumSize() const;
-    QString customizedLabelText( const QString& text, Qt::Orientation orientation, qreal value ) const;
-    bool isVertical() const;
-
-    QMap< qreal, QString > annotations;
-
-private:
-    friend class TickIterator;
-    QString titleText;
-    TextAttributes titleTextAttributes;
-    bool useDefaultTextAttributes;
-    Position position;
-    QRect geometry;
-    int customTickLength;
-    QList< qreal > customTicksPositions;
-    mutable QStringList cachedHeaderLabels;
-    mutable qreal cachedLabelHeight;
-    mutable qreal cachedLabelWidth;
-    mutable int cachedFontHeight;
-    mutable int cachedFontWidth;
-    mutable QSize cachedMaximumSize;
-    qreal axisTitleSpace;
-};
-
-inline CartesianAxis::CartesianAxis( Private * p, AbstractDiagram* diagram )
-    : AbstractAxis( p, diagram )
-{
-    init();
-}
-
-inline CartesianAxis::Private * CartesianAxis::d_func()
-{ return static_cast<Private*>( AbstractAxis::d_func() ); }
-inline const CartesianAxis::Private * CartesianAxis::d_func() const
-{ return static_cast<const Private*>( AbstractAxis::d_func() ); }
+namespace KChart {
 
+class TextLayoutItem;
 
 class XySwitch
 {
@@ -173,6 +123,124 @@ private:
     QString m_text;
 };
 
+/**
+  * \internal
+  */
+class Q_DECL_HIDDEN CartesianAxis::Private : public AbstractAxis::Private
+{
+    friend class CartesianAxis;
+
+public:
+    Private( AbstractCartesianDiagram* diagram, CartesianAxis* axis )
+        : AbstractAxis::Private( diagram, axis )
+        , useDefaultTextAttributes( true )
+        , cachedHeaderLabels( QStringList() )
+        , cachedLabelHeight( 0.0 )
+        , cachedFontHeight( 0 )
+        , axisTitleSpace( 1.0 )
+        , paintCacheValid( false )
+    {}
+    ~Private() { clearTickCache(); }
+
+    static const Private *get( const CartesianAxis *axis ) { return axis->d_func(); };
+
+    CartesianAxis* axis() const { return static_cast<CartesianAxis *>( mAxis ); }
+    void drawTitleText( QPainter*, CartesianCoordinatePlane* plane, const QRect& areaGeoRect ) const;
+    const TextAttributes titleTextAttributesWithAdjustedRotation() const;
+    QSize calculateMaximumSize() const;
+    QString customizedLabelText( const QString& text, Qt::Orientation orientation, qreal value ) const;
+    bool isVertical() const;
+
+    /*
+     * A tick as computed by TickIterator, with its label already customized
+     * and measured with the given label text attributes.
+     */
+    struct CachedTick {
+        qreal position;
+        TickIterator::TickType type;
+        bool hasLabel;
+        QString text;
+        QSize labelSize;
+        QPolygon labelPolygon;
+        qreal labelMargin;
+    };
+    typedef QVector< CachedTick > CachedTickList;
+
+    /*
+     * Everything the ticks and their labels are computed from, apart from
+     * settings whose change already calls setCachedSizeDirty().
+     */
+    struct TickCacheKey {
+        TickCacheKey();
+        bool operator==( const TickCacheKey& other ) const;
+        bool operator!=( const TickCacheKey& other ) const { return !operator==( other ); }
+
+        DataDimension dimension;
+        bool centerTicks;
+        GridAttributes gridAttributes;
+        unsigned int autoAdjust;
+        TextAttributes textAttributes;
+        RulerAttributes rulerAttributes;
+        QStringList labels;
+        QStringList shortLabels;
+        QFont labelFont;
+        const QPaintDevice* paintDevice;
+    };
+
+    // drops all cached ticks if anything they depend on has changed
+    void validateTickCache( CartesianCoordinatePlane* plane, bool centerTicks ) const;
+    // the ticks for a label thinning factor and label rotation, shared by layout and painting
+    const CachedTickList& ticks( CartesianCoordinatePlane* plane, uint labelThinningFactor,
+                                 const TextAttributes& labelTA, bool centerTicks ) const;
+    void clearTickCache() const;
+    void clearPaintCache() const;
+
+    // a tick mark and its label as laid out by paintCtx()
+    struct PaintedTick {
+        QLineF line;
+        QPen pen;
+        TextLayoutItem* label;
+    };
+
+    QMap< qreal, QString > annotations;
+
+private:
+    friend class TickIterator;
+    QString titleText;
+    TextAttributes titleTextAttributes;
+    bool useDefaultTextAttributes;
+    Position position;
+    QRect geometry;
+    int customTickLength;
+    QList< qreal > customTicksPositions;
+    mutable QStringList cachedHeaderLabels;
+    mutable qreal cachedLabelHeight;
+    mutable qreal cachedLabelWidth;
+    mutable int cachedFontHeight;
+    mutable int cachedFontWidth;
+    mutable QSize cachedMaximumSize;
+    qreal axisTitleSpace;
+
+    mutable TickCacheKey tickCacheKey;
+    mutable QHash< QPair< uint, int >, CachedTickList > tickCache;
+    // the result of the label layout in paintCtx(), replayed as long as nothing changes
+    mutable bool paintCacheValid;
+    mutable QLineF paintCacheAxisLine;
+    mutable QRect paintCacheGeometry;
+    mutable QVector< PaintedTick > paintedTicks;
+};
+
+inline CartesianAxis::CartesianAxis( Private * p, AbstractDiagram* diagram )
+    : AbstractAxis( p, diagram )
+{
+    init();
+}
+
+inline CartesianAxis::Private * CartesianAxis::d_func()
+{ return static_cast<Private*>( AbstractAxis::d_func() ); }
+inline const CartesianAxis::Private * CartesianAxis::d_func() const
+{ return static_cast<const Private*>( AbstractAxis::d_func() ); }
+
 }
 
 #endif
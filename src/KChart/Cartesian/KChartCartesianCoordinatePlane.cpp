@@ -29,13 +29,13 @@
 #include "KChartPainterSaver_p.h"
 #include "KChartBarDiagram.h"
 #include "KChartStockDiagram.h"
+#include "KChartInstrumentation.h"
 
 #include <QApplication>
 #include <QFont>
 #include <QList>
 #include <QtDebug>
 #include <QPainter>
-#include <QTime>
 
 
 using namespace KChart;
@@ -100,6 +100,7 @@ void CartesianCoordinatePlane::paint( QPainter* painter )
     }
     d->bPaintIsRunning = true;
 
+    Instrumentation::Scope scope( "paint", this );
     AbstractDiagramList diags = diagrams();
     if ( !diags.isEmpty() )
     {
@@ -116,7 +117,10 @@ void CartesianCoordinatePlane::paint( QPainter* painter )
         painter->setClipRegion( clipRegion );
 
         // paint the coordinate system rulers:
-        d->grid->drawGrid( &ctx );
+        {
+            Instrumentation::Scope gridScope( "grid", this );
+            d->grid->drawGrid( &ctx );
+        }
 
         // paint the diagrams:
         for ( int i = 0; i < diags.size(); i++ )
@@ -124,18 +128,9 @@ void CartesianCoordinatePlane::paint( QPainter* painter )
             if ( diags[i]->isHidden() ) {
                 continue;
             }
-            bool doDumpPaintTime = AbstractDiagram::Private::get( diags[ i ] )->doDumpPaintTime;
-            QTime stopWatch;
-            if ( doDumpPaintTime ) {
-                stopWatch.start();
-            }
-
+            Instrumentation::Scope diagramScope( "paint", diags[i] );
             PainterSaver diagramPainterSaver( painter );
             diags[i]->paint( &ctx );
-
-            if ( doDumpPaintTime ) {
-                qDebug() << "Painting diagram" << i << "took" << stopWatch.elapsed() << "milliseconds";
-            }
         }
 
     }
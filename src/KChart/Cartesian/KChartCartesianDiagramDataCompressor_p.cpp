@@ -24,6 +24,7 @@
 
 #include "KChartAbstractCartesianDiagram.h"
 #include "KChartMath_p.h"
+#include "KChartInstrumentation.h"
 
 
 using namespace KChart;
@@ -32,6 +33,7 @@ using namespace std;
 CartesianDiagramDataCompressor::CartesianDiagramDataCompressor( QObject* parent )
     : QObject( parent )
     , m_mode( Precise )
+    , m_aggregationMode( AverageAggregation )
     , m_xResolution( 0 )
     , m_yResolution( 0 )
     , m_sampleStep( 0 )
@@ -128,6 +130,9 @@ void CartesianDiagramDataCompressor::slotRowsAboutToBeInserted( const QModelInde
 
 void CartesianDiagramDataCompressor::slotRowsInserted( const QModelIndex& parent, int start, int end )
 {
+    if ( parent == m_rootIndex ) {
+        m_rangeIndexes.clear();
+    }
     if ( !prepareDataChange( parent, true, &start, &end ) ) {
         return;
     }
@@ -151,6 +156,9 @@ void CartesianDiagramDataCompressor::slotColumnsAboutToBeInserted( const QModelI
 
 void CartesianDiagramDataCompressor::slotColumnsInserted( const QModelIndex& parent, int start, int end )
 {
+    if ( parent == m_rootIndex ) {
+        m_rangeIndexes.clear();
+    }
     if ( !prepareDataChange( parent, false, &start, &end ) ) {
         return;
     }
@@ -176,6 +184,7 @@ void CartesianDiagramDataCompressor::slotRowsRemoved( const QModelIndex& parent,
 {
     if ( parent != m_rootIndex )
         return;
+    m_rangeIndexes.clear();
     Q_ASSERT( start <= end );
     Q_UNUSED( end )
 
@@ -206,6 +215,7 @@ void CartesianDiagramDataCompressor::slotColumnsRemoved( const QModelIndex& pare
 {
     if ( parent != m_rootIndex )
         return;
+    m_rangeIndexes.clear();
     Q_ASSERT( start <= end );
     Q_UNUSED( end );
 
@@ -252,14 +262,40 @@ void CartesianDiagramDataCompressor::slotModelDataChanged(
     for ( int row = topleft.row; row <= bottomright.row; ++row )
         for ( int column = topleft.column; column <= bottomright.column; ++column )
             invalidate( CachePosition( row, column ) );
+
+    // keep the range indexes of the changed columns up to date; updating a row costs
+    // logarithmic time, so if a big part of a column changed, rather build it again on next use
+    const int firstColumn = topLeftIndex.column();
+    const int lastColumn = qMin( bottomRightIndex.column(), m_rangeIndexes.size() - 1 );
+    const int changedRows = bottomRightIndex.row() - topLeftIndex.row() + 1;
+    for ( int column = firstColumn; column <= lastColumn; ++column ) {
+        RangeIndex& index = m_rangeIndexes[ column ];
+        if ( index.isEmpty() ) {
+            continue;
+        }
+        if ( changedRows > m_model->rowCount( m_rootIndex ) / 16 ) {
+            index.clear();
+            continue;
+        }
+        for ( int row = topLeftIndex.row(); row <= bottomRightIndex.row(); ++row ) {
+            index.update( row, m_modelCache.data( row, column ) );
+        }
+    }
 }
 
 void CartesianDiagramDataCompressor::slotModelLayoutChanged()
 {
+    m_rangeIndexes.clear();
     rebuildCache();
     calculateSampleStepWidth();
 }
 
+void CartesianDiagramDataCompressor::slotModelReset()
+{
+    m_rangeIndexes.clear();
+    rebuildCache();
+}
+
 void CartesianDiagramDataCompressor::slotDiagramLayoutChanged( AbstractDiagram* diagramBase )
 {
     AbstractCartesianDiagram* diagram = qobject_cast< AbstractCartesianDiagram* >( diagramBase );
@@ -323,7 +359,7 @@ void CartesianDiagramDataCompressor::setModel( QAbstractItemModel* model )
         disconnect( m_model, SIGNAL(columnsAboutToBeRemoved(QModelIndex,int,int)),
                  this, SLOT(slotColumnsAboutToBeRemoved(QModelIndex,int,int)) );
         disconnect( m_model, SIGNAL(modelReset()),
-                    this, SLOT(rebuildCache()) );
+                    this, SLOT(slotModelReset()) );
         m_model = nullptr;
     }
 
@@ -353,8 +389,9 @@ void CartesianDiagramDataCompressor::setModel( QAbstractItemModel* model )
                  SLOT(slotColumnsRemoved(QModelIndex,int,int)) );
         connect( m_model, SIGNAL(columnsAboutToBeRemoved(QModelIndex,int,int)),
                  SLOT(slotColumnsAboutToBeRemoved(QModelIndex,int,int)) );
-        connect( m_model, SIGNAL(modelReset()), SLOT(rebuildCache()) );
+        connect( m_model, SIGNAL(modelReset()), SLOT(slotModelReset()) );
     }
+    m_rangeIndexes.clear();
     rebuildCache();
     calculateSampleStepWidth();
 }
@@ -365,6 +402,7 @@ void CartesianDiagramDataCompressor::setRootIndex( const QModelIndex& root )
         Q_ASSERT( root.model() == m_model || !root.isValid() );
         m_rootIndex = root;
         m_modelCache.setRootIndex( root );
+        m_rangeIndexes.clear();
         rebuildCache();
         calculateSampleStepWidth();
     }
@@ -388,7 +426,7 @@ bool CartesianDiagramDataCompressor::setResolutionInternal( int x, int y )
     const int oldXRes = m_xResolution;
     const int oldYRes = m_yResolution;
 
-    if ( m_datasetDimension != 1 ) {
+    if ( m_datasetDimension != 1 && m_aggregationMode == AverageAggregation ) {
         // just ignore the X resolution in that case
         m_xResolution = m_model ? m_model->rowCount( m_rootIndex ) : 0;
     } else {
@@ -430,7 +468,10 @@ const CartesianDiagramDataCompressor::DataPoint& CartesianDiagramDataCompressor:
     }
     if ( ! isCached( position ) ) {
         retrieveModelData( position );
+    } else {
+        Instrumentation::count( Instrumentation::CacheHits );
     }
+    Instrumentation::count( Instrumentation::PointsCompressed );
     return m_data.at( position.column ).at( position.row );
 }
 
@@ -484,7 +525,13 @@ void CartesianDiagramDataCompressor::retrieveModelData( const CachePosition& pos
     switch ( m_mode ) {
     case Precise:
     {
+        if ( m_aggregationMode != AverageAggregation ) {
+            retrieveStockData( position, &result );
+            break;
+        }
+
         const QModelIndexList indexes = mapToModel( position );
+        Instrumentation::count( Instrumentation::PointsFetched, indexes.count() );
 
         if ( m_datasetDimension == 2 ) {
             Q_ASSERT( indexes.count() == 2 );
@@ -550,7 +597,8 @@ CartesianDiagramDataCompressor::CachePosition CartesianDiagramDataCompressor::ma
     if ( indexesPerPixel() == 0 ) {
         return mapToCache( QModelIndex() );
     }
-    return CachePosition( int( row / indexesPerPixel() ), column / m_datasetDimension );
+    const int effectiveDimension = m_datasetDimension == 2 ? 2 : 1;
+    return CachePosition( int( row / indexesPerPixel() ), column / effectiveDimension );
 }
 
 QModelIndexList CartesianDiagramDataCompressor::mapToModel( const CachePosition& position ) const
@@ -658,3 +706,191 @@ void CartesianDiagramDataCompressor::setDatasetDimension( int dimension )
         calculateSampleStepWidth();
     }
 }
+
+void CartesianDiagramDataCompressor::setAggregationMode( AggregationMode mode )
+{
+    if ( mode != m_aggregationMode ) {
+        m_aggregationMode = mode;
+        rebuildCache();
+        calculateSampleStepWidth();
+    }
+}
+
+CartesianDiagramDataCompressor::AggregationMode CartesianDiagramDataCompressor::aggregationMode() const
+{
+    return m_aggregationMode;
+}
+
+void CartesianDiagramDataCompressor::retrieveStockData( const CachePosition& position, DataPoint* result ) const
+{
+    const qreal ipp = indexesPerPixel();
+    const int begin = floor( position.row * ipp );
+    const int end = qMin( m_model->rowCount( m_rootIndex ), int( floor( ( position.row + 1 ) * ipp ) ) );
+    if ( begin >= end ) {
+        return;
+    }
+
+    const RangeIndex& index = rangeIndex( position.column );
+    Instrumentation::count( Instrumentation::PointsFetched );
+
+    // the part of the stock data the column holds, counting from open = 0 to close = 3
+    const int valuesPerDataset = m_aggregationMode == OpenHighLowCloseAggregation ? 4 : 3;
+    const int valueType = position.column % valuesPerDataset + ( 4 - valuesPerDataset );
+    int row = -1;
+    switch ( valueType ) {
+    case 0:
+        row = index.firstValidRow( begin, end );
+        break;
+    case 1:
+        row = index.maximumRow( begin, end );
+        break;
+    case 2:
+        row = index.minimumRow( begin, end );
+        break;
+    default:
+        row = index.lastValidRow( begin, end );
+        break;
+    }
+
+    result->key = ( begin + end - 1 ) / 2.0;
+    if ( row < 0 ) {
+        // no values at all, like a single row holding NaN
+        result->index = m_model->index( begin, position.column, m_rootIndex );
+        result->value = std::numeric_limits< qreal >::quiet_NaN();
+        row = begin;
+    } else {
+        result->index = m_model->index( row, position.column, m_rootIndex );
+        result->value = index.value( row );
+    }
+    // only look at the row the value came from, looking at all of them would defeat the index
+    result->hidden = m_model->data( result->index, DataHiddenRole ).value<bool>();
+}
+
+const CartesianDiagramDataCompressor::RangeIndex& CartesianDiagramDataCompressor::rangeIndex( int column ) const
+{
+    const int columnCount = m_model->columnCount( m_rootIndex );
+    if ( m_rangeIndexes.size() != columnCount ) {
+        m_rangeIndexes.resize( columnCount );
+    }
+    RangeIndex& index = m_rangeIndexes[ column ];
+    if ( index.isEmpty() ) {
+        const int rowCount = m_model->rowCount( m_rootIndex );
+        QVector< qreal > values( rowCount );
+        for ( int row = 0; row < rowCount; ++row ) {
+            values[ row ] = m_modelCache.data( row, column );
+        }
+        Instrumentation::count( Instrumentation::PointsFetched, rowCount );
+        index.build( values );
+    }
+    return index;
+}
+
+bool CartesianDiagramDataCompressor::RangeIndex::isValid( int row ) const
+{
+    return row >= 0 && !ISNAN( m_values[ row ] );
+}
+
+void CartesianDiagramDataCompressor::RangeIndex::build( const QVector< qreal >& values )
+{
+    m_values = values;
+    m_maxRows.clear();
+    m_minRows.clear();
+    for ( int level = 1, previousSize = m_values.size(); previousSize > 1; ++level ) {
+        const int size = ( previousSize + 1 ) / 2;
+        m_maxRows.append( QVector< int >( size ) );
+        m_minRows.append( QVector< int >( size ) );
+        for ( int i = 0; i < size; ++i ) {
+            updateEntry( level, i );
+        }
+        previousSize = size;
+    }
+}
+
+void CartesianDiagramDataCompressor::RangeIndex::clear()
+{
+    m_values.clear();
+    m_maxRows.clear();
+    m_minRows.clear();
+}
+
+void CartesianDiagramDataCompressor::RangeIndex::update( int row, qreal value )
+{
+    m_values[ row ] = value;
+    for ( int level = 1, i = row >> 1; level <= m_maxRows.size(); ++level, i >>= 1 ) {
+        updateEntry( level, i );
+    }
+}
+
+void CartesianDiagramDataCompressor::RangeIndex::updateEntry( int level, int i )
+{
+    const int previousSize = level == 1 ? m_values.size() : m_maxRows[ level - 2 ].size();
+    const int left = 2 * i;
+    const int right = 2 * i + 1;
+    const bool hasRight = right < previousSize;
+    m_maxRows[ level - 1 ][ i ] = better( entry( level - 1, left, true ),
+                                          hasRight ? entry( level - 1, right, true ) : -1, true );
+    m_minRows[ level - 1 ][ i ] = better( entry( level - 1, left, false ),
+                                          hasRight ? entry( level - 1, right, false ) : -1, false );
+}
+
+int CartesianDiagramDataCompressor::RangeIndex::entry( int level, int i, bool maximum ) const
+{
+    if ( level == 0 ) {
+        return i;
+    }
+    return maximum ? m_maxRows[ level - 1 ][ i ] : m_minRows[ level - 1 ][ i ];
+}
+
+int CartesianDiagramDataCompressor::RangeIndex::better( int row1, int row2, bool maximum ) const
+{
+    if ( !isValid( row1 ) ) {
+        return isValid( row2 ) ? row2 : -1;
+    }
+    if ( !isValid( row2 ) ) {
+        return row1;
+    }
+    const qreal value1 = m_values[ row1 ];
+    const qreal value2 = m_values[ row2 ];
+    if ( value1 == value2 ) {
+        return qMin( row1, row2 );
+    }
+    return ( maximum ? value1 > value2 : value1 < value2 ) ? row1 : row2;
+}
+
+int CartesianDiagramDataCompressor::RangeIndex::find( int begin, int end, bool maximum ) const
+{
+    // walk up the levels, taking the blocks at the range's borders that are not
+    // completely covered by a block of the next level
+    int result = -1;
+    for ( int level = 0; begin < end; ++level, begin >>= 1, end >>= 1 ) {
+        if ( begin & 1 ) {
+            result = better( result, entry( level, begin, maximum ), maximum );
+            ++begin;
+        }
+        if ( end & 1 ) {
+            --end;
+            result = better( result, entry( level, end, maximum ), maximum );
+        }
+    }
+    return result;
+}
+
+int CartesianDiagramDataCompressor::RangeIndex::firstValidRow( int begin, int end ) const
+{
+    for ( int row = begin; row < end; ++row ) {
+        if ( isValid( row ) ) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+int CartesianDiagramDataCompressor::RangeIndex::lastValidRow( int begin, int end ) const
+{
+    for ( int row = end - 1; row >= begin; --row ) {
+        if ( isValid( row ) ) {
+            return row;
+        }
+    }
+    return -1;
+}
@@ -125,6 +125,17 @@ namespace KChart {
             SamplingSeven
         };
 
+        enum AggregationMode {
+            // every column is compressed on its own, by averaging the rows of a pixel
+            AverageAggregation,
+            // every three columns are the high, low and close values of stock data, a pixel
+            // gets the highest high, the lowest low and the last close value of its rows
+            HighLowCloseAggregation,
+            // like HighLowCloseAggregation, with an additional open value in front of the
+            // others, a pixel gets the first open value of its rows
+            OpenHighLowCloseAggregation
+        };
+
         explicit CartesianDiagramDataCompressor( QObject* parent = nullptr );
 
         // input: model, chart resolution, approximation mode
@@ -134,6 +145,8 @@ namespace KChart {
         void recalcResolution();
         void setApproximationMode( ApproximationMode mode );
         void setDatasetDimension( int dimension );
+        void setAggregationMode( AggregationMode mode );
+        AggregationMode aggregationMode() const;
 
         // output: resulting model resolution, data points
         // FIXME (Mirko) rather stupid naming, Mirko!
@@ -170,8 +183,42 @@ namespace KChart {
         void rebuildCache();
         // reset all cached values, without changing the cache geometry
         void clearCache();
+        // the model's data changed completely
+        void slotModelReset();
 
     private:
+        // The values of one model column together with the rows of the minimum and maximum values
+        // of blocks of 2, 4, 8, ... rows, to find the extremes of any range of rows in logarithmic
+        // time. Used by the stock aggregation modes, so that rebuilding the cache after zooming
+        // does not need to look at every row again.
+        class RangeIndex {
+        public:
+            bool isEmpty() const { return m_values.isEmpty(); }
+            void build( const QVector< qreal >& values );
+            void clear();
+            void update( int row, qreal value );
+
+            qreal value( int row ) const { return m_values[ row ]; }
+            // the following return the row of the respective value in [begin, end),
+            // or -1 if all values in the range are NaN
+            int firstValidRow( int begin, int end ) const;
+            int lastValidRow( int begin, int end ) const;
+            int minimumRow( int begin, int end ) const { return find( begin, end, false ); }
+            int maximumRow( int begin, int end ) const { return find( begin, end, true ); }
+
+        private:
+            bool isValid( int row ) const;
+            int entry( int level, int i, bool maximum ) const;
+            int better( int row1, int row2, bool maximum ) const;
+            int find( int begin, int end, bool maximum ) const;
+            void updateEntry( int level, int i );
+
+            QVector< qreal > m_values;
+            // m_maxRows[ level - 1 ][ i ] is the row of the maximum of rows [i << level, (i + 1) << level)
+            QVector< QVector< int > > m_maxRows;
+            QVector< QVector< int > > m_minRows;
+        };
+
         // private version of setResolution() that does *not* call rebuildCache()
         bool setResolutionInternal( int x, int y );
         // forget cached data at the position
@@ -192,6 +239,10 @@ namespace KChart {
 
         // retrieve data from the model, put it into the cache
         void retrieveModelData( const CachePosition& ) const;
+        // aggregate the rows of a position according to the stock aggregation modes
+        void retrieveStockData( const CachePosition&, DataPoint* result ) const;
+        // the range index of a model column, built on first use
+        const RangeIndex& rangeIndex( int column ) const;
         // check if a data point is in the cache:
         bool isCached( const CachePosition& ) const;
         // set sample step width according to settings:
@@ -202,6 +253,7 @@ namespace KChart {
         QModelIndex m_rootIndex;
 
         ApproximationMode m_mode;
+        AggregationMode m_aggregationMode;
         int m_xResolution;
         int m_yResolution;
         unsigned int m_sampleStep;
@@ -209,6 +261,7 @@ namespace KChart {
         mutable QVector<DataPointVector> m_data; // one per dataset
         ModelDataCache< qreal, Qt::DisplayRole > m_modelCache;
         mutable DataValueAttributesCache m_dataValueAttributesCache;
+        mutable QVector< RangeIndex > m_rangeIndexes; // one per model column
         int m_datasetDimension;
     };
 }
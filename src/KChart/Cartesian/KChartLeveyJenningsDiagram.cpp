@@ -35,6 +35,9 @@ using namespace KChart;
 using namespace std;
 
 LeveyJenningsDiagram::Private::Private()
+    : prefixValidRows( 0 ),
+      prefixInRowOrder( true ),
+      prefixShift( 0.0 )
 {
 }
 
@@ -306,15 +309,37 @@ float LeveyJenningsDiagram::calculatedStandardDeviation() const
     return d->calculatedStandardDeviation;
 }
 
+/**
+ * Returns the calculated mean value over the QC values within \a timeRange,
+ * including both ends. An invalid start or end leaves the range open on that
+ * side. Rows without a valid time are not within any range.
+ */
+float LeveyJenningsDiagram::calculatedMeanValue( const QPair< QDateTime, QDateTime >& timeRange ) const
+{
+    return d->windowStatistics( timeRange.first, timeRange.second ).mean();
+}
+
+/**
+ * Returns the calculated standard deviation over the QC values within \a timeRange,
+ * including both ends. An invalid start or end leaves the range open on that
+ * side. Rows without a valid time are not within any range.
+ */
+float LeveyJenningsDiagram::calculatedStandardDeviation( const QPair< QDateTime, QDateTime >& timeRange ) const
+{
+    return d->windowStatistics( timeRange.first, timeRange.second ).standardDeviation();
+}
+
 void LeveyJenningsDiagram::setModel( QAbstractItemModel* model )
 {
     if ( this->model() != nullptr )
     {
         disconnect( this->model(), SIGNAL(dataChanged(QModelIndex,QModelIndex)),
-                                   this, SLOT(calculateMeanAndStandardDeviation()) );
+                                   this, SLOT(updateStatisticsForChangedData(QModelIndex,QModelIndex)) );
         disconnect( this->model(), SIGNAL(rowsInserted(QModelIndex,int,int)),
-                                   this, SLOT(calculateMeanAndStandardDeviation()) );
+                                   this, SLOT(updateStatisticsForInsertedRows(QModelIndex,int,int)) );
         disconnect( this->model(), SIGNAL(rowsRemoved(QModelIndex,int,int)),
+                                   this, SLOT(updateStatisticsForRemovedRows(QModelIndex,int,int)) );
+        disconnect( this->model(), SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
                                    this, SLOT(calculateMeanAndStandardDeviation()) );
         disconnect( this->model(), SIGNAL(columnsInserted(QModelIndex,int,int)),
                                    this, SLOT(calculateMeanAndStandardDeviation()) );
@@ -329,10 +354,12 @@ void LeveyJenningsDiagram::setModel( QAbstractItemModel* model )
     if ( this->model() != nullptr )
     {
         connect( this->model(), SIGNAL(dataChanged(QModelIndex,QModelIndex)),
-                                this, SLOT(calculateMeanAndStandardDeviation()) );
+                                this, SLOT(updateStatisticsForChangedData(QModelIndex,QModelIndex)) );
         connect( this->model(), SIGNAL(rowsInserted(QModelIndex,int,int)),
-                                this, SLOT(calculateMeanAndStandardDeviation()) );
+                                this, SLOT(updateStatisticsForInsertedRows(QModelIndex,int,int)) );
         connect( this->model(), SIGNAL(rowsRemoved(QModelIndex,int,int)),
+                                this, SLOT(updateStatisticsForRemovedRows(QModelIndex,int,int)) );
+        connect( this->model(), SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
                                 this, SLOT(calculateMeanAndStandardDeviation()) );
         connect( this->model(), SIGNAL(columnsInserted(QModelIndex,int,int)),
                                 this, SLOT(calculateMeanAndStandardDeviation()) );
@@ -347,38 +374,55 @@ void LeveyJenningsDiagram::setModel( QAbstractItemModel* model )
     }
 }
 
-// TODO: This is the 'easy' solution
-// evaluate whether this is enough or we need some better one or even boost here
+// Recalculates the statistics from all rows. Everything else updates them incrementally.
 void LeveyJenningsDiagram::calculateMeanAndStandardDeviation() const
 {
-    QVector< qreal > values;
-    // first fetch all values
+    d->rowValues.clear();
+    d->rowTimes.clear();
+    d->statistics = RunningStatistics();
+    d->invalidatePrefixIndex( 0 );
+
     const QAbstractItemModel& m = *model();
     const int rowCount = m.rowCount( rootIndex() );
-
-    for ( int row = 0; row < rowCount; ++row )
-    {
-        const QVariant var = m.data( m.index( row, 1, rootIndex() ) );
-        if ( !var.isValid() )
-            continue;
-        const qreal value = var.toReal();
-        if ( ISNAN( value ) )
-            continue;
-        values << value;
+    if ( rowCount > 0 ) {
+        d->fetchRows( m, rootIndex(), 0, rowCount - 1 );
     }
+    d->updateCalculatedValues();
+}
 
-    qreal sum = 0.0;
-    qreal sumSquares = 0.0;
-    Q_FOREACH( qreal value, values )
-    {
-        sum += value;
-        sumSquares += value * value;
+void LeveyJenningsDiagram::updateStatisticsForChangedData( const QModelIndex& topLeft,
+                                                           const QModelIndex& bottomRight )
+{
+    if ( topLeft.parent() != rootIndex() || topLeft.column() > 3 || bottomRight.column() < 1 ) {
+        return;
+    }
+    // re-fetch the changed rows, replacing their previous values
+    const int first = topLeft.row();
+    const int last = qMin( bottomRight.row(), d->rowValues.count() - 1 );
+    if ( last < first ) {
+        return;
     }
+    d->removeRows( first, last );
+    d->fetchRows( *model(), rootIndex(), first, last );
+    d->updateCalculatedValues();
+}
 
-    const int N = values.count();
+void LeveyJenningsDiagram::updateStatisticsForInsertedRows( const QModelIndex& parent, int first, int last )
+{
+    if ( parent != rootIndex() ) {
+        return;
+    }
+    d->fetchRows( *model(), rootIndex(), first, last );
+    d->updateCalculatedValues();
+}
 
-    d->calculatedMeanValue = sum / N;
-    d->calculatedStandardDeviation = sqrt( ( static_cast< qreal >( N ) * sumSquares - sum * sum ) / ( N * ( N - 1 ) ) );
+void LeveyJenningsDiagram::updateStatisticsForRemovedRows( const QModelIndex& parent, int first, int last )
+{
+    if ( parent != rootIndex() ) {
+        return;
+    }
+    d->removeRows( first, qMin( last, d->rowValues.count() - 1 ) );
+    d->updateCalculatedValues();
 }
 
 // calculates the largest QDate not greater than \a dt.
@@ -86,6 +86,9 @@ public:
     float calculatedMeanValue() const;
     float calculatedStandardDeviation() const;
 
+    float calculatedMeanValue( const QPair< QDateTime, QDateTime >& timeRange ) const;
+    float calculatedStandardDeviation( const QPair< QDateTime, QDateTime >& timeRange ) const;
+
     void setFluidicsPackChanges( const QVector< QDateTime >& changes );
     QVector< QDateTime > fluidicsPackChanges() const;
 
@@ -122,6 +125,11 @@ protected:
 
 protected Q_SLOTS:
     void calculateMeanAndStandardDeviation() const;
+
+private Q_SLOTS:
+    void updateStatisticsForChangedData( const QModelIndex& topLeft, const QModelIndex& bottomRight );
+    void updateStatisticsForInsertedRows( const QModelIndex& parent, int first, int last );
+    void updateStatisticsForRemovedRows( const QModelIndex& parent, int first, int last );
 }; // End of class KChartLineDiagram
 
 }
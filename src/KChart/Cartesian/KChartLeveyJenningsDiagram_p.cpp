@@ -22,8 +22,52 @@
 #include "KChartLeveyJenningsDiagram.h"
 #include "KChartDataValueAttributes.h"
 
+#include <QAbstractItemModel>
+
+#include <algorithm>
+#include <limits>
+
 using namespace KChart;
 
+const qint64 LeveyJenningsDiagram::Private::noTime = std::numeric_limits< qint64 >::min();
+
+RunningStatistics::RunningStatistics()
+    : count( 0 ),
+      runningMean( 0.0 ),
+      m2( 0.0 )
+{
+}
+
+void RunningStatistics::add( qreal value )
+{
+    ++count;
+    const qreal delta = value - runningMean;
+    runningMean += delta / count;
+    m2 += delta * ( value - runningMean );
+}
+
+void RunningStatistics::remove( qreal value )
+{
+    if ( count <= 1 ) {
+        *this = RunningStatistics();
+        return;
+    }
+    const qreal delta = value - runningMean;
+    runningMean -= delta / ( count - 1 );
+    m2 = qMax( qreal( 0.0 ), m2 - delta * ( value - runningMean ) );
+    --count;
+}
+
+qreal RunningStatistics::mean() const
+{
+    return count > 0 ? runningMean : std::numeric_limits< qreal >::quiet_NaN();
+}
+
+qreal RunningStatistics::standardDeviation() const
+{
+    return count > 1 ? std::sqrt( m2 / ( count - 1 ) ) : std::numeric_limits< qreal >::quiet_NaN();
+}
+
 LeveyJenningsDiagram::Private::Private( const Private& rhs )
     : LineDiagram::Private( rhs ),
       lotChangedPosition( rhs.lotChangedPosition ),
@@ -34,7 +78,10 @@ LeveyJenningsDiagram::Private::Private( const Private& rhs )
       scanLinePen( rhs.scanLinePen ),
       icons( rhs.icons ),
       expectedMeanValue( rhs.expectedMeanValue ),
-      expectedStandardDeviation( rhs.expectedStandardDeviation )
+      expectedStandardDeviation( rhs.expectedStandardDeviation ),
+      prefixValidRows( 0 ),
+      prefixInRowOrder( true ),
+      prefixShift( 0.0 )
 {
 }
 
@@ -47,3 +94,146 @@ void LeveyJenningsDiagram::Private::setYAxisRange() const
     plane->setVerticalRange( QPair< qreal, qreal >( expectedMeanValue - 4 * expectedStandardDeviation, 
                                                     expectedMeanValue + 4 * expectedStandardDeviation ) );
 }
+
+void LeveyJenningsDiagram::Private::fetchRows( const QAbstractItemModel& model, const QModelIndex& root,
+                                               int first, int last ) const
+{
+    const int count = last - first + 1;
+    rowValues.insert( first, count, std::numeric_limits< qreal >::quiet_NaN() );
+    rowTimes.insert( first, count, noTime );
+    for ( int row = first; row <= last; ++row ) {
+        const QVariant var = model.data( model.index( row, 1, root ) );
+        const qreal value = var.isValid() ? var.toReal() : std::numeric_limits< qreal >::quiet_NaN();
+        if ( !ISNAN( value ) ) {
+            rowValues[ row ] = value;
+            statistics.add( value );
+        }
+        const QDateTime time = model.data( model.index( row, 3, root ) ).toDateTime();
+        if ( time.isValid() ) {
+            rowTimes[ row ] = time.toMSecsSinceEpoch();
+        }
+    }
+    invalidatePrefixIndex( first );
+}
+
+void LeveyJenningsDiagram::Private::removeRows( int first, int last ) const
+{
+    for ( int row = first; row <= last; ++row ) {
+        if ( !ISNAN( rowValues.at( row ) ) ) {
+            statistics.remove( rowValues.at( row ) );
+        }
+    }
+    rowValues.remove( first, last - first + 1 );
+    rowTimes.remove( first, last - first + 1 );
+    invalidatePrefixIndex( first );
+}
+
+void LeveyJenningsDiagram::Private::updateCalculatedValues() const
+{
+    calculatedMeanValue = statistics.mean();
+    calculatedStandardDeviation = statistics.standardDeviation();
+}
+
+void LeveyJenningsDiagram::Private::invalidatePrefixIndex( int fromRow ) const
+{
+    prefixValidRows = prefixInRowOrder ? qMin( prefixValidRows, fromRow ) : 0;
+}
+
+void LeveyJenningsDiagram::Private::appendPrefixEntry( int row ) const
+{
+    const int entries = prefixTimes.count();
+    const qreal shifted = rowValues.at( row ) - prefixShift;
+    prefixTimes.append( rowTimes.at( row ) );
+    prefixRows.append( row );
+    prefixCount.append( entries + 1 );
+    prefixSum.append( prefixSum.at( entries ) + shifted );
+    prefixSumSquares.append( prefixSumSquares.at( entries ) + shifted * shifted );
+}
+
+void LeveyJenningsDiagram::Private::updatePrefixIndex() const
+{
+    const int rowCount = rowValues.count();
+    if ( prefixValidRows == rowCount && prefixCount.count() == prefixTimes.count() + 1 ) {
+        return;
+    }
+    int entries = 0;
+    if ( prefixValidRows == 0 ) {
+        // a full rebuild; pick a new shift
+        prefixShift = statistics.count ? statistics.runningMean : 0.0;
+        prefixInRowOrder = true;
+    } else {
+        // the entries are in row order, keep those of the rows still up to date
+        entries = std::lower_bound( prefixRows.constBegin(), prefixRows.constEnd(), prefixValidRows )
+                  - prefixRows.constBegin();
+    }
+    prefixTimes.resize( entries );
+    prefixRows.resize( entries );
+    prefixCount.resize( entries + 1 );
+    prefixSum.resize( entries + 1 );
+    prefixSumSquares.resize( entries + 1 );
+    prefixCount[ 0 ] = 0;
+    prefixSum[ 0 ] = 0.0;
+    prefixSumSquares[ 0 ] = 0.0;
+    for ( int row = prefixValidRows; row < rowCount; ++row ) {
+        if ( ISNAN( rowValues.at( row ) ) || rowTimes.at( row ) == noTime ) {
+            continue;
+        }
+        if ( !prefixTimes.isEmpty() && rowTimes.at( row ) < prefixTimes.last() ) {
+            rebuildSortedPrefixIndex();
+            return;
+        }
+        appendPrefixEntry( row );
+    }
+    prefixValidRows = rowCount;
+}
+
+// for models whose rows are not sorted by time
+void LeveyJenningsDiagram::Private::rebuildSortedPrefixIndex() const
+{
+    const int rowCount = rowValues.count();
+    QVector< QPair< qint64, int > > timedRows;
+    timedRows.reserve( rowCount );
+    for ( int row = 0; row < rowCount; ++row ) {
+        if ( !ISNAN( rowValues.at( row ) ) && rowTimes.at( row ) != noTime ) {
+            timedRows.append( qMakePair( rowTimes.at( row ), row ) );
+        }
+    }
+    std::stable_sort( timedRows.begin(), timedRows.end() );
+
+    prefixTimes.resize( 0 );
+    prefixRows.resize( 0 );
+    prefixCount.resize( 1 );
+    prefixSum.resize( 1 );
+    prefixSumSquares.resize( 1 );
+    for ( int i = 0; i < timedRows.count(); ++i ) {
+        appendPrefixEntry( timedRows.at( i ).second );
+    }
+    prefixInRowOrder = false;
+    prefixValidRows = rowCount;
+}
+
+RunningStatistics LeveyJenningsDiagram::Private::windowStatistics( const QDateTime& begin,
+                                                                   const QDateTime& end ) const
+{
+    updatePrefixIndex();
+
+    const int first = begin.isValid()
+                      ? std::lower_bound( prefixTimes.constBegin(), prefixTimes.constEnd(),
+                                          begin.toMSecsSinceEpoch() ) - prefixTimes.constBegin()
+                      : 0;
+    const int last = end.isValid()
+                     ? std::upper_bound( prefixTimes.constBegin(), prefixTimes.constEnd(),
+                                         end.toMSecsSinceEpoch() ) - prefixTimes.constBegin()
+                     : prefixTimes.count();
+
+    RunningStatistics result;
+    if ( last <= first ) {
+        return result;
+    }
+    result.count = prefixCount.at( last ) - prefixCount.at( first );
+    const qreal sum = prefixSum.at( last ) - prefixSum.at( first );
+    const qreal sumSquares = prefixSumSquares.at( last ) - prefixSumSquares.at( first );
+    result.runningMean = prefixShift + sum / result.count;
+    result.m2 = qMax( qreal( 0.0 ), sumSquares - sum * sum / result.count );
+    return result;
+}
@@ -46,6 +46,28 @@ namespace KChart {
 
     class PaintContext;
 
+/**
+ * \internal
+ *
+ * Mean and variance maintained with Welford's algorithm, which, unlike
+ * summing up x and x^2, does not lose precision when the variance is
+ * small compared to the mean. Values can also be removed again.
+ */
+    struct RunningStatistics
+    {
+        RunningStatistics();
+
+        void add( qreal value );
+        void remove( qreal value );
+
+        qreal mean() const;
+        qreal standardDeviation() const;
+
+        int count;
+        qreal runningMean;
+        qreal m2;
+    };
+
 /**
  * \internal
  */
@@ -59,6 +81,17 @@ namespace KChart {
 
         void setYAxisRange() const;
 
+        // the per-row values and times the statistics are maintained from
+        void fetchRows( const QAbstractItemModel& model, const QModelIndex& root, int first, int last ) const;
+        void removeRows( int first, int last ) const;
+        void updateCalculatedValues() const;
+
+        void invalidatePrefixIndex( int fromRow ) const;
+        void updatePrefixIndex() const;
+        void rebuildSortedPrefixIndex() const;
+        void appendPrefixEntry( int row ) const;
+        RunningStatistics windowStatistics( const QDateTime& begin, const QDateTime& end ) const;
+
         Qt::Alignment lotChangedPosition;
         Qt::Alignment fluidicsPackChangedPosition;
         Qt::Alignment sensorChangedPosition;
@@ -78,6 +111,28 @@ namespace KChart {
 
         mutable float calculatedMeanValue;
         mutable float calculatedStandardDeviation;
+
+        // value (NaN if none) and time in ms since the epoch (noTime if none) of every row, in row order
+        mutable QVector< qreal > rowValues;
+        mutable QVector< qint64 > rowTimes;
+        mutable RunningStatistics statistics;
+
+        // Prefix sums over the rows having both a value and a time, sorted by time, for statistics
+        // of a time window in O(log n). Rows without a time are in no window. The values are shifted
+        // by prefixShift, a value close to the mean, to keep the sum of squares precise.
+        // As long as the rows are sorted by time, the entries are in row order too; then only the
+        // entries of the first prefixValidRows rows are up to date and appending rows extends them.
+        // Otherwise any change rebuilds them.
+        mutable int prefixValidRows;
+        mutable bool prefixInRowOrder;
+        mutable qreal prefixShift;
+        mutable QVector< qint64 > prefixTimes;
+        mutable QVector< int > prefixRows;
+        mutable QVector< int > prefixCount;
+        mutable QVector< qreal > prefixSum;
+        mutable QVector< qreal > prefixSumSquares;
+
+        static const qint64 noTime;
     };
 
     KCHART_IMPL_DERIVED_DIAGRAM( LeveyJenningsDiagram, LineDiagram, LeveyJenningsCoordinatePlane )
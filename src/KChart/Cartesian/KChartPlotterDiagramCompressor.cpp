@@ -21,6 +21,7 @@
 
 #include "KChartPlotterDiagramCompressor_p.h"
 #include "KChartMath_p.h"
+#include "KChartInstrumentation.h"
 
 #include <QPointF>
 
@@ -839,6 +840,7 @@ PlotterDiagramCompressor::DataPoint PlotterDiagramCompressor::data( const CacheP
     DataPoint point;
     QModelIndexList indexes = d->mapToModel( pos );
     Q_ASSERT( indexes.count() == 2 );
+    Instrumentation::count( Instrumentation::PointsFetched );
     QVariant yValue = d->m_model->data( indexes.last() );
     QVariant xValue = d->m_model->data( indexes.first() );
     Q_ASSERT( xValue.isValid() );
@@ -22,6 +22,9 @@
 
 #include "KChartPaintContext.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartMath_p.h"
+
+#include <qmath.h>
 
 using namespace KChart;
 
@@ -54,6 +57,7 @@ void StockDiagram::init()
 
     d->lowHighLinePen = QPen( Qt::black );
     setDatasetDimensionInternal( 3 );
+    d->compressor.setAggregationMode( CartesianDiagramDataCompressor::HighLowCloseAggregation );
     //setDatasetDimension( 3 );
 
     setPen( QPen( Qt::black ) );
@@ -66,6 +70,8 @@ void StockDiagram::init()
 void StockDiagram::setType( Type type )
 {
     d->type = type;
+    d->compressor.setAggregationMode( type == HighLowClose ? CartesianDiagramDataCompressor::HighLowCloseAggregation
+                                                           : CartesianDiagramDataCompressor::OpenHighLowCloseAggregation );
     emit propertiesChanged();
 }
 
@@ -138,7 +144,7 @@ ThreeDBarAttributes StockDiagram::threeDBarAttributes() const
  */
 void StockDiagram::setThreeDBarAttributes( int column, const ThreeDBarAttributes &attr )
 {
-    d->setDatasetAttrs( column, qVariantFromValue( attr ), StockBarAttributesRole );
+    d->setDatasetAttrs( column, qVariantFromValue( attr ), ThreeDBarAttributesRole );
     emit propertiesChanged();
 }
 
@@ -286,53 +292,70 @@ void StockDiagram::paint( PaintContext *context )
     // Clear old reverse mapping data and create new
     // reverse mapping scene
     d->reverseMapper.clear();
+    d->shadowColors.clear();
 
     PainterSaver painterSaver( context->painter() );
-    const int rowCount = attributesModel()->rowCount( attributesModelRootIndex() );
+    // the compressor already aggregates the rows of one pixel to a single bar, so there are
+    // at most as many rows as the diagram is wide, even for a huge model
+    const int rowCount = d->compressor.modelDataRows();
     const int divisor = ( d->type == OpenHighLowClose || d->type == Candlestick ) ? 4 : 3;
     const int colCount = attributesModel()->columnCount( attributesModelRootIndex() ) / divisor;
+
+    // With more bars than pixels, all bars falling into one pixel column are merged into one
+    const AbstractCoordinatePlane *plane = context->coordinatePlane();
+    const qreal barWidth = qAbs( plane->translate( QPointF( 1.0, 0.0 ) ).x() - plane->translate( QPointF( 0.0, 0.0 ) ).x() );
+    const bool mergeBars = barWidth < 1.0;
+
     for ( int col = 0; col < colCount; ++col )
     {
+        Private::Bar pendingBar;
+        int pendingPixel = 0;
+        bool hasPendingBar = false;
+
         for ( int row = 0; row < rowCount; row++ ) {
-            CartesianDiagramDataCompressor::DataPoint low;
-            CartesianDiagramDataCompressor::DataPoint high;
-            CartesianDiagramDataCompressor::DataPoint open;
-            CartesianDiagramDataCompressor::DataPoint close;
-            CartesianDiagramDataCompressor::DataPoint volume;
+            Private::Bar bar;
 
             if ( d->type == HighLowClose ) {
                 const CartesianDiagramDataCompressor::CachePosition highPos( row, col * divisor );
                 const CartesianDiagramDataCompressor::CachePosition lowPos( row, col * divisor + 1 );
                 const CartesianDiagramDataCompressor::CachePosition closePos( row, col * divisor + 2 );
-                low = d->compressor.data( lowPos );
-                high = d->compressor.data( highPos );
-                close = d->compressor.data( closePos );
+                bar.low = d->compressor.data( lowPos );
+                bar.high = d->compressor.data( highPos );
+                bar.close = d->compressor.data( closePos );
+                bar.open.hidden = true;
             } else if ( d->type == OpenHighLowClose || d->type == Candlestick ) {
                 const CartesianDiagramDataCompressor::CachePosition openPos( row, col * divisor );
                 const CartesianDiagramDataCompressor::CachePosition highPos( row, col * divisor + 1 );
                 const CartesianDiagramDataCompressor::CachePosition lowPos( row, col * divisor + 2 );
                 const CartesianDiagramDataCompressor::CachePosition closePos( row, col * divisor + 3 );
-                open = d->compressor.data( openPos );
-                low = d->compressor.data( lowPos );
-                high = d->compressor.data( highPos );
-                close = d->compressor.data( closePos );
+                bar.open = d->compressor.data( openPos );
+                bar.low = d->compressor.data( lowPos );
+                bar.high = d->compressor.data( highPos );
+                bar.close = d->compressor.data( closePos );
             }
 
+            if ( !mergeBars ) {
+                d->drawBar( col, bar, context );
+                continue;
+            }
 
-            switch ( d->type ) {
-            case HighLowClose:
-                open.hidden = true;
-                // Fall-through intended!
-            case OpenHighLowClose:
-                if ( close.index.isValid() && low.index.isValid() && high.index.isValid() )
-                d->drawOHLCBar( col, open, high, low, close, context );
-                break;
-            case Candlestick:
-                d->drawCandlestick( col, open, high, low, close, context );
-                break;
+            const qreal key = ISNAN( bar.close.key ) ? row : bar.close.key;
+            const int pixel = qFloor( plane->translate( QPointF( key + 0.5, 0.0 ) ).x() );
+            if ( hasPendingBar && pixel == pendingPixel ) {
+                Private::mergeBar( &pendingBar, bar );
+                continue;
             }
+            if ( hasPendingBar )
+                d->drawBar( col, pendingBar, context );
+            pendingBar = bar;
+            pendingPixel = pixel;
+            hasPendingBar = true;
         }
+        if ( hasPendingBar )
+            d->drawBar( col, pendingBar, context );
     }
+
+    d->flushBatches( context );
 }
 
 void StockDiagram::resize( const QSizeF &size )
@@ -359,10 +382,10 @@ qreal StockDiagram::threeDItemDepth( const QModelIndex &index ) const
 
 const QPair<QPointF, QPointF> StockDiagram::calculateDataBoundaries() const
 {
-    const int rowCount = attributesModel()->rowCount( attributesModelRootIndex() );
+    const int rowCount = d->compressor.modelDataRows();
     const int colCount = attributesModel()->columnCount( attributesModelRootIndex() );
     qreal xMin = 0.0;
-    qreal xMax = rowCount;
+    qreal xMax = attributesModel()->rowCount( attributesModelRootIndex() );
     qreal yMin = 0.0;
     qreal yMax = 0.0;
     for ( int row = 0; row < rowCount; row++ ) {
@@ -20,6 +20,7 @@
 #include "KChartStockDiagram_p.h"
 
 #include "KChartPainterSaver_p.h"
+#include "KChartInstrumentation.h"
 
 using namespace KChart;
 
@@ -33,8 +34,8 @@ public:
         bool useShadowColors;
     };
 
-    ThreeDPainter( QPainter *p )
-        : painter( p ) {};
+    ThreeDPainter( QPainter *p, ShadowColorCache *cache )
+        : painter( p ), shadowColors( cache ) {};
 
     QPolygonF drawTwoDLine( const QLineF &line, const QPen &pen,
                             const ThreeDProperties &props );
@@ -46,8 +47,10 @@ public:
 private:
     QPointF projectPoint( const QPointF &point, qreal depth, qreal angle ) const;
     QColor calcShadowColor( const QColor &color, qreal angle ) const;
+    QColor shadowColor( const QColor &color, qreal angle ) const;
 
     QPainter *painter;
+    ShadowColorCache *shadowColors;
 };
 
 /**
@@ -84,6 +87,20 @@ QColor StockDiagram::Private::ThreeDPainter::calcShadowColor( const QColor &colo
                    qRound( color.blue()  * sinAngle ) );
 }
 
+/**
+ * Returns the shadow color for a given color like calcShadowColor(), computing it
+ * only once per paint for every color and angle
+ */
+QColor StockDiagram::Private::ThreeDPainter::shadowColor( const QColor &color, qreal angle ) const
+{
+    const QPair< QRgb, qreal > key( color.rgba(), angle );
+    ShadowColorCache::const_iterator it = shadowColors->constFind( key );
+    if ( it == shadowColors->constEnd() ) {
+        it = shadowColors->insert( key, calcShadowColor( color, angle ) );
+    }
+    return it.value();
+}
+
 /**
  * Draws a 2D line in 3D space by painting it with a z-coordinate of props.depth / 2.0
  *
@@ -114,6 +131,7 @@ QPolygonF StockDiagram::Private::ThreeDPainter::drawTwoDLine( const QLineF &line
 
     painter->setPen( pen );
     painter->drawLine( QLineF( deepP1, deepP2 ) );
+    Instrumentation::count( Instrumentation::PrimitivesDrawn );
 
     return threeDArea;
 }
@@ -149,8 +167,8 @@ QPolygonF StockDiagram::Private::ThreeDPainter::drawThreeDLine( const QLineF &li
     if ( props.useShadowColors ) {
         QBrush shadowBrush( brush );
         QPen shadowPen( pen );
-        shadowBrush.setColor( calcShadowColor( brush.color(), props.angle ) );
-        shadowPen.setColor( calcShadowColor( pen.color(), props.angle ) );
+        shadowBrush.setColor( shadowColor( brush.color(), props.angle ) );
+        shadowPen.setColor( shadowColor( pen.color(), props.angle ) );
         painter->setBrush( shadowBrush );
         painter->setPen( shadowPen );
     } else {
@@ -159,6 +177,7 @@ QPolygonF StockDiagram::Private::ThreeDPainter::drawThreeDLine( const QLineF &li
     }
 
     painter->drawPolygon( threeDArea );
+    Instrumentation::count( Instrumentation::PrimitivesDrawn );
 
     return threeDArea;
 }
@@ -214,6 +233,7 @@ QPolygonF StockDiagram::Private::ThreeDPainter::drawThreeDRect( const QRectF &re
     painter->setPen( pen );
     painter->setBrush( brush );
     painter->drawRect( normalizedRect );
+    Instrumentation::count( Instrumentation::PrimitivesDrawn );
 
     return drawnPolygon;
 }
@@ -233,6 +253,107 @@ StockDiagram::Private::~Private()
 {
 }
 
+static bool isPresent( const CartesianDiagramDataCompressor::DataPoint &point )
+{
+    return point.index.isValid() && !point.hidden;
+}
+
+/**
+ * Merges \a next into \a bar: the result opens like the first of the two bars,
+ * closes like the last one and spans the range of both
+ */
+void StockDiagram::Private::mergeBar( Bar *bar, const Bar &next )
+{
+    if ( !isPresent( bar->open ) && isPresent( next.open ) )
+        bar->open = next.open;
+    if ( isPresent( next.close ) )
+        bar->close = next.close;
+    if ( isPresent( next.high ) && ( !isPresent( bar->high ) || next.high.value > bar->high.value ) )
+        bar->high = next.high;
+    if ( isPresent( next.low ) && ( !isPresent( bar->low ) || next.low.value < bar->low.value ) )
+        bar->low = next.low;
+}
+
+/**
+ * Draws \a bar as an OHLC bar or a candlestick, depending on the type of the diagram
+ */
+void StockDiagram::Private::drawBar( int dataset, const Bar &bar, PaintContext *context )
+{
+    switch ( type ) {
+    case HighLowClose:
+    case OpenHighLowClose:
+        if ( bar.close.index.isValid() && bar.low.index.isValid() && bar.high.index.isValid() )
+            drawOHLCBar( dataset, bar.open, bar.high, bar.low, bar.close, context );
+        break;
+    case Candlestick:
+        drawCandlestick( dataset, bar.open, bar.high, bar.low, bar.close, context );
+        break;
+    }
+}
+
+/**
+ * Returns the batch collecting the primitives painted with \a pen and \a brush
+ */
+StockDiagram::Private::PrimitiveBatch &StockDiagram::Private::batch( const QPen &pen, const QBrush &brush )
+{
+    // there are only a few distinct pens and brushes per diagram, usually one or two per dataset
+    for ( int i = batches.size() - 1; i >= 0; --i ) {
+        if ( batches[ i ].pen == pen && batches[ i ].brush == brush )
+            return batches[ i ];
+    }
+    PrimitiveBatch newBatch;
+    newBatch.pen = pen;
+    newBatch.brush = brush;
+    batches.append( newBatch );
+    return batches.last();
+}
+
+/**
+ * Paints the collected 2D bars with one call per pen, brush and kind of primitive,
+ * and then their data value labels on top of them
+ */
+void StockDiagram::Private::flushBatches( PaintContext *context )
+{
+    if ( batches.isEmpty() && pendingLabels.isEmpty() )
+        return;
+    QPainter *const painter = context->painter();
+    {
+        PainterSaver painterSaver( painter );
+        Q_FOREACH( const PrimitiveBatch &batch, batches ) {
+            painter->setPen( batch.pen );
+            painter->setBrush( batch.brush );
+            if ( !batch.lines.isEmpty() ) {
+                painter->drawLines( batch.lines.constData(), batch.lines.size() );
+                Instrumentation::count( Instrumentation::PrimitivesDrawn, batch.lines.size() );
+            }
+            if ( !batch.rects.isEmpty() ) {
+                painter->drawRects( batch.rects.constData(), batch.rects.size() );
+                Instrumentation::count( Instrumentation::PrimitivesDrawn, batch.rects.size() );
+            }
+        }
+    }
+    batches.clear();
+
+    Q_FOREACH( const LabelPaintCache &lpc, pendingLabels ) {
+        paintDataValueTextsAndMarkers( context, lpc, false );
+    }
+    pendingLabels.clear();
+}
+
+/**
+ * Paints the labels of a bar in \a lpc, right away if the bar has been painted
+ * right away as well, otherwise together with the batched bars
+ */
+void StockDiagram::Private::addLabels( PaintContext *context, const LabelPaintCache &lpc, bool paintNow )
+{
+    if ( lpc.paintReplay.isEmpty() )
+        return;
+    if ( paintNow )
+        paintDataValueTextsAndMarkers( context, lpc, false );
+    else
+        pendingLabels.append( lpc );
+}
+
 /**
  * Projects a point onto the coordinate plane
  *
@@ -273,6 +394,8 @@ void StockDiagram::Private::drawOHLCBar( int dataset, const CartesianDiagramData
     StockBarAttributes attr = stockDiagram()->stockBarAttributes( col );
     ThreeDBarAttributes threeDAttr = stockDiagram()->threeDBarAttributes( col );
     const qreal tickLength = attr.tickLength();
+    const QPen pen = diagram->pen( dataset );
+    const QBrush brush = diagram->brush( dataset );
 
     const QPointF leftOpenPoint( open.key + 0.5 - tickLength, open.value );
     const QPointF rightOpenPoint( open.key + 0.5, open.value );
@@ -284,6 +407,8 @@ void StockDiagram::Private::drawOHLCBar( int dataset, const CartesianDiagramData
     bool reversedOrder = false;
     // If 3D mode is enabled, we have to make sure the z-order is right
     if ( threeDAttr.isEnabled() ) {
+        // 3D bars are painted right away, on top of the 2D bars before them
+        flushBatches( context );
         const int angle = threeDAttr.angle();
         // Z-order is from right to left
         if ( ( angle >= 0 && angle < 90 ) || ( angle >= 180 && angle < 270 ) )
@@ -295,18 +420,18 @@ void StockDiagram::Private::drawOHLCBar( int dataset, const CartesianDiagramData
 
     if ( reversedOrder ) {
         if ( !open.hidden )
-            drawLine( dataset, col, leftOpenPoint, rightOpenPoint, context ); // Open marker
+            drawLine( col, leftOpenPoint, rightOpenPoint, pen, brush, threeDAttr, context ); // Open marker
         if ( !low.hidden && !high.hidden )
-            drawLine( dataset, col, lowPoint, highPoint, context ); // Low-High line
+            drawLine( col, lowPoint, highPoint, pen, brush, threeDAttr, context ); // Low-High line
         if ( !close.hidden )
-            drawLine( dataset, col, leftClosePoint, rightClosePoint, context ); // Close marker
+            drawLine( col, leftClosePoint, rightClosePoint, pen, brush, threeDAttr, context ); // Close marker
     } else {
         if ( !close.hidden )
-            drawLine( dataset, col, leftClosePoint, rightClosePoint, context ); // Close marker
+            drawLine( col, leftClosePoint, rightClosePoint, pen, brush, threeDAttr, context ); // Close marker
         if ( !low.hidden && !high.hidden )
-            drawLine( dataset, col, lowPoint, highPoint, context ); // Low-High line
+            drawLine( col, lowPoint, highPoint, pen, brush, threeDAttr, context ); // Low-High line
         if ( !open.hidden )
-            drawLine( dataset, col, leftOpenPoint, rightOpenPoint, context ); // Open marker
+            drawLine( col, leftOpenPoint, rightOpenPoint, pen, brush, threeDAttr, context ); // Open marker
     }
 
     LabelPaintCache lpc;
@@ -326,7 +451,7 @@ void StockDiagram::Private::drawOHLCBar( int dataset, const CartesianDiagramData
         addLabel( &lpc, diagram->attributesModel()->mapToSource( close.index ), nullptr,
                             PositionPoints( rightClosePoint ), Position::South, Position::South, close.value );
     }
-    paintDataValueTextsAndMarkers( context, lpc, false );
+    addLabels( context, lpc, threeDAttr.isEnabled() );
 }
 
 /**
@@ -342,8 +467,6 @@ void StockDiagram::Private::drawCandlestick( int /*dataset*/, const CartesianDia
                                              const CartesianDiagramDataCompressor::DataPoint &close,
                                              PaintContext *context )
 {
-    PainterSaver painterSaver( context->painter() );
-
     // Note: A row in the model is a column in a StockDiagram, and the other way around
     const int row = low.index.row();
     const int col = low.index.column();
@@ -392,7 +515,9 @@ void StockDiagram::Private::drawCandlestick( int /*dataset*/, const CartesianDia
 
     // Use the ThreeDPainter class to draw a 3D candlestick
     if ( threeDAttr.isEnabled() ) {
-        ThreeDPainter threeDPainter( context->painter() );
+        // 3D candlesticks are painted right away, on top of the 2D ones before them
+        flushBatches( context );
+        ThreeDPainter threeDPainter( context->painter(), &shadowColors );
 
         ThreeDPainter::ThreeDProperties threeDProps;
         threeDProps.depth = threeDAttr.depth();
@@ -417,15 +542,13 @@ void StockDiagram::Private::drawCandlestick( int /*dataset*/, const CartesianDia
                 drawnPolygon = threeDPainter.drawTwoDLine( lowerLine, pen, threeDProps );
         }
     } else {
-        QPainter *const painter = context->painter();
-        painter->setBrush( brush );
-        painter->setPen( pen );
+        PrimitiveBatch &primitives = batch( pen, brush );
         if ( drawLowerLine )
-            painter->drawLine( lowerLine );
+            primitives.lines.append( lowerLine );
         if ( drawUpperLine )
-            painter->drawLine( upperLine );
+            primitives.lines.append( upperLine );
         if ( drawCandlestick )
-            painter->drawRect( candlestick );
+            primitives.rects.append( candlestick );
 
         // The 2D representation is the projected candlestick itself
         drawnPolygon = candlestick;
@@ -451,7 +574,7 @@ void StockDiagram::Private::drawCandlestick( int /*dataset*/, const CartesianDia
         addLabel( &lpc, diagram->attributesModel()->mapToSource( high.index ), nullptr,
                   PositionPoints( highPoint ), Position::South, Position::South, high.value );
 
-    paintDataValueTextsAndMarkers( context, lpc, false );
+    addLabels( context, lpc, threeDAttr.isEnabled() );
 }
 
 /**
@@ -460,20 +583,19 @@ void StockDiagram::Private::drawCandlestick( int /*dataset*/, const CartesianDia
   * @param col The column of the diagram to paint the line in
   * @param point1 The first point
   * @param point2 The second point
+  * @param pen The pen of the dataset
+  * @param brush The brush of the dataset, used for the 3D effect
+  * @param threeDBarAttr The 3D attributes of the column
   * @param context The context to draw the low-high line in
   */
-void StockDiagram::Private::drawLine( int dataset, int col, const QPointF &point1, const QPointF &point2, PaintContext *context )
+void StockDiagram::Private::drawLine( int col, const QPointF &point1, const QPointF &point2,
+                                      const QPen &pen, const QBrush &brush,
+                                      const ThreeDBarAttributes &threeDBarAttr, PaintContext *context )
 {
-    PainterSaver painterSaver( context->painter() );
-
     // A row in the model is a column in the diagram
     const int modelRow = col;
     const int modelCol = 0;
 
-    const QPen pen = diagram->pen( dataset );
-    const QBrush brush = diagram->brush( dataset );
-    const ThreeDBarAttributes threeDBarAttr = stockDiagram()->threeDBarAttributes( col );
-
     QPointF transP1 = context->coordinatePlane()->translate( point1 );
     QPointF transP2 = context->coordinatePlane()->translate( point2 );
     QLineF line = QLineF( transP1, transP2 );
@@ -484,13 +606,11 @@ void StockDiagram::Private::drawLine( int dataset, int col, const QPointF &point
         threeDProps.depth = threeDBarAttr.depth();
         threeDProps.useShadowColors = threeDBarAttr.useShadowColors();
 
-        ThreeDPainter painter( context->painter() );
+        ThreeDPainter painter( context->painter(), &shadowColors );
         reverseMapper.addPolygon( modelCol, modelRow, painter.drawThreeDLine( line, brush, pen, threeDProps ) );
     } else {
-        context->painter()->setPen( pen );
-        //context->painter()->setBrush( brush );
         reverseMapper.addLine( modelCol, modelRow, transP1, transP2 );
-        context->painter()->drawLine( line );
+        batch( pen, QBrush() ).lines.append( line );
     }
 }
 
@@ -25,6 +25,8 @@
 #include "KChartCartesianDiagramDataCompressor_p.h"
 #include "KChartPaintContext.h"
 
+#include <QHash>
+
 namespace KChart {
 
 class Q_DECL_HIDDEN StockDiagram::Private : public AbstractCartesianDiagram::Private
@@ -52,6 +54,38 @@ public:
     QPen lowHighLinePen;
     QMap<int, QPen> lowHighLinePens;
 
+    /**
+     * The four values making up one bar of the diagram
+     */
+    struct Bar {
+        CartesianDiagramDataCompressor::DataPoint open;
+        CartesianDiagramDataCompressor::DataPoint high;
+        CartesianDiagramDataCompressor::DataPoint low;
+        CartesianDiagramDataCompressor::DataPoint close;
+    };
+
+    /**
+     * Lines and rectangles sharing one pen and brush, painted together by flushBatches()
+     */
+    struct PrimitiveBatch {
+        QPen pen;
+        QBrush brush;
+        QVector< QLineF > lines;
+        QVector< QRectF > rects;
+    };
+
+    typedef QHash< QPair< QRgb, qreal >, QColor > ShadowColorCache;
+
+    // 2D bars and their data value labels are collected while painting and painted at the end,
+    // or before the next 3D bar
+    QVector< PrimitiveBatch > batches;
+    QVector< LabelPaintCache > pendingLabels;
+    // shadow colors computed during the current paint, by color and 3D angle
+    ShadowColorCache shadowColors;
+
+    static void mergeBar( Bar *bar, const Bar &next );
+    void drawBar( int dataset, const Bar &bar, PaintContext *context );
+    void flushBatches( PaintContext *context );
 
     void drawOHLCBar( int dataset, const CartesianDiagramDataCompressor::DataPoint &open,
                       const CartesianDiagramDataCompressor::DataPoint &high,
@@ -69,7 +103,10 @@ public:
                           PaintContext *context );
 
 private:
-    void drawLine( int dataset, int col, const QPointF &point1, const QPointF &p2, PaintContext *context );
+    PrimitiveBatch &batch( const QPen &pen, const QBrush &brush );
+    void addLabels( PaintContext *context, const LabelPaintCache &lpc, bool paintNow );
+    void drawLine( int col, const QPointF &point1, const QPointF &p2, const QPen &pen, const QBrush &brush,
+                   const ThreeDBarAttributes &threeDBarAttr, PaintContext *context );
     QPointF projectPoint( PaintContext *context, const QPointF &point ) const;
     QRectF projectCandlestick( PaintContext *context, const QPointF &open, const QPointF &close, qreal width ) const;
     int openValueColumn() const;
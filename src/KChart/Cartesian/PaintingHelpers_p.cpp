@@ -30,6 +30,7 @@
 #include "KChartPainterSaver_p.h"
 #include "KChartPlotter.h"
 #include "KChartPrintingParameters.h"
+#include "KChartInstrumentation.h"
 #include "KChartLineAttributes.h"
 #include "KChartThreeDLineAttributes.h"
 #include "ReverseMapper.h"
@@ -57,6 +58,7 @@ void paintPolyline( PaintContext* ctx, const QBrush& brush, const QPen& pen, con
     ctx->painter()->setPen( PrintingParameters::scalePen(
         QPen( pen.color(), pen.width(), pen.style(), Qt::FlatCap, Qt::MiterJoin ) ) );
     ctx->painter()->drawPolyline( points );
+    Instrumentation::count( Instrumentation::PrimitivesDrawn );
 }
 
 void paintThreeDLines( PaintContext* ctx, AbstractDiagram *diagram, const QModelIndex& index,
@@ -78,6 +80,7 @@ void paintThreeDLines( PaintContext* ctx, AbstractDiagram *diagram, const QModel
 
     reverseMapper->addPolygon( index.row(), index.column(), segment );
     ctx->painter()->drawPolygon( segment );
+    Instrumentation::count( Instrumentation::PrimitivesDrawn );
 }
 
 void paintValueTracker( PaintContext* ctx, const ValueTrackerAttributes& vt, const QPointF& at )
@@ -293,6 +296,7 @@ void paintAreas( AbstractDiagram::Private* diagramPrivate, PaintContext* ctx, co
     ctx->painter()->setBrush( trans );
 
     ctx->painter()->drawPath( path );
+    Instrumentation::count( Instrumentation::PrimitivesDrawn );
 }
 
 } // namespace PaintingHelpers
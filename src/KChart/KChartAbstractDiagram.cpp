@@ -34,6 +34,7 @@
 #include "KChartAbstractThreeDAttributes.h"
 #include "KChartThreeDLineAttributes.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartInstrumentation.h"
 
 #include <limits>
 
@@ -120,6 +121,7 @@ const QPair<QPointF, QPointF> AbstractDiagram::dataBoundaries () const
 void AbstractDiagram::setDataBoundariesDirty() const
 {
     d->databoundariesDirty = true;
+    ++d->dataRevision;
     update();
 }
 
@@ -462,7 +464,11 @@ void AbstractDiagram::paintMarker( QPainter* painter,
     if ( ma.markerColor().isValid() )
         indexBrush.setColor( ma.markerColor() );
 
-    paintMarker( painter, ma, indexBrush, indexPen, pos, maSize );
+    if ( !d->useMarkerSprites || !d->paintMarkerSprite( painter, ma, indexBrush, indexPen, pos, maSize ) ) {
+        paintMarker( painter, ma, indexBrush, indexPen, pos, maSize );
+    } else {
+        Instrumentation::count( Instrumentation::PrimitivesDrawn );
+    }
 
     // workaround: BC cannot be changed, otherwise we would pass the
     // index down to next-lower paintMarker function. So far, we
@@ -487,6 +493,7 @@ void AbstractDiagram::paintMarker( QPainter* painter,
                                    const QPointF& pos,
                                    const QSizeF& maSize )
 {
+    Instrumentation::count( Instrumentation::PrimitivesDrawn );
     const QPen oldPen( painter->pen() );
     // Pen is used to paint 4Pixels - 1 Pixel - Ring and FastCross types.
     // make sure to use the brush color - see above in those cases.
@@ -33,10 +33,13 @@
 #include "KChartBarDiagram.h"
 #include "KChartFrameAttributes.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartInstrumentation.h"
 
 #include <QAbstractTextDocumentLayout>
 #include <QTextBlock>
 #include <QApplication>
+#include <QPaintEngine>
+#include <qmath.h>
 
 
 using namespace KChart;
@@ -70,7 +73,6 @@ LabelPaintInfo::LabelPaintInfo( const LabelPaintInfo& other )
 
 AbstractDiagram::Private::Private()
   : diagram( nullptr )
-  , doDumpPaintTime( false )
   , plane( nullptr )
   , attributesModel( new PrivateAttributesModel(nullptr,nullptr) )
   , allowOverlappingDataValueTexts( false )
@@ -78,6 +80,8 @@ AbstractDiagram::Private::Private()
   , percent( false )
   , datasetDimension( 1 )
   , databoundariesDirty( true )
+  , dataRevision( 0 )
+  , useMarkerSprites( false )
   , mCachedFontMetrics( QFontMetrics( qApp->font() ) )
 {
 }
@@ -152,7 +156,6 @@ void AbstractDiagram::Private::setAttributesModel( AttributesModel* amodel )
 
 AbstractDiagram::Private::Private( const AbstractDiagram::Private& rhs ) :
     diagram( nullptr ),
-    doDumpPaintTime( rhs.doDumpPaintTime ),
     // Do not copy the plane
     plane( nullptr ),
     attributesModelRootIndex( QModelIndex() ),
@@ -161,6 +164,9 @@ AbstractDiagram::Private::Private( const AbstractDiagram::Private& rhs ) :
     antiAliasing( rhs.antiAliasing ),
     percent( rhs.percent ),
     datasetDimension( rhs.datasetDimension ),
+    databoundariesDirty( true ),
+    dataRevision( 0 ),
+    useMarkerSprites( false ),
     mCachedFontMetrics( rhs.cachedFontMetrics() )
 {
     attributesModel = new PrivateAttributesModel( nullptr, nullptr);
@@ -221,6 +227,7 @@ void AbstractDiagram::Private::addLabel(
 
         const QPointF referencePoint = relPos.referencePoint();
         if ( !diagram->coordinatePlane()->isVisiblePoint( referencePoint ) ) {
+            Instrumentation::count( Instrumentation::LabelsCulled );
             continue;
         }
 
@@ -389,6 +396,7 @@ void AbstractDiagram::Private::paintDataValueTextsAndMarkers(
         qWarning() << Q_FUNC_INFO << "Neither painting nor finding the bounding rect, what are we doing?";
     }
 
+    Instrumentation::Scope scope( "labels", diagram );
     const PainterSaver painterSaver( ctx->painter() );
     ctx->painter()->setClipping( false );
 
@@ -489,6 +497,7 @@ void AbstractDiagram::Private::paintDataValueText(
 
     const TextAttributes ta( attrs.textAttributes() );
     if ( !ta.isVisible() || ( !attrs.showRepetitiveDataLabels() && prevPaintedDataValueText == text ) ) {
+        Instrumentation::count( Instrumentation::LabelsCulled );
         return;
     }
     prevPaintedDataValueText = text;
@@ -551,7 +560,9 @@ void AbstractDiagram::Private::paintDataValueText(
         }
     }
 
-    if ( drawIt ) {
+    if ( !drawIt ) {
+        Instrumentation::count( Instrumentation::LabelsCulled );
+    } else {
         QRectF rect = layout->frameBoundingRect( doc.rootFrame() );
         if ( cumulatedBoundingRect ) {
             (*cumulatedBoundingRect) |= transform.mapRect( rect );
@@ -579,6 +590,7 @@ void AbstractDiagram::Private::paintDataValueText(
                 painter->drawRoundedRect( borderRect, radius, radius );
             }
             layout->draw( painter, context );
+            Instrumentation::count( Instrumentation::LabelsPlaced );
         }
     }
 }
@@ -676,3 +688,60 @@ LineAttributesInfo::LineAttributesInfo( const QModelIndex& _index, const QPointF
     , nextValue ( _nextValue )
 {
 }
+
+bool AbstractDiagram::Private::paintMarkerSprite( QPainter* painter, const MarkerAttributes& markerAttributes,
+                                                  const QBrush& brush, const QPen& pen,
+                                                  const QPointF& pos, const QSizeF& size )
+{
+    const QPaintEngine* engine = painter->paintEngine();
+    if ( !engine || engine->type() != QPaintEngine::Raster
+         || painter->deviceTransform().type() > QTransform::TxTranslate ) {
+        return false;
+    }
+    const qreal dpr = painter->device()->devicePixelRatioF();
+    const QPainter::RenderHints renderHints = painter->renderHints();
+
+    int i = 0;
+    for ( ; i < markerSprites.size(); ++i ) {
+        const MarkerSprite& sprite = markerSprites.at( i );
+        if ( sprite.size == size && sprite.devicePixelRatio == dpr && sprite.renderHints == renderHints
+             && sprite.brush == brush && sprite.pen == pen && sprite.markerAttributes == markerAttributes ) {
+            break;
+        }
+    }
+    if ( i == markerSprites.size() ) {
+        // a diagram rarely uses more than a handful of different markers, if it does,
+        // start over rather than searching an ever growing list
+        static const int MaximumMarkerSprites = 64;
+        if ( markerSprites.size() >= MaximumMarkerSprites ) {
+            markerSprites.clear();
+            i = 0;
+        }
+
+        MarkerSprite sprite;
+        sprite.markerAttributes = markerAttributes;
+        sprite.brush = brush;
+        sprite.pen = pen;
+        sprite.size = size;
+        sprite.devicePixelRatio = dpr;
+        sprite.renderHints = renderHints;
+        // leave room for the pen and the antialiasing around the marker
+        const qreal margin = qMax( qreal( 1.0 ), PrintingParameters::scalePen( pen ).widthF() ) + 2.0;
+        const QSizeF extent( size.width() + 2.0 * margin, size.height() + 2.0 * margin );
+        sprite.center = QPointF( qCeil( 0.5 * extent.width() ), qCeil( 0.5 * extent.height() ) );
+        sprite.pixmap = QPixmap( QSize( 2 * sprite.center.x(), 2 * sprite.center.y() ) * dpr );
+        sprite.pixmap.setDevicePixelRatio( dpr );
+        sprite.pixmap.fill( Qt::transparent );
+        {
+            QPainter spritePainter( &sprite.pixmap );
+            spritePainter.setRenderHints( renderHints );
+            diagram->paintMarker( &spritePainter, markerAttributes, brush, pen, sprite.center, size );
+        }
+        markerSprites.append( sprite );
+    }
+
+    const MarkerSprite& sprite = markerSprites.at( i );
+    const QPointF topLeft = pos - sprite.center;
+    painter->drawPixmap( QPointF( qRound( topLeft.x() ), qRound( topLeft.y() ) ), sprite.pixmap );
+    return true;
+}
@@ -34,6 +34,7 @@
 #include "KChartAbstractDiagram.h"
 #include "KChartAbstractCoordinatePlane.h"
 #include "KChartDataValueAttributes.h"
+#include "KChartMarkerAttributes.h"
 #include "KChartBackgroundAttributes.h"
 #include "KChartRelativePosition.h"
 #include "KChartPosition.h"
@@ -49,7 +50,10 @@
 #include <QFont>
 #include <QFontMetrics>
 #include <QPaintDevice>
+#include <QPainter>
 #include <QModelIndex>
+#include <QPixmap>
+#include <QVector>
 
 
 namespace KChart {
@@ -184,13 +188,23 @@ namespace KChart {
          */
         bool isTransposed() const;
 
+        /**
+         * Paints a marker by copying a pixmap of it, which is rendered on first use.
+         *
+         * Returns false if that would not look like painting the marker directly, e.g. because
+         * the painter scales or paints to a vector device. The caller then needs to paint the
+         * marker itself.
+         */
+        bool paintMarkerSprite( QPainter* painter, const MarkerAttributes& markerAttributes,
+                                const QBrush& brush, const QPen& pen,
+                                const QPointF& pos, const QSizeF& size );
+
         static Private* get( AbstractDiagram *diagram ) { return diagram->_d; }
 
         AbstractDiagram* diagram;
         ReverseMapper reverseMapper;
         /// The size of the diagram set by AbstractDiagram::resize()
         QSizeF diagramSize;
-        bool doDumpPaintTime; // for use in performance testing code
 
     protected:
         void init();
@@ -205,14 +219,34 @@ namespace KChart {
         int datasetDimension;
         mutable QPair<QPointF,QPointF> databoundaries;
         mutable bool databoundariesDirty;
+        // incremented by setDataBoundariesDirty(), i.e. whenever the data or its
+        // structure change; lets diagrams tell whether values they kept are still current
+        mutable uint dataRevision;
 
         QMap< Qt::Orientation, QString > unitSuffix;
         QMap< Qt::Orientation, QString > unitPrefix;
         QMap< int, QMap< Qt::Orientation, QString > > unitSuffixMap;
         QMap< int, QMap< Qt::Orientation, QString > > unitPrefixMap;
         QList< QPainterPath > alreadyDrawnDataValueTexts;
+        // while set, paintMarker() uses paintMarkerSprite(); diagrams that paint
+        // a lot of markers turn it on for the duration of their paint()
+        bool useMarkerSprites;
 
     private:
+        struct MarkerSprite {
+            MarkerAttributes markerAttributes;
+            QBrush brush;
+            QPen pen;
+            QSizeF size;
+            qreal devicePixelRatio;
+            // the sprite is painted with these, antialiased or not
+            QPainter::RenderHints renderHints;
+            QPixmap pixmap;
+            // where the marker's center is in the pixmap
+            QPointF center;
+        };
+        QVector< MarkerSprite > markerSprites;
+
         QString prevPaintedDataValueText;
         mutable QFontMetrics mCachedFontMetrics;
         mutable QFont mCachedFont;
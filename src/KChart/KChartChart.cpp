@@ -43,6 +43,7 @@
 #include <KChartMarkerAttributes.h>
 #include "KChartPainterSaver_p.h"
 #include "KChartPrintingParameters.h"
+#include "KChartInstrumentation.h"
 
 #include <algorithm>
 
@@ -1116,7 +1117,11 @@ void Chart::Private::reapplyInternalLayouts()
 
 void Chart::Private::paintAll( QPainter* painter )
 {
-    updateDirtyLayouts();
+    Instrumentation::Scope scope( "paint", chart );
+    {
+        Instrumentation::Scope layoutScope( "layout", chart );
+        updateDirtyLayouts();
+    }
 
     QRect rect( QPoint( 0, 0 ), overrideSize.isValid() ? overrideSize : chart->size() );
 
@@ -1139,6 +1144,7 @@ void Chart::Private::paintAll( QPainter* painter )
         const bool hidden = legend->isHidden() && legend->testAttribute( Qt::WA_WState_ExplicitShowHide );
         if ( !hidden ) {
             //qDebug() << "painting legend at " << legend->geometry();
+            Instrumentation::Scope legendScope( "paint", legend );
             legend->paintIntoRect( *painter, legend->geometry() );
         }
     }
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2026 The KDiagram developers
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "KChartInstrumentation.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+#include <QSet>
+
+#include <cstring>
+
+using namespace KChart;
+
+namespace {
+
+// Upper bound for the kept trace events, about 100 MB
+const int maximumTraceEvents = 1000000;
+
+const char* const counterNames[ Instrumentation::CounterCount ] = {
+    "pointsFetched",
+    "pointsCompressed",
+    "primitivesDrawn",
+    "labelsPlaced",
+    "labelsCulled",
+    "cacheHits"
+};
+
+struct Frame
+{
+    const QObject* owner;
+    qint64 start;
+    qint64 counters[ Instrumentation::CounterCount ];
+};
+
+struct TraceEvent
+{
+    const char* stage;
+    const char* className;
+    const void* owner;
+    qint64 start;
+    qint64 duration;
+    qint64 counters[ Instrumentation::CounterCount ];
+};
+
+struct InstrumentationData
+{
+    InstrumentationData()
+        : trace( false )
+    {
+        clock.start();
+    }
+
+    QElapsedTimer clock;
+    QVector< Frame > frames;
+    QHash< const QObject*, Instrumentation::Statistics > statistics;
+    // owners whose destroyed() signal prunes their statistics
+    QSet< const QObject* > watched;
+    // context of these connections, so they go away with this object
+    QObject guard;
+    Instrumentation::Statistics total;
+    bool trace;
+    QVector< TraceEvent > events;
+};
+
+InstrumentationData* data()
+{
+    static InstrumentationData instance;
+    return &instance;
+}
+
+// the statistics of owner, which are dropped when owner is destroyed
+Instrumentation::Statistics& ownerStatistics( InstrumentationData* data, const QObject* owner )
+{
+    if ( owner && !data->watched.contains( owner ) ) {
+        data->watched.insert( owner );
+        QObject::connect( owner, &QObject::destroyed, &data->guard, [ data, owner ]() {
+            data->watched.remove( owner );
+            data->statistics.remove( owner );
+        } );
+    }
+    return data->statistics[ owner ];
+}
+
+}
+
+bool Instrumentation::s_enabled = false;
+
+Instrumentation::Stage::Stage()
+    : calls( 0 ),
+      nsecs( 0 )
+{
+}
+
+Instrumentation::Statistics::Statistics()
+{
+    std::memset( m_counters, 0, sizeof( m_counters ) );
+}
+
+qint64 Instrumentation::Statistics::stageTime( const QByteArray& stage ) const
+{
+    Q_FOREACH( const Stage& s, m_stages ) {
+        if ( s.name == stage )
+            return s.nsecs;
+    }
+    return 0;
+}
+
+int Instrumentation::Statistics::stageCalls( const QByteArray& stage ) const
+{
+    Q_FOREACH( const Stage& s, m_stages ) {
+        if ( s.name == stage )
+            return s.calls;
+    }
+    return 0;
+}
+
+void Instrumentation::setEnabled( bool enabled )
+{
+    s_enabled = enabled;
+}
+
+void Instrumentation::setTraceEnabled( bool enabled )
+{
+    data()->trace = enabled;
+}
+
+bool Instrumentation::isTraceEnabled()
+{
+    return data()->trace;
+}
+
+void Instrumentation::reset()
+{
+    InstrumentationData* const data = ::data();
+    data->statistics.clear();
+    data->total = Statistics();
+    data->events.clear();
+    // stages that are still running keep their place on the stack, but
+    // must not report counts from before the reset
+    for ( int i = 0; i < data->frames.size(); ++i ) {
+        std::memset( data->frames[ i ].counters, 0, sizeof( data->frames[ i ].counters ) );
+    }
+}
+
+Instrumentation::Statistics Instrumentation::statistics( const QObject* owner )
+{
+    return data()->statistics.value( owner );
+}
+
+Instrumentation::Statistics Instrumentation::totalStatistics()
+{
+    return data()->total;
+}
+
+void Instrumentation::begin( const QObject* owner )
+{
+    InstrumentationData* const data = ::data();
+    Frame frame;
+    frame.owner = owner;
+    // the counters of a frame track the totals at its start, so the
+    // counts of the stage are the difference when it ends
+    std::memcpy( frame.counters, data->total.m_counters, sizeof( frame.counters ) );
+    frame.start = data->clock.nsecsElapsed();
+    data->frames.append( frame );
+}
+
+static void addStage( QVector< Instrumentation::Stage >* stages, const char* stage, qint64 nsecs )
+{
+    for ( int i = 0; i < stages->size(); ++i ) {
+        Instrumentation::Stage& s = ( *stages )[ i ];
+        if ( s.name == stage ) {
+            ++s.calls;
+            s.nsecs += nsecs;
+            return;
+        }
+    }
+    Instrumentation::Stage s;
+    s.name = stage;
+    s.calls = 1;
+    s.nsecs = nsecs;
+    stages->append( s );
+}
+
+void Instrumentation::end( const char* stage, const QObject* owner )
+{
+    InstrumentationData* const data = ::data();
+    if ( data->frames.isEmpty() ) {
+        return;
+    }
+    const qint64 now = data->clock.nsecsElapsed();
+    const Frame frame = data->frames.takeLast();
+    Q_ASSERT( frame.owner == owner );
+    const qint64 duration = now - frame.start;
+
+    addStage( &ownerStatistics( data, owner ).m_stages, stage, duration );
+    addStage( &data->total.m_stages, stage, duration );
+
+    if ( data->trace && data->events.size() < maximumTraceEvents ) {
+        TraceEvent event;
+        event.stage = stage;
+        event.className = owner ? owner->metaObject()->className() : "";
+        event.owner = owner;
+        event.start = frame.start;
+        event.duration = duration;
+        for ( int i = 0; i < CounterCount; ++i ) {
+            event.counters[ i ] = data->total.m_counters[ i ] - frame.counters[ i ];
+        }
+        data->events.append( event );
+    }
+}
+
+void Instrumentation::addCount( Counter counter, qint64 n )
+{
+    InstrumentationData* const data = ::data();
+    data->total.m_counters[ counter ] += n;
+    if ( !data->frames.isEmpty() ) {
+        ownerStatistics( data, data->frames.last().owner ).m_counters[ counter ] += n;
+    }
+}
+
+QByteArray Instrumentation::chromeTrace()
+{
+    const InstrumentationData* const data = ::data();
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray events;
+    Q_FOREACH( const TraceEvent& event, data->events ) {
+        QJsonObject args;
+        args.insert( QStringLiteral( "object" ),
+                     QString::fromLatin1( "0x%1" ).arg( quintptr( event.owner ), 0, 16 ) );
+        for ( int i = 0; i < CounterCount; ++i ) {
+            if ( event.counters[ i ] != 0 )
+                args.insert( QLatin1String( counterNames[ i ] ), double( event.counters[ i ] ) );
+        }
+
+        QJsonObject json;
+        json.insert( QStringLiteral( "name" ), QString::fromLatin1( "%1::%2" )
+                     .arg( QLatin1String( event.className ), QLatin1String( event.stage ) ) );
+        json.insert( QStringLiteral( "cat" ), QStringLiteral( "KChart" ) );
+        json.insert( QStringLiteral( "ph" ), QStringLiteral( "X" ) );
+        // trace event timestamps are in microseconds
+        json.insert( QStringLiteral( "ts" ), event.start / 1000.0 );
+        json.insert( QStringLiteral( "dur" ), event.duration / 1000.0 );
+        json.insert( QStringLiteral( "pid" ), double( pid ) );
+        json.insert( QStringLiteral( "tid" ), 1 );
+        json.insert( QStringLiteral( "args" ), args );
+        events.append( json );
+    }
+
+    QJsonObject trace;
+    trace.insert( QStringLiteral( "traceEvents" ), events );
+    trace.insert( QStringLiteral( "displayTimeUnit" ), QStringLiteral( "ms" ) );
+    return QJsonDocument( trace ).toJson( QJsonDocument::Compact );
+}
+
+bool Instrumentation::writeChromeTrace( QIODevice* device )
+{
+    if ( !device ) {
+        return false;
+    }
+    const QByteArray trace = chromeTrace();
+    return device->write( trace ) == trace.size();
+}
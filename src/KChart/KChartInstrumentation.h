@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2026 The KDiagram developers
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KCHARTINSTRUMENTATION_H
+#define KCHARTINSTRUMENTATION_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include "KChartGlobal.h"
+
+/** \file KChartInstrumentation.h
+ *  \brief Declaring the class KChart::Instrumentation.
+ *
+ *
+ */
+
+QT_BEGIN_NAMESPACE
+class QIODevice;
+class QObject;
+QT_END_NAMESPACE
+
+namespace KChart {
+
+/**
+  * \class Instrumentation KChartInstrumentation.h KChartInstrumentation
+  * \brief Instrumentation records timings and counts of the chart rendering pipeline.
+  *
+  * When enabled, Chart, the coordinate planes and the diagrams record how long
+  * each of their paint stages took, together with counts of the work done
+  * inside of them: points fetched from the model, points left after data
+  * compression, primitives drawn, data value labels placed and culled and
+  * compression cache hits. Counts go to the object that owns the innermost
+  * stage running when they occurred; they are kept per object, not per stage.
+  * The time of a stage includes the stages nested inside of it, so the stage
+  * times of an object can add up to more than the time actually spent.
+  *
+  * The results are available per object through statistics(), summed up over
+  * all objects through totalStatistics() and, if tracing is enabled, as a
+  * Chrome trace-event JSON file that can be loaded into chrome://tracing or
+  * other compatible trace viewers. The statistics of an object are discarded
+  * when it is destroyed, its share of totalStatistics() is kept.
+  *
+  * Instrumentation is disabled by default. When disabled, every instrumented
+  * location costs a single test of a static flag.
+  *
+  * \note Instrumentation is not thread safe, it must only be used from the
+  * thread that is painting the charts.
+  */
+class KCHART_EXPORT Instrumentation
+{
+public:
+    enum Counter {
+        PointsFetched,    ///< model values read while filling the compression cache
+        PointsCompressed, ///< data points handed out by the compression cache
+        PrimitivesDrawn,  ///< lines, polygons, rectangles and markers drawn
+        LabelsPlaced,     ///< data value labels that were painted
+        LabelsCulled,     ///< data value labels dropped as invisible or overlapping
+        CacheHits,        ///< data points served from the compression cache
+        CounterCount
+    };
+
+    /**
+      * The accumulated timing of one named stage.
+      */
+    struct KCHART_EXPORT Stage
+    {
+        Stage();
+
+        QByteArray name;
+        int calls;
+        qint64 nsecs;
+    };
+
+    /**
+      * The stage timings and counters recorded for one object, or for all of them.
+      * Stage times include the time of nested stages, counters are not split
+      * up by stage.
+      */
+    class KCHART_EXPORT Statistics
+    {
+    public:
+        Statistics();
+
+        /** \return the stages in the order they were first entered */
+        QVector<Stage> stages() const { return m_stages; }
+        /** \return the total time spent in \a stage in nanoseconds */
+        qint64 stageTime( const QByteArray& stage ) const;
+        /** \return how often \a stage was entered */
+        int stageCalls( const QByteArray& stage ) const;
+        /** \return the value of \a counter */
+        qint64 counter( Counter counter ) const { return m_counters[ counter ]; }
+
+    private:
+        friend class Instrumentation;
+        QVector<Stage> m_stages;
+        qint64 m_counters[ CounterCount ];
+    };
+
+    /**
+      * Records the time from its construction to its destruction as \a stage of \a owner.
+      *
+      * \a stage must point to a string literal, it is stored without copying.
+      */
+    class Scope
+    {
+    public:
+        Scope( const char* stage, const QObject* owner )
+            : m_stage( stage ),
+              m_owner( owner ),
+              m_started( s_enabled )
+        {
+            if ( m_started )
+                begin( owner );
+        }
+        ~Scope()
+        {
+            if ( m_started )
+                end( m_stage, m_owner );
+        }
+
+    private:
+        Q_DISABLE_COPY( Scope )
+        const char* m_stage;
+        const QObject* m_owner;
+        bool m_started;
+    };
+
+    /**
+      * Enables or disables recording. Data recorded so far is kept.
+      */
+    static void setEnabled( bool enabled );
+    static bool isEnabled() { return s_enabled; }
+
+    /**
+      * Enables or disables keeping the individual stage events for chromeTrace().
+      * Tracing only records anything while instrumentation is enabled.
+      * The number of kept events is limited, events beyond the limit are dropped.
+      */
+    static void setTraceEnabled( bool enabled );
+    static bool isTraceEnabled();
+
+    /**
+      * Discards all statistics and trace events recorded so far.
+      */
+    static void reset();
+
+    /**
+      * \return the statistics recorded for \a owner since the last reset(),
+      * or empty statistics if \a owner was destroyed since
+      */
+    static Statistics statistics( const QObject* owner );
+
+    /**
+      * \return the statistics of all objects since the last reset()
+      */
+    static Statistics totalStatistics();
+
+    /**
+      * \return the trace events recorded since the last reset() in the
+      * Chrome trace-event JSON format
+      */
+    static QByteArray chromeTrace();
+
+    /**
+      * Writes chromeTrace() to \a device.
+      * \return true if the complete trace could be written
+      */
+    static bool writeChromeTrace( QIODevice* device );
+
+    /**
+      * Adds \a n to \a counter of the owner of the innermost running stage.
+      */
+    static void count( Counter counter, qint64 n = 1 )
+    {
+        if ( s_enabled )
+            addCount( counter, n );
+    }
+
+private:
+    Instrumentation();
+
+    static void begin( const QObject* owner );
+    static void end( const char* stage, const QObject* owner );
+    static void addCount( Counter counter, qint64 n );
+
+    static bool s_enabled;
+};
+
+}
+
+#endif // KCHARTINSTRUMENTATION_H
@@ -30,12 +30,15 @@
 #include <QFont>
 #include <QGridLayout>
 #include <QPainter>
+#include <QSet>
 #include <QTextTableCell>
 #include <QTextCursor>
 #include <QTextCharFormat>
 #include <QTextDocumentFragment>
 #include <QTimer>
 #include <QAbstractTextDocumentLayout>
+#include <QApplication>
+#include <QWheelEvent>
 #include <QtDebug>
 #include <QLabel>
 
@@ -53,7 +56,12 @@ Legend::Private::Private() :
     titleText( QObject::tr( "Legend" ) ),
     spacing( 1 ),
     useAutomaticMarkerSize( true ),
-    legendStyle( MarkersOnly )
+    legendStyle( MarkersOnly ),
+    maximumVisibleEntries( 0 ),
+    firstVisibleEntry( 0 ),
+    wheelDelta( 0 ),
+    entriesLabelFontSize( 0.0 ),
+    entriesTitleFontSize( 0.0 )
 {
     // By default we specify a simple, hard point as the 'relative' position's ref. point,
     // since we can not be sure that there will be any parent specified for the legend.
@@ -97,6 +105,9 @@ void Legend::init()
 {
     setSizePolicy( QSizePolicy::Fixed, QSizePolicy::Fixed );
 
+    // a cloned Private must not reuse the items owned by the original legend's layout
+    d->entries.clear();
+
     d->layout = new QGridLayout( this );
     d->layout->setMargin( 2 );
     d->layout->setSpacing( d->spacing );
@@ -233,7 +244,8 @@ bool Legend::compare( const Legend* other ) const
             (titleText()              == other->titleText())&&
             (titleTextAttributes()    == other->titleTextAttributes()) &&
             (spacing()                == other->spacing()) &&
-            (legendStyle()            == other->legendStyle());
+            (legendStyle()            == other->legendStyle()) &&
+            (maximumVisibleEntries()  == other->maximumVisibleEntries());
 }
 
 
@@ -777,6 +789,75 @@ uint Legend::spacing() const
     return d->spacing;
 }
 
+void Legend::setMaximumVisibleEntries( int count )
+{
+    count = qMax( 0, count );
+    if ( d->maximumVisibleEntries == count ) {
+        return;
+    }
+    d->maximumVisibleEntries = count;
+    setNeedRebuild();
+}
+
+int Legend::maximumVisibleEntries() const
+{
+    return d->maximumVisibleEntries;
+}
+
+void Legend::setFirstVisibleEntry( int entry )
+{
+    entry = qMax( 0, entry );
+    if ( d->firstVisibleEntry == entry ) {
+        return;
+    }
+    d->firstVisibleEntry = entry;
+    if ( d->maximumVisibleEntries ) {
+        setNeedRebuild();
+    }
+}
+
+int Legend::firstVisibleEntry() const
+{
+    return d->firstVisibleEntry;
+}
+
+int Legend::entryCount() const
+{
+    return d->modelLabels.count();
+}
+
+void Legend::showNextEntries()
+{
+    setFirstVisibleEntry( qMin( d->firstVisibleEntry + d->maximumVisibleEntries,
+                                qMax( 0, entryCount() - d->maximumVisibleEntries ) ) );
+}
+
+void Legend::showPreviousEntries()
+{
+    setFirstVisibleEntry( d->firstVisibleEntry - d->maximumVisibleEntries );
+}
+
+void Legend::wheelEvent( QWheelEvent* event )
+{
+    if ( !d->maximumVisibleEntries || entryCount() <= d->maximumVisibleEntries ) {
+        AbstractAreaWidget::wheelEvent( event );
+        return;
+    }
+    // High resolution wheels and touchpads send fractions of a step
+    const int delta = event->angleDelta().y();
+    if ( delta != 0 && ( delta < 0 ) != ( d->wheelDelta < 0 ) ) {
+        d->wheelDelta = 0;
+    }
+    d->wheelDelta += delta;
+    const int steps = d->wheelDelta / 120;
+    d->wheelDelta -= steps * 120;
+    if ( steps ) {
+        setFirstVisibleEntry( qBound( 0, d->firstVisibleEntry - steps * QApplication::wheelScrollLines(),
+                                      entryCount() - d->maximumVisibleEntries ) );
+    }
+    event->accept();
+}
+
 void Legend::setDefaultColors()
 {
     Palette pal = Palette::defaultPalette();
@@ -819,7 +900,12 @@ void Legend::resizeEvent( QResizeEvent * event )
 #ifdef DEBUG_LEGEND_PAINT
     qDebug() << "Legend::resizeEvent() called";
 #endif
-    forceRebuild();
+    // Resizing the reference area can change the font sizes and with them the marker sizes;
+    // otherwise the existing items only need to be re-flowed, which resizeLayout() does.
+    if ( d->entries.isEmpty() || d->labelFontSize() != d->entriesLabelFontSize
+         || d->titleFontSize() != d->entriesTitleFontSize ) {
+        forceRebuild();
+    }
     sizeHint();
     QTimer::singleShot( 0, this, SLOT(emitPositionChanged()) );
 }
@@ -868,11 +954,11 @@ QSizeF Legend::Private::markerSize( Legend *q, int dataset, qreal fontHeight ) c
     }
 }
 
-QSizeF Legend::Private::maxMarkerSize( Legend *q, qreal fontHeight ) const
+QSizeF Legend::Private::maxMarkerSize( Legend *q, qreal fontHeight, int first, int count ) const
 {
     QSizeF ret( 1.0, 1.0 );
     if ( q->legendStyle() != LinesOnly ) {
-        for ( int dataset = 0; dataset < modelLabels.count(); ++dataset ) {
+        for ( int dataset = first; dataset < first + count; ++dataset ) {
             ret = ret.expandedTo( markerSize( q, dataset, fontHeight ) );
         }
     }
@@ -886,6 +972,31 @@ HDatasetItem::HDatasetItem()
      spacer(nullptr)
 {}
 
+LegendEntry::LegendEntry()
+   : markerLine(nullptr),
+     label(nullptr),
+     diagram(nullptr),
+     legendStyle(Legend::MarkersOnly),
+     lineLength(0),
+     measureOrientation(KChartEnums::MeasureOrientationMinimum)
+{}
+
+KChartEnums::MeasureOrientation Legend::Private::measureOrientation() const
+{
+    return orientation == Qt::Vertical ? KChartEnums::MeasureOrientationMinimum
+                                       : KChartEnums::MeasureOrientationHorizontal;
+}
+
+qreal Legend::Private::labelFontSize() const
+{
+    return textAttributes.calculatedFontSize( referenceArea, measureOrientation() );
+}
+
+qreal Legend::Private::titleFontSize() const
+{
+    return titleTextAttributes.calculatedFontSize( referenceArea, measureOrientation() );
+}
+
 static void updateToplevelLayout(QWidget *w)
 {
     while ( w ) {
@@ -919,9 +1030,7 @@ void Legend::buildLegend()
 
     d->fetchPaintOptions( this );
 
-    const KChartEnums::MeasureOrientation measureOrientation =
-        orientation() == Qt::Vertical ? KChartEnums::MeasureOrientationMinimum
-                                      : KChartEnums::MeasureOrientationHorizontal;
+    const KChartEnums::MeasureOrientation measureOrientation = d->measureOrientation();
 
     // legend caption
     if ( !titleText().isEmpty() && titleTextAttributes().isVisible() ) {
@@ -941,7 +1050,9 @@ void Legend::buildLegend()
         }
     }
 
-    qreal fontHeight = textAttributes().calculatedFontSize( referenceArea(), measureOrientation );
+    d->entriesLabelFontSize = d->labelFontSize();
+    d->entriesTitleFontSize = d->titleFontSize();
+    qreal fontHeight = d->entriesLabelFontSize;
     {
         QFont tmpFont = textAttributes().font();
         tmpFont.setPointSizeF( fontHeight );
@@ -952,7 +1063,18 @@ void Legend::buildLegend()
         }
     }
 
-    const QSizeF maxMarkerSize = d->maxMarkerSize( this, fontHeight );
+    // with a limited number of visible entries, only the entries in that window get layout items;
+    // the others are neither measured nor laid out
+    const int entryCount = d->modelLabels.count();
+    int firstEntry = 0;
+    int windowCount = entryCount;
+    if ( d->maximumVisibleEntries && entryCount > d->maximumVisibleEntries ) {
+        windowCount = d->maximumVisibleEntries;
+        d->firstVisibleEntry = qBound( 0, d->firstVisibleEntry, entryCount - windowCount );
+        firstEntry = d->firstVisibleEntry;
+    }
+
+    const QSizeF maxMarkerSize = d->maxMarkerSize( this, fontHeight, firstEntry, windowCount );
 
     // If we show a marker on a line, we paint it after 8 pixels
     // of the line have been painted. This allows to see the line style
@@ -964,7 +1086,7 @@ void Legend::buildLegend()
     int maxLineLength = 18;
     {
         bool hasComplexPenStyle = false;
-        for ( int dataset = 0; dataset < d->modelLabels.count(); ++dataset ) {
+        for ( int dataset = firstEntry; dataset < firstEntry + windowCount; ++dataset ) {
             const QPen pn = pen( dataset );
             const Qt::PenStyle ps = pn.style();
             if ( ps != Qt::NoPen ) {
@@ -983,9 +1105,15 @@ void Legend::buildLegend()
 
     // for all datasets: add (line)marker items and text items to the layout;
     // actual layout happens in flowHDatasetItems() for horizontal layout, here for vertical
-    for ( int dataset = 0; dataset < d->modelLabels.count(); ++dataset ) {
-        const int vLayoutRow = 2 + dataset * 2;
+    // entries beyond the current window size will not be reused
+    d->destroyEntries( windowCount );
+    d->entries.resize( windowCount );
+
+    for ( int i = 0; i < windowCount; ++i ) {
+        const int dataset = firstEntry + i;
+        const int vLayoutRow = 2 + i * 2;
         HDatasetItem dsItem;
+        LegendEntry &entry = d->entries[ i ];
 
         // It is possible to set the marker brush through markerAttributes as well as
         // the dataset brush set in the diagram - the markerAttributes have higher precedence.
@@ -993,28 +1121,63 @@ void Legend::buildLegend()
         markerAttrs.setMarkerSize( d->markerSize( this, dataset, fontHeight ) );
         const QBrush markerBrush = markerAttrs.markerColor().isValid() ?
                                    QBrush( markerAttrs.markerColor() ) : brush( dataset );
+        const QPen datasetPen = pen( dataset );
+
+        // only (re)create the marker if something it was created from has changed
+        if ( !entry.markerLine || entry.diagram != diagram() || entry.legendStyle != legendStyle() ||
+             entry.markerAttributes != markerAttrs || entry.markerBrush != markerBrush ||
+             entry.pen != datasetPen || entry.lineLength != maxLineLength ||
+             entry.lineSymbolAlignment != d->legendLineSymbolAlignment ) {
+            delete entry.markerLine;
+            entry.markerLine = nullptr;
+            switch ( legendStyle() ) {
+            case MarkersOnly:
+                entry.markerLine = new MarkerLayoutItem( diagram(), markerAttrs, markerBrush,
+                                                         markerAttrs.pen(), Qt::AlignLeft | Qt::AlignVCenter );
+                break;
+            case LinesOnly:
+                entry.markerLine = new LineLayoutItem( diagram(), maxLineLength, datasetPen,
+                                                       d->legendLineSymbolAlignment, Qt::AlignCenter );
+                break;
+            case MarkersAndLines:
+                entry.markerLine = new LineWithMarkerLayoutItem(
+                    diagram(), maxLineLength, datasetPen, lineLengthLeftOfMarker, markerAttrs,
+                    markerBrush, markerAttrs.pen(), Qt::AlignCenter );
+                break;
+            default:
+                Q_ASSERT( false );
+            }
+            entry.diagram = diagram();
+            entry.legendStyle = legendStyle();
+            entry.markerAttributes = markerAttrs;
+            entry.markerBrush = markerBrush;
+            entry.pen = datasetPen;
+            entry.lineLength = maxLineLength;
+            entry.lineSymbolAlignment = d->legendLineSymbolAlignment;
+        }
 
-        switch ( legendStyle() ) {
-        case MarkersOnly:
-            dsItem.markerLine = new MarkerLayoutItem( diagram(), markerAttrs, markerBrush,
-                                                      markerAttrs.pen(), Qt::AlignLeft | Qt::AlignVCenter );
-            break;
-        case LinesOnly:
-            dsItem.markerLine = new LineLayoutItem( diagram(), maxLineLength, pen( dataset ),
-                                                    d->legendLineSymbolAlignment, Qt::AlignCenter );
-            break;
-        case MarkersAndLines:
-            dsItem.markerLine = new LineWithMarkerLayoutItem(
-                diagram(), maxLineLength, pen( dataset ), lineLengthLeftOfMarker, markerAttrs,
-                markerBrush, markerAttrs.pen(), Qt::AlignCenter );
-            break;
-        default:
-            Q_ASSERT( false );
+        // the label is updated in place, which only re-measures it if its text or attributes changed
+        if ( !entry.label || entry.measureOrientation != measureOrientation ) {
+            delete entry.label;
+            entry.label = new TextLayoutItem( text( dataset ), textAttributes(), referenceArea(),
+                                              measureOrientation, d->textAlignment );
+            entry.label->setParentWidget( this );
+            entry.measureOrientation = measureOrientation;
+        } else {
+            if ( entry.label->autoReferenceArea() != referenceArea() ) {
+                entry.label->setAutoReferenceArea( referenceArea() );
+            }
+            if ( entry.label->textAttributes() != textAttributes() ) {
+                entry.label->setTextAttributes( textAttributes() );
+            }
+            if ( entry.label->text() != text( dataset ) ) {
+                entry.label->setText( text( dataset ) );
+            }
+            entry.label->setTextAlignment( d->textAlignment );
         }
 
-        dsItem.label = new TextLayoutItem( text( dataset ), textAttributes(), referenceArea(),
-                                           measureOrientation, d->textAlignment );
-        dsItem.label->setParentWidget( this );
+        dsItem.markerLine = entry.markerLine;
+        dsItem.label = entry.label;
 
         // horizontal layout is deferred to flowDatasetItems()
 
@@ -1032,7 +1195,7 @@ void Legend::buildLegend()
         d->paintItems << dsItem.label;
 
         // horizontal separator line, only between items
-        if ( showLines() && dataset != d->modelLabels.count() - 1 ) {
+        if ( showLines() && i != windowCount - 1 ) {
             HorizontalLineLayoutItem* lineItem = new HorizontalLineLayoutItem;
             d->layout->addItem( lineItem, vLayoutRow + 1, 0, 1, 5, Qt::AlignCenter );
             d->paintItems << lineItem;
@@ -1044,10 +1207,21 @@ void Legend::buildLegend()
     }
 
     // vertical line (only in vertical mode)
-    if ( orientation() == Qt::Vertical && showLines() && d->modelLabels.count() ) {
+    if ( orientation() == Qt::Vertical && showLines() && windowCount ) {
         VerticalLineLayoutItem* lineItem = new VerticalLineLayoutItem;
         d->paintItems << lineItem;
-        d->layout->addItem( lineItem, 2, 2, d->modelLabels.count() * 2, 1 );
+        d->layout->addItem( lineItem, 2, 2, windowCount * 2, 1 );
+    }
+
+    // position of the window of visible entries, below the entries
+    if ( windowCount < entryCount ) {
+        TextLayoutItem* pageItem =
+            new TextLayoutItem( tr( "%1-%2 of %3" ).arg( firstEntry + 1 ).arg( firstEntry + windowCount )
+                                                    .arg( entryCount ),
+                                textAttributes(), referenceArea(), measureOrientation, Qt::AlignCenter );
+        pageItem->setParentWidget( this );
+        d->paintItems << pageItem;
+        d->layout->addItem( pageItem, 2 + windowCount * 2, 0, 1, 5, Qt::AlignCenter );
     }
 
     updateToplevelLayout( this );
@@ -1219,21 +1393,53 @@ int Legend::heightForWidth( int width ) const
         currentLineHeight = qMax( currentLineHeight, hdsItem.height() );
     }
     ret += currentLineHeight; // one less spacings than lines
+    // the position of the window of visible entries, if not all of them are shown
+    if ( QLayoutItem *item = d->layout->itemAtPosition( 2 + d->hLayoutDatasets.count() * 2, 0 ) ) {
+        ret += spacing() + item->sizeHint().height();
+    }
     return ret;
 }
 
 void Legend::Private::destroyOldLayout()
 {
-    // in the horizontal layout case, the QHBoxLayout destructor also deletes child layout items
-    // (it isn't documented that QLayoutItems delete their children)
+    // the marker and label items of the entries are kept for reuse, everything else is deleted.
+    // in the horizontal layout case, the QHBoxLayout destructor would also delete child layout items
+    // (it isn't documented that QLayoutItems delete their children), so take those out first.
+    QSet< QLayoutItem* > entryItems;
+    Q_FOREACH( const LegendEntry &entry, entries ) {
+        entryItems << entry.markerLine << entry.label;
+    }
     for ( int i = layout->count() - 1; i >= 0; i-- ) {
-        delete layout->takeAt( i );
+        QLayoutItem *const item = layout->takeAt( i );
+        if ( QLayout *const hbox = item->layout() ) {
+            for ( int j = hbox->count() - 1; j >= 0; j-- ) {
+                QLayoutItem *const child = hbox->takeAt( j );
+                if ( !entryItems.contains( child ) ) {
+                    delete child;
+                }
+            }
+        }
+        if ( !entryItems.contains( item ) ) {
+            delete item;
+        }
     }
     Q_ASSERT( !layout->count() );
     hLayoutDatasets.clear();
     paintItems.clear();
 }
 
+void Legend::Private::destroyEntries( int first )
+{
+    // only call this while the entries' items are not in the layout
+    for ( int i = first; i < entries.count(); i++ ) {
+        delete entries[ i ].markerLine;
+        delete entries[ i ].label;
+    }
+    if ( first < entries.count() ) {
+        entries.resize( first );
+    }
+}
+
 void Legend::setHiddenDatasets( const QList<uint> hiddenDatasets )
 {
     d->hiddenDatasets = hiddenDatasets;
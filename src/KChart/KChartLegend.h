@@ -379,6 +379,38 @@ m_legend->setFloatingPosition( relativePosition );
     void setSpacing( uint space );
     uint spacing() const;
 
+    /**
+     * Limits the number of entries shown at a time to \a count. The legend
+     * then shows a window onto its entries, which can be moved with
+     * setFirstVisibleEntry(), the paging slots or the mouse wheel.
+     *
+     * Layout items are only created and measured for the entries inside the
+     * window, so sizing and painting the legend cost the same no matter how
+     * many datasets there are.
+     *
+     * The default of 0 shows all entries.
+     *
+     * \sa setFirstVisibleEntry, showNextEntries, showPreviousEntries
+     */
+    void setMaximumVisibleEntries( int count );
+    int maximumVisibleEntries() const;
+
+    /**
+     * Moves the window of visible entries so that it starts at \a entry.
+     * Entries are counted in legend order, skipping hidden datasets. The
+     * value is clamped so that the window stays filled.
+     *
+     * This has no effect unless setMaximumVisibleEntries() limits the window.
+     */
+    void setFirstVisibleEntry( int entry );
+    int firstVisibleEntry() const;
+
+    /**
+     * Returns the number of entries of the legend, including those outside
+     * of the window of visible entries, as of the last time it was laid out.
+     */
+    int entryCount() const;
+
     // called internally by KChart::Chart, when painting into a custom QPainter
     void forceRebuild() Q_DECL_OVERRIDE;
 
@@ -389,6 +421,15 @@ m_legend->setFloatingPosition( relativePosition );
     void needSizeHint() Q_DECL_OVERRIDE;
     void resizeLayout( const QSize& size ) Q_DECL_OVERRIDE;
 
+public Q_SLOTS:
+    /** Moves the window of visible entries forward by one page. \sa setMaximumVisibleEntries */
+    void showNextEntries();
+    /** Moves the window of visible entries back by one page. \sa setMaximumVisibleEntries */
+    void showPreviousEntries();
+
+protected:
+    void wheelEvent( QWheelEvent* event ) Q_DECL_OVERRIDE;
+
 Q_SIGNALS:
     void destroyedLegend( Legend* );
     /** Emitted upon change of a property of the Legend or any of its components. */
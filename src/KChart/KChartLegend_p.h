@@ -67,6 +67,27 @@ struct HDatasetItem
     QSpacerItem *spacer;
 };
 
+/*
+ * The marker and label of one legend entry, together with what they were created from. They are
+ * kept across buildLegend() calls so that only entries that actually changed get new items.
+ */
+struct LegendEntry
+{
+    LegendEntry();
+
+    AbstractLayoutItem *markerLine;
+    TextLayoutItem *label;
+
+    AbstractDiagram *diagram;
+    Legend::LegendStyle legendStyle;
+    MarkerAttributes markerAttributes;
+    QBrush markerBrush;
+    QPen pen;
+    int lineLength;
+    Qt::Alignment lineSymbolAlignment;
+    KChartEnums::MeasureOrientation measureOrientation;
+};
+
 class DiagramsObserversList : public QList<DiagramObserver*> {};
 
 /**
@@ -91,10 +112,14 @@ public:
 
     void fetchPaintOptions( Legend *q );
     QSizeF markerSize( Legend *q, int dataset, qreal fontHeight ) const;
-    QSizeF maxMarkerSize( Legend *q, qreal fontHeight ) const;
+    QSizeF maxMarkerSize( Legend *q, qreal fontHeight, int first, int count ) const;
     void reflowHDatasetItems( Legend *q );
     void flowHDatasetItems( Legend *q );
     void destroyOldLayout();
+    void destroyEntries( int first );
+    KChartEnums::MeasureOrientation measureOrientation() const;
+    qreal labelFontSize() const;
+    qreal titleFontSize() const;
 
 private:
     // user-settable
@@ -118,6 +143,10 @@ private:
     uint spacing;
     bool useAutomaticMarkerSize;
     LegendStyle legendStyle;
+    int maximumVisibleEntries;
+    int firstVisibleEntry;
+    // angle delta of wheel events not scrolled by yet, less than one step
+    int wheelDelta;
 
     // internal
     mutable QStringList modelLabels;
@@ -128,6 +157,10 @@ private:
     QVector< AbstractLayoutItem* > paintItems;
     QGridLayout* layout;
     QList< HDatasetItem > hLayoutDatasets;
+    QVector< LegendEntry > entries;
+    // font sizes the entries were built with; while they are unchanged, resizing only re-flows
+    qreal entriesLabelFontSize;
+    qreal entriesTitleFontSize;
     DiagramsObserversList observers;
 };
 
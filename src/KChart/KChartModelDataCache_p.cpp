@@ -21,19 +21,20 @@
 
 #include <limits>
 
-using namespace KChart::ModelDataCachePrivate;
+#include <QHash>
 
-ModelSignalMapperConnector::ModelSignalMapperConnector( ModelSignalMapper& mapper )
-    : QObject( nullptr ),
-      m_mapper( mapper )
-{
-}
+using namespace KChart::ModelDataCachePrivate;
 
-ModelSignalMapperConnector::~ModelSignalMapperConnector()
+// the connectors of all models that have caches
+static QHash< QAbstractItemModel*, ModelSignalMapperConnector* >& connectors()
 {
+    static QHash< QAbstractItemModel*, ModelSignalMapperConnector* > s_connectors;
+    return s_connectors;
 }
 
-void ModelSignalMapperConnector::connectSignals( QAbstractItemModel* model )
+ModelSignalMapperConnector::ModelSignalMapperConnector( QAbstractItemModel* model )
+    : QObject( nullptr ),
+      m_model( model )
 {
     connect( model, SIGNAL(destroyed()),                              this, SLOT(resetModel()) );
     connect( model, SIGNAL(columnsInserted(QModelIndex,int,int)), this, SLOT(columnsInserted(QModelIndex,int,int)) );
@@ -45,54 +46,79 @@ void ModelSignalMapperConnector::connectSignals( QAbstractItemModel* model )
     connect( model, SIGNAL(rowsRemoved(QModelIndex,int,int)),     this, SLOT(rowsRemoved(QModelIndex,int,int)) );
 }
 
-void ModelSignalMapperConnector::disconnectSignals( QAbstractItemModel* model )
+ModelSignalMapperConnector::~ModelSignalMapperConnector()
+{
+    // the signals are disconnected by QObject
+    if ( m_model != nullptr )
+        connectors().remove( m_model );
+}
+
+ModelSignalMapperConnector* ModelSignalMapperConnector::attach( QAbstractItemModel* model, ModelSignalMapper* mapper )
+{
+    if ( model == nullptr )
+        return nullptr;
+
+    ModelSignalMapperConnector*& connector = connectors()[ model ];
+    if ( connector == nullptr )
+        connector = new ModelSignalMapperConnector( model );
+    connector->m_mappers.append( mapper );
+    return connector;
+}
+
+void ModelSignalMapperConnector::detach( ModelSignalMapper* mapper )
 {
-    disconnect( model, SIGNAL(destroyed()),                              this, SLOT(resetModel()) );
-    disconnect( model, SIGNAL(columnsInserted(QModelIndex,int,int)), this, SLOT(columnsInserted(QModelIndex,int,int)) );
-    disconnect( model, SIGNAL(columnsRemoved(QModelIndex,int,int)),  this, SLOT(columnsRemoved(QModelIndex,int,int)) );
-    disconnect( model, SIGNAL(dataChanged(QModelIndex,QModelIndex)),  this, SLOT(dataChanged(QModelIndex,QModelIndex)) );
-    disconnect( model, SIGNAL(layoutChanged()),                          this, SLOT(layoutChanged()) );
-    disconnect( model, SIGNAL(modelReset()),                             this, SLOT(modelReset()) );
-    disconnect( model, SIGNAL(rowsInserted(QModelIndex,int,int)),    this, SLOT(rowsInserted(QModelIndex,int,int)) );
-    disconnect( model, SIGNAL(rowsRemoved(QModelIndex,int,int)),     this, SLOT(rowsRemoved(QModelIndex,int,int)) );
+    m_mappers.removeOne( mapper );
+    if ( m_mappers.isEmpty() )
+        delete this;
 }
 
 void ModelSignalMapperConnector::resetModel()
 {
-    m_mapper.resetModel();
+    // the model is gone, a new one at the same address needs a connector of its own
+    connectors().remove( m_model );
+    m_model = nullptr;
+    Q_FOREACH( ModelSignalMapper* mapper, m_mappers )
+        mapper->resetModel();
 }
 
 void ModelSignalMapperConnector::columnsInserted( const QModelIndex& parent, int start, int end )
 {
-    m_mapper.columnsInserted( parent, start, end );
+    Q_FOREACH( ModelSignalMapper* mapper, m_mappers )
+        mapper->columnsInserted( parent, start, end );
 }
 
 void ModelSignalMapperConnector::columnsRemoved( const QModelIndex& parent, int start, int end )
 {
-    m_mapper.columnsRemoved( parent, start, end );
+    Q_FOREACH( ModelSignalMapper* mapper, m_mappers )
+        mapper->columnsRemoved( parent, start, end );
 }
 
 void ModelSignalMapperConnector::dataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight )
 {
-    m_mapper.dataChanged( topLeft, bottomRight );
+    Q_FOREACH( ModelSignalMapper* mapper, m_mappers )
+        mapper->dataChanged( topLeft, bottomRight );
 }
 
 void ModelSignalMapperConnector::layoutChanged()
 {
-    m_mapper.layoutChanged();
+    Q_FOREACH( ModelSignalMapper* mapper, m_mappers )
+        mapper->layoutChanged();
 }
 
 void ModelSignalMapperConnector::modelReset()
 {
-    m_mapper.modelReset();
+    Q_FOREACH( ModelSignalMapper* mapper, m_mappers )
+        mapper->modelReset();
 }
 
 void ModelSignalMapperConnector::rowsInserted( const QModelIndex& parent, int start, int end )
 {
-    m_mapper.rowsInserted( parent, start, end );
+    Q_FOREACH( ModelSignalMapper* mapper, m_mappers )
+        mapper->rowsInserted( parent, start, end );
 }
 
 void ModelSignalMapperConnector::rowsRemoved( const QModelIndex& parent, int start, int end )
 {
-    m_mapper.rowsRemoved( parent, start, end );
+    Q_FOREACH( ModelSignalMapper* mapper, m_mappers )
+        mapper->rowsRemoved( parent, start, end );
 }
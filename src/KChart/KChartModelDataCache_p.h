@@ -20,13 +20,16 @@
 #ifndef KCHARTMODELDATACACHE_H
 #define KCHARTMODELDATACACHE_H
 
+#include <cmath>
 #include <limits>
 
 #include <QObject>
 #include <QModelIndex>
+#include <QPointer>
 #include <QVector>
 
 #include "kchart_export.h"
+#include "KChartAttributesModel.h"
 
 QT_BEGIN_NAMESPACE
 class QAbstractItemModel;
@@ -52,16 +55,18 @@ namespace KChart
             virtual void rowsRemoved( const QModelIndex&, int, int ) = 0;
         };
 
-        // this class maps slots to a non-QObject instantiating ModelSignalMapper
+        // this class maps slots to non-QObject instantiating ModelSignalMappers
+        // there is one connector per model, shared by all caches of that model; it connects
+        // when the first cache is created, so the caches are up to date before any
+        // diagram that connected to the model later handles a signal
         class KCHART_EXPORT ModelSignalMapperConnector : public QObject
         {
             Q_OBJECT
         public:
-            explicit ModelSignalMapperConnector( ModelSignalMapper& mapper );
-            ~ModelSignalMapperConnector();
-
-            void connectSignals( QAbstractItemModel* model );
-            void disconnectSignals( QAbstractItemModel* model );
+            // adds mapper to the connector of model, which is created if needed
+            static ModelSignalMapperConnector* attach( QAbstractItemModel* model, ModelSignalMapper* mapper );
+            // removes mapper, the connector deletes itself when no mapper is left
+            void detach( ModelSignalMapper* mapper );
 
         protected Q_SLOTS:
             void resetModel();
@@ -74,7 +79,11 @@ namespace KChart
             void rowsRemoved( const QModelIndex&, int, int );
 
         private:
-            ModelSignalMapper& m_mapper;
+            explicit ModelSignalMapperConnector( QAbstractItemModel* model );
+            ~ModelSignalMapperConnector();
+
+            QAbstractItemModel* m_model;
+            QVector< ModelSignalMapper* > m_mappers;
         };
 
         template< class T>
@@ -88,82 +97,295 @@ namespace KChart
         {
             return std::numeric_limits< qreal >::quiet_NaN();
         }
+
+        template< class T >
+        bool isNan( const T& )
+        {
+            return false;
+        }
+
+        template<>
+        inline bool isNan< qreal >( const qreal& value )
+        {
+            return std::isnan( value );
+        }
+
+        // the cached data of one (source model, root index, role), shared by all ModelDataCaches
+        // showing it, so that it is fetched only once
+        // the caches forward the signals of the models they were given, which may be different
+        // AttributesModels of the source model; every change is applied by the first cache that
+        // forwards it, and ignored when the others forward it again
+        template< class T, int ROLE >
+        class SharedModelData
+        {
+        public:
+            static SharedModelData* attach( QAbstractItemModel* model, const QModelIndex& rootIndex )
+            {
+                QVector< SharedModelData* >& all = instances();
+                for ( int i = 0; i < all.count(); ++i )
+                {
+                    SharedModelData* shared = all.at( i );
+                    if ( shared->m_model.data() == model && shared->m_rootIndex == rootIndex )
+                    {
+                        ++shared->m_refCount;
+                        return shared;
+                    }
+                }
+                SharedModelData* shared = new SharedModelData( model, rootIndex );
+                all.append( shared );
+                return shared;
+            }
+
+            void detach()
+            {
+                Q_ASSERT( m_refCount > 0 );
+                if ( --m_refCount == 0 )
+                {
+                    instances().removeOne( this );
+                    delete this;
+                }
+            }
+
+            // like data( row, column ), but checks the bounds against the model
+            T checkedData( int row, int column ) const
+            {
+                if ( m_model.isNull() || row < 0 || column < 0
+                     || row >= m_model->rowCount( m_rootIndex ) || column >= m_model->columnCount( m_rootIndex ) )
+                    return ModelDataCachePrivate::nan< T >();
+
+                if ( row >= m_data.count() )
+                {
+                    qWarning( "KChart didn't receive signal rowsInserted, resetModel or layoutChanged, "
+                              "but an index with a row outside of the known bounds." );
+
+                    // apparently, data were added behind our back (w/o signals)
+                    const_cast< SharedModelData< T, ROLE >* >( this )->rowsInserted( m_data.count(),
+                                                                                     m_model->rowCount( m_rootIndex ) - 1 );
+                    Q_ASSERT( row < m_data.count() );
+                }
+
+                if ( column >= m_columnCount )
+                {
+                    qWarning( "KChart didn't got signal columnsInserted, resetModel or layoutChanged, "
+                              "but an index with a column outside of the known bounds." );
+
+                    // apparently, data were added behind our back (w/o signals)
+                    const_cast< SharedModelData< T, ROLE >* >( this )->columnsInserted( m_columnCount,
+                                                                                        m_model->columnCount( m_rootIndex ) - 1 );
+                    Q_ASSERT( column < m_columnCount );
+                }
+
+                return data( row, column );
+            }
+
+            T data( int row, int column ) const
+            {
+                if ( row < 0 || column < 0 || m_model.isNull() )
+                    return ModelDataCachePrivate::nan< T >();
+
+                Q_ASSERT( row < m_model->rowCount(m_rootIndex) );
+                Q_ASSERT( column < m_model->columnCount(m_rootIndex) );
+
+                Q_ASSERT( row < m_data.count() );
+                Q_ASSERT( column < m_columnCount );
+
+                if ( isCached( row, column ) )
+                    return m_data.at( row ).at( column );
+
+                return fetchFromModel( row, column, ROLE );
+            }
+
+            QAbstractItemModel* model() const
+            {
+                return m_model.data();
+            }
+
+            QModelIndex rootIndex() const
+            {
+                return m_rootIndex;
+            }
+
+            // the changes below are in rows and columns of model() below rootIndex()
+
+            void columnsInserted( int start, int end )
+            {
+                const int count = end - start + 1;
+                if ( m_model.isNull() || start > m_columnCount
+                     || m_columnCount + count != m_model->columnCount( m_rootIndex ) )
+                    return; // already applied
+
+                const int rowCount = m_data.count();
+                for ( int row = 0; row < rowCount; ++row )
+                {
+                    m_data[ row ].insert( start, count, T() );
+                    m_cacheValid[ row ].insert( start, count, false );
+                }
+                m_columnCount += count;
+            }
+
+            void columnsRemoved( int start, int end )
+            {
+                const int count = end - start + 1;
+                if ( m_model.isNull() || end >= m_columnCount
+                     || m_columnCount - count != m_model->columnCount( m_rootIndex ) )
+                    return; // already applied
+
+                const int rowCount = m_data.count();
+                for ( int row = 0; row < rowCount; ++row )
+                {
+                    m_data[ row ].remove( start, count );
+                    m_cacheValid[ row ].remove( start, count );
+                }
+                m_columnCount -= count;
+            }
+
+            void dataChanged( int top, int left, int bottom, int right )
+            {
+                // invalidating twice does no harm
+                const int maxRow = qMin( bottom, m_data.count() - 1 );
+                const int maxCol = qMin( right, m_columnCount - 1 );
+                for ( int row = qMax( 0, top ); row <= maxRow; ++row )
+                {
+                    for ( int col = qMax( 0, left ); col <= maxCol; ++col )
+                    {
+                        m_cacheValid[ row ][ col ] = false;
+                        Q_ASSERT( !isCached( row, col ) );
+                    }
+                }
+            }
+
+            void rowsInserted( int start, int end )
+            {
+                const int count = end - start + 1;
+                if ( m_model.isNull() || start > m_data.count()
+                     || m_data.count() + count != m_model->rowCount( m_rootIndex ) )
+                    return; // already applied
+
+                m_data.insert( start, count, QVector< T >( m_columnCount ) );
+                m_cacheValid.insert( start, count, QVector< bool >( m_columnCount, false ) );
+            }
+
+            void rowsRemoved( int start, int end )
+            {
+                const int count = end - start + 1;
+                if ( m_model.isNull() || end >= m_data.count()
+                     || m_data.count() - count != m_model->rowCount( m_rootIndex ) )
+                    return; // already applied
+
+                m_data.remove( start, count );
+                m_cacheValid.remove( start, count );
+            }
+
+            void reset()
+            {
+                m_data.clear();
+                m_cacheValid.clear();
+                m_columnCount = 0;
+
+                if ( m_model.isNull() )
+                    return;
+
+                m_columnCount = m_model->columnCount( m_rootIndex );
+                m_data.fill( QVector< T >( m_columnCount ), m_model->rowCount( m_rootIndex ) );
+                m_cacheValid.fill( QVector< bool >( m_columnCount, false ), m_model->rowCount( m_rootIndex ) );
+            }
+
+        protected:
+            SharedModelData( QAbstractItemModel* model, const QModelIndex& rootIndex )
+                : m_model( model ),
+                  m_rootIndex( rootIndex ),
+                  m_refCount( 1 ),
+                  m_columnCount( 0 )
+            {
+                reset();
+            }
+
+            bool isCached( int row, int column ) const
+            {
+                return m_cacheValid.at( row ).at( column );
+            }
+
+            T fetchFromModel( int row, int column, int role ) const
+            {
+                Q_ASSERT( !m_model.isNull() );
+
+                const QModelIndex index = m_model->index( row, column, m_rootIndex );
+                const QVariant data = index.data( role );
+                const T value = data.isNull() ? ModelDataCachePrivate::nan< T >()
+                                              : ( data.value< T >() );
+
+                m_data[ row ][ column ] = value;
+                m_cacheValid[ row ][ column ] = true;
+
+                return value;
+            }
+
+        private:
+            static QVector< SharedModelData* >& instances()
+            {
+                static QVector< SharedModelData* > s_instances;
+                return s_instances;
+            }
+
+            // the model is not connected to, the caches tell about its changes
+            QPointer< QAbstractItemModel > m_model;
+            QModelIndex m_rootIndex;
+            int m_refCount;
+            int m_columnCount;
+            mutable QVector< QVector< T > > m_data;
+            mutable QVector< QVector< bool > > m_cacheValid;
+        };
     }
 
+    // caches the data of a model for the role ROLE, converted to T; all caches of the
+    // same model and root index share their data, and so do the caches of AttributesModels
+    // of the same source model, which is where an AttributesModel gets its data from
     template< class T, int ROLE >
     class ModelDataCache : public ModelDataCachePrivate::ModelSignalMapper
     {
     public:
         ModelDataCache()
             : m_model( nullptr ),
-              m_connector( *this )
+              m_connector( nullptr ),
+              m_shared( Shared::attach( nullptr, QModelIndex() ) )
         {
         }
 
-        virtual ~ModelDataCache()
+        ~ModelDataCache()
         {
+            if ( m_connector != nullptr )
+                m_connector->detach( this );
+            m_shared->detach();
         }
 
         T data( const QModelIndex& index ) const
         {
-            if ( !index.isValid() || index.parent() != m_rootIndex || index.row() >= m_model->rowCount(m_rootIndex) || index.column() >= m_model->columnCount(m_rootIndex) )
+            if ( !index.isValid() || index.parent() != m_rootIndex )
                 return ModelDataCachePrivate::nan< T >();
 
-            if ( index.row() >= m_data.count() )
-            {
-                qWarning( "KChart didn't receive signal rowsInserted, resetModel or layoutChanged, "
-                          "but an index with a row outside of the known bounds." );
-
-                // apparently, data were added behind our back (w/o signals)
-                const_cast< ModelDataCache< T, ROLE >* >( this )->rowsInserted( m_rootIndex,
-                                                                                m_data.count(),
-                                                                                m_model->rowCount( m_rootIndex ) - 1 );
-                Q_ASSERT( index.row() < m_data.count() );
-            }
-
-            if ( index.column() >= m_data.first().count() )
-            {
-                qWarning( "KChart didn't got signal columnsInserted, resetModel or layoutChanged, "
-                          "but an index with a column outside of the known bounds." );
-
-                // apparently, data were added behind our back (w/o signals)
-                const_cast< ModelDataCache< T, ROLE >* >( this )->columnsInserted( m_rootIndex,
-                                                                                   m_data.first().count(),
-                                                                                   m_model->columnCount( m_rootIndex ) - 1 );
-                Q_ASSERT( index.column() < m_data.first().count() );
-            }
-
-            return data( index.row(), index.column() );
+            const T value = m_shared->checkedData( index.row(), index.column() );
+            if ( m_model != m_shared->model() && ModelDataCachePrivate::isNan< T >( value ) )
+                return ownData( index, value );
+            return value;
         }
 
         T data( int row, int column ) const
         {
-            if ( row < 0 || column < 0 )
-                return ModelDataCachePrivate::nan< T >();
-
-            Q_ASSERT( row < m_model->rowCount(m_rootIndex) );
-            Q_ASSERT( column < m_model->columnCount(m_rootIndex) );
-
-            Q_ASSERT( row < m_data.count() );
-            Q_ASSERT( column < m_data.first().count() );
-
-            if ( isCached( row, column ) )
-                return m_data.at( row ).at( column );
-
-            return fetchFromModel( row, column, ROLE );
+            const T value = m_shared->data( row, column );
+            if ( m_model != m_shared->model() && ModelDataCachePrivate::isNan< T >( value ) )
+                return ownData( m_model->index( row, column, m_rootIndex ), value );
+            return value;
         }
 
         void setModel( QAbstractItemModel* model )
         {
-            if ( m_model != nullptr )
-                m_connector.disconnectSignals( m_model );
-
+            if ( model == m_model )
+                return;
+            if ( m_connector != nullptr )
+                m_connector->detach( this );
             m_model = model;
-
-            if ( m_model != nullptr )
-                m_connector.connectSignals( m_model );
-
-            modelReset();
+            m_connector = ModelDataCachePrivate::ModelSignalMapperConnector::attach( model, this );
+            share();
         }
 
         QAbstractItemModel* model() const
@@ -173,9 +395,9 @@ namespace KChart
 
         void setRootIndex( const QModelIndex& rootIndex )
         {
-            Q_ASSERT( rootIndex.model() == m_model || !rootIndex.isValid() );
+            Q_ASSERT( rootIndex.model() == model() || !rootIndex.isValid() );
             m_rootIndex = rootIndex;
-            modelReset();
+            share();
         }
 
         QModelIndex rootIndex() const
@@ -183,98 +405,62 @@ namespace KChart
             return m_rootIndex;
         }
 
-    protected:
-        bool isCached( int row, int column ) const
-        {
-            return m_cacheValid.at( row ).at( column );
-        }
+    private:
+        Q_DISABLE_COPY( ModelDataCache )
+        typedef ModelDataCachePrivate::SharedModelData< T, ROLE > Shared;
 
-        T fetchFromModel( int row, int column, int role ) const
+        // attaches to the data of (model, root index), or of its source if model is an
+        // AttributesModel, whose data and layout are those of its source model
+        void share()
         {
-            Q_ASSERT( m_model != nullptr );
+            QAbstractItemModel* sourceModel = m_model;
+            QModelIndex sourceRootIndex = m_rootIndex;
+            const AttributesModel* attributesModel = qobject_cast< const AttributesModel* >( m_model );
+            if ( attributesModel != nullptr && attributesModel->sourceModel() != nullptr )
+            {
+                sourceModel = attributesModel->sourceModel();
+                sourceRootIndex = attributesModel->mapToSource( m_rootIndex );
+            }
 
-            const QModelIndex index = m_model->index( row, column, m_rootIndex );
-            const QVariant data = index.data( role );
-            const T value = data.isNull() ? ModelDataCachePrivate::nan< T >()
-                                          : ( data.value< T >() );
+            // attach before detaching, so that the data is kept when nothing changed
+            Shared* shared = Shared::attach( sourceModel, sourceRootIndex );
+            m_shared->detach();
+            m_shared = shared;
+        }
 
-            m_data[ row ][ column ] = value;
-            m_cacheValid[ row ][ column ] = true;
+        // an AttributesModel may have a value of its own where its source model has none
+        T ownData( const QModelIndex& index, const T& sourceValue ) const
+        {
+            const QVariant data = index.data( ROLE );
+            return data.isNull() ? sourceValue : data.value< T >();
+        }
 
-            return value;
+        void resetModel() Q_DECL_OVERRIDE
+        {
+            // no need to disconnect, this is a response to SIGNAL( destroyed() ); the
+            // connector stays around until it is detached from
+            m_model = nullptr;
+            m_rootIndex = QModelIndex();
+            share();
         }
 
         void columnsInserted( const QModelIndex& parent, int start, int end ) Q_DECL_OVERRIDE
         {
-            Q_ASSERT( m_model != nullptr );
-            Q_ASSERT( parent.model() == m_model || !parent.isValid() );
-
-            if ( parent != m_rootIndex )
-                return;
-
-            Q_ASSERT( start <= end );
-            Q_ASSERT( start <= m_model->columnCount(m_rootIndex) );
-
-            const int rowCount = m_data.count();
-            for ( int row = 0; row < rowCount; ++row )
-            {
-                m_data[ row ].insert( start, end - start + 1, T() );
-                m_cacheValid[ row ].insert( start, end - start + 1, false );
-                Q_ASSERT( m_data.at( row ).count() == m_model->columnCount( m_rootIndex ) );
-                Q_ASSERT( m_cacheValid.at( row ).count() == m_model->columnCount( m_rootIndex ) );
-            }
+            if ( parent == m_rootIndex )
+                m_shared->columnsInserted( start, end );
         }
 
         void columnsRemoved( const QModelIndex& parent, int start, int end ) Q_DECL_OVERRIDE
         {
-            Q_ASSERT( m_model != nullptr );
-            Q_ASSERT( parent.model() == m_model || !parent.isValid() );
-
-            if ( parent != m_rootIndex )
-                return;
-
-            Q_ASSERT( start <= end );
-
-            const int rowCount = m_data.count();
-            for ( int row = 0; row < rowCount; ++row )
-            {
-                m_data[ row ].remove( start, end - start + 1 );
-                m_cacheValid[ row ].remove( start, end - start + 1 );
-                Q_ASSERT( m_data.at( row ).count() == m_model->columnCount( m_rootIndex ) );
-                Q_ASSERT( m_cacheValid.at( row ).count() == m_model->columnCount( m_rootIndex ) );
-            }
+            if ( parent == m_rootIndex )
+                m_shared->columnsRemoved( start, end );
         }
 
         void dataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight ) Q_DECL_OVERRIDE
         {
-            if ( !m_model )
-                return;
-            Q_ASSERT( m_model != nullptr );
             Q_ASSERT( topLeft.parent() == bottomRight.parent() );
-
-            if ( !topLeft.isValid() || !bottomRight.isValid() || topLeft.parent() != m_rootIndex )
-                return;
-
-            Q_ASSERT( topLeft.model() == m_model && bottomRight.model() == m_model );
-
-            const int minRow = qMax( 0, topLeft.row() );
-            const int maxRow = bottomRight.row();
-            const int minCol = qMax( 0, topLeft.column() );
-            const int maxCol = bottomRight.column();
-
-            Q_ASSERT( minRow <= maxRow );
-            Q_ASSERT( minCol <= maxCol );
-            Q_ASSERT( maxRow < m_model->rowCount( m_rootIndex ) );
-            Q_ASSERT( maxCol < m_model->columnCount( m_rootIndex ) );
-
-            for ( int row = minRow; row <= maxRow; ++row )
-            {
-                for ( int col = minCol; col <= maxCol; ++col )
-                {
-                    m_cacheValid[ row ][ col ] = false;
-                    Q_ASSERT( !isCached( row, col ) );
-                }
-            }
+            if ( topLeft.isValid() && bottomRight.isValid() && topLeft.parent() == m_rootIndex )
+                m_shared->dataChanged( topLeft.row(), topLeft.column(), bottomRight.row(), bottomRight.column() );
         }
 
         void layoutChanged() Q_DECL_OVERRIDE
@@ -284,67 +470,27 @@ namespace KChart
 
         void modelReset() Q_DECL_OVERRIDE
         {
-            m_data.clear();
-            m_cacheValid.clear();
-
-            if ( m_model == nullptr )
-                return;
-
-            m_data.fill( QVector< T >( m_model->columnCount( m_rootIndex ) ), m_model->rowCount( m_rootIndex ) );
-            m_cacheValid.fill( QVector< bool >( m_model->columnCount( m_rootIndex ), false ), m_model->rowCount( m_rootIndex ) );
-
-            Q_ASSERT( m_data.count() == m_model->rowCount( m_rootIndex ) );
-            Q_ASSERT( m_cacheValid.count() == m_model->rowCount( m_rootIndex ) );
+            // the source model of an AttributesModel may have been replaced
+            share();
+            m_shared->reset();
         }
 
         void rowsInserted( const QModelIndex& parent, int start, int end ) Q_DECL_OVERRIDE
         {
-            Q_ASSERT( m_model != nullptr );
-            Q_ASSERT( parent.model() == m_model || !parent.isValid() );
-
-            if ( parent != m_rootIndex || start >= m_model->rowCount(m_rootIndex) )
-                return;
-
-            Q_ASSERT( start <= end );
-            Q_ASSERT( end - start + 1 <= m_model->rowCount(m_rootIndex) );
-
-            m_data.insert( start, end - start + 1, QVector< T >( m_model->columnCount( m_rootIndex ) ) );
-            m_cacheValid.insert( start, end - start + 1, QVector< bool >( m_model->columnCount( m_rootIndex ), false ) );
-
-            Q_ASSERT( m_data.count() == m_model->rowCount( m_rootIndex ) );
-            Q_ASSERT( m_cacheValid.count() == m_model->rowCount( m_rootIndex ) );
+            if ( parent == m_rootIndex )
+                m_shared->rowsInserted( start, end );
         }
 
         void rowsRemoved( const QModelIndex& parent, int start, int end ) Q_DECL_OVERRIDE
         {
-            Q_ASSERT( m_model != nullptr );
-            Q_ASSERT( parent.model() == m_model || !parent.isValid() );
-
-            if ( parent != m_rootIndex || start >= m_data.count() )
-                return;
-
-            Q_ASSERT( start <= end );
-
-            m_data.remove( start, end - start + 1 );
-            m_cacheValid.remove( start, end - start + 1 );
-
-            Q_ASSERT( m_data.count() == m_model->rowCount( m_rootIndex ) );
-            Q_ASSERT( m_cacheValid.count() == m_model->rowCount( m_rootIndex ) );
-        }
-
-        void resetModel() Q_DECL_OVERRIDE
-        {
-            // no need to disconnect, this is a response to SIGNAL( destroyed() )
-            m_model = nullptr;
-            modelReset();
+            if ( parent == m_rootIndex )
+                m_shared->rowsRemoved( start, end );
         }
 
-    private:
         QAbstractItemModel* m_model;
         QModelIndex m_rootIndex;
-        ModelDataCachePrivate::ModelSignalMapperConnector m_connector;
-        mutable QVector< QVector< T > > m_data;
-        mutable QVector< QVector< bool > > m_cacheValid;
+        ModelDataCachePrivate::ModelSignalMapperConnector* m_connector;
+        Shared* m_shared;
     };
 }
 
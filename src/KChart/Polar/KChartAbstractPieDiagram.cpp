@@ -26,6 +26,8 @@
 #include "KChartMath_p.h"
 
 #include <QMap>
+#include <QPainter>
+#include <QPaintDevice>
 
 
 using namespace KChart;
@@ -33,11 +35,45 @@ using namespace KChart;
 AbstractPieDiagram::Private::Private()
     : granularity( 1.0 )
     , autoRotateLabels( false )
+    , sliceGeometryDirty( true )
+    , arcScale( 1.0 )
 {
 }
 
 AbstractPieDiagram::Private::~Private() {}
 
+qreal AbstractPieDiagram::Private::arcStep( qreal granularity, qreal radius ) const
+{
+    // the largest step whose chord deviates less than this from the arc
+    static const qreal maxDeviation = 0.1;
+    // even tiny pies should look round, not like polygons
+    static const qreal maxStep = 10.0;
+
+    // the deviation is visible in device pixels, so a pie that is painted
+    // zoomed in or onto a high resolution device needs a finer step
+    radius *= arcScale;
+    if ( radius <= maxDeviation ) {
+        return qMax( granularity, maxStep );
+    }
+    const qreal step = 2.0 * acos( 1.0 - maxDeviation / radius ) * 180.0 / M_PI;
+    return qMax( granularity, qMin( step, maxStep ) );
+}
+
+qreal AbstractPieDiagram::Private::deviceScale( const QPainter* painter )
+{
+    if ( !painter ) {
+        return 1.0;
+    }
+    // the longer of the two transformed unit vectors, which also covers rotation and shearing
+    const QTransform transform = painter->worldTransform();
+    qreal scale = qMax( sqrt( transform.m11() * transform.m11() + transform.m12() * transform.m12() ),
+                        sqrt( transform.m21() * transform.m21() + transform.m22() * transform.m22() ) );
+    if ( painter->device() ) {
+        scale *= painter->device()->devicePixelRatioF();
+    }
+    return scale > 0.0 ? scale : 1.0;
+}
+
 AbstractPieDiagram::AbstractPieDiagram( QWidget* parent, PolarCoordinatePlane *plane ) :
     AbstractPolarDiagram( new Private(), parent, plane )
 {
@@ -51,6 +87,18 @@ AbstractPieDiagram::~AbstractPieDiagram()
 
 void AbstractPieDiagram::init()
 {
+    // anything that can change the slices' shapes, colors or labels invalidates
+    // the geometry the Pie and Ring diagrams keep between paints
+    connect( this, SIGNAL(modelsChanged()), this, SLOT(setSliceGeometryDirty()) );
+    connect( this, SIGNAL(modelDataChanged()), this, SLOT(setSliceGeometryDirty()) );
+    connect( this, SIGNAL(dataHidden()), this, SLOT(setSliceGeometryDirty()) );
+    connect( this, SIGNAL(propertiesChanged()), this, SLOT(setSliceGeometryDirty()) );
+    connect( this, SIGNAL(layoutChanged(AbstractDiagram*)), this, SLOT(setSliceGeometryDirty()) );
+}
+
+void AbstractPieDiagram::setSliceGeometryDirty()
+{
+    d_func()->sliceGeometryDirty = true;
 }
 
 
@@ -81,6 +129,7 @@ bool AbstractPieDiagram::compare( const AbstractPieDiagram* other ) const
 void AbstractPieDiagram::setGranularity( qreal value )
 {
     d->granularity = value;
+    d->sliceGeometryDirty = true;
 }
 
 qreal AbstractPieDiagram::granularity() const
@@ -106,6 +155,7 @@ int AbstractPieDiagram::startPosition() const
 void AbstractPieDiagram::setAutoRotateLabels( bool autoRotate )
 {
     d->autoRotateLabels = autoRotate;
+    d->sliceGeometryDirty = true;
 }
 
 bool AbstractPieDiagram::autoRotateLabels() const
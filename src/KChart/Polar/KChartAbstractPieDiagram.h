@@ -86,6 +86,9 @@ public:
     ThreeDPieAttributes threeDPieAttributes() const;
     ThreeDPieAttributes threeDPieAttributes( int column ) const;
     ThreeDPieAttributes threeDPieAttributes( const QModelIndex & index ) const;
+
+private Q_SLOTS:
+    void setSliceGeometryDirty();
 }; // End of class KChartAbstractPieDiagram
 
 }
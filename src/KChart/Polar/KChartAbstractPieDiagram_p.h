@@ -37,6 +37,10 @@
 #include "KChartMath_p.h"
 
 
+QT_BEGIN_NAMESPACE
+class QPainter;
+QT_END_NAMESPACE
+
 namespace KChart {
 
 class PolarCoordinatePlane;
@@ -54,10 +58,31 @@ public:
     Private( const Private& rhs ) :
         AbstractPolarDiagram::Private( rhs ),
         granularity( rhs.granularity ),
-        autoRotateLabels( false )
+        autoRotateLabels( false ),
+        sliceGeometryDirty( true ),
+        arcScale( 1.0 )
         {
         }
 
+    /**
+     * Returns the angular step, in degrees, for tessellating an arc of \a radius logical
+     * pixels: coarse enough to not waste points on small pies, fine enough that the chords
+     * stay within a tenth of a device pixel of the true arc at arcScale. The step never
+     * gets finer than \a granularity.
+     */
+    qreal arcStep( qreal granularity, qreal radius ) const;
+
+    /**
+     * Returns how many device pixels one logical pixel covers when painting with
+     * \a painter, taking its world transformation and the device pixel ratio into account.
+     */
+    static qreal deviceScale( const QPainter* painter );
+
+    // set whenever anything the cached slice geometry depends on has changed
+    bool sliceGeometryDirty;
+    // the deviceScale() of the painter the cached slice geometry was computed for
+    qreal arcScale;
+
 private:
     qreal granularity;
     bool autoRotateLabels;
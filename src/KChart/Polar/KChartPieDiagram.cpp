@@ -26,17 +26,24 @@
 #include "KChartThreeDPieAttributes.h"
 #include "KChartPainterSaver_p.h"
 #include "KChartMath_p.h"
+#include "KChartInstrumentation.h"
 
 #include <QDebug>
 #include <QPainter>
 #include <QStack>
 
+#include <algorithm>
+
 
 using namespace KChart;
 
 PieDiagram::Private::Private()
-  : labelDecorations( PieDiagram::NoDecoration ),
-    isCollisionAvoidanceEnabled( false )
+  : size( 0 ),
+    labelDecorations( PieDiagram::NoDecoration ),
+    isCollisionAvoidanceEnabled( false ),
+    cachedPaintDevice( nullptr ),
+    cachedValueTotal( 0.0 ),
+    reuseSliceGeometry( false )
 {
 }
 
@@ -79,6 +86,7 @@ PieDiagram::LabelDecorations PieDiagram::labelDecorations() const
 void PieDiagram::setLabelCollisionAvoidanceEnabled( bool enabled )
 {
     d->isCollisionAvoidanceEnabled = enabled;
+    d->sliceGeometryDirty = true;
 }
 
 bool PieDiagram::isLabelCollisionAvoidanceEnabled() const
@@ -135,6 +143,8 @@ void PieDiagram::paint( PaintContext* ctx )
     // for text labels.
     // In the second stage, we make use of that information and
     // perform the actual painting.
+    // The result of the first stage and the slice polygons are kept
+    // for the next paint as long as nothing they depend on changes.
     placeLabels( ctx );
     paintInternal( ctx );
 }
@@ -234,13 +244,36 @@ void PieDiagram::placeLabels( PaintContext* paintContext )
     const ThreeDPieAttributes threeDAttrs( threeDPieAttributes() );
     const int colCount = columnCount();
 
-    d->reverseMapper.clear(); // on first call, this sets up the internals of the ReverseMapper.
-
+    const QVector< qreal > previousStartAngles = d->startAngles;
+    const QVector< qreal > previousAngleLens = d->angleLens;
     calcSliceAngles();
     if ( d->startAngles.isEmpty() ) {
         return;
     }
 
+    const QPaintDevice* device = paintContext->painter() ? paintContext->painter()->device() : nullptr;
+    const qreal total = valueTotals();
+    const qreal arcScale = Private::deviceScale( paintContext->painter() );
+    d->reuseSliceGeometry = !d->sliceGeometryDirty &&
+                            paintContext->rectangle() == d->cachedRectangle &&
+                            device == d->cachedPaintDevice &&
+                            arcScale == d->arcScale &&
+                            total == d->cachedValueTotal &&
+                            d->startAngles == previousStartAngles &&
+                            d->angleLens == previousAngleLens;
+    if ( d->reuseSliceGeometry ) {
+        return;
+    }
+    d->sliceGeometryDirty = false;
+    d->cachedRectangle = paintContext->rectangle();
+    d->cachedPaintDevice = device;
+    d->arcScale = arcScale;
+    d->cachedValueTotal = total;
+    d->slicePolygons = QVector< QPolygonF >( colCount );
+    d->sliceRuns.clear();
+
+    d->reverseMapper.clear(); // on first call, this sets up the internals of the ReverseMapper.
+
     calcPieSize( paintContext->rectangle() );
 
     // keep resizing the pie until the labels and the pie fit into paintContext->rectangle()
@@ -298,65 +331,94 @@ static int wraparound( int i, int size )
     return i;
 }
 
-//#define SHUFFLE_DEBUG
+namespace {
+// orders labels from top to bottom; ties keep the order of the slices so that the
+// placement does not depend on how the sort happens to treat equal keys
+struct LabelTopLessThan
+{
+    explicit LabelTopLessThan( const QVector< QRectF >& rects ) : m_rects( rects ) {}
+    bool operator()( int a, int b ) const
+    {
+        const qreal topA = m_rects[ a ].top();
+        const qreal topB = m_rects[ b ].top();
+        return topA < topB || ( topA == topB && a < b );
+    }
+    const QVector< QRectF >& m_rects;
+};
+}
 
 void PieDiagram::shuffleLabels( QRectF* textBoundingRect )
 {
-    // things that could be improved here:
-    // - use a variable number (chosen using angle information) of neighbors to check
-    // - try harder to arrange the labels to look nice
-
-    // ideas:
-    // - leave labels that don't collide alone (only if they their offset is zero)
-    // - use a graphics view for collision detection
+    // The labels left and right of the pie are swept separately from top to bottom. A label
+    // that overlaps the one above it on its side is moved down right below it, so every side
+    // becomes a stack of labels that do not overlap, and only the neighbouring label needs to
+    // be checked. Labels of the right side that still reach into one of the left side, which
+    // can only happen near the top and bottom of the pie, are then moved to the right. Both
+    // stacks are sorted, so apart from the sort this is linear in the number of labels, and
+    // the result only depends on the label positions.
 
     LabelPaintCache& lpc = d->labelPaintCache;
     const int n = lpc.paintReplay.size();
-    bool modified = false;
-    qreal direction = 5.0;
-    QVector< qreal > offsets;
-    offsets.fill( 0.0, n );
-
-    for ( bool lastRoundModified = true; lastRoundModified; ) {
-        lastRoundModified = false;
-
-        for ( int i = 0; i < n; i++ ) {
-            const int neighborsToCheck = qMax( 10, lpc.paintReplay.size() - 1 );
-            const int minComp = wraparound( i - neighborsToCheck / 2, n );
-            const int maxComp = wraparound( i + ( neighborsToCheck + 1 ) / 2, n );
+    QVector< QRectF > rects( n );
+    QVector< int > sides[ 2 ]; // left, right
+    for ( int i = 0; i < n; i++ ) {
+        rects[ i ] = lpc.paintReplay[ i ].labelArea.boundingRect();
+        const int slice = lpc.paintReplay[ i ].index.column();
+        qreal angle = std::fmod( d->startAngles[ slice ] + d->angleLens[ slice ] / 2.0, 360.0 );
+        if ( angle < 0.0 ) {
+            angle += 360.0;
+        }
+        sides[ angle < 90.0 || angle >= 270.0 ? 1 : 0 ].append( i );
+    }
 
-            QPainterPath& path = lpc.paintReplay[ i ].labelArea;
+    for ( int side = 0; side < 2; side++ ) {
+        QVector< int >& labels = sides[ side ];
+        std::sort( labels.begin(), labels.end(), LabelTopLessThan( rects ) );
+        for ( int k = 1; k < labels.size(); k++ ) {
+            const qreal above = rects[ labels[ k - 1 ] ].bottom();
+            QRectF& rect = rects[ labels[ k ] ];
+            if ( rect.top() < above ) {
+                rect.moveTop( above );
+            }
+        }
+    }
 
-            for ( int j = minComp; j != maxComp; j = wraparound( j + 1, n ) ) {
-                if ( i == j ) {
-                    continue;
-                }
-                QPainterPath& otherPath = lpc.paintReplay[ j ].labelArea;
-
-                while ( ( offsets[ i ] + direction > 0 ) && otherPath.intersects( path ) ) {
-#ifdef SHUFFLE_DEBUG
-                    qDebug() << "collision involving" << j << "and" << i << " -- n =" << n;
-                    TextAttributes ta = lpc.paintReplay[ i ].attrs.textAttributes();
-                    ta.setPen( QPen( Qt::white ) );
-                    lpc.paintReplay[ i ].attrs.setTextAttributes( ta );
-#endif
-                    uint slice = lpc.paintReplay[ i ].index.column();
-                    qreal angle = DEGTORAD( d->startAngles[ slice ] + d->angleLens[ slice ] / 2.0 );
-                    qreal dx = cos( angle ) * direction;
-                    qreal dy = -sin( angle ) * direction;
-                    offsets[ i ] += direction;
-                    path.translate( dx, dy );
-                    lastRoundModified = true;
+    // the left stack is sorted and free of overlaps, so the left labels next to a right one
+    // are found by a single pass over it
+    const QVector< int >& left = sides[ 0 ];
+    int first = 0;
+    Q_FOREACH( int i, sides[ 1 ] ) {
+        QRectF& rect = rects[ i ];
+        while ( first < left.size() && rects[ left[ first ] ].bottom() <= rect.top() ) {
+            first++;
+        }
+        // only the few left labels level with this one are checked, until none overlaps
+        bool moved = true;
+        while ( moved ) {
+            moved = false;
+            for ( int k = first; k < left.size() && rects[ left[ k ] ].top() < rect.bottom(); k++ ) {
+                const QRectF& other = rects[ left[ k ] ];
+                if ( other.intersects( rect ) ) {
+                    rect.moveLeft( other.right() );
+                    moved = true;
                 }
             }
         }
-        direction *= -1.07; // this can "overshoot", but avoids getting trapped in local minimums
-        modified = modified || lastRoundModified;
+    }
+
+    bool modified = false;
+    for ( int i = 0; i < n; i++ ) {
+        QPainterPath& path = lpc.paintReplay[ i ].labelArea;
+        const QPointF delta = rects[ i ].topLeft() - path.boundingRect().topLeft();
+        if ( !delta.isNull() ) {
+            path.translate( delta );
+            modified = true;
+        }
     }
 
     if ( modified ) {
-        for ( int i = 0; i < lpc.paintReplay.size(); i++ ) {
-            *textBoundingRect |= lpc.paintReplay[ i ].labelArea.boundingRect();
+        for ( int i = 0; i < n; i++ ) {
+            *textBoundingRect |= rects[ i ];
         }
     }
 }
@@ -449,16 +511,56 @@ void PieDiagram::paintInternal( PaintContext* paintContext )
     const ThreeDPieAttributes threeDAttrs( threeDPieAttributes() );
     const int colCount = columnCount();
 
+    QRectF pieRect = twoDPieRect( paintContext->rectangle(), threeDAttrs );
+
+    // With thousands of slices most of them are thinner than a pixel; painting them one by one
+    // costs a lot and shows nothing, so runs of such slices are merged into a single polygon.
+    // Without the 3D effect, flat slices do not overlap and need no back to front ordering.
+    static const int sliceRunThreshold = 1000;
+    if ( colCount >= sliceRunThreshold && !threeDAttrs.isEnabled() ) {
+        drawSliceRuns( paintContext->painter(), pieRect );
+    } else {
+        paintSlicesBackToFront( paintContext->painter(), pieRect, colCount );
+    }
+
+    d->paintDataValueTextsAndMarkers( paintContext, d->labelPaintCache, false, false );
+    // it's safer to do this at the beginning of placeLabels, but we can save some memory here.
+    d->forgetAlreadyPaintedDataValues();
+    // ### maybe move this into AbstractDiagram, also make ReverseMapper deal better with multiple polygons
+    const QPointF center = paintContext->rectangle().center();
+    const PainterSaver painterSaver( paintContext->painter() );
+    paintContext->painter()->setBrush( Qt::NoBrush );
+    Q_FOREACH( const LabelPaintInfo &pi, d->labelPaintCache.paintReplay ) {
+        // we expect the PainterPath to be a rectangle
+        if ( pi.labelArea.elementCount() != 5 ) {
+            continue;
+        }
+
+        paintContext->painter()->setPen( pen( pi.index ) );
+        if ( d->labelDecorations & LineFromSliceDecoration ) {
+            paintContext->painter()->drawLine( labelAttachmentLine( center, pi.markerPos, pi.labelArea ) );
+        }
+        if ( d->labelDecorations & FrameDecoration ) {
+            paintContext->painter()->drawPath( pi.labelArea );
+        }
+        if ( !d->reuseSliceGeometry ) {
+            d->reverseMapper.addPolygon( pi.index.row(), pi.index.column(),
+                                         polygonFromPainterPath( pi.labelArea ) );
+        }
+    }
+}
+
+void PieDiagram::paintSlicesBackToFront( QPainter* painter, const QRectF& pieRect, int colCount )
+{
     // Paint from back to front ("painter's algorithm") - first draw the backmost slice,
     // then the slices on the left and right from back to front, then the frontmost one.
 
-    QRectF pieRect = twoDPieRect( paintContext->rectangle(), threeDAttrs );
     const int backmostSlice = findSliceAt( 90, colCount );
     const int frontmostSlice = findSliceAt( 270, colCount );
     int currentLeftSlice = backmostSlice;
     int currentRightSlice = backmostSlice;
 
-    drawSlice( paintContext->painter(), pieRect, backmostSlice );
+    drawSlice( painter, pieRect, backmostSlice );
 
     if ( backmostSlice == frontmostSlice ) {
         const int rightmostSlice = findSliceAt( 0, colCount );
@@ -474,49 +576,22 @@ void PieDiagram::paintInternal( PaintContext* paintContext )
 
     while ( currentLeftSlice != frontmostSlice ) {
         if ( currentLeftSlice != backmostSlice ) {
-            drawSlice( paintContext->painter(), pieRect, currentLeftSlice );
+            drawSlice( painter, pieRect, currentLeftSlice );
         }
         currentLeftSlice = findLeftSlice( currentLeftSlice, colCount );
     }
 
     while ( currentRightSlice != frontmostSlice ) {
         if ( currentRightSlice != backmostSlice ) {
-            drawSlice( paintContext->painter(), pieRect, currentRightSlice );
+            drawSlice( painter, pieRect, currentRightSlice );
         }
         currentRightSlice = findRightSlice( currentRightSlice, colCount );
     }
 
     // if the backmost slice is not the frontmost slice, we draw the frontmost one last
     if ( backmostSlice != frontmostSlice || ! threeDPieAttributes().isEnabled() ) {
-        drawSlice( paintContext->painter(), pieRect, frontmostSlice );
+        drawSlice( painter, pieRect, frontmostSlice );
     }
-
-    d->paintDataValueTextsAndMarkers( paintContext, d->labelPaintCache, false, false );
-    // it's safer to do this at the beginning of placeLabels, but we can save some memory here.
-    d->forgetAlreadyPaintedDataValues();
-    // ### maybe move this into AbstractDiagram, also make ReverseMapper deal better with multiple polygons
-    const QPointF center = paintContext->rectangle().center();
-    const PainterSaver painterSaver( paintContext->painter() );
-    paintContext->painter()->setBrush( Qt::NoBrush );
-    Q_FOREACH( const LabelPaintInfo &pi, d->labelPaintCache.paintReplay ) {
-        // we expect the PainterPath to be a rectangle
-        if ( pi.labelArea.elementCount() != 5 ) {
-            continue;
-        }
-
-        paintContext->painter()->setPen( pen( pi.index ) );
-        if ( d->labelDecorations & LineFromSliceDecoration ) {
-            paintContext->painter()->drawLine( labelAttachmentLine( center, pi.markerPos, pi.labelArea ) );
-        }
-        if ( d->labelDecorations & FrameDecoration ) {
-            paintContext->painter()->drawPath( pi.labelArea );
-        }
-        d->reverseMapper.addPolygon( pi.index.row(), pi.index.column(),
-                                     polygonFromPainterPath( pi.labelArea ) );
-    }
-    d->labelPaintCache.clear();
-    d->startAngles.clear();
-    d->angleLens.clear();
 }
 
 #if defined ( Q_OS_WIN)
@@ -590,43 +665,115 @@ void PieDiagram::drawSliceSurface( QPainter* painter, const QRectF& drawPosition
     }
     painter->setPen( pen );
 
+    // the polygon is also needed for the full circle, for the ReverseMapper
+    QPolygonF& poly = d->slicePolygons[ slice ];
+    if ( poly.isEmpty() ) {
+        if ( angleLen == 360 ) {
+            poly = QPolygonF( drawPosition );
+        } else {
+            poly = arcPolygon( drawPosition, startAngle, angleLen );
+        }
+        //Add polygon to Reverse mapper for showing tool tips.
+        d->reverseMapper.addPolygon( index.row(), index.column(), poly );
+    }
+
     if ( angleLen == 360 ) {
         // full circle, avoid nasty line in the middle
         painter->drawEllipse( drawPosition );
+    } else {
+        painter->drawPolygon( poly );
+    }
+    Instrumentation::count( Instrumentation::PrimitivesDrawn );
+}
 
-        //Add polygon to Reverse mapper for showing tool tips.
-        QPolygonF poly( drawPosition );
-        d->reverseMapper.addPolygon( index.row(), index.column(), poly );
+/**
+  Internal method that returns the outline of a slice: the arc from \a startAngle
+  spanning \a angleLen degrees plus the center point of \a drawPosition.
+  */
+QPolygonF PieDiagram::arcPolygon( const QRectF& drawPosition, qreal startAngle, qreal angleLen )
+{
+    const qreal step = d->arcStep( granularity(), drawPosition.width() / 2.0 );
+
+    // Start with getting the points for the arc.
+    const int arcPoints = static_cast<int>(trunc( angleLen / step ));
+    QPolygonF poly( arcPoints + 2 );
+    qreal degree = 0.0;
+    int iPoint = 0;
+    bool perfectMatch = false;
+
+    while ( degree <= angleLen ) {
+        poly[ iPoint ] = pointOnEllipse( drawPosition, startAngle + degree );
+        perfectMatch = ( degree == angleLen );
+        degree += step;
+        ++iPoint;
+    }
+    // if necessary add one more point to fill the last small gap
+    if ( !perfectMatch ) {
+        poly[ iPoint ] = pointOnEllipse( drawPosition, startAngle + angleLen );
+
+        // add the center point of the piece
+        poly.append( drawPosition.center() );
     } else {
-        // draw the top of this piece
-        // Start with getting the points for the arc.
-        const int arcPoints = static_cast<int>(trunc( angleLen / granularity() ));
-        QPolygonF poly( arcPoints + 2 );
-        qreal degree = 0.0;
-        int iPoint = 0;
-        bool perfectMatch = false;
-
-        while ( degree <= angleLen ) {
-            poly[ iPoint ] = pointOnEllipse( drawPosition, startAngle + degree );
-            //qDebug() << degree << angleLen << poly[ iPoint ];
-            perfectMatch = ( degree == angleLen );
-            degree += granularity();
-            ++iPoint;
-        }
-        // if necessary add one more point to fill the last small gap
-        if ( !perfectMatch ) {
-            poly[ iPoint ] = pointOnEllipse( drawPosition, startAngle + angleLen );
-
-            // add the center point of the piece
-            poly.append( drawPosition.center() );
-        } else {
-            poly[ iPoint ] = drawPosition.center();
+        poly[ iPoint ] = drawPosition.center();
+    }
+    return poly;
+}
+
+/**
+  Internal method that draws all slices of a flat pie in data order, merging runs of
+  consecutive slices whose arcs are shorter than a pixel into one polygon painted with
+  the brush and pen of the run's first slice. Exploded slices are never merged.
+
+  \param painter the QPainter to draw in
+  \param drawPosition the position of the pie
+  */
+void PieDiagram::drawSliceRuns( QPainter* painter, const QRectF& drawPosition )
+{
+    const int colCount = columnCount();
+
+    if ( d->sliceRuns.isEmpty() ) {
+        const qreal radius = drawPosition.width() / 2.0;
+        // the angle of an arc that is one pixel long
+        const qreal pixelAngle = radius > 0.0 ? 180.0 / ( M_PI * radius ) : 360.0;
+
+        for ( int slice = 0; slice < colCount; ) {
+            Private::SliceRun run;
+            run.first = slice;
+            run.last = slice;
+            qreal runAngleLen = d->angleLens[ slice ];
+            if ( runAngleLen < pixelAngle &&
+                 !pieAttributes( model()->index( 0, slice, rootIndex() ) ).explode() ) { // checked
+                while ( run.last + 1 < colCount &&
+                        runAngleLen + d->angleLens[ run.last + 1 ] < pixelAngle &&
+                        !pieAttributes( model()->index( 0, run.last + 1, rootIndex() ) ).explode() ) { // checked
+                    ++run.last;
+                    runAngleLen += d->angleLens[ run.last ];
+                }
+            }
+            if ( run.last > run.first && runAngleLen > 0.0 ) {
+                run.polygon = arcPolygon( drawPosition, d->startAngles[ run.first ], runAngleLen );
+                d->reverseMapper.addPolygon( 0, run.first, run.polygon );
+            }
+            d->sliceRuns.append( run );
+            slice = run.last + 1;
         }
-        //find the value and paint it
-        //fix value position
-        d->reverseMapper.addPolygon( index.row(), index.column(), poly );
+    }
 
-        painter->drawPolygon( poly );
+    const PainterSaver painterSaver( painter );
+    painter->setRenderHint( QPainter::Antialiasing );
+    Q_FOREACH( const Private::SliceRun& run, d->sliceRuns ) {
+        if ( run.polygon.isEmpty() ) {
+            // single slices, and runs of empty slices
+            for ( int slice = run.first; slice <= run.last; ++slice ) {
+                drawSlice( painter, drawPosition, slice );
+            }
+            continue;
+        }
+        const QModelIndex index( model()->index( 0, run.first, rootIndex() ) ); // checked
+        painter->setBrush( brush( index ) );
+        painter->setPen( pen( index ) );
+        painter->drawPolygon( run.polygon );
+        Instrumentation::count( Instrumentation::PrimitivesDrawn );
     }
 }
 
@@ -801,6 +948,7 @@ void PieDiagram::draw3dCutSurface( QPainter* painter,
     poly[3] = QPointF( center.x(), center.y() + threeDHeight );
     // TODO: add polygon to ReverseMapper
     painter->drawPolygon( poly );
+    Instrumentation::count( Instrumentation::PrimitivesDrawn );
 }
 
 /**
@@ -825,7 +973,8 @@ void PieDiagram::draw3dOuterRim( QPainter* painter,
     startAngle = qMax( startAngle, qreal( 180.0 ) );
     endAngle = qMin( endAngle, qreal( 360.0 ) );
 
-    int numHalfPoints = trunc( ( endAngle - startAngle ) / granularity() ) + 1;
+    const qreal step = d->arcStep( granularity(), rect.width() / 2.0 );
+    int numHalfPoints = trunc( ( endAngle - startAngle ) / step ) + 1;
     if ( numHalfPoints < 2 ) {
         return;
     }
@@ -839,7 +988,7 @@ void PieDiagram::draw3dOuterRim( QPainter* painter,
         poly[ numHalfPoints - iPoint - 1 ] = pointOnEllipse( rect, degree );
 
         perfectMatch = (degree == startAngle);
-        degree -= granularity();
+        degree -= step;
         ++iPoint;
     }
     // if necessary add one more point to fill the last small gap
@@ -860,6 +1009,7 @@ void PieDiagram::draw3dOuterRim( QPainter* painter,
 
     // TODO: Add polygon to ReverseMapper
     painter->drawPolygon( poly );
+    Instrumentation::count( Instrumentation::PrimitivesDrawn );
 }
 
 /**
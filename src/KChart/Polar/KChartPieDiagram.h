@@ -91,11 +91,15 @@ protected:
 private:
     // ### move to private class?
     void placeLabels( PaintContext* paintContext );
-    // Solve problems with label overlap by changing label positions inside d->labelPaintCache.
+    // Solve problems with label overlap by changing label positions inside d->labelPaintCache,
+    // sweeping the labels on each side of the pie from top to bottom.
     void shuffleLabels( QRectF* textBoundingRect );
     void paintInternal( PaintContext* paintContext );
+    void paintSlicesBackToFront( QPainter* painter, const QRectF& pieRect, int columnCount );
     void drawSlice( QPainter* painter, const QRectF& drawPosition, uint slice );
     void drawSliceSurface( QPainter* painter, const QRectF& drawPosition, uint slice );
+    void drawSliceRuns( QPainter* painter, const QRectF& drawPosition );
+    QPolygonF arcPolygon( const QRectF& drawPosition, qreal startAngle, qreal angleLen );
     void addSliceLabel( LabelPaintCache* lpc, const QRectF& drawPosition, uint slice );
     void draw3DEffect( QPainter* painter, const QRectF& drawPosition, uint slice );
     void draw3dCutSurface( QPainter* painter,
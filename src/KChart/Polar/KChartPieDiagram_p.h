@@ -54,19 +54,44 @@ public:
         angleLens(),
         size( 0 ),
         labelDecorations( NoDecoration ),
-        isCollisionAvoidanceEnabled( false )
+        isCollisionAvoidanceEnabled( false ),
+        cachedPaintDevice( nullptr ),
+        cachedValueTotal( 0.0 ),
+        reuseSliceGeometry( false )
         {
             // just for consistency
         }
 
+    /**
+     * A run of consecutive slices painted as one polygon. Runs of a single slice
+     * have an empty polygon and are painted normally.
+     */
+    struct SliceRun {
+        int first;
+        int last;
+        QPolygonF polygon;
+    };
+
 protected:
-    // this information needed temporarily at drawing time
+    // slice positions, pie size and label positions of the last paint; they are kept until
+    // the data, the attributes or the paint rectangle change
     QVector< qreal > startAngles;
     QVector< qreal > angleLens;
     qreal size;
     LabelPaintCache labelPaintCache;
     PieDiagram::LabelDecorations labelDecorations;
     bool isCollisionAvoidanceEnabled;
+
+    // what the cached geometry was computed for
+    QRectF cachedRectangle;
+    const QPaintDevice* cachedPaintDevice;
+    qreal cachedValueTotal;
+    // true while painting from the geometry computed by an earlier paint
+    bool reuseSliceGeometry;
+    // the surface polygon of each slice, empty until the slice was first drawn
+    QVector< QPolygonF > slicePolygons;
+    // slices grouped for painting pies with very many slices, see PieDiagram::drawSliceRuns()
+    QVector< SliceRun > sliceRuns;
 };
 
 KCHART_IMPL_DERIVED_DIAGRAM( PieDiagram, AbstractPieDiagram, PolarCoordinatePlane )
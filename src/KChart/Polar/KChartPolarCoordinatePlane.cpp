@@ -27,6 +27,7 @@
 #include "KChartAbstractPolarDiagram.h"
 #include "KChartPolarDiagram.h"
 #include "KChartMath_p.h"
+#include "KChartInstrumentation.h"
 
 #include <QFont>
 #include <QList>
@@ -76,6 +77,7 @@ void PolarCoordinatePlane::paint ( QPainter* painter )
      // need at least one so d->currentTransformation can be a valid pointer
     Q_ASSERT( !d->coordinateTransformations.isEmpty() );
 
+    Instrumentation::Scope scope( "paint", this );
     PaintContext ctx;
     ctx.setPainter ( painter );
     ctx.setCoordinatePlane ( this );
@@ -110,11 +112,15 @@ void PolarCoordinatePlane::paint ( QPainter* painter )
 
     // paint the coordinate system rulers:
     d->currentTransformation = &d->coordinateTransformations.first();
-    d->grid->drawGrid( &ctx );
+    {
+        Instrumentation::Scope gridScope( "grid", this );
+        d->grid->drawGrid( &ctx );
+    }
 
     // paint the diagrams which will re-use their DataValueTextInfoList(s) filled in step 1:
     for ( int i = 0; i < diags.size(); i++ ) {
         d->currentTransformation = & ( d->coordinateTransformations[i] );
+        Instrumentation::Scope diagramScope( "paint", diags[i] );
         PainterSaver painterSaver( painter );
         PolarDiagram* polarDia = dynamic_cast<PolarDiagram*>( diags[i] );
         if ( polarDia ) {
@@ -36,6 +36,8 @@
 #include "KChartPolarGrid.h"
 #include "KChartMath_p.h"
 
+#include <QVector>
+
 
 namespace KChart {
 
@@ -44,6 +46,16 @@ namespace KChart {
  */
 struct PolarCoordinatePlane::CoordinateTransformation
 {
+    CoordinateTransformation()
+        : radiusUnit( 1.0 )
+        , angleUnit( 1.0 )
+        , minValue( 0.0 )
+        , startPosition( 0.0 )
+        , spokeDirectionsAngleUnit( 0.0 )
+        , startRotation( 1.0, 0.0 )
+        , startRotationPosition( 0.0 )
+    {}
+
     // represents the distance of the diagram coordinate origin to the
     // origin of the coordinate plane space:
     QPointF originTranslation;
@@ -54,23 +66,59 @@ struct PolarCoordinatePlane::CoordinateTransformation
     qreal startPosition;
     ZoomParameters zoom;
 
+    // the directions of the spokes 0, 1, 2, ... before rotating them by startPosition,
+    // filled on demand; nearly all points a polar diagram paints lie on a spoke
+    mutable QVector<QPointF> spokeDirections;
+    mutable qreal spokeDirectionsAngleUnit;
+    // cos and sin of the rotation by startPosition
+    mutable QPointF startRotation;
+    mutable qreal startRotationPosition;
+
+    // more spokes than this are not worth keeping, the table would get too big
+    enum { MaximumCachedSpokes = 1 << 16 };
+
     static QPointF polarToCartesian( qreal R, qreal theta )
     {
         // de-inline me
         return QPointF( R * cos( DEGTORAD( theta ) ), R * sin( DEGTORAD( theta ) ) );
     }
 
+    // the unit vector pointing to the position \a angle on the angle axis
+    QPointF direction( qreal angle ) const
+    {
+        if ( startRotationPosition != startPosition ) {
+            startRotation = polarToCartesian( 1.0, -startPosition );
+            startRotationPosition = startPosition;
+        }
+
+        QPointF unrotated;
+        const int spoke = int( angle );
+        if ( spoke == angle && spoke >= 0 && spoke < MaximumCachedSpokes ) {
+            if ( spokeDirectionsAngleUnit != angleUnit ) {
+                spokeDirections.clear();
+                spokeDirectionsAngleUnit = angleUnit;
+            }
+            for ( int i = spokeDirections.size(); i <= spoke; ++i ) {
+                spokeDirections.append( polarToCartesian( 1.0, ( i * -angleUnit ) - 90.0 ) );
+            }
+            unrotated = spokeDirections.at( spoke );
+        } else {
+            unrotated = polarToCartesian( 1.0, ( angle * -angleUnit ) - 90.0 );
+        }
+
+        return QPointF( unrotated.x() * startRotation.x() - unrotated.y() * startRotation.y(),
+                        unrotated.x() * startRotation.y() + unrotated.y() * startRotation.x() );
+    }
+
     inline const QPointF translate( const QPointF& diagramPoint ) const
     {
         // ### de-inline me
         // calculate the polar coordinates
         const qreal x = (diagramPoint.x() * radiusUnit) - (minValue * radiusUnit);
 //qDebug() << x << "=" << diagramPoint.x() << "*" << radiusUnit << "  startPosition: " << startPosition;
-        const qreal y = ( diagramPoint.y() * -angleUnit) - 90.0 - startPosition;
         // convert to cartesian coordinates
-        QPointF cartesianPoint = polarToCartesian( x, y );
-        cartesianPoint.setX( cartesianPoint.x() * zoom.xFactor );
-        cartesianPoint.setY( cartesianPoint.y() * zoom.yFactor );
+        const QPointF unit = direction( diagramPoint.y() );
+        const QPointF cartesianPoint( x * unit.x() * zoom.xFactor, x * unit.y() * zoom.yFactor );
 
         QPointF newOrigin = originTranslation;
         qreal minOrigin = qMin( newOrigin.x(), newOrigin.y() );
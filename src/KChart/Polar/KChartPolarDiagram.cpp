@@ -23,6 +23,7 @@
 #include "KChartPaintContext.h"
 #include "KChartPainterSaver_p.h"
 #include "KChartMath_p.h"
+#include "KChartInstrumentation.h"
 
 #include <QPainter>
 
@@ -30,7 +31,9 @@ using namespace KChart;
 
 PolarDiagram::Private::Private() :
     rotateCircularLabels( false ),
-    closeDatasets( false )
+    closeDatasets( false ),
+    datasetPointsRevision( 0 ),
+    datasetPointsValid( false )
 {
 }
 
@@ -152,21 +155,37 @@ void PolarDiagram::paint( PaintContext* ctx,
     const int rowCount = model()->rowCount( rootIndex() );
     const int colCount = model()->columnCount( rootIndex() );
 
+    // the points kept from an earlier pass are still valid if the plane
+    // transforms the values the same way and the values did not change
+    const PolarGridGeometry geometry( polarCoordinatePlane(), ctx->rectangle(),
+                                      dataBoundaries().first.y(), dataBoundaries().second.y(), 0 );
+    const bool reusePoints = d->datasetPointsValid && d->datasetPoints.size() == colCount &&
+                             geometry == d->datasetPointsGeometry &&
+                             d->datasetPointsRevision == d->dataRevision;
+
     if ( calculateListAndReturnScale ) {
         // Check if all of the data value texts / data comments fit into the available space...
         d->labelPaintCache.clear();
+        d->datasetPoints.resize( colCount );
 
         for ( int iCol = 0; iCol < colCount; ++iCol ) {
+            QPolygonF& points = d->datasetPoints[ iCol ];
+            const bool reuseColumn = reusePoints && points.size() == rowCount;
+            points.resize( rowCount );
             for ( int iRow=0; iRow < rowCount; ++iRow ) {
                 QModelIndex index = model()->index( iRow, iCol, rootIndex() ); // checked
                 const qreal value = model()->data( index ).toReal();
-                QPointF point = coordinatePlane()->translate(
-                        QPointF( value, iRow ) ) + ctx->rectangle().topLeft();
-                //qDebug() << point;
-                d->addLabel( &d->labelPaintCache, index, nullptr, PositionPoints( point ),
+                if ( !reuseColumn ) {
+                    points[ iRow ] = coordinatePlane()->translate(
+                            QPointF( value, iRow ) ) + ctx->rectangle().topLeft();
+                }
+                d->addLabel( &d->labelPaintCache, index, nullptr, PositionPoints( points[ iRow ] ),
                              Position::Center, Position::Center, value );
             }
         }
+        d->datasetPointsGeometry = geometry;
+        d->datasetPointsRevision = d->dataRevision;
+        d->datasetPointsValid = true;
 
         newZoomX = coordinatePlane()->zoomFactorX();
         newZoomY = coordinatePlane()->zoomFactorY();
@@ -198,13 +217,18 @@ void PolarDiagram::paint( PaintContext* ctx,
             //           in the same way as LineDiagram does it.
             QBrush brush = d->datasetAttrs( iCol, KChart::DatasetBrushRole ).value<QBrush>();
             QPolygonF polygon;
-            for ( int iRow = 0; iRow < rowCount; ++iRow ) {
-                QModelIndex index = model()->index( iRow, iCol, rootIndex() ); // checked
-                const qreal value = model()->data( index ).toReal();
-                QPointF point = coordinatePlane()->translate( QPointF( value, iRow ) )
-                                + ctx->rectangle().topLeft();
-                polygon.append( point );
-                //qDebug() << point;
+            if ( reusePoints && d->datasetPoints[ iCol ].size() == rowCount ) {
+                // neither the plane nor the data changed since the labels were placed
+                polygon = d->datasetPoints[ iCol ];
+            } else {
+                for ( int iRow = 0; iRow < rowCount; ++iRow ) {
+                    QModelIndex index = model()->index( iRow, iCol, rootIndex() ); // checked
+                    const qreal value = model()->data( index ).toReal();
+                    QPointF point = coordinatePlane()->translate( QPointF( value, iRow ) )
+                                    + ctx->rectangle().topLeft();
+                    polygon.append( point );
+                    //qDebug() << point;
+                }
             }
             if ( closeDatasets() && !polygon.isEmpty() ) {
                 // close the circle by connecting the last data point to the first
@@ -219,6 +243,7 @@ void PolarDiagram::paint( PaintContext* ctx,
             {
                 ctx->painter()->setPen( PrintingParameters::scalePen( p ) );
                 ctx->painter()->drawPolyline( polygon );
+                Instrumentation::count( Instrumentation::PrimitivesDrawn );
             }
         }
         d->paintDataValueTextsAndMarkers( ctx, d->labelPaintCache, true );
@@ -34,8 +34,11 @@
 #include "KChartPolarDiagram.h"
 #include "KChartAbstractPolarDiagram_p.h"
 
+#include "KChartPolarGrid.h"
 #include "KChartMath_p.h"
 
+#include <QPolygonF>
+#include <QVector>
 
 namespace KChart {
 
@@ -54,7 +57,9 @@ public:
         showDelimitersAtPosition( rhs.showDelimitersAtPosition ),
         showLabelsAtPosition( rhs.showLabelsAtPosition ),
         rotateCircularLabels( rhs.rotateCircularLabels ),
-        closeDatasets( rhs.closeDatasets )
+        closeDatasets( rhs.closeDatasets ),
+        datasetPointsRevision( 0 ),
+        datasetPointsValid( false )
         {
         }
 
@@ -64,6 +69,13 @@ private:
     bool rotateCircularLabels;
     bool closeDatasets;
     LabelPaintCache labelPaintCache;
+    // the points of the datasets, calculated along with the labels by the first pass of
+    // paint(); they are reused by the drawing pass and by later paints instead of translating
+    // every value again, as long as neither the plane geometry nor the data change
+    QVector< QPolygonF > datasetPoints;
+    PolarGridGeometry datasetPointsGeometry;
+    uint datasetPointsRevision;
+    bool datasetPointsValid;
 };
 
 KCHART_IMPL_DERIVED_DIAGRAM( PolarDiagram, AbstractPolarDiagram, PolarCoordinatePlane )
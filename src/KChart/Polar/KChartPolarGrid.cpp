@@ -30,6 +30,45 @@
 using namespace KChart;
 
 
+PolarGridGeometry::PolarGridGeometry()
+    : angleUnit( 0.0 ),
+      radiusUnit( 0.0 ),
+      startPosition( 0.0 ),
+      zoomFactorX( 0.0 ),
+      zoomFactorY( 0.0 ),
+      minimum( 0.0 ),
+      maximum( 0.0 ),
+      rings( 0 )
+{
+}
+
+PolarGridGeometry::PolarGridGeometry( const PolarCoordinatePlane* plane, const QRectF& rectangle,
+                                      qreal minimum, qreal maximum, int rings )
+    : rectangle( rectangle ),
+      origin( plane->translate( QPointF( 0.0, 0.0 ) ) ),
+      angleUnit( plane->angleUnit() ),
+      radiusUnit( plane->radiusUnit() ),
+      startPosition( plane->startPosition() ),
+      zoomFactorX( plane->zoomFactorX() ),
+      zoomFactorY( plane->zoomFactorY() ),
+      zoomCenter( plane->zoomCenter() ),
+      minimum( minimum ),
+      maximum( maximum ),
+      rings( rings )
+{
+}
+
+bool PolarGridGeometry::operator==( const PolarGridGeometry& other ) const
+{
+    return rectangle == other.rectangle && origin == other.origin &&
+           angleUnit == other.angleUnit && radiusUnit == other.radiusUnit &&
+           startPosition == other.startPosition &&
+           zoomFactorX == other.zoomFactorX && zoomFactorY == other.zoomFactorY &&
+           zoomCenter == other.zoomCenter &&
+           minimum == other.minimum && maximum == other.maximum && rings == other.rings;
+}
+
+
 DataDimensionsList PolarGrid::calculateGrid(
     const DataDimensionsList& rawDataDimensions ) const
 {
@@ -83,10 +122,17 @@ void PolarGrid::drawGrid( PaintContext* context )
     const qreal r = qAbs( min ) + dgr->dataBoundaries().second.y(); // use the full extents
 
     if ( gridAttrsSagittal.isGridVisible() ) {
-        const int numberOfSpokes = ( int ) ( 360 / plane->angleUnit() );
-        for ( int i = 0; i < numberOfSpokes ; ++i ) {
-            context->painter()->drawLine( origin, plane->translate( QPointF( r - qAbs( min ), i ) ) + context->rectangle().topLeft() );
+        const PolarGridGeometry geometry( plane, context->rectangle(), min, dgr->dataBoundaries().second.y(), 0 );
+        if ( m_spokes.isEmpty() || geometry != m_spokesGeometry ) {
+            m_spokesGeometry = geometry;
+            m_spokes.clear();
+            const int numberOfSpokes = ( int ) ( 360 / plane->angleUnit() );
+            m_spokes.reserve( numberOfSpokes );
+            for ( int i = 0; i < numberOfSpokes ; ++i ) {
+                m_spokes.append( QLineF( origin, plane->translate( QPointF( r - qAbs( min ), i ) ) + context->rectangle().topLeft() ) );
+            }
         }
+        context->painter()->drawLines( m_spokes );
     }
 
     if ( gridAttrsCircular.isGridVisible() )
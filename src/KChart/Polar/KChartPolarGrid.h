@@ -23,11 +23,47 @@
 #include "KChartPolarCoordinatePlane.h"
 #include "KChartAbstractGrid.h"
 
+#include <QLineF>
+#include <QRectF>
+#include <QVector>
+
 namespace KChart {
 
     class PaintContext;
     class PolarCoordinatePlane;
 
+    /**
+     * \internal
+     *
+     * \brief The state of a polar or radar plane its grid lines depend on.
+     *
+     * The grids keep their lines between paints, and only calculate them
+     * again when the geometry of the plane changed. The Polar and Radar
+     * diagrams do the same with the points of their datasets.
+     */
+    struct PolarGridGeometry
+    {
+        PolarGridGeometry();
+        PolarGridGeometry( const PolarCoordinatePlane* plane, const QRectF& rectangle,
+                           qreal minimum, qreal maximum, int rings );
+
+        bool operator==( const PolarGridGeometry& other ) const;
+        bool operator!=( const PolarGridGeometry& other ) const { return !( *this == other ); }
+
+        QRectF rectangle;
+        // the position of the diagram coordinate origin in the plane
+        QPointF origin;
+        qreal angleUnit;
+        qreal radiusUnit;
+        qreal startPosition;
+        qreal zoomFactorX;
+        qreal zoomFactorY;
+        QPointF zoomCenter;
+        qreal minimum;
+        qreal maximum;
+        int rings;
+    };
+
     /**
      * \internal
      *
@@ -49,6 +85,10 @@ namespace KChart {
     private:
         DataDimensionsList calculateGrid(
             const DataDimensionsList& rawDataDimensions ) const Q_DECL_OVERRIDE;
+
+        // the sagittal grid lines of the last paint, and the geometry they belong to
+        PolarGridGeometry m_spokesGeometry;
+        QVector< QLineF > m_spokes;
     };
 
 }
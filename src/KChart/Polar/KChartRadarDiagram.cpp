@@ -23,6 +23,7 @@
 #include "KChartPaintContext.h"
 #include "KChartPainterSaver_p.h"
 #include "KChartMath_p.h"
+#include "KChartInstrumentation.h"
 
 #include <QPainter>
 
@@ -31,7 +32,9 @@ using namespace KChart;
 RadarDiagram::Private::Private() :
     closeDatasets( false ),
     reverseData( false ),
-    fillAlpha( 0.0 )
+    fillAlpha( 0.0 ),
+    datasetPointsRevision( 0 ),
+    datasetPointsValid( false )
 {
 }
 
@@ -193,22 +196,39 @@ void RadarDiagram::paint( PaintContext* ctx,
         destRect.setY( destRect.y() + 2 * labelHeight );
         destRect.setHeight( destRect.height() - 4 * labelHeight );
     }
-    
+
+    // the points kept from an earlier pass are still valid if the plane
+    // transforms the values the same way and the values did not change
+    const PolarGridGeometry geometry( plane, ctx->rectangle(), min, dataBoundaries().second.y(), 0 );
+    const bool reusePoints = d->datasetPointsValid && d->datasetPoints.size() == colCount &&
+                             geometry == d->datasetPointsGeometry && destRect == d->datasetPointsDestRect &&
+                             d->datasetPointsRevision == d->dataRevision;
+
     if ( calculateListAndReturnScale ) {
         ctx->painter()->save();
         // Check if all of the data value texts / data comments will fit
         // into the available space:
         d->labelPaintCache.clear();
+        d->datasetPoints.resize( colCount );
         ctx->painter()->save();
         for ( iCol=0; iCol < colCount; ++iCol ) {
+            QPolygonF& points = d->datasetPoints[ iCol ];
+            const bool reuseColumn = reusePoints && points.size() == rowCount;
+            points.resize( rowCount );
             for ( iRow=0; iRow < rowCount; ++iRow ) {
                 QModelIndex index = model()->index( iRow, iCol, rootIndex() ); // checked
                 const qreal value = model()->data( index ).toReal();
-                QPointF point = scaleToRealPosition( QPointF( value, iRow ), ctx->rectangle(), destRect, *ctx->coordinatePlane() );
-                d->addLabel( &d->labelPaintCache, index, nullptr, PositionPoints( point ),
+                if ( !reuseColumn ) {
+                    points[ iRow ] = scaleToRealPosition( QPointF( value, iRow ), ctx->rectangle(), destRect, *ctx->coordinatePlane() );
+                }
+                d->addLabel( &d->labelPaintCache, index, nullptr, PositionPoints( points[ iRow ] ),
                              Position::Center, Position::Center, value );
             }
         }
+        d->datasetPointsGeometry = geometry;
+        d->datasetPointsDestRect = destRect;
+        d->datasetPointsRevision = d->dataRevision;
+        d->datasetPointsValid = true;
         ctx->painter()->restore();
         const qreal oldZoomX = coordinatePlane()->zoomFactorX();
         const qreal oldZoomY = coordinatePlane()->zoomFactorY();
@@ -240,13 +260,19 @@ void RadarDiagram::paint( PaintContext* ctx,
             //           in the same way as LineDiagram does it.
             QPolygonF polygon;
             QPointF point0;
-            for ( iRow=0; iRow < rowCount; ++iRow ) {
-                QModelIndex index = model()->index( iRow, iCol, rootIndex() ); // checked
-                const qreal value = model()->data( index ).toReal();
-                QPointF point = scaleToRealPosition( QPointF( value, d->reverseData ? ( rowCount - iRow ) : iRow ), ctx->rectangle(), destRect, *ctx->coordinatePlane() );
-                polygon.append( point );
-                if ( ! iRow )
-                    point0= point;
+            if ( reusePoints && !d->reverseData && d->datasetPoints[ iCol ].size() == rowCount ) {
+                polygon = d->datasetPoints[ iCol ];
+                if ( rowCount )
+                    point0 = polygon.first();
+            } else {
+                for ( iRow=0; iRow < rowCount; ++iRow ) {
+                    QModelIndex index = model()->index( iRow, iCol, rootIndex() ); // checked
+                    const qreal value = model()->data( index ).toReal();
+                    QPointF point = scaleToRealPosition( QPointF( value, d->reverseData ? ( rowCount - iRow ) : iRow ), ctx->rectangle(), destRect, *ctx->coordinatePlane() );
+                    polygon.append( point );
+                    if ( ! iRow )
+                        point0= point;
+                }
             }
             if ( closeDatasets() && rowCount )
                 polygon.append( point0 );
@@ -271,6 +297,7 @@ void RadarDiagram::paint( PaintContext* ctx,
                 ctx->painter()->setBrush( br );
                 ctx->painter()->setPen( p.pen );
                 ctx->painter()->drawPolygon( p.polygon );
+                Instrumentation::count( Instrumentation::PrimitivesDrawn );
             }
         }
 
@@ -281,6 +308,7 @@ void RadarDiagram::paint( PaintContext* ctx,
             ctx->painter()->setBrush( p.brush );
             ctx->painter()->setPen( p.pen );
             ctx->painter()->drawPolyline( p.polygon );
+            Instrumentation::count( Instrumentation::PrimitivesDrawn );
         }
 
         d->paintDataValueTextsAndMarkers( ctx, d->labelPaintCache, true );
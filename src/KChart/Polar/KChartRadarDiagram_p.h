@@ -33,8 +33,11 @@
 
 #include "KChartAbstractPolarDiagram_p.h"
 #include "KChartRadarDiagram.h"
+#include "KChartPolarGrid.h"
 #include "KChartMath_p.h"
 
+#include <QPolygonF>
+#include <QVector>
 
 namespace KChart {
 
@@ -52,7 +55,9 @@ public:
         AbstractPolarDiagram::Private( rhs ),
         closeDatasets( rhs.closeDatasets ),
         reverseData( rhs.reverseData ),
-        fillAlpha( rhs.fillAlpha )
+        fillAlpha( rhs.fillAlpha ),
+        datasetPointsRevision( 0 ),
+        datasetPointsValid( false )
         {
         }
 
@@ -61,6 +66,15 @@ private:
     bool reverseData;
     qreal fillAlpha;
     LabelPaintCache labelPaintCache;
+    // the label positions of the first paint() pass; unless the data is reversed they are
+    // the corners of the polygons, which the drawing pass then does not need to calculate again.
+    // They are kept for later paints as long as neither the plane geometry, the rectangle
+    // the diagram is scaled into nor the data change.
+    QVector< QPolygonF > datasetPoints;
+    PolarGridGeometry datasetPointsGeometry;
+    QRectF datasetPointsDestRect;
+    uint datasetPointsRevision;
+    bool datasetPointsValid;
 };
 
 KCHART_IMPL_DERIVED_DIAGRAM( RadarDiagram, AbstractPolarDiagram, RadarCoordinatePlane )
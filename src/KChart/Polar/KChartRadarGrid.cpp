@@ -177,17 +177,26 @@ void RadarGrid::drawGrid( PaintContext* context )
     context->painter()->setPen ( PrintingParameters::scalePen( QColor ( Qt::lightGray ) ) );
     if ( plane->globalGridAttributes().isGridVisible() )
     {
-        for ( int j = 1; j < dgr->numberOfGridRings() + 1; ++j )
-        {
-            QPointF oldPoint( scaleToRealPosition( QPointF( j * step - qAbs( min ), numberOfSpokes - 1 ), context->rectangle(), destRect, *plane ) );
-            for ( int i = 0; i < numberOfSpokes ; ++i ) {                
-                const QPointF newPoint = scaleToRealPosition( QPointF( j * step - qAbs( min ), i ), context->rectangle(), destRect, *plane );
-                context->painter()->drawLine( oldPoint, newPoint );
-                oldPoint = newPoint;
-                
-                context->painter()->drawLine( origin, newPoint );
+        const PolarGridGeometry geometry( plane, context->rectangle(), min, dgr->dataBoundaries().second.y(),
+                                          dgr->numberOfGridRings() );
+        if ( m_lines.isEmpty() || geometry != m_linesGeometry || destRect != m_linesDestRect || origin != m_linesOrigin ) {
+            m_linesGeometry = geometry;
+            m_linesDestRect = destRect;
+            m_linesOrigin = origin;
+            m_lines.clear();
+            for ( int j = 1; j < dgr->numberOfGridRings() + 1; ++j )
+            {
+                QPointF oldPoint( scaleToRealPosition( QPointF( j * step - qAbs( min ), numberOfSpokes - 1 ), context->rectangle(), destRect, *plane ) );
+                for ( int i = 0; i < numberOfSpokes ; ++i ) {
+                    const QPointF newPoint = scaleToRealPosition( QPointF( j * step - qAbs( min ), i ), context->rectangle(), destRect, *plane );
+                    m_lines.append( QLineF( oldPoint, newPoint ) );
+                    oldPoint = newPoint;
+
+                    m_lines.append( QLineF( origin, newPoint ) );
+                }
             }
         }
+        context->painter()->drawLines( m_lines );
         context->painter()->setPen( ta.pen() );
         qreal fontSize = 0;
         for ( int i = 0; i < dgr->numberOfGridRings() + 1; ++i )
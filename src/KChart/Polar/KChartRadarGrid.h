@@ -22,6 +22,7 @@
 
 //#include "KChartRadarCoordinatePlane.h"
 #include "KChartAbstractGrid.h"
+#include "KChartPolarGrid.h"
 
 namespace KChart {
 
@@ -49,6 +50,12 @@ namespace KChart {
     private:
         DataDimensionsList calculateGrid(
             const DataDimensionsList& rawDataDimensions ) const Q_DECL_OVERRIDE;
+
+        // the rings and spokes of the last paint, and the geometry they belong to
+        PolarGridGeometry m_linesGeometry;
+        QRectF m_linesDestRect;
+        QPointF m_linesOrigin;
+        QVector< QLineF > m_lines;
     };
 
 }
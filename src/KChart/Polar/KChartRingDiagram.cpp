@@ -28,13 +28,15 @@
 #include "KChartThreeDPieAttributes.h"
 #include "KChartDataValueAttributes.h"
 #include "KChartMath_p.h"
+#include "KChartInstrumentation.h"
 
 #include <QPainter>
 
 using namespace KChart;
 
 RingDiagram::Private::Private()
-    : relativeThickness( false )
+    : size( 0 )
+    , relativeThickness( false )
     , expandWhenExploded( false )
 {
 }
@@ -81,6 +83,7 @@ bool RingDiagram::compare( const RingDiagram* other ) const
 void RingDiagram::setRelativeThickness( bool relativeThickness )
 {
     d->relativeThickness = relativeThickness;
+    d->sliceGeometryDirty = true;
 }
 
 bool RingDiagram::relativeThickness() const
@@ -91,6 +94,7 @@ bool RingDiagram::relativeThickness() const
 void RingDiagram::setExpandWhenExploded( bool expand )
 {
         d->expandWhenExploded = expand;
+        d->sliceGeometryDirty = true;
 }
 
 bool RingDiagram::expandWhenExploded() const
@@ -153,8 +157,6 @@ void RingDiagram::paint( PaintContext* ctx )
     if ( !checkInvariants(true) )
         return;
 
-    d->reverseMapper.clear();
-
     const PieAttributes attrs( pieAttributes() );
 
     const int rCount = rowCount();
@@ -165,6 +167,8 @@ void RingDiagram::paint( PaintContext* ctx )
     if ( contentsRect.isEmpty() )
         return;
 
+    const QVector< QVector<qreal> > previousStartAngles = d->startAngles;
+    const QVector< QVector<qreal> > previousAngleLens = d->angleLens;
     d->startAngles = QVector< QVector<qreal> >( rCount, QVector<qreal>( colCount ) );
     d->angleLens = QVector< QVector<qreal> >( rCount, QVector<qreal>( colCount ) );
 
@@ -206,9 +210,10 @@ void RingDiagram::paint( PaintContext* ctx )
 
     QVariant vValY;
 
-    d->forgetAlreadyPaintedDataValues();
+    QVector< qreal > rowTotals( rCount );
     for ( int iRow = 0; iRow < rCount; ++iRow ) {
         const qreal sum = valueTotals( iRow );
+        rowTotals[ iRow ] = sum;
         if ( sum == 0.0 ) //nothing to draw
             continue;
         qreal currentValue = plane ? plane->startPosition() : 0.0;
@@ -233,7 +238,27 @@ void RingDiagram::paint( PaintContext* ctx )
             }
 
             currentValue = d->startAngles[ iRow ][ iColumn ] + d->angleLens[ iRow ][ iColumn ];
+        }
+    }
+
+    // the slice outlines only depend on the angles, the attributes, the paint rectangle and
+    // how far the painter scales it, so they are reused until one of them changes
+    const qreal arcScale = Private::deviceScale( ctx->painter() );
+    if ( d->sliceGeometryDirty || contentsRect != d->cachedRectangle || arcScale != d->arcScale ||
+         d->startAngles != previousStartAngles || d->angleLens != previousAngleLens ) {
+        d->sliceGeometryDirty = false;
+        d->cachedRectangle = contentsRect;
+        d->arcScale = arcScale;
+        d->sliceGeometry = QVector< QVector< Private::SliceGeometry > >(
+                               rCount, QVector< Private::SliceGeometry >( colCount ) );
+        d->reverseMapper.clear();
+    }
 
+    d->forgetAlreadyPaintedDataValues();
+    for ( int iRow = 0; iRow < rCount; ++iRow ) {
+        if ( rowTotals[ iRow ] == 0.0 ) //nothing to draw
+            continue;
+        for ( int iColumn = 0; iColumn < colCount; ++iColumn ) {
             drawOneSlice( ctx->painter(), iRow, iColumn, granularity() );
         }
     }
@@ -274,17 +299,9 @@ void RingDiagram::drawPieSurface( QPainter* painter, uint dataset, uint slice, q
     // Is there anything to draw at all?
     qreal angleLen = d->angleLens[ dataset ][ slice ];
     if ( angleLen ) {
-        qreal startAngle = d->startAngles[ dataset ][ slice ];
-
         QModelIndex index( model()->index( dataset, slice, rootIndex() ) ); // checked
-        const PieAttributes attrs( pieAttributes( index ) );
         const ThreeDPieAttributes threeDAttrs( threeDPieAttributes( index ) );
 
-        const int rCount = rowCount();
-        const int colCount = columnCount();
-
-        int iPoint = 0;
-
         QRectF drawPosition = d->position;
 
         painter->setRenderHint ( QPainter::Antialiasing );
@@ -302,98 +319,21 @@ void RingDiagram::drawPieSurface( QPainter* painter, uint dataset, uint slice, q
             // FIXME: Draw a complete ring here
             //painter->drawEllipse( drawPosition );
         } else {
-            bool perfectMatch = false;
-
-            qreal circularGap = 0.0;
-
-            if ( attrs.gapFactor( true ) > 0.0 ) {
-                // FIXME: Measure in degrees!
-                circularGap = attrs.gapFactor( true );
-            }
-
-            QPolygonF poly;
-
-            qreal degree = 0;
-
-            qreal actualStartAngle = startAngle + circularGap;
-            qreal actualAngleLen = angleLen - 2 * circularGap;
-
-            qreal totalRadialExplode = 0.0;
-            qreal maxRadialExplode = 0.0;
-
-            qreal totalRadialGap = 0.0;
-            qreal maxRadialGap = 0.0;
-            for ( uint i = rCount - 1; i > dataset; --i ) {
-                qreal maxRadialExplodeInThisRow = 0.0;
-                qreal maxRadialGapInThisRow = 0.0;
-                for ( int j = 0; j < colCount; ++j ) {
-                    const PieAttributes cellAttrs( pieAttributes( model()->index( i, j, rootIndex() ) ) ); // checked
-                    if ( d->expandWhenExploded ) {
-                        maxRadialGapInThisRow = qMax( maxRadialGapInThisRow, cellAttrs.gapFactor( false ) );
-                    }
-
-                    // Don't use a gap for the very inner circle
-                    if ( cellAttrs.explode() && d->expandWhenExploded ) {
-                        maxRadialExplodeInThisRow = qMax( maxRadialExplodeInThisRow, cellAttrs.explodeFactor() );
-                    }
-                }
-                maxRadialExplode += maxRadialExplodeInThisRow;
-                maxRadialGap += maxRadialGapInThisRow;
-
-                // FIXME: What if explode factor of inner ring is > 1.0 ?
-                //if ( !d->expandWhenExploded )
-                //    break;
-            }
-            totalRadialGap = maxRadialGap + attrs.gapFactor( false );
-            totalRadialExplode = attrs.explode() ? maxRadialExplode + attrs.explodeFactor() : maxRadialExplode;
-
-            while ( degree <= actualAngleLen ) {
-            const QPointF p = pointOnEllipse( drawPosition, dataset, slice, false, actualStartAngle + degree,
-                                              totalRadialGap, totalRadialExplode );
-                poly.append( p );
-                degree += granularity;
-                iPoint++;
+            Private::SliceGeometry& geometry = d->sliceGeometry[ dataset ][ slice ];
+            if ( geometry.polygon.isEmpty() ) {
+                geometry.polygon = slicePolygon( dataset, slice, granularity,
+                                                 &geometry.lastInnerBrinkPoint, &geometry.centerPoint );
+                d->reverseMapper.addPolygon( index.row(), index.column(), geometry.polygon );
             }
-            if ( ! perfectMatch ) {
-                poly.append( pointOnEllipse( drawPosition, dataset, slice, false, actualStartAngle + actualAngleLen,
-                                             totalRadialGap, totalRadialExplode ) );
-                iPoint++;
-            }
-
-            // The center point of the inner brink
-            const QPointF innerCenterPoint( poly[ int(iPoint / 2) ] );
+            const QPolygonF& poly = geometry.polygon;
+            const int lastInnerBrinkPoint = geometry.lastInnerBrinkPoint;
+            const QPointF& centerPoint = geometry.centerPoint;
 
-            actualStartAngle = startAngle + circularGap;
-            actualAngleLen = angleLen - 2 * circularGap;
-
-            degree = actualAngleLen;
-
-            const int lastInnerBrinkPoint = iPoint;
-            while ( degree >= 0 ) {
-                poly.append( pointOnEllipse( drawPosition, dataset, slice, true, actualStartAngle + degree,
-                                             totalRadialGap, totalRadialExplode ) );
-                perfectMatch = (degree == 0);
-                degree -= granularity;
-                iPoint++;
-            }
-            // if necessary add one more point to fill the last small gap
-            if ( ! perfectMatch ) {
-                poly.append( pointOnEllipse( drawPosition, dataset, slice, true, actualStartAngle,
-                                             totalRadialGap, totalRadialExplode ) );
-                iPoint++;
-            }
-
-            // The center point of the outer brink
-            const QPointF outerCenterPoint( poly[ lastInnerBrinkPoint + int((iPoint - lastInnerBrinkPoint) / 2) ] );
-            //qDebug() << poly;
             //find the value and paint it
             //fix value position
             const qreal sum = valueTotals( dataset );
             painter->drawPolygon( poly );
-
-            d->reverseMapper.addPolygon( index.row(), index.column(), poly );
-
-            const QPointF centerPoint = (innerCenterPoint + outerCenterPoint) / 2.0;
+            Instrumentation::count( Instrumentation::PrimitivesDrawn );
 
             const PainterSaver ps( painter );
             const TextAttributes ta = dataValueAttributes( index ).textAttributes();
@@ -415,6 +355,121 @@ void RingDiagram::drawPieSurface( QPainter* painter, uint dataset, uint slice, q
 }
 
 
+/**
+  Internal method that computes the outline of one of the slices in a ring chart
+  and the position of its label.
+
+  \param dataset the dataset of the slice
+  \param slice the slice
+  \param granularity the finest angular step to tessellate the arcs with
+  \param lastInnerBrinkPoint returns the index of the first point of the outer arc
+  \param centerPoint returns the position of the label
+  */
+QPolygonF RingDiagram::slicePolygon( uint dataset, uint slice, qreal granularity,
+                                     int* lastInnerBrinkPoint, QPointF* centerPoint )
+{
+    const qreal angleLen = d->angleLens[ dataset ][ slice ];
+    const qreal startAngle = d->startAngles[ dataset ][ slice ];
+    const QModelIndex index( model()->index( dataset, slice, rootIndex() ) ); // checked
+    const PieAttributes attrs( pieAttributes( index ) );
+
+    const int rCount = rowCount();
+    const int colCount = columnCount();
+    const QRectF drawPosition = d->position;
+    // the rings are narrow, tessellate for the outermost one
+    const qreal step = d->arcStep( granularity, drawPosition.width() / 2.0 );
+
+    bool perfectMatch = false;
+
+    qreal circularGap = 0.0;
+
+    if ( attrs.gapFactor( true ) > 0.0 ) {
+        // FIXME: Measure in degrees!
+        circularGap = attrs.gapFactor( true );
+    }
+
+    QPolygonF poly;
+    int iPoint = 0;
+
+    qreal degree = 0;
+
+    qreal actualStartAngle = startAngle + circularGap;
+    qreal actualAngleLen = angleLen - 2 * circularGap;
+
+    qreal totalRadialExplode = 0.0;
+    qreal maxRadialExplode = 0.0;
+
+    qreal totalRadialGap = 0.0;
+    qreal maxRadialGap = 0.0;
+    for ( uint i = rCount - 1; i > dataset; --i ) {
+        qreal maxRadialExplodeInThisRow = 0.0;
+        qreal maxRadialGapInThisRow = 0.0;
+        for ( int j = 0; j < colCount; ++j ) {
+            const PieAttributes cellAttrs( pieAttributes( model()->index( i, j, rootIndex() ) ) ); // checked
+            if ( d->expandWhenExploded ) {
+                maxRadialGapInThisRow = qMax( maxRadialGapInThisRow, cellAttrs.gapFactor( false ) );
+            }
+
+            // Don't use a gap for the very inner circle
+            if ( cellAttrs.explode() && d->expandWhenExploded ) {
+                maxRadialExplodeInThisRow = qMax( maxRadialExplodeInThisRow, cellAttrs.explodeFactor() );
+            }
+        }
+        maxRadialExplode += maxRadialExplodeInThisRow;
+        maxRadialGap += maxRadialGapInThisRow;
+
+        // FIXME: What if explode factor of inner ring is > 1.0 ?
+        //if ( !d->expandWhenExploded )
+        //    break;
+    }
+    totalRadialGap = maxRadialGap + attrs.gapFactor( false );
+    totalRadialExplode = attrs.explode() ? maxRadialExplode + attrs.explodeFactor() : maxRadialExplode;
+
+    while ( degree <= actualAngleLen ) {
+        const QPointF p = pointOnEllipse( drawPosition, dataset, slice, false, actualStartAngle + degree,
+                                          totalRadialGap, totalRadialExplode );
+        poly.append( p );
+        degree += step;
+        iPoint++;
+    }
+    if ( ! perfectMatch ) {
+        poly.append( pointOnEllipse( drawPosition, dataset, slice, false, actualStartAngle + actualAngleLen,
+                                     totalRadialGap, totalRadialExplode ) );
+        iPoint++;
+    }
+
+    // The center point of the inner brink
+    const QPointF innerCenterPoint( poly[ int(iPoint / 2) ] );
+
+    actualStartAngle = startAngle + circularGap;
+    actualAngleLen = angleLen - 2 * circularGap;
+
+    degree = actualAngleLen;
+
+    *lastInnerBrinkPoint = iPoint;
+    while ( degree >= 0 ) {
+        poly.append( pointOnEllipse( drawPosition, dataset, slice, true, actualStartAngle + degree,
+                                     totalRadialGap, totalRadialExplode ) );
+        perfectMatch = (degree == 0);
+        degree -= step;
+        iPoint++;
+    }
+    // if necessary add one more point to fill the last small gap
+    if ( ! perfectMatch ) {
+        poly.append( pointOnEllipse( drawPosition, dataset, slice, true, actualStartAngle,
+                                     totalRadialGap, totalRadialExplode ) );
+        iPoint++;
+    }
+
+    // The center point of the outer brink
+    const QPointF outerCenterPoint( poly[ *lastInnerBrinkPoint + int((iPoint - *lastInnerBrinkPoint) / 2) ] );
+    //qDebug() << poly;
+
+    *centerPoint = ( innerCenterPoint + outerCenterPoint ) / 2.0;
+    return poly;
+}
+
+
 /**
   * Auxiliary method returning a point to a given boundary
   * rectangle of the enclosed ellipse and an angle.
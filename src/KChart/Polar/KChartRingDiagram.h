@@ -80,6 +80,8 @@ protected:
 private:
     void drawOneSlice( QPainter* painter, uint dataset, uint slice, qreal granularity );
     void drawPieSurface( QPainter* painter, uint dataset, uint slice, qreal granularity );
+    QPolygonF slicePolygon( uint dataset, uint slice, qreal granularity,
+                            int* lastInnerBrinkPoint, QPointF* centerPoint );
     QPointF pointOnEllipse( const QRectF& rect, int dataset, int slice, bool outer, qreal angle,
                             qreal totalGapFactor, qreal totalExplodeFactor );
 }; // End of class RingDiagram
@@ -70,6 +70,19 @@ protected:
     bool expandWhenExploded;
     // polygons associated to their 3d depth
     QMap<qreal, QPolygon> polygonsToRender;
+
+    /**
+     * The outline of one slice and where its label goes, kept between paints.
+     */
+    struct SliceGeometry {
+        QPolygonF polygon;
+        int lastInnerBrinkPoint;
+        QPointF centerPoint;
+    };
+    // the paint rectangle sliceGeometry was computed for
+    QRectF cachedRectangle;
+    // per dataset and slice, an empty polygon means not computed yet
+    QVector< QVector< SliceGeometry > > sliceGeometry;
 };
 
 KCHART_IMPL_DERIVED_DIAGRAM( RingDiagram, AbstractPieDiagram, PolarCoordinatePlane )
@@ -21,6 +21,11 @@
 #include "KChartAbstractTernaryDiagram_p.h"
 
 #include "KChartTernaryCoordinatePlane.h"
+#include "TernaryConstants.h"
+
+#include <limits>
+
+#include <QDebug>
 
 using namespace KChart;
 
@@ -29,6 +34,52 @@ AbstractTernaryDiagram::Private::Private()
 {
 }
 
+void AbstractTernaryDiagram::Private::projectDataset( const TernaryCoordinatePlane* plane, int column,
+                                                      ProjectedDataset* dataset ) const
+{
+    dataset->rows.clear();
+    dataset->values.clear();
+    dataset->positions.clear();
+
+    const QAbstractItemModel* model = diagram->model();
+    const QModelIndex rootIndex = diagram->rootIndex();
+    const int rowCount = model->rowCount( rootIndex );
+    dataset->rows.reserve( rowCount );
+    dataset->values.reserve( 3 * rowCount );
+    dataset->positions.reserve( rowCount );
+
+    // translate( TernaryPoint( a, b ) ) is ( 1 - b, 0 ) + a * AxisVector_C_A, and the plane maps
+    // that linearly to widget coordinates, so every point is origin + a * aUnit + b * bUnit
+    const QPointF origin = plane->translate( QPointF( 1.0, 0.0 ) );
+    const QPointF aUnit = plane->translate( QPointF( 1.0, 0.0 ) + AxisVector_C_A ) - origin;
+    const QPointF bUnit = plane->translate( QPointF( 0.0, 0.0 ) ) - origin;
+
+    for ( int row = 0; row < rowCount; ++row ) {
+        // see if there is data otherwise skip
+        const QVariant base = model->data( model->index( row, column, rootIndex ) ); // checked
+        if ( base.isNull() ) {
+            continue;
+        }
+        const qreal x = qMax( base.toReal(), qreal( 0.0 ) );
+        const qreal y = qMax( model->data( model->index( row, column + 1, rootIndex ) ).toReal(), // checked
+                              qreal( 0.0 ) );
+        const qreal z = qMax( model->data( model->index( row, column + 2, rootIndex ) ).toReal(), // checked
+                              qreal( 0.0 ) );
+
+        // fix messed up data values (paint as much as possible)
+        const qreal total = x + y + z;
+        if ( fabs( total ) > 3 * std::numeric_limits<qreal>::epsilon() ) {
+            dataset->rows.append( row );
+            dataset->values << x << y << z;
+            dataset->positions.append( origin + ( x / total ) * aUnit + ( y / total ) * bUnit );
+        } else {
+            // ignore and do not paint this point, garbage data
+            qDebug() << "AbstractTernaryDiagram: data point x/y/z:"
+                     << x << "/" << y << "/" << z << "ignored, unusable.";
+        }
+    }
+}
+
 void AbstractTernaryDiagram::init()
 {
 }
@@ -43,6 +43,8 @@
 #include "ReverseMapper.h"
 #include "ChartGraphicsItem.h"
 
+#include <QVector>
+
 namespace KChart {
 
 /**
@@ -69,6 +71,24 @@ namespace KChart {
         AbstractTernaryDiagram* referenceDiagram;
         QPointF referenceDiagramOffset;
 
+        /**
+         * The usable data points of one dataset, stored in contiguous arrays.
+         */
+        struct ProjectedDataset {
+            QVector< int > rows;
+            // x, y and z of each point, negative values clamped to zero
+            QVector< qreal > values;
+            // the points in widget coordinates
+            QVector< QPointF > positions;
+        };
+
+        /**
+         * Reads the dataset starting at \a column and projects all its usable points
+         * onto \a plane in one go. Rows without data or with a zero sum are left out.
+         */
+        void projectDataset( const TernaryCoordinatePlane* plane, int column,
+                             ProjectedDataset* dataset ) const;
+
         void drawPoint( QPainter* p, int row, int column,
                         const QPointF& widgetLocation )
         {
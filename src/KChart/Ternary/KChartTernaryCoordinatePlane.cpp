@@ -27,6 +27,7 @@
 #include "KChartPainterSaver_p.h"
 #include "KChartTernaryAxis.h"
 #include "KChartAbstractTernaryDiagram.h"
+#include "KChartInstrumentation.h"
 
 #include "TernaryConstants.h"
 
@@ -149,6 +150,7 @@ QSizePolicy TernaryCoordinatePlane::sizePolicy() const
 
 void TernaryCoordinatePlane::paint( QPainter* painter )
 {
+    Instrumentation::Scope scope( "paint", this );
     PainterSaver s( painter );
     // FIXME: this is not a good location for that:
     painter->setRenderHint(QPainter::Antialiasing, true );
@@ -164,11 +166,15 @@ void TernaryCoordinatePlane::paint( QPainter* painter )
 
         // paint the coordinate system rulers:
         Q_ASSERT( d->grid != nullptr );
-        d->grid->drawGrid( &ctx );
+        {
+            Instrumentation::Scope gridScope( "grid", this );
+            d->grid->drawGrid( &ctx );
+        }
 
         // paint the diagrams:
         for ( int i = 0; i < diags.size(); i++ )
         {
+            Instrumentation::Scope diagramScope( "paint", diags[i] );
             PainterSaver diagramPainterSaver( painter );
             diags[i]->paint ( &ctx );
         }
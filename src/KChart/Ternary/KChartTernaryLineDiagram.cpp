@@ -23,6 +23,7 @@
 #include <limits>
 
 #include <QPainter>
+#include <QPolygonF>
 
 #include <KChartPaintContext.h>
 
@@ -32,6 +33,7 @@
 #include "TernaryPoint.h"
 #include "TernaryConstants.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartInstrumentation.h"
 
 using namespace KChart;
 
@@ -88,61 +90,68 @@ void  TernaryLineDiagram::paint (PaintContext *paintContext)
         (TernaryCoordinatePlane*) paintContext->coordinatePlane();
     Q_ASSERT( plane );
 
-    qreal x, y, z;
-
     // for some reason(?) TernaryPointDiagram is using per-diagram DVAs only:
     const DataValueAttributes attrs( dataValueAttributes() );
 
     d->forgetAlreadyPaintedDataValues();
 
-    int columnCount = model()->columnCount( rootIndex() );
-    QPointF start;
-    for (int column=0; column<columnCount; column+=datasetDimension() )
+    const int columnCount = model()->columnCount( rootIndex() );
+    const int numrows = model()->rowCount( rootIndex() );
+    // see TernaryPointDiagram::paint()
+    static const int MarkerSpriteThreshold = 1000;
+    const int datasetCount = ( columnCount + datasetDimension() - 1 ) / datasetDimension();
+    d->useMarkerSprites = numrows * datasetCount >= MarkerSpriteThreshold;
+
+    Private::ProjectedDataset dataset;
+    QPolygonF polyline;
+    for ( int column = 0; column < columnCount; column += datasetDimension() )
     {
-        int numrows = model()->rowCount( rootIndex() );
-        for ( int row = 0; row < numrows; row++ )
+        d->projectDataset( plane, column, &dataset );
+
+        // connect consecutive points with as few polylines as the pens allow,
+        // the pen of a segment is the one of the point it leads to
+        p->setBrush( Qt::NoBrush );
+        polyline.clear();
+        QPen polylinePen;
+        for ( int i = 0; i < dataset.rows.size(); ++i )
         {
-            // see if there is data otherwise skip
-            QModelIndex base = model()->index( row, column ); // checked
-            if ( ! model()->data( base ).isNull() )
-            {
-                p->setPen( PrintingParameters::scalePen( pen( base ) ) );
-                p->setBrush( brush( base ) );
-
-                // retrieve data
-                x = qMax( model()->data( model()->index( row, column, rootIndex() ) ).toReal(), // checked
-                          0.0 );
-                y = qMax( model()->data( model()->index( row, column+1, rootIndex() ) ).toReal(), // checked
-                          0.0 );
-                z = qMax( model()->data( model()->index( row, column+2, rootIndex() ) ).toReal(), // checked
-                          0.0 );
-
-                qreal total = x + y + z;
-                if ( fabs( total ) > 3 * std::numeric_limits<qreal>::epsilon() ) {
-                    TernaryPoint tPunkt( x / total, y / total );
-                    QPointF diagramLocation = translate( tPunkt );
-                    QPointF widgetLocation = plane->translate( diagramLocation );
-
-                    if ( row > 0 ) {
-                        p->drawLine( start, widgetLocation );
-                    }
-                    paintMarker( p, model()->index( row, column, rootIndex() ), widgetLocation ); // checked
-                    start = widgetLocation;
-                    // retrieve text and data value attributes
-                    // FIXME use data model DisplayRole text
-                    QString text = tr( "(%1, %2, %3)", "(x, y, z) values of the data point" )
-                                   .arg( x * 100, 0, 'f', 0 )
-                                   .arg( y * 100, 0, 'f', 0 )
-                                   .arg( z * 100, 0, 'f', 0 );
-                    d->paintDataValueText( p, attrs, widgetLocation, true, text, true );
-                } else {
-                    // ignore and do not paint this point, garbage data
-                    qDebug() << "TernaryPointDiagram::paint: data point x/y/z:"
-                             << x << "/" << y << "/" << z << "ignored, unusable.";
+            const QPen segmentPen = PrintingParameters::scalePen(
+                        pen( model()->index( dataset.rows.at( i ), column, rootIndex() ) ) ); // checked
+            if ( i > 0 && segmentPen != polylinePen ) {
+                if ( polyline.size() > 1 ) {
+                    p->setPen( polylinePen );
+                    p->drawPolyline( polyline );
+                    Instrumentation::count( Instrumentation::PrimitivesDrawn );
                 }
+                polyline.clear();
+                polyline << dataset.positions.at( i - 1 );
+            }
+            polylinePen = segmentPen;
+            polyline << dataset.positions.at( i );
+        }
+        if ( polyline.size() > 1 ) {
+            p->setPen( polylinePen );
+            p->drawPolyline( polyline );
+            Instrumentation::count( Instrumentation::PrimitivesDrawn );
+        }
+
+        for ( int i = 0; i < dataset.rows.size(); ++i )
+        {
+            const QPointF& widgetLocation = dataset.positions.at( i );
+            paintMarker( p, model()->index( dataset.rows.at( i ), column, rootIndex() ), widgetLocation ); // checked
+            if ( attrs.isVisible() ) {
+                // FIXME use data model DisplayRole text
+                const qreal* values = dataset.values.constData() + 3 * i;
+                QString text = tr( "(%1, %2, %3)", "(x, y, z) values of the data point" )
+                               .arg( values[ 0 ] * 100, 0, 'f', 0 )
+                               .arg( values[ 1 ] * 100, 0, 'f', 0 )
+                               .arg( values[ 2 ] * 100, 0, 'f', 0 );
+                d->paintDataValueText( p, attrs, widgetLocation, true, text, true );
             }
         }
     }
+
+    d->useMarkerSprites = false;
 }
 
 const QPair< QPointF, QPointF >  TernaryLineDiagram::calculateDataBoundaries () const
@@ -76,56 +76,39 @@ void  TernaryPointDiagram::paint (PaintContext *paintContext)
         static_cast< TernaryCoordinatePlane* >( paintContext->coordinatePlane() );
     Q_ASSERT( plane );
 
-    qreal x, y, z;
-
-
     // for some reason(?) TernaryPointDiagram is using per-diagram DVAs only:
     const DataValueAttributes attrs( dataValueAttributes() );
 
     d->forgetAlreadyPaintedDataValues();
 
-    int columnCount = model()->columnCount( rootIndex() );
-    for (int column=0; column<columnCount; column+=datasetDimension() )
+    const int columnCount = model()->columnCount( rootIndex() );
+    const int numrows = model()->rowCount( rootIndex() );
+    // copying pre-rendered markers is a lot faster than painting each of them, and
+    // the difference is invisible when the plane does not scale the painter
+    static const int MarkerSpriteThreshold = 1000;
+    const int datasetCount = ( columnCount + datasetDimension() - 1 ) / datasetDimension();
+    d->useMarkerSprites = numrows * datasetCount >= MarkerSpriteThreshold;
+
+    Private::ProjectedDataset dataset;
+    for ( int column = 0; column < columnCount; column += datasetDimension() )
     {
-        int numrows = model()->rowCount( rootIndex() );
-        for ( int row = 0; row < numrows; row++ )
+        d->projectDataset( plane, column, &dataset );
+        for ( int i = 0; i < dataset.rows.size(); ++i )
         {
-            QModelIndex base = model()->index( row, column, rootIndex() ); // checked
-            // see if there is data otherwise skip
-            if ( ! model()->data( base ).isNull() )
-            {
-                p->setPen( PrintingParameters::scalePen( pen( base ) ) );
-                p->setBrush( brush( base ) );
-
-                // retrieve data
-                x = qMax( model()->data( model()->index( row, column+0, rootIndex() ) ).toReal(), // checked
-                          0.0 );
-                y = qMax( model()->data( model()->index( row, column+1, rootIndex() ) ).toReal(), // checked
-                          0.0 );
-                z = qMax( model()->data( model()->index( row, column+2, rootIndex() ) ).toReal(), // checked
-                          0.0 );
-
-                // fix messed up data values (paint as much as possible)
-                qreal total = x + y + z;
-                if ( fabs( total ) > 3 * std::numeric_limits<qreal>::epsilon() ) {
-                    TernaryPoint tPunkt( x / total, y / total );
-                    QPointF diagramLocation = translate( tPunkt );
-                    QPointF widgetLocation = plane->translate( diagramLocation );
-
-                    paintMarker( p, model()->index( row, column, rootIndex() ), widgetLocation ); // checked
-                    QString text = tr( "(%1, %2, %3)", "(x, y, z) values of the data point" )
-                                   .arg( x * 100, 0, 'f', 0 )
-                                   .arg( y * 100, 0, 'f', 0 )
-                                   .arg( z * 100, 0, 'f', 0 );
-                    d->paintDataValueText( p, attrs, widgetLocation, true, text, true );
-                } else {
-                    // ignore and do not paint this point, garbage data
-                    qDebug() << "TernaryPointDiagram::paint: data point x/y/z:"
-                             << x << "/" << y << "/" << z << "ignored, unusable.";
-                }
+            const QPointF& widgetLocation = dataset.positions.at( i );
+            paintMarker( p, model()->index( dataset.rows.at( i ), column, rootIndex() ), widgetLocation ); // checked
+            if ( attrs.isVisible() ) {
+                const qreal* values = dataset.values.constData() + 3 * i;
+                QString text = tr( "(%1, %2, %3)", "(x, y, z) values of the data point" )
+                               .arg( values[ 0 ] * 100, 0, 'f', 0 )
+                               .arg( values[ 1 ] * 100, 0, 'f', 0 )
+                               .arg( values[ 2 ] * 100, 0, 'f', 0 );
+                d->paintDataValueText( p, attrs, widgetLocation, true, text, true );
             }
         }
     }
+
+    d->useMarkerSprites = false;
 }
 
 const QPair< QPointF, QPointF >  TernaryPointDiagram::calculateDataBoundaries () const
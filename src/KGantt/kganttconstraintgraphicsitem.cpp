@@ -18,12 +18,15 @@
  */
 
 #include "kganttconstraintgraphicsitem.h"
+#include "kganttconstraintgraphicsitem_p.h"
 #include "kganttconstraintmodel.h"
 #include "kganttgraphicsscene.h"
 #include "kganttitemdelegate.h"
 #include "kganttsummaryhandlingproxymodel.h"
 
+#include <QHash>
 #include <QPainter>
+#include <QStyleOptionGraphicsItem>
 #include <QDebug>
 
 using namespace KGantt;
@@ -42,8 +45,62 @@ ConstraintGraphicsItem::ConstraintGraphicsItem( const Constraint& c, QGraphicsIt
     setZValue( 10. );
 }
 
+/* The routed geometry of every constraint item, see ConstraintGeometry */
+typedef QHash<const ConstraintGraphicsItem*, ConstraintGeometry> ConstraintGeometryHash;
+Q_GLOBAL_STATIC( ConstraintGeometryHash, constraintGeometries )
+
+typedef QHash<const QStyleOptionGraphicsItem*, const ConstraintGeometry*> AttachedGeometryHash;
+
+static AttachedGeometryHash& attachedGeometries()
+{
+    static AttachedGeometryHash s_attached;
+    return s_attached;
+}
+
+/* \returns The geometry of \a item as routed by the delegate of its
+ * scene. It is routed again only if an endpoint moved or the scene
+ * got another delegate since the last call.
+ */
+const ConstraintGeometry& ConstraintGeometry::of( const ConstraintGraphicsItem* item )
+{
+    ConstraintGeometry& geometry = ( *constraintGeometries() )[ item ];
+    const ItemDelegate* delegate = item->scene()->itemDelegate();
+    const Constraint& c = item->constraint();
+    if ( !geometry.isValidFor( delegate, item->start(), item->end(), c.relationType() ) ) {
+        geometry.delegate = delegate;
+        geometry.start = item->start();
+        geometry.end = item->end();
+        geometry.relationType = c.relationType();
+        geometry.boundingRect = delegate->constraintBoundingRect( geometry.start, geometry.end, c );
+        geometry.line = delegate->constraintLine( geometry.start, geometry.end, c );
+        geometry.arrow = delegate->constraintArrow( geometry.start, geometry.end, c );
+    }
+    return geometry;
+}
+
+/* \returns The geometry attached to \a opt, or 0 if there is none. */
+const ConstraintGeometry* ConstraintGeometry::find( const QStyleOptionGraphicsItem& opt )
+{
+    const AttachedGeometryHash& attached = attachedGeometries();
+    return attached.isEmpty() ? nullptr : attached.value( &opt, nullptr );
+}
+
+/* Attaches \a geometry to \a opt until the attacher goes out of scope. */
+ConstraintGeometryAttacher::ConstraintGeometryAttacher( const QStyleOptionGraphicsItem& opt, const ConstraintGeometry& geometry )
+    : m_opt( opt )
+{
+    attachedGeometries().insert( &opt, &geometry );
+}
+
+ConstraintGeometryAttacher::~ConstraintGeometryAttacher()
+{
+    attachedGeometries().remove( &m_opt );
+}
+
 ConstraintGraphicsItem::~ConstraintGraphicsItem()
 {
+    if ( !constraintGeometries.isDestroyed() )
+        constraintGeometries()->remove( this );
 }
 
 int ConstraintGraphicsItem::type() const
@@ -65,7 +122,16 @@ Constraint ConstraintGraphicsItem::proxyConstraint() const
 
 QRectF ConstraintGraphicsItem::boundingRect() const
 {
-    return scene()->itemDelegate()->constraintBoundingRect( m_start, m_end, m_constraint );
+    return ConstraintGeometry::of( this ).boundingRect;
+}
+
+/* Makes the scene fetch the bounding rect again, e.g. because the
+ * scene got another delegate. The geometry itself is rerouted lazily.
+ */
+void ConstraintGraphicsItem::invalidateGeometry()
+{
+    prepareGeometryChange();
+    update();
 }
 
 void ConstraintGraphicsItem::paint( QPainter* painter, const QStyleOptionGraphicsItem* option,
@@ -73,6 +139,11 @@ void ConstraintGraphicsItem::paint( QPainter* painter, const QStyleOptionGraphic
 {
     Q_UNUSED( widget );
     //qDebug() << "ConstraintGraphicsItem::paint(...), c=" << m_constraint;
+    // Hidden or batched by GraphicsScene at this level of detail
+    if ( scene()->isLevelOfDetail( this, option->levelOfDetailFromTransform( painter->worldTransform() ) ) ) return;
+    // Painted together with the other constraints by GraphicsScene::drawBackground()
+    if ( scene()->itemDelegate()->isConstraintBatchingEnabled() ) return;
+    const ConstraintGeometryAttacher attacher( *option, ConstraintGeometry::of( this ) );
     scene()->itemDelegate()->paintConstraintItem( painter, *option, m_start, m_end, m_constraint );
 }
 
@@ -97,6 +168,9 @@ void ConstraintGraphicsItem::setEnd( const QPointF& end )
 
 void ConstraintGraphicsItem::updateItem( const QPointF& start,const QPointF& end )
 {
-    setStart( start );
-    setEnd( end );
+    if ( start == m_start && end == m_end ) return;
+    prepareGeometryChange();
+    m_start = start;
+    m_end = end;
+    update();
 }
@@ -54,6 +54,9 @@ namespace KGantt {
 
         void updateItem( const QPointF& start,const QPointF& end );
     private:
+        friend class GraphicsScene;
+        void invalidateGeometry();
+
         Constraint m_constraint;
         QPointF m_start;
         QPointF m_end;
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KGantt library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KGANTTCONSTRAINTGRAPHICSITEM_P_H
+#define KGANTTCONSTRAINTGRAPHICSITEM_P_H
+
+#include "kganttconstraintgraphicsitem.h"
+
+#include <QPolygonF>
+#include <QRectF>
+
+QT_BEGIN_NAMESPACE
+class QStyleOptionGraphicsItem;
+QT_END_NAMESPACE
+
+namespace KGantt {
+    /* The geometry of a constraint as routed by an ItemDelegate.
+     * ConstraintGraphicsItem keeps it until an endpoint moves or the
+     * scene gets another delegate, and attaches it to the option it
+     * passes to ItemDelegate::paintConstraintItem(), which then paints
+     * it instead of routing the constraint again. The geometry is
+     * attached to that one option object for the duration of the paint
+     * call; copies of the option do not carry it.
+     */
+    struct Q_DECL_HIDDEN ConstraintGeometry {
+        ConstraintGeometry() : delegate( nullptr ), relationType( Constraint::FinishStart ) {}
+
+        bool isValidFor( const ItemDelegate* d, const QPointF& s, const QPointF& e,
+                         Constraint::RelationType type ) const
+        {
+            return delegate && delegate == d && start == s && end == e && relationType == type;
+        }
+
+        static const ConstraintGeometry& of( const ConstraintGraphicsItem* item );
+        static const ConstraintGeometry* find( const QStyleOptionGraphicsItem& opt );
+
+        const ItemDelegate* delegate;
+        QPointF start;
+        QPointF end;
+        Constraint::RelationType relationType;
+        QRectF boundingRect;
+        QPolygonF line;
+        QPolygonF arrow;
+    };
+
+    class Q_DECL_HIDDEN ConstraintGeometryAttacher {
+        Q_DISABLE_COPY( ConstraintGeometryAttacher )
+    public:
+        ConstraintGeometryAttacher( const QStyleOptionGraphicsItem& opt, const ConstraintGeometry& geometry );
+        ~ConstraintGeometryAttacher();
+
+    private:
+        const QStyleOptionGraphicsItem& m_opt;
+    };
+}
+
+#endif /* KGANTTCONSTRAINTGRAPHICSITEM_P_H */
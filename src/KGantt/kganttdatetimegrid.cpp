@@ -23,8 +23,13 @@
 #include "kganttabstractrowcontroller.h"
 
 #include <QApplication>
+#include <QDataStream>
 #include <QDateTime>
 #include <QPainter>
+#include <QPainterPath>
+#include <QPaintDevice>
+#include <QTimeZone>
+#include <QtMath>
 #include <QStyle>
 #include <QStyleOptionHeader>
 #include <QWidget>
@@ -32,7 +37,9 @@
 #include <QDebug>
 #include <QList>
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 
 using namespace KGantt;
 
@@ -58,14 +65,33 @@ QDebug operator<<( QDebug dbg, KGantt::DateTimeScaleFormatter::Range range )
  * and shows days and week numbers in the header
  */
 
+namespace {
+    const qint64 msecsPerDay = 24*60*60*1000;
+    // QDate( 1970, 1, 1 ).toJulianDay()
+    const qint64 epochJulianDay = 2440588;
+
+    inline qint64 wallMSecs( const QDateTime& dt )
+    {
+        return dt.date().toJulianDay() * msecsPerDay + dt.time().msecsSinceStartOfDay();
+    }
+}
+
+void DateTimeGrid::Private::updateMapping()
+{
+    startMSecs = startDateTime.isValid() ? wallMSecs( startDateTime ) : 0;
+    secsToX = dayWidth/( 24.*60.*60. );
+    transitions.clear();
+    transitionsFrom = transitionsTo = 0;
+    transitionsKnown = false;
+}
+
 qreal DateTimeGrid::Private::dateTimeToChartX( const QDateTime& dt ) const
 {
     assert( startDateTime.isValid() );
-    qreal result = startDateTime.date().daysTo(dt.date())*24.*60.*60.;
-    result += startDateTime.time().msecsTo(dt.time())/1000.;
-    result *= dayWidth/( 24.*60.*60. );
-
-    return result;
+    if ( !dt.isValid() ) return 0.;
+    // Same as startDateTime.date().daysTo( dt.date() ) days plus
+    // startDateTime.time().msecsTo( dt.time() ), without QDateTime arithmetic
+    return ( ( wallMSecs( dt ) - startMSecs )/1000. )*secsToX;
 }
 
 QDateTime DateTimeGrid::Private::chartXtoDateTime( qreal x ) const
@@ -73,6 +99,18 @@ QDateTime DateTimeGrid::Private::chartXtoDateTime( qreal x ) const
     assert( startDateTime.isValid() );
     int days = static_cast<int>( x/dayWidth );
     qreal secs = x*( 24.*60.*60. )/dayWidth;
+
+    // Adding days keeps the wall clock time, adding (milli)seconds does not
+    // when the UTC offset changes in between. Without such a change both
+    // are plain additions to the wall clock time.
+    const qint64 dayMSecs = startMSecs + days*msecsPerDay;
+    const qint64 msecs = dayMSecs
+                         + static_cast<int>( secs-(days*24.*60.*60.) )*qint64( 1000 )
+                         + qRound( ( secs-static_cast<int>( secs ) )*1000. );
+    if ( !hasTransitionBetween( dayMSecs, msecs ) ) {
+        return wallMSecsToDateTime( msecs );
+    }
+
     QDateTime dt = startDateTime;
     QDateTime result = dt.addDays( days )
                        .addSecs( static_cast<int>(secs-(days*24.*60.*60.) ) )
@@ -80,6 +118,77 @@ QDateTime DateTimeGrid::Private::chartXtoDateTime( qreal x ) const
     return result;
 }
 
+QDateTime DateTimeGrid::Private::wallMSecsToDateTime( qint64 msecs ) const
+{
+    const QDate date = QDate::fromJulianDay( msecs/msecsPerDay );
+    const QTime time = QTime::fromMSecsSinceStartOfDay( static_cast<int>( msecs%msecsPerDay ) );
+    switch ( startDateTime.timeSpec() ) {
+    case Qt::TimeZone:
+        return QDateTime( date, time, startDateTime.timeZone() );
+    case Qt::OffsetFromUTC:
+        return QDateTime( date, time, Qt::OffsetFromUTC, startDateTime.offsetFromUtc() );
+    default:
+        return QDateTime( date, time, startDateTime.timeSpec() );
+    }
+}
+
+/* \returns true if the UTC offset of startDateTime's time zone may change
+ * between the wall clock times \a from and \a to, or if that is unknown. */
+bool DateTimeGrid::Private::hasTransitionBetween( qint64 from, qint64 to ) const
+{
+    const Qt::TimeSpec spec = startDateTime.timeSpec();
+    if ( spec == Qt::UTC || spec == Qt::OffsetFromUTC ) return false;
+
+    if ( from > to ) qSwap( from, to );
+    // Wall clock times around a transition are ambiguous, keep clear of them
+    from -= msecsPerDay;
+    to += msecsPerDay;
+    if ( !transitionsKnown || from < transitionsFrom || to > transitionsTo ) {
+        if ( !loadTransitions( from, to ) ) return true;
+    }
+    QVector<qint64>::const_iterator it = std::lower_bound( transitions.constBegin(), transitions.constEnd(), from );
+    return it != transitions.constEnd() && *it <= to;
+}
+
+bool DateTimeGrid::Private::loadTransitions( qint64 from, qint64 to ) const
+{
+    const QTimeZone tz = startDateTime.timeSpec() == Qt::TimeZone
+                         ? startDateTime.timeZone() : QTimeZone::systemTimeZone();
+    if ( !tz.isValid() ) return false;
+    if ( !tz.hasTransitions() ) {
+        // Without transition data only zones without DST are safe
+        if ( tz.hasDaylightTime() ) return false;
+        transitions.clear();
+        transitionsFrom = std::numeric_limits<qint64>::min();
+        transitionsTo = std::numeric_limits<qint64>::max();
+        transitionsKnown = true;
+        return true;
+    }
+
+    // Load generously, scrolling should not hit this again
+    const qint64 margin = 5*366*msecsPerDay;
+    if ( transitionsKnown ) {
+        from = qMin( from, transitionsFrom );
+        to = qMax( to, transitionsTo );
+    }
+    from -= margin;
+    to += margin;
+
+    transitions.clear();
+    const qint64 epochMSecs = epochJulianDay*msecsPerDay;
+    const QTimeZone::OffsetDataList list =
+        tz.transitions( QDateTime::fromMSecsSinceEpoch( from - epochMSecs - msecsPerDay, Qt::UTC ),
+                        QDateTime::fromMSecsSinceEpoch( to - epochMSecs + msecsPerDay, Qt::UTC ) );
+    Q_FOREACH( const QTimeZone::OffsetData& data, list ) {
+        transitions.append( data.atUtc.toMSecsSinceEpoch() + epochMSecs + data.offsetFromUtc*qint64( 1000 ) );
+    }
+    std::sort( transitions.begin(), transitions.end() );
+    transitionsFrom = from;
+    transitionsTo = to;
+    transitionsKnown = true;
+    return true;
+}
+
 #define d d_func()
 
 /*!\class KGantt::DateTimeScaleFormatter
@@ -307,6 +416,7 @@ QDateTime DateTimeGrid::startDateTime() const
 void DateTimeGrid::setStartDateTime( const QDateTime& dt )
 {
     d->startDateTime = dt;
+    d->updateMapping();
     emit gridChanged();
 }
 
@@ -341,6 +451,7 @@ void DateTimeGrid::setDayWidth( qreal w )
 {
     assert( w>0 );
     d->dayWidth = w;
+    d->updateMapping();
     emit gridChanged();
 }
 
@@ -386,6 +497,9 @@ void DateTimeGrid::setUserDefinedLowerScale( DateTimeScaleFormatter* lower )
 {
     delete d->lower;
     d->lower = lower;
+    // the tile keys only know the formatters by address, which the new one may reuse
+    d->headerTiles.clear();
+    d->gridTiles.clear();
     emit gridChanged();
 }
 
@@ -400,6 +514,7 @@ void DateTimeGrid::setUserDefinedUpperScale( DateTimeScaleFormatter* upper )
 {
     delete d->upper;
     d->upper = upper;
+    d->headerTiles.clear();
     emit gridChanged();
 }
 
@@ -766,43 +881,53 @@ DateTimeGrid::Private::HeaderType DateTimeGrid::Private::headerTypeForScale( Dat
         return Private::HeaderDay;
 }
 
-void DateTimeGrid::paintGrid( QPainter* painter,
-                              const QRectF& sceneRect,
-                              const QRectF& exposedRect,
-                              AbstractRowController* rowController,
-                              QWidget* widget )
+void DateTimeGrid::Private::paintVerticalLinesForScale( QPainter* painter,
+                                                        const QRectF& sceneRect,
+                                                        const QRectF& exposedRect,
+                                                        QWidget* widget )
 {
     // TODO: Support hours and weeks
-    switch ( scale() ) {
+    switch ( scale ) {
     case ScaleHour:
     case ScaleDay:
     case ScaleWeek:
     case ScaleMonth:
-        d->paintVerticalLines( painter, sceneRect, exposedRect, widget, d->headerTypeForScale( scale() ) );
+        paintVerticalLines( painter, sceneRect, exposedRect, widget, headerTypeForScale( scale ) );
         break;
     case ScaleAuto: {
         const qreal tabw = QApplication::fontMetrics().width( QLatin1String( "XXXXX" ) );
-        const qreal dayw = dayWidth();
+        const qreal dayw = dayWidth;
         if ( dayw > 24*60*60*tabw ) {
 
-            d->paintVerticalUserDefinedLines( painter, sceneRect, exposedRect, &d->minute_lower, widget );
+            paintVerticalUserDefinedLines( painter, sceneRect, exposedRect, &minute_lower, widget );
         } else if ( dayw > 24*60*tabw ) {
-            d->paintVerticalLines( painter, sceneRect, exposedRect, widget, Private::HeaderHour );
+            paintVerticalLines( painter, sceneRect, exposedRect, widget, HeaderHour );
         } else if ( dayw > 24*tabw ) {
-        d->paintVerticalLines( painter, sceneRect, exposedRect, widget, Private::HeaderDay );
+        paintVerticalLines( painter, sceneRect, exposedRect, widget, HeaderDay );
         } else if ( dayw > tabw ) {
-            d->paintVerticalUserDefinedLines( painter, sceneRect, exposedRect, &d->week_lower, widget );
+            paintVerticalUserDefinedLines( painter, sceneRect, exposedRect, &week_lower, widget );
         } else if ( 4*dayw > tabw ) {
-            d->paintVerticalUserDefinedLines( painter, sceneRect, exposedRect, &d->month_lower, widget );
+            paintVerticalUserDefinedLines( painter, sceneRect, exposedRect, &month_lower, widget );
         } else {
-            d->paintVerticalUserDefinedLines( painter, sceneRect, exposedRect, &d->year_lower, widget );
+            paintVerticalUserDefinedLines( painter, sceneRect, exposedRect, &year_lower, widget );
         }
         break;
     }
     case ScaleUserDefined:
-        d->paintVerticalUserDefinedLines( painter, sceneRect, exposedRect, d->lower, widget );
+        paintVerticalUserDefinedLines( painter, sceneRect, exposedRect, lower, widget );
         break;
     }
+}
+
+void DateTimeGrid::paintGrid( QPainter* painter,
+                              const QRectF& sceneRect,
+                              const QRectF& exposedRect,
+                              AbstractRowController* rowController,
+                              QWidget* widget )
+{
+    if ( !d->paintCachedVerticalLines( painter, sceneRect, exposedRect, widget ) ) {
+        d->paintVerticalLinesForScale( painter, sceneRect, exposedRect, widget );
+    }
     if ( rowController ) {
         // First draw the rows
         QPen pen = painter->pen();
@@ -867,59 +992,209 @@ void DateTimeGrid::Private::getAutomaticFormatters( DateTimeScaleFormatter** low
 }
 
 
-void DateTimeGrid::paintHeader( QPainter* painter,  const QRectF& headerRect, const QRectF& exposedRect,
-                                qreal offset, QWidget* widget )
+void DateTimeGrid::Private::paintHeaderCells( DateTimeGrid* q, QPainter* painter,
+                                              const QRectF& headerRect, const QRectF& exposedRect,
+                                              qreal offset, QWidget* widget )
 {
-    painter->save();
-    QPainterPath clipPath;
-    clipPath.addRect( headerRect );
-    painter->setClipPath( clipPath, Qt::IntersectClip );
-    switch ( scale() )
+    switch ( q->scale() )
     {
     case ScaleHour:
-        paintHourScaleHeader( painter, headerRect, exposedRect, offset, widget );
+        q->paintHourScaleHeader( painter, headerRect, exposedRect, offset, widget );
         break;
     case ScaleDay:
-        paintDayScaleHeader( painter, headerRect, exposedRect, offset, widget );
+        q->paintDayScaleHeader( painter, headerRect, exposedRect, offset, widget );
         break;
     case ScaleWeek:
-        paintWeekScaleHeader( painter, headerRect, exposedRect, offset, widget );
+        q->paintWeekScaleHeader( painter, headerRect, exposedRect, offset, widget );
         break;
     case ScaleMonth:
-        paintMonthScaleHeader( painter, headerRect, exposedRect, offset, widget );
+        q->paintMonthScaleHeader( painter, headerRect, exposedRect, offset, widget );
         break;
     case ScaleAuto:
         {
-            DateTimeScaleFormatter *lower, *upper;
-            d->getAutomaticFormatters( &lower, &upper );
-            const qreal lowerHeight = d->tabHeight( lower->text( startDateTime() ) );
-            const qreal upperHeight = d->tabHeight( upper->text( startDateTime() ) );
+            DateTimeScaleFormatter *autoLower, *autoUpper;
+            getAutomaticFormatters( &autoLower, &autoUpper );
+            const qreal lowerHeight = tabHeight( autoLower->text( q->startDateTime() ) );
+            const qreal upperHeight = tabHeight( autoUpper->text( q->startDateTime() ) );
             const qreal upperRatio = upperHeight/( lowerHeight+upperHeight );
 
             const QRectF upperHeaderRect( headerRect.x(), headerRect.top(), headerRect.width()-1, headerRect.height() * upperRatio );
             const QRectF lowerHeaderRect( headerRect.x(), upperHeaderRect.bottom()+1, headerRect.width()-1,  headerRect.height()-upperHeaderRect.height()-1 );
 
-            paintUserDefinedHeader( painter, lowerHeaderRect, exposedRect, offset, lower, widget );
-            paintUserDefinedHeader( painter, upperHeaderRect, exposedRect, offset, upper, widget );
+            q->paintUserDefinedHeader( painter, lowerHeaderRect, exposedRect, offset, autoLower, widget );
+            q->paintUserDefinedHeader( painter, upperHeaderRect, exposedRect, offset, autoUpper, widget );
             break;
         }
     case ScaleUserDefined:
         {
-            const qreal lowerHeight = d->tabHeight( d->lower->text( startDateTime() ) );
-            const qreal upperHeight = d->tabHeight( d->upper->text( startDateTime() ) );
+            const qreal lowerHeight = tabHeight( lower->text( q->startDateTime() ) );
+            const qreal upperHeight = tabHeight( upper->text( q->startDateTime() ) );
             const qreal upperRatio = upperHeight/( lowerHeight+upperHeight );
 
             const QRectF upperHeaderRect( headerRect.x(), headerRect.top(), headerRect.width()-1, headerRect.height() * upperRatio );
             const QRectF lowerHeaderRect( headerRect.x(), upperHeaderRect.bottom()+1, headerRect.width()-1,  headerRect.height()-upperHeaderRect.height()-1 );
 
-            paintUserDefinedHeader( painter, lowerHeaderRect, exposedRect, offset, d->lower, widget );
-            paintUserDefinedHeader( painter, upperHeaderRect, exposedRect, offset, d->upper, widget );
+            q->paintUserDefinedHeader( painter, lowerHeaderRect, exposedRect, offset, lower, widget );
+            q->paintUserDefinedHeader( painter, upperHeaderRect, exposedRect, offset, upper, widget );
         }
         break;
     }
+}
+
+void DateTimeGrid::paintHeader( QPainter* painter,  const QRectF& headerRect, const QRectF& exposedRect,
+                                qreal offset, QWidget* widget )
+{
+    painter->save();
+    QPainterPath clipPath;
+    clipPath.addRect( headerRect );
+    painter->setClipPath( clipPath, Qt::IntersectClip );
+    if ( !d->paintCachedHeader( this, painter, headerRect, exposedRect, offset, widget ) ) {
+        d->paintHeaderCells( this, painter, headerRect, exposedRect, offset, widget );
+    }
     painter->restore();
 }
 
+namespace {
+    // Width of a cached tile in chart coordinates
+    const int tileWidth = 256;
+    // Height of a grid line tile, a multiple of the dash pattern length
+    const int stripeHeight = 240;
+
+    inline int tileIndex( qreal x )
+    {
+        return qFloor( x / tileWidth );
+    }
+
+    inline bool isPixelAligned( qreal v )
+    {
+        return qFuzzyCompare( 1. + v, 1. + qRound( v ) );
+    }
+
+    /* Tiles are only blitted onto widgets with a pure, pixel-aligned
+     * translation. Printing and exporting always paint directly. */
+    bool canUseTiles( QPainter* painter )
+    {
+        const QPaintDevice* device = painter->device();
+        if ( !device || device->devType() != QInternal::Widget ) return false;
+        const QTransform t = painter->deviceTransform();
+        return t.type() <= QTransform::TxTranslate
+            && isPixelAligned( t.dx() ) && isPixelAligned( t.dy() );
+    }
+}
+
+bool DateTimeGrid::Private::paintCachedHeader( DateTimeGrid* q, QPainter* painter,
+                                               const QRectF& headerRect, const QRectF& exposedRect,
+                                               qreal offset, QWidget* widget )
+{
+    if ( !widget || !canUseTiles( painter ) || !isPixelAligned( offset ) ) return false;
+
+    const qreal dpr = widget->devicePixelRatioF();
+    QByteArray key;
+    {
+        QDataStream stream( &key, QIODevice::WriteOnly );
+        stream << int( scale ) << dayWidth << startDateTime << quint64( quintptr( lower ) )
+               << quint64( quintptr( upper ) ) << headerRect.height() << dpr
+               << QApplication::font() << widget->font() << widget->palette().cacheKey()
+               << quint64( quintptr( widget->style() ) ) << widget->isEnabled()
+               << widget->isActiveWindow() << widget->underMouse()
+               << int( widget->layoutDirection() );
+    }
+    if ( key != headerTiles.key ) {
+        headerTiles.tiles.clear();
+        headerTiles.key = key;
+    }
+
+    const int off = qRound( offset );
+    const int first = tileIndex( exposedRect.left() + off );
+    const int last = tileIndex( exposedRect.right() + off );
+    for ( int tile = first; tile <= last; ++tile ) {
+        QPixmap* pix = headerTiles.tiles.object( tile );
+        if ( !pix ) {
+            pix = new QPixmap( QSize( tileWidth, qCeil( headerRect.height() ) ) * dpr );
+            pix->setDevicePixelRatio( dpr );
+            pix->fill( Qt::transparent );
+            {
+                QPainter p( pix );
+                p.setRenderHints( painter->renderHints() );
+                p.translate( 0, -headerRect.top() );
+                const QRectF tileRect( 0, headerRect.top(), tileWidth, headerRect.height() );
+                paintHeaderCells( q, &p, tileRect, tileRect, tile * tileWidth, widget );
+            }
+            headerTiles.tiles.insert( tile, pix );
+        }
+        painter->drawPixmap( QPointF( tile * tileWidth - off, headerRect.top() ), *pix );
+    }
+    return true;
+}
+
+bool DateTimeGrid::Private::paintCachedVerticalLines( QPainter* painter,
+                                                      const QRectF& sceneRect,
+                                                      const QRectF& exposedRect,
+                                                      QWidget* widget )
+{
+    // The lines end at the scene rect, only its inside is vertically uniform
+    if ( !canUseTiles( painter )
+         || exposedRect.top() < sceneRect.top() || exposedRect.bottom() > sceneRect.bottom() ) {
+        return false;
+    }
+
+    const qreal dpr = painter->device()->devicePixelRatioF();
+    QByteArray key;
+    {
+        int freeDayMask = 0;
+        Q_FOREACH( Qt::DayOfWeek day, freeDays ) {
+            freeDayMask |= 1 << day;
+        }
+        QDataStream stream( &key, QIODevice::WriteOnly );
+        stream << int( scale ) << dayWidth << startDateTime << int( weekStart ) << freeDayMask
+               << freeDaysBrush << quint64( quintptr( lower ) ) << painter->pen() << painter->brush()
+               << int( painter->renderHints() ) << dpr << QApplication::font()
+               << QApplication::palette().cacheKey()
+               << ( widget ? widget->palette().cacheKey() : qint64( 0 ) );
+    }
+    if ( key != gridTiles.key ) {
+        gridTiles.tiles.clear();
+        gridTiles.key = key;
+    }
+
+    painter->save();
+    painter->setClipRect( exposedRect, Qt::IntersectClip );
+    const int first = tileIndex( exposedRect.left() );
+    const int last = tileIndex( exposedRect.right() );
+    const int firstStripe = qFloor( ( exposedRect.top() - sceneRect.top() ) / stripeHeight );
+    for ( int tile = first; tile <= last; ++tile ) {
+        QPixmap* pix = gridTiles.tiles.object( tile );
+        if ( !pix ) {
+            pix = new QPixmap( QSize( tileWidth, stripeHeight ) * dpr );
+            pix->setDevicePixelRatio( dpr );
+            pix->fill( Qt::transparent );
+            {
+                QPainter p( pix );
+                p.setRenderHints( painter->renderHints() );
+                p.setPen( painter->pen() );
+                p.setBrush( painter->brush() );
+                p.translate( -tile * tileWidth, 0 );
+                const QRectF tileRect( tile * tileWidth, 0, tileWidth, stripeHeight );
+                paintVerticalLinesForScale( &p, tileRect, tileRect, widget );
+            }
+            gridTiles.tiles.insert( tile, pix );
+        }
+        for ( qreal y = sceneRect.top() + firstStripe * stripeHeight; y < exposedRect.bottom(); y += stripeHeight ) {
+            painter->drawPixmap( QPointF( tile * tileWidth, y ), *pix );
+        }
+    }
+    painter->restore();
+    return true;
+}
+
+/*! Paints one part of the header of a user defined or automatic
+ * scale, using \a formatter.
+ *
+ * When painted on a widget, the header is cached in tiles, so a
+ * reimplementation is only called again when the grid changes. Call
+ * invalidateHeaderCache() when its output changes for other reasons.
+ * \sa paintHeader()
+ */
 void DateTimeGrid::paintUserDefinedHeader( QPainter* painter,
                                            const QRectF& headerRect, const QRectF& exposedRect,
                                            qreal offset, const DateTimeScaleFormatter* formatter,
@@ -1000,6 +1275,10 @@ void DateTimeGrid::Private::paintHeader( QPainter* painter,
 }
 
 /*! Paints the hour scale header.
+ *
+ * When painted on a widget, the header is cached in tiles, so a
+ * reimplementation is only called again when the grid changes. Call
+ * invalidateHeaderCache() when its output changes for other reasons.
  * \sa paintHeader()
  */
 void DateTimeGrid::paintHourScaleHeader( QPainter* painter,
@@ -1041,6 +1320,10 @@ void DateTimeGrid::paintHourScaleHeader( QPainter* painter,
 }
 
 /*! Paints the day scale header.
+ *
+ * When painted on a widget, the header is cached in tiles, so a
+ * reimplementation is only called again when the grid changes. Call
+ * invalidateHeaderCache() when its output changes for other reasons.
  * \sa paintHeader()
  */
 void DateTimeGrid::paintDayScaleHeader( QPainter* painter,  const QRectF& headerRect, const QRectF& exposedRect,
@@ -1081,6 +1364,10 @@ void DateTimeGrid::paintDayScaleHeader( QPainter* painter,  const QRectF& header
 }
 
 /*! Paints the week scale header.
+ *
+ * When painted on a widget, the header is cached in tiles, so a
+ * reimplementation is only called again when the grid changes. Call
+ * invalidateHeaderCache() when its output changes for other reasons.
  * \sa paintHeader()
  */
 void DateTimeGrid::paintWeekScaleHeader( QPainter* painter,  const QRectF& headerRect, const QRectF& exposedRect,
@@ -1120,6 +1407,10 @@ void DateTimeGrid::paintWeekScaleHeader( QPainter* painter,  const QRectF& heade
 }
 
 /*! Paints the week scale header.
+ *
+ * When painted on a widget, the header is cached in tiles, so a
+ * reimplementation is only called again when the grid changes. Call
+ * invalidateHeaderCache() when its output changes for other reasons.
  * \sa paintHeader()
  */
 void DateTimeGrid::paintMonthScaleHeader( QPainter* painter,  const QRectF& headerRect, const QRectF& exposedRect,
@@ -1186,6 +1477,17 @@ QRectF DateTimeGrid::computeRect(const QDateTime& from, const QDateTime& to, con
     return QRectF(topLeft, rect.top(), topRight - topLeft, rect.height());
 }
 
+/*! Drops the cached header tiles, so the header is painted again by
+ * paintHourScaleHeader(), paintDayScaleHeader(), paintWeekScaleHeader(),
+ * paintMonthScaleHeader() or paintUserDefinedHeader() the next time it
+ * is repainted. Subclasses whose header depends on state the grid does
+ * not know about call this when that state changes.
+ */
+void DateTimeGrid::invalidateHeaderCache()
+{
+    d->headerTiles.clear();
+}
+
 /** Return a date-range represented by the rectangle.
 */
 QPair<QDateTime, QDateTime> DateTimeGrid::dateTimeRange(const QRectF& rect) const
@@ -119,6 +119,7 @@ namespace KGantt {
         
         QRectF computeRect(const QDateTime& from, const QDateTime& to, const QRectF& rect) const;
         QPair<QDateTime, QDateTime> dateTimeRange(const QRectF& rect) const;
+        void invalidateHeaderCache();
 
         /* reimp */ void drawBackground(QPainter* paint, const QRectF& rect) Q_DECL_OVERRIDE;
         /* reimp */ void drawForeground(QPainter* paint, const QRectF& rect) Q_DECL_OVERRIDE;
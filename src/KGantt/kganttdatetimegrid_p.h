@@ -26,6 +26,10 @@
 
 #include <QDateTime>
 #include <QBrush>
+#include <QByteArray>
+#include <QCache>
+#include <QPixmap>
+#include <QVector>
 
 namespace KGantt {
     class Q_DECL_HIDDEN DateTimeScaleFormatter::Private
@@ -75,6 +79,7 @@ namespace KGantt {
               minute_lower( DateTimeScaleFormatter::Second, QString::fromLatin1("s" ) ),
               timeLine(new DateTimeTimeLine)
         {
+            updateMapping();
         }
         ~Private()
         {
@@ -86,6 +91,11 @@ namespace KGantt {
         qreal dateTimeToChartX( const QDateTime& dt ) const;
         QDateTime chartXtoDateTime( qreal x ) const;
 
+        void updateMapping();
+        QDateTime wallMSecsToDateTime( qint64 msecs ) const;
+        bool hasTransitionBetween( qint64 from, qint64 to ) const;
+        bool loadTransitions( qint64 from, qint64 to ) const;
+
         int tabHeight( const QString& txt, QWidget* widget = nullptr ) const;
         void getAutomaticFormatters( DateTimeScaleFormatter** lower, DateTimeScaleFormatter** upper);
 
@@ -130,6 +140,35 @@ namespace KGantt {
 
         void drawTimeLine(QPainter* painter, const QRectF& rect);
 
+        void paintVerticalLinesForScale( QPainter* painter,
+                                         const QRectF& sceneRect,
+                                         const QRectF& exposedRect,
+                                         QWidget* widget );
+        void paintHeaderCells( DateTimeGrid* q, QPainter* painter,
+                               const QRectF& headerRect, const QRectF& exposedRect,
+                               qreal offset, QWidget* widget );
+
+        /* Rendered header cells and vertical grid lines, split into tiles
+         * of a fixed width in chart coordinates. The tiles are dropped as
+         * soon as anything that goes into their rendering changes. */
+        struct TileCache {
+            TileCache() : tiles( 64 ) {}
+            void clear() { key.clear(); tiles.clear(); }
+            QByteArray key;
+            QCache<int, QPixmap> tiles;
+        };
+
+        bool paintCachedHeader( DateTimeGrid* q, QPainter* painter,
+                                const QRectF& headerRect, const QRectF& exposedRect,
+                                qreal offset, QWidget* widget );
+        bool paintCachedVerticalLines( QPainter* painter,
+                                       const QRectF& sceneRect,
+                                       const QRectF& exposedRect,
+                                       QWidget* widget );
+
+        TileCache headerTiles;
+        TileCache gridTiles;
+
         QDateTime startDateTime;
         QDateTime endDateTime;
         qreal dayWidth;
@@ -156,6 +195,19 @@ namespace KGantt {
         DateTimeScaleFormatter minute_upper;
         DateTimeScaleFormatter minute_lower;
         DateTimeTimeLine *timeLine;
+
+        /* The mapping between dates and chart coordinates works on
+         * wall clock milliseconds (julian day * msecs per day + msecs since
+         * midnight). startMSecs is the wall clock time of startDateTime. */
+        qint64 startMSecs;
+        qreal secsToX;
+
+        /* Wall clock times of UTC offset changes of the time zone of
+         * startDateTime, loaded on demand for [transitionsFrom, transitionsTo] */
+        mutable QVector<qint64> transitions;
+        mutable qint64 transitionsFrom;
+        mutable qint64 transitionsTo;
+        mutable bool transitionsKnown;
     };
 
     inline DateTimeGrid::DateTimeGrid( DateTimeGrid::Private* d ) : AbstractGrid( d ) {}
@@ -26,6 +26,7 @@
 #include "kganttconstraint.h"
 #include "kganttabstractgrid.h"
 #include "kganttabstractrowcontroller.h"
+#include "kganttstyleoptionganttitem_p.h"
 
 #include <cassert>
 #include <cmath>
@@ -38,6 +39,8 @@
 #include <QItemSelectionModel>
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsLineItem>
+#include <QStyleOptionGraphicsItem>
+#include <QHash>
 
 #include <QDebug>
 
@@ -50,6 +53,34 @@ using namespace KGantt;
 typedef QGraphicsItem BASE;
 
 namespace {
+    /* Model data needed to paint a GraphicsItem, see
+     * GraphicsItem::updateStyleCache(). It is kept here and not in
+     * the item, so that the layout of GraphicsItem does not change.
+     */
+    struct StyleCache {
+        StyleCache()
+            : displayPosition( StyleOptionGanttItem::Left ),
+              displayAlignment( Qt::AlignLeft|Qt::AlignVCenter ) {}
+
+        StyleOptionGanttItem::Position displayPosition;
+        Qt::Alignment displayAlignment;
+        QString text;
+        StyleOptionGanttItemData itemData;
+    };
+    typedef QHash<const GraphicsItem*, StyleCache> StyleCacheHash;
+    Q_GLOBAL_STATIC( StyleCacheHash, styleCaches )
+
+    /* The style cache of \a item, which updateStyleCache() filled. */
+    const StyleCache& cachedStyle( const GraphicsItem* item )
+    {
+        return *styleCaches()->constFind( item );
+    }
+
+    void invalidateStyleCache( const GraphicsItem* item )
+    {
+        if ( !styleCaches.isDestroyed() ) styleCaches()->remove( item );
+    }
+
     class Updater {
         bool *u_ptr;
         bool oldval;
@@ -82,6 +113,7 @@ GraphicsItem::GraphicsItem( const QModelIndex& idx, QGraphicsItem* parent,
 
 GraphicsItem::~GraphicsItem()
 {
+    invalidateStyleCache( this );
 }
 
 void GraphicsItem::init()
@@ -99,42 +131,71 @@ int GraphicsItem::type() const
     return Type;
 }
 
-StyleOptionGanttItem GraphicsItem::getStyleOption() const
+/* Reads everything painting needs from the model into the style cache
+ * of this item, unless it is there already. The cache is invalidated
+ * by setIndex(), i.e. whenever updateItem() runs for a changed row,
+ * and when the constraints change.
+ */
+void GraphicsItem::updateStyleCache() const
 {
-    StyleOptionGanttItem opt;
-    if (!m_index.isValid()) {
-        // TODO: find out why we get invalid indexes
-        //qDebug()<<"GraphicsItem::getStyleOption: Invalid index";
-        return opt;
-    }
-    opt.itemRect = rect();
-    opt.boundingRect = boundingRect();
-    QVariant tp = m_index.model()->data( m_index, TextPositionRole );
+    StyleCacheHash* caches = styleCaches();
+    if ( caches->contains( this ) ) return;
+    StyleCache& cache = ( *caches )[ this ];
+    if (!m_index.isValid()) return;
+
+    const QAbstractItemModel* model = m_index.model();
+    QVariant tp = model->data( m_index, TextPositionRole );
     if (tp.isValid()) {
-        opt.displayPosition = static_cast<StyleOptionGanttItem::Position>(tp.toInt());
+        cache.displayPosition = static_cast<StyleOptionGanttItem::Position>(tp.toInt());
     } else {
 #if 0
-        qDebug() << "Item" << m_index.model()->data( m_index, Qt::DisplayRole ).toString()
+        qDebug() << "Item" << model->data( m_index, Qt::DisplayRole ).toString()
                  << ", ends="<<m_endConstraints.size() << ", starts="<<m_startConstraints.size();
 #endif
-        opt.displayPosition = m_endConstraints.size()<m_startConstraints.size()?StyleOptionGanttItem::Left:StyleOptionGanttItem::Right;
+        cache.displayPosition = m_endConstraints.size()<m_startConstraints.size()?StyleOptionGanttItem::Left:StyleOptionGanttItem::Right;
 #if 0
-        qDebug() << "choosing" << opt.displayPosition;
+        qDebug() << "choosing" << cache.displayPosition;
 #endif
     }
-    QVariant da = m_index.model()->data( m_index, Qt::TextAlignmentRole );
+    QVariant da = model->data( m_index, Qt::TextAlignmentRole );
     if ( da.isValid() ) {
-        opt.displayAlignment = static_cast< Qt::Alignment >( da.toInt() );
+        cache.displayAlignment = static_cast< Qt::Alignment >( da.toInt() );
     } else {
-        switch ( opt.displayPosition ) {
-        case StyleOptionGanttItem::Left: opt.displayAlignment = Qt::AlignLeft|Qt::AlignVCenter; break;
-        case StyleOptionGanttItem::Right: opt.displayAlignment = Qt::AlignRight|Qt::AlignVCenter; break;
+        switch ( cache.displayPosition ) {
+        case StyleOptionGanttItem::Left: cache.displayAlignment = Qt::AlignLeft|Qt::AlignVCenter; break;
+        case StyleOptionGanttItem::Right: cache.displayAlignment = Qt::AlignRight|Qt::AlignVCenter; break;
         case StyleOptionGanttItem::Hidden: // fall through
-        case StyleOptionGanttItem::Center: opt.displayAlignment = Qt::AlignCenter; break;
+        case StyleOptionGanttItem::Center: cache.displayAlignment = Qt::AlignCenter; break;
         }
     }
+    cache.text = model->data( m_index, Qt::DisplayRole ).toString();
+    cache.itemData.itemType = static_cast<ItemType>( model->data( m_index, ItemTypeRole ).toInt() );
+    cache.itemData.taskCompletion = model->data( m_index, TaskCompletionRole );
+}
+
+/* \returns The item type of index(), from the style cache. */
+ItemType GraphicsItem::cachedItemType() const
+{
+    updateStyleCache();
+    return cachedStyle( this ).itemData.itemType;
+}
+
+StyleOptionGanttItem GraphicsItem::getStyleOption() const
+{
+    StyleOptionGanttItem opt;
+    if (!m_index.isValid()) {
+        // TODO: find out why we get invalid indexes
+        //qDebug()<<"GraphicsItem::getStyleOption: Invalid index";
+        return opt;
+    }
+    updateStyleCache();
+    const StyleCache& cache = cachedStyle( this );
+    opt.itemRect = rect();
+    opt.boundingRect = boundingRect();
+    opt.displayPosition = cache.displayPosition;
+    opt.displayAlignment = cache.displayAlignment;
     opt.grid = scene()->grid();
-    opt.text = m_index.model()->data( m_index, Qt::DisplayRole ).toString();
+    opt.text = cache.text;
     if ( isEnabled() ) opt.state  |= QStyle::State_Enabled;
     if ( isSelected() ) opt.state |= QStyle::State_Selected;
     if ( hasFocus() ) opt.state   |= QStyle::State_HasFocus;
@@ -178,8 +239,14 @@ void GraphicsItem::paint( QPainter* painter, const QStyleOptionGraphicsItem* opt
 {
     Q_UNUSED( widget );
     if ( boundingRect().isValid() && scene() ) {
+        // Too narrow to show any detail, GraphicsScene paints it in a batch
+        if ( scene()->isLevelOfDetail( this, option->levelOfDetailFromTransform( painter->worldTransform() ) ) ) return;
+        // Paint from the style cache, without querying the model
         StyleOptionGanttItem opt = getStyleOption();
         *static_cast<QStyleOption*>(&opt) = *static_cast<const QStyleOption*>( option );
+        updateStyleCache();
+        const StyleOptionGanttItemData data = cachedStyle( this ).itemData;
+        const StyleOptionGanttItemDataAttacher attacher( opt, data );
         //opt.fontMetrics = painter->fontMetrics();
         scene()->itemDelegate()->paintGanttItem( painter, opt, index() );
     }
@@ -188,6 +255,7 @@ void GraphicsItem::paint( QPainter* painter, const QStyleOptionGraphicsItem* opt
 void GraphicsItem::setIndex( const QPersistentModelIndex& idx )
 {
     m_index=idx;
+    invalidateStyleCache( this );
     update();
 }
 
@@ -229,6 +297,7 @@ QPointF GraphicsItem::endConnector( int relationType ) const
 void GraphicsItem::constraintsChanged()
 {
     if ( !scene() || !scene()->itemDelegate() ) return;
+    invalidateStyleCache( this );
     const Span bs = scene()->itemDelegate()->itemBoundingSpan( getStyleOption(), index() );
     const QRectF br = boundingRect();
     setBoundingRect( QRectF( bs.start(), 0., bs.length(), br.height() ) );
@@ -266,6 +335,12 @@ void GraphicsItem::removeEndConstraint( ConstraintGraphicsItem* item )
 
 void GraphicsItem::updateConstraintItems()
 {
+    if ( m_startConstraints.isEmpty() && m_endConstraints.isEmpty() ) return;
+    GraphicsScene* gs = scene();
+    if ( gs && gs->isBatchUpdating() ) {
+        gs->deferConstraintUpdate( this );
+        return;
+    }
     { // Workaround for multiple definition error with MSVC6
     Q_FOREACH( ConstraintGraphicsItem* item, m_startConstraints ) {
         QPointF s = startConnector( item->constraint().relationType() );
@@ -88,11 +88,15 @@ namespace KGantt {
         /*reimp*/ void mouseMoveEvent( QGraphicsSceneMouseEvent* ) Q_DECL_OVERRIDE;
 
     private:
+        friend class GraphicsScene; // moves constraint items in batch updates, checks the item type
+
         void init();
 
         QPointF startConnector( int relationType ) const;
         QPointF endConnector( int relationType ) const;
         void updateConstraintItems();
+        void updateStyleCache() const;
+        ItemType cachedItemType() const;
         StyleOptionGanttItem getStyleOption() const;
         void updateModel();
         void updateItemFromMouse( const QPointF& scenepos );
@@ -29,11 +29,16 @@
 
 #include <QApplication>
 #include <QGraphicsSceneHelpEvent>
+#include <QPagedPaintDevice>
 #include <QPainter>
 #include <QPrinter>
+#include <QStyleOptionGraphicsItem>
 #include <QTextDocument>
 #include <QToolTip>
 #include <QSet>
+#include <QMap>
+#include <QVector>
+#include <QtMath>
 
 #include <QDebug>
 
@@ -59,6 +64,7 @@ using namespace KGantt;
 GraphicsScene::Private::Private( GraphicsScene* _q )
     : q( _q ),
       dragSource( nullptr ),
+      batchUpdateLevel( 0 ),
       itemDelegate( new ItemDelegate( _q ) ),
       rowController( nullptr ),
       grid( &default_grid ),
@@ -175,6 +181,7 @@ void GraphicsScene::Private::clearItems()
         delete item;
     }
     items.clear();
+    pendingConstraintUpdates.clear();
     // do last to avoid cleaning up items
     clearConstraintItems();
 }
@@ -208,6 +215,9 @@ void GraphicsScene::setItemDelegate( ItemDelegate* delegate )
 {
     if ( !d->itemDelegate.isNull() && d->itemDelegate->parent()==this ) delete d->itemDelegate;
     d->itemDelegate = delegate;
+    Q_FOREACH( ConstraintGraphicsItem* citem, d->constraintItems ) {
+        citem->invalidateGeometry();
+    }
     update();
 }
 
@@ -395,6 +405,215 @@ void GraphicsScene::Private::recursiveUpdateMultiItem( const Span& span, const Q
     }
 }
 
+/* Moves every constraint item attached to one of the items collected
+ * during a batch update. Each constraint item is moved once, even if
+ * both its start and end item were updated, possibly several times.
+ */
+void GraphicsScene::Private::flushConstraintUpdates()
+{
+    typedef QPair<QPointF,QPointF> Endpoints;
+    QHash<ConstraintGraphicsItem*,Endpoints> endpoints;
+    Q_FOREACH( GraphicsItem* item, pendingConstraintUpdates ) {
+        Q_FOREACH( ConstraintGraphicsItem* citem, item->startConstraints() ) {
+            QHash<ConstraintGraphicsItem*,Endpoints>::iterator it = endpoints.find( citem );
+            if ( it == endpoints.end() ) it = endpoints.insert( citem, Endpoints( citem->start(), citem->end() ) );
+            it->first = item->startConnector( citem->constraint().relationType() );
+        }
+        Q_FOREACH( ConstraintGraphicsItem* citem, item->endConstraints() ) {
+            QHash<ConstraintGraphicsItem*,Endpoints>::iterator it = endpoints.find( citem );
+            if ( it == endpoints.end() ) it = endpoints.insert( citem, Endpoints( citem->start(), citem->end() ) );
+            it->second = item->endConnector( citem->constraint().relationType() );
+        }
+    }
+    pendingConstraintUpdates.clear();
+    for ( QHash<ConstraintGraphicsItem*,Endpoints>::const_iterator it = endpoints.constBegin();
+          it != endpoints.constEnd(); ++it ) {
+        it.key()->updateItem( it->first, it->second );
+    }
+}
+
+/*! Starts a batch update. Until the matching endBatchUpdate(),
+ * items updated with GraphicsItem::updateItem() only change their own
+ * geometry; the constraint items attached to them are moved once
+ * when the outermost batch ends. Calls may be nested.
+ */
+void GraphicsScene::beginBatchUpdate()
+{
+    ++d->batchUpdateLevel;
+}
+
+/*! Ends a batch update started with beginBatchUpdate(). */
+void GraphicsScene::endBatchUpdate()
+{
+    assert( d->batchUpdateLevel > 0 );
+    if ( --d->batchUpdateLevel == 0 ) {
+        d->flushConstraintUpdates();
+    }
+}
+
+/*! \returns true between beginBatchUpdate() and endBatchUpdate(). */
+bool GraphicsScene::isBatchUpdating() const
+{
+    return d->batchUpdateLevel > 0;
+}
+
+/*! Called by \a item instead of moving its constraint items
+ * while a batch update is in progress.
+ */
+void GraphicsScene::deferConstraintUpdate( GraphicsItem* item )
+{
+    assert( isBatchUpdating() );
+    d->pendingConstraintUpdates.insert( item );
+}
+
+static bool leftLessThan( const QRectF& a, const QRectF& b )
+{
+    return a.left() < b.left();
+}
+
+/* \returns the type of \a item if it is to be painted with level of
+ * detail at \a levelOfDetail (see QStyleOptionGraphicsItem), TypeNone otherwise.
+ */
+int GraphicsScene::Private::levelOfDetailType( const GraphicsItem* item, qreal levelOfDetail ) const
+{
+    if ( isPrinting || itemDelegate.isNull() || item->isSelected() ) return TypeNone;
+    const qreal width = itemDelegate->levelOfDetailWidth();
+    if ( width <= 0. || item->rect().width()*levelOfDetail >= width ) return TypeNone;
+    const int typ = item->cachedItemType();
+    return ( typ == TypeTask || typ == TypeSummary ) ? typ : TypeNone;
+}
+
+/* Appends the items of the row of \a idx to \a result, and those of
+ * its descendants if they are drawn in the same row.
+ */
+void GraphicsScene::Private::appendRowItems( const QModelIndex& idx, QVector<const GraphicsItem*>* result ) const
+{
+    for ( int col = 0; col < summaryHandlingModel->columnCount( idx.parent() ); ++col ) {
+        const GraphicsItem* item = items.value( idx.sibling( idx.row(), col ), nullptr );
+        if ( item ) result->append( item );
+    }
+    if ( summaryHandlingModel->data( idx, ItemTypeRole ).toInt() != TypeMulti
+         || rowController->isRowExpanded( summaryHandlingModel->mapToSource( idx ) ) ) return;
+    const int rows = summaryHandlingModel->rowCount( idx );
+    for ( int row = 0; row < rows; ++row ) {
+        appendRowItems( summaryHandlingModel->index( row, 0, idx ), result );
+    }
+}
+
+/* \returns The items in the rows that intersect \a rect. The rows are
+ * found with the row controller, as the scene keeps no item index.
+ */
+QVector<const GraphicsItem*> GraphicsScene::Private::rowItems( const QRectF& rect ) const
+{
+    QVector<const GraphicsItem*> result;
+    if ( !rowController ) return result;
+    for ( QModelIndex sidx = rowController->indexAt( qMax( 0, qFloor( rect.top() ) ) );
+          sidx.isValid(); sidx = rowController->indexBelow( sidx ) ) {
+        if ( rowController->rowGeometry( sidx ).start() > rect.bottom() ) break;
+        appendRowItems( summaryHandlingModel->mapFromSource( sidx ), &result );
+    }
+    return result;
+}
+
+/* Paints all visible constraints in one go when the delegate has
+ * constraint batching enabled. This runs right after the grid, so the
+ * constraints stay below the items as if they were painted individually.
+ */
+void GraphicsScene::Private::paintConstraintBatch( QPainter* painter, const QRectF& exposed )
+{
+    if ( itemDelegate.isNull() || !itemDelegate->isConstraintBatchingEnabled() ) return;
+    const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform( painter->worldTransform() );
+    QVector<ConstraintGraphicsItem*> batch;
+    Q_FOREACH( ConstraintGraphicsItem* citem, constraintItems ) {
+        if ( !citem->isVisible() || !citem->boundingRect().intersects( exposed ) ) continue;
+        if ( q->isLevelOfDetail( citem, lod ) ) continue;
+        batch << citem;
+    }
+    itemDelegate->paintConstraintItems( painter, batch );
+}
+
+/* Paints all items in \a exposed that are below the level-of-detail
+ * width as merged rectangles per row, plus their constraints. This
+ * runs in drawBackground(), so the items painted in full stay on top.
+ */
+void GraphicsScene::Private::paintLevelOfDetail( QPainter* painter, const QRectF& exposed )
+{
+    if ( isPrinting || itemDelegate.isNull() || itemDelegate->levelOfDetailWidth() <= 0. ) return;
+    const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform( painter->worldTransform() );
+    if ( lod <= 0. ) return;
+    const qreal pixel = 1./lod;
+
+    // item type -> row top -> item rects
+    typedef QMap<qreal, QVector<QRectF> > Rows;
+    QMap<int, Rows> rowsByType;
+    Q_FOREACH( const GraphicsItem* item, rowItems( exposed.adjusted( 0., -pixel, 0., pixel ) ) ) {
+        if ( !item->isVisible() ) continue;
+        const QRectF r = item->rect().translated( item->pos() );
+        if ( !QRectF( r.left(), r.top(), qMax( r.width(), pixel ), r.height() ).intersects( exposed ) ) continue;
+        const int typ = levelOfDetailType( item, lod );
+        if ( typ == TypeNone ) continue;
+        rowsByType[typ][r.top()].append( r );
+    }
+
+    for ( QMap<int, Rows>::iterator tit = rowsByType.begin(); tit != rowsByType.end(); ++tit ) {
+        QVector<QRectF> merged;
+        for ( Rows::iterator rit = tit->begin(); rit != tit->end(); ++rit ) {
+            QVector<QRectF>& rects = *rit;
+            std::sort( rects.begin(), rects.end(), leftLessThan );
+            QRectF run = rects.first();
+            for ( int i = 1; i < rects.size(); ++i ) {
+                if ( rects[i].left() <= run.right() + pixel ) {
+                    run.setRight( qMax( run.right(), rects[i].right() ) );
+                } else {
+                    if ( run.width() < pixel ) run.setWidth( pixel );
+                    merged << run;
+                    run = rects[i];
+                }
+            }
+            if ( run.width() < pixel ) run.setWidth( pixel );
+            merged << run;
+        }
+        itemDelegate->paintLevelOfDetailItems( painter, static_cast<ItemType>( tit.key() ), merged );
+    }
+
+    if ( itemDelegate->levelOfDetailConstraintMode() != ItemDelegate::LodConstraintsAsLines ) return;
+    QVector<const ConstraintGraphicsItem*> lodConstraints;
+    Q_FOREACH( const ConstraintGraphicsItem* citem, constraintItems ) {
+        if ( !citem->isVisible() ) continue;
+        const QRectF r = QRectF( citem->start(), citem->end() ).normalized().adjusted( -pixel, -pixel, pixel, pixel );
+        if ( !r.intersects( exposed ) || !q->isLevelOfDetail( citem, lod ) ) continue;
+        lodConstraints << citem;
+    }
+    itemDelegate->paintLevelOfDetailConstraints( painter, lodConstraints );
+}
+
+/*! \returns true if \a item is too narrow at \a levelOfDetail to
+ * be painted on its own. Such items are painted in batches by
+ * drawBackground() instead.
+ *
+ * \see ItemDelegate::setLevelOfDetailWidth
+ */
+bool GraphicsScene::isLevelOfDetail( const GraphicsItem* item, qreal levelOfDetail ) const
+{
+    return d->levelOfDetailType( item, levelOfDetail ) != TypeNone;
+}
+
+/*! \returns true if the constraint \a item is attached to an item
+ * painted with level of detail. Such constraints are hidden or painted
+ * as straight lines by drawBackground().
+ *
+ * \see ItemDelegate::setLevelOfDetailConstraintMode
+ */
+bool GraphicsScene::isLevelOfDetail( const ConstraintGraphicsItem* item, qreal levelOfDetail ) const
+{
+    if ( d->isPrinting || d->itemDelegate.isNull() || d->itemDelegate->levelOfDetailWidth() <= 0. ) return false;
+    const Constraint c = item->proxyConstraint();
+    const GraphicsItem* start = findItem( c.startIndex() );
+    if ( start && isLevelOfDetail( start, levelOfDetail ) ) return true;
+    const GraphicsItem* end = findItem( c.endIndex() );
+    return end && isLevelOfDetail( end, levelOfDetail );
+}
+
 void GraphicsScene::updateRow( const QModelIndex& rowidx )
 {
     //qDebug() << "GraphicsScene::updateRow("<<rowidx<<")" << rowidx.data( Qt::DisplayRole );
@@ -490,6 +709,7 @@ void GraphicsScene::removeItem( const QModelIndex& idx )
         // We have to remove the item from the list first because
         // there is a good chance there will be reentrant calls
         d->items.erase( it );
+        d->pendingConstraintUpdates.remove( item );
         {
             // Remove any constraintitems attached
             const QSet<ConstraintGraphicsItem*> clst = QSet<ConstraintGraphicsItem*>::fromList( item->startConstraints() ) +
@@ -526,12 +746,14 @@ void GraphicsScene::clearItems()
 
 void GraphicsScene::updateItems()
 {
+    beginBatchUpdate();
     for ( QHash<QPersistentModelIndex,GraphicsItem*>::iterator it = d->items.begin();
           it != d->items.end(); ++it ) {
         GraphicsItem* const item = it.value();
         const QPersistentModelIndex& idx = it.key();
         item->updateItem( Span( item->pos().y(), item->rect().height() ), idx );
     }
+    endBatchUpdate();
     invalidate( QRectF(), QGraphicsScene::BackgroundLayer );
 }
 
@@ -617,6 +839,9 @@ void GraphicsScene::drawBackground( QPainter* painter, const QRectF& _rect )
     d->grid->paintGrid( painter, scn, rect, d->rowController );
 
     d->grid->drawBackground(painter, rect);
+
+    d->paintConstraintBatch( painter, rect );
+    d->paintLevelOfDetail( painter, rect );
 }
 
 void GraphicsScene::drawForeground( QPainter* painter, const QRectF& rect )
@@ -737,6 +962,44 @@ void GraphicsScene::print( QPainter* painter, qreal start, qreal end,
     doPrint( painter, targetRect, start, end, nullptr, drawRowLabels, drawColumnLabels );
 }
 
+/*! Print the Gantt chart page by page to \a device, which can be
+ * a QPrinter or a QPdfWriter. If \a drawRowLabels is true (the
+ * default), each row will have it's label printed on the left side
+ * of every page. If \a drawColumnLabels is true (the default), each
+ * column will have it's label printed at the top of every page.
+ *
+ * The chart is cut into bands of rows that fit the page height and
+ * each band into slices of time that fit the page width. Every band
+ * is printed from a separate scene that only holds the items of that
+ * band, so even plans with a very large number of rows can be printed
+ * with constant memory, and the items of this scene are left alone.
+ * One scene pixel is printed as 1/96 inch.
+ *
+ * printProgress() is emitted after every page.
+ */
+void GraphicsScene::printPages( QPagedPaintDevice* device, bool drawRowLabels, bool drawColumnLabels )
+{
+    d->printPages( device, sceneRect().left(), sceneRect().right(), drawRowLabels, drawColumnLabels );
+}
+
+/*! Print part of the Gantt chart from \a start to \a end page by page
+ * to \a device. See the other printPages() overload for details.
+ *
+ * To print a certain range of a chart with a DateTimeGrid, use
+ * qreal DateTimeGrid::mapFromDateTime( const QDateTime& dt) const
+ * to figure out the values for \a start and \a end.
+ */
+void GraphicsScene::printPages( QPagedPaintDevice* device, qreal start, qreal end, bool drawRowLabels, bool drawColumnLabels )
+{
+    d->printPages( device, start, end, drawRowLabels, drawColumnLabels );
+}
+
+/*! \fn void GraphicsScene::printProgress( int page, int pageCount )
+ * This signal is emitted by printPages() after \a page of \a pageCount
+ * pages has been printed. Connected slots must not modify the scene
+ * or its models.
+ */
+
 /*!\internal
  */
 void GraphicsScene::doPrint( QPainter* painter, const QRectF& targetRect,
@@ -747,24 +1010,12 @@ void GraphicsScene::doPrint( QPainter* painter, const QRectF& targetRect,
     d->isPrinting = true;
     d->drawColumnLabels = drawColumnLabels;
     d->labelsWidth = 0.0;
-    QFont sceneFont( font() );
 #ifdef HAVE_PRINTER
-    if ( printer ) {
-        sceneFont = QFont( font(), printer );
-        if ( font().pointSizeF() >= 0.0 )
-            sceneFont.setPointSizeF( font().pointSizeF() );
-        else if ( font().pointSize() >= 0 )
-            sceneFont.setPointSize( font().pointSize() );
-        else
-            sceneFont.setPixelSize( font().pixelSize() );
-    }
+    const QFont sceneFont = d->printFont( printer );
+#else
+    const QFont sceneFont = d->printFont( nullptr );
 #endif
 
-    QGraphicsTextItem dummyTextItem( QLatin1String("X") );
-    dummyTextItem.adjustSize();
-    QFontMetrics fm(dummyTextItem.font());
-    sceneFont.setPixelSize( fm.height() );
-
     const QRectF oldScnRect( sceneRect() );
     QRectF scnRect( oldScnRect );
     scnRect.setLeft( start );
@@ -842,6 +1093,161 @@ void GraphicsScene::doPrint( QPainter* painter, const QRectF& targetRect,
     painter->restore();
 }
 
+/* Returns the font used for text drawn while printing to \a device,
+ * sized like the text of the scene.
+ */
+QFont GraphicsScene::Private::printFont( QPaintDevice* device ) const
+{
+    const QFont font = q->font();
+    QFont sceneFont( font );
+    if ( device ) {
+        sceneFont = QFont( font, device );
+        if ( font.pointSizeF() >= 0.0 )
+            sceneFont.setPointSizeF( font.pointSizeF() );
+        else if ( font.pointSize() >= 0 )
+            sceneFont.setPointSize( font.pointSize() );
+        else
+            sceneFont.setPixelSize( font.pixelSize() );
+    }
+
+    QGraphicsTextItem dummyTextItem( QLatin1String("X") );
+    dummyTextItem.adjustSize();
+    QFontMetrics fm(dummyTextItem.font());
+    sceneFont.setPixelSize( fm.height() );
+    return sceneFont;
+}
+
+/* Makes sure the items of the row \a sidx, and the items at the other
+ * end of its constraints, exist.
+ */
+void GraphicsScene::Private::createPageItems( const QModelIndex& sidx )
+{
+    const QModelIndex idx = summaryHandlingModel->mapFromSource( sidx );
+    if ( !q->findItem( idx ) ) q->updateRow( idx );
+
+    if ( constraintModel.isNull() ) return;
+    const QList<Constraint> clst = constraintModel->constraintsForIndex( sidx );
+    Q_FOREACH( const Constraint& c, clst ) {
+        const QModelIndex other = ( c.startIndex() == sidx ) ? c.endIndex() : c.startIndex();
+        const QModelIndex oidx = summaryHandlingModel->mapFromSource( other );
+        if ( !oidx.isValid() || q->findItem( oidx ) ) continue;
+        if ( !rowController->isRowVisible( other ) ) continue;
+        q->updateRow( oidx.sibling( oidx.row(), 0 ) );
+    }
+}
+
+/* Implements GraphicsScene::printPages(). The rows are walked once to
+ * find the page bands and the width of the row labels, then every band
+ * is printed slice by slice from a scratch scene that only holds the
+ * items of that band. The scene itself is not touched.
+ */
+void GraphicsScene::Private::printPages( QPagedPaintDevice* device, qreal start, qreal end,
+                                         bool drawRowLabels, bool _drawColumnLabels )
+{
+    assert( device );
+    if ( !rowController || end <= start ) return;
+
+    QModelIndex sidx = summaryHandlingModel->mapToSource( summaryHandlingModel->index( 0, 0, q->rootIndex() ) );
+    if ( !sidx.isValid() ) return;
+
+    QPainter painter;
+    if ( !painter.begin( device ) ) return;
+
+    const QFont sceneFont = printFont( device );
+    const QFontMetricsF fm( sceneFont );
+    const qreal charWidth = fm.width( QString::fromLatin1( "X" ) );
+    const qreal headerHeight = _drawColumnLabels ? rowController->headerHeight() : 0.;
+
+    /* One scene pixel is printed as 1/96 inch */
+    const qreal scale = device->logicalDpiY() / 96.;
+    const qreal pageWidth = device->width() / scale;
+    const qreal bandHeight = qMax( device->height() / scale - headerHeight, qreal( 1. ) );
+
+    /* Find the row bands and the width of the labels */
+    QVector<QModelIndex> bandRows;
+    QVector<Span> bands;
+    qreal textWidth = 0.;
+    do {
+        const Span rg = rowController->rowGeometry( sidx );
+        if ( bands.isEmpty() || rg.end() - bands.last().start() > bandHeight ) {
+            bandRows << sidx;
+            bands << rg;
+        } else {
+            bands.last().setLength( rg.end() - bands.last().start() );
+        }
+        if ( drawRowLabels ) {
+            const QString txt = summaryHandlingModel->mapFromSource( sidx ).data( Qt::DisplayRole ).toString();
+            textWidth = qMax( fm.width( txt ) + charWidth, textWidth );
+        }
+    } while ( ( sidx = rowController->indexBelow( sidx ) ).isValid() );
+    textWidth = qMin( textWidth, pageWidth / 2. );
+
+    const qreal sliceWidth = pageWidth - textWidth;
+    const int slices = qMax( 1, qCeil( ( end - start ) / sliceWidth ) );
+    const int pageCount = bands.count() * slices;
+
+    int page = 0;
+    for ( int band = 0; band < bands.count(); ++band ) {
+        const Span& brg = bands.at( band );
+        const QModelIndex last = ( band + 1 < bands.count() ) ? bandRows.at( band + 1 ) : QModelIndex();
+
+        /* The scratch scene shares the models, grid, row controller and
+         * delegate of this scene without connecting to any of them.
+         */
+        GraphicsScene bandScene( q );
+        bandScene.setFont( q->font() );
+        bandScene.setPalette( q->palette() );
+        Private* const bd = bandScene.d_func();
+        bd->summaryHandlingModel = summaryHandlingModel;
+        bd->constraintModel = constraintModel;
+        bd->selectionModel = selectionModel;
+        bd->rowController = rowController;
+        bd->grid = grid;
+        bd->itemDelegate = itemDelegate;
+        bd->readOnly = true;
+        bd->isPrinting = true;
+        bd->drawColumnLabels = _drawColumnLabels;
+
+        bandScene.beginBatchUpdate();
+        for ( sidx = bandRows.at( band ); sidx.isValid() && sidx != last; sidx = rowController->indexBelow( sidx ) ) {
+            bd->createPageItems( sidx );
+        }
+        bandScene.endBatchUpdate();
+
+        bandScene.setSceneRect( QRectF( start, brg.start() - headerHeight, end - start, brg.length() + headerHeight ) );
+
+        for ( int slice = 0; slice < slices; ++slice ) {
+            if ( page > 0 ) device->newPage();
+
+            const qreal left = start + slice * sliceWidth;
+            const qreal width = qMin( sliceWidth, end - left );
+            painter.setFont( sceneFont );
+            bandScene.render( &painter,
+                              QRectF( textWidth * scale, 0., width * scale, ( headerHeight + brg.length() ) * scale ),
+                              QRectF( left, brg.start() - headerHeight, width, headerHeight + brg.length() ) );
+
+            if ( textWidth > 0. ) {
+                painter.save();
+                painter.scale( scale, scale );
+                painter.setFont( sceneFont );
+                for ( sidx = bandRows.at( band ); sidx.isValid() && sidx != last; sidx = rowController->indexBelow( sidx ) ) {
+                    const Span rg = rowController->rowGeometry( sidx );
+                    const QString txt = summaryHandlingModel->mapFromSource( sidx ).data( Qt::DisplayRole ).toString();
+                    const QRectF r( charWidth / 2., headerHeight + rg.start() - brg.start(), textWidth - charWidth, rg.length() );
+                    painter.drawText( r, Qt::AlignLeft|Qt::AlignVCenter|Qt::TextSingleLine,
+                                      fm.elidedText( txt, Qt::ElideRight, r.width() ) );
+                }
+                painter.restore();
+            }
+
+            ++page;
+            emit q->printProgress( page, pageCount );
+        }
+    }
+
+    painter.end();
+}
+
 #include "moc_kganttgraphicsscene.cpp"
 
 
@@ -950,5 +1356,45 @@ KDAB_SCOPED_UNITTEST_SIMPLE( KGantt, GraphicsView, "test" ) {
     assertFalse( foreignItemDestroyed );
     graphicsView.updateScene();
     assertFalse( foreignItemDestroyed );
+
+    // A ranged dataChanged moves constraint items along with both ends
+    KGantt::ConstraintModel constraintModel;
+    graphicsView.setConstraintModel( &constraintModel );
+    constraintModel.addConstraint( KGantt::Constraint( model.index( 0, 0 ), model.index( 1, 0 ) ) );
+    model.blockSignals( true );
+    item->setData( QDateTime( QDate( 2007, 3, 2 ) ), KGantt::StartTimeRole );
+    item->setData( QDateTime( QDate( 2007, 3, 4 ) ), KGantt::EndTimeRole );
+    item2->setData( QDateTime( QDate( 2007, 3, 5 ) ), KGantt::StartTimeRole );
+    item2->setData( QDateTime( QDate( 2007, 3, 8 ) ), KGantt::EndTimeRole );
+    model.blockSignals( false );
+    model.dataChanged( model.index( 0, 0 ), model.index( 1, 0 ) );
+
+    KGantt::GraphicsScene* scene = qobject_cast<KGantt::GraphicsScene*>( graphicsView.scene() );
+    assertFalse( scene->isBatchUpdating() );
+    KGantt::GraphicsItem* startItem = scene->findItem( scene->summaryHandlingModel()->mapFromSource( model.index( 0, 0 ) ) );
+    KGantt::GraphicsItem* endItem = scene->findItem( scene->summaryHandlingModel()->mapFromSource( model.index( 1, 0 ) ) );
+    assertNotNull( startItem );
+    assertNotNull( endItem );
+    assertEqual( startItem->startConstraints().size(), 1 );
+    KGantt::ConstraintGraphicsItem* citem = startItem->startConstraints().first();
+    // finish-start: from the right edge of the start item to the left edge of the end item
+    assertTrue( citem->start() == startItem->mapToScene( startItem->rect().right(), startItem->rect().center().y() ) );
+    assertTrue( citem->end() == endItem->mapToScene( endItem->rect().left(), endItem->rect().center().y() ) );
+
+    // Level of detail applies to items narrower than the configured width only
+    assertFalse( scene->isLevelOfDetail( startItem, 1. ) );
+    scene->itemDelegate()->setLevelOfDetailWidth( startItem->rect().width() + 1. );
+    assertTrue( scene->isLevelOfDetail( startItem, 1. ) );
+    assertFalse( scene->isLevelOfDetail( startItem, 2. ) );
+    assertTrue( scene->isLevelOfDetail( citem, 1. ) );
+    startItem->setSelected( true );
+    assertFalse( scene->isLevelOfDetail( startItem, 1. ) );
+    startItem->setSelected( false );
+    // The item type is cached with the item and follows model changes
+    item->setData( KGantt::TypeEvent, KGantt::ItemTypeRole );
+    assertFalse( scene->isLevelOfDetail( startItem, 1. ) );
+    item->setData( KGantt::TypeTask, KGantt::ItemTypeRole );
+    assertTrue( scene->isLevelOfDetail( startItem, 1. ) );
+    scene->itemDelegate()->setLevelOfDetailWidth( 0. );
 }
 #endif /* KDAB_NO_UNIT_TESTS */
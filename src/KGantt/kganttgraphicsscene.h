@@ -30,6 +30,7 @@
 QT_BEGIN_NAMESPACE
 class QAbstractProxyModel;
 class QItemSelectionModel;
+class QPagedPaintDevice;
 class QPrinter;
 QT_END_NAMESPACE
 
@@ -88,7 +89,15 @@ namespace KGantt {
         void updateRow( const QModelIndex& idx );
         GraphicsItem* createItem( ItemType type ) const;
 
+        void beginBatchUpdate();
+        void endBatchUpdate();
+        bool isBatchUpdating() const;
+
+        bool isLevelOfDetail( const GraphicsItem* item, qreal levelOfDetail ) const;
+        bool isLevelOfDetail( const ConstraintGraphicsItem* item, qreal levelOfDetail ) const;
+
         /* used by GraphicsItem */
+        void deferConstraintUpdate( GraphicsItem* item );
         void itemEntered( const QModelIndex& );
         void itemPressed( const QModelIndex& );
         void itemClicked( const QModelIndex& );
@@ -101,6 +110,8 @@ namespace KGantt {
         void print( QPrinter* printer, qreal start, qreal end, bool drawRowLabels = true, bool drawColumnLabels = true );
         void print( QPainter* painter, const QRectF& target = QRectF(), bool drawRowLabels=true, bool drawColumnLabels = true );
         void print( QPainter* painter, qreal start, qreal end, const QRectF& target = QRectF(), bool drawRowLabels=true, bool drawColumnLabels = true );
+        void printPages( QPagedPaintDevice* device, bool drawRowLabels = true, bool drawColumnLabels = true );
+        void printPages( QPagedPaintDevice* device, qreal start, qreal end, bool drawRowLabels = true, bool drawColumnLabels = true );
 
     Q_SIGNALS:
         void gridChanged();
@@ -110,6 +121,8 @@ namespace KGantt {
         void entered( const QModelIndex & index );
         void pressed( const QModelIndex & index );
 
+        void printProgress( int page, int pageCount );
+
     protected:
         /*reimp*/ void helpEvent( QGraphicsSceneHelpEvent *helpEvent ) Q_DECL_OVERRIDE;
         /*reimp*/ void drawBackground( QPainter* painter, const QRectF& rect ) Q_DECL_OVERRIDE;
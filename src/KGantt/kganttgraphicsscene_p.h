@@ -20,9 +20,12 @@
 #ifndef KGANTTGRAPHICSSCENE_P_H
 #define KGANTTGRAPHICSSCENE_P_H
 
+#include <QFont>
 #include <QPersistentModelIndex>
 #include <QHash>
+#include <QSet>
 #include <QPointer>
+#include <QVector>
 #include <QItemSelectionModel>
 #include <QAbstractProxyModel>
 
@@ -43,15 +46,31 @@ namespace KGantt {
         ConstraintGraphicsItem* findConstraintItem( const Constraint& c ) const;
 
 	void recursiveUpdateMultiItem( const Span& span, const QModelIndex& idx );
+        void flushConstraintUpdates();
+
+        int levelOfDetailType( const GraphicsItem* item, qreal levelOfDetail ) const;
+        void appendRowItems( const QModelIndex& idx, QVector<const GraphicsItem*>* result ) const;
+        QVector<const GraphicsItem*> rowItems( const QRectF& rect ) const;
+        void paintLevelOfDetail( QPainter* painter, const QRectF& exposed );
+        void paintConstraintBatch( QPainter* painter, const QRectF& exposed );
 
         void clearItems();
 
+        QFont printFont( QPaintDevice* device ) const;
+        void printPages( QPagedPaintDevice* device, qreal start, qreal end,
+                         bool drawRowLabels, bool drawColumnLabels );
+        void createPageItems( const QModelIndex& sidx );
+
         GraphicsScene* q;
 
         QHash<QPersistentModelIndex,GraphicsItem*> items;
         QList<ConstraintGraphicsItem*> constraintItems;
         GraphicsItem* dragSource;
 
+        /* batched updates, see beginBatchUpdate() */
+        int batchUpdateLevel;
+        QSet<GraphicsItem*> pendingConstraintUpdates;
+
         QPointer<ItemDelegate> itemDelegate;
         AbstractRowController* rowController;
         DateTimeGrid           default_grid;
@@ -22,6 +22,7 @@
 #include "kganttabstractrowcontroller.h"
 #include "kganttgraphicsitem.h"
 #include "kganttconstraintmodel.h"
+#include "kganttdatetimetimeline.h"
 
 #include <QMenu>
 #include <QPainter>
@@ -31,6 +32,7 @@
 #include <QAbstractProxyModel>
 #include <QPrinter>
 
+#include <algorithm>
 #include <cassert>
 
 #if defined KDAB_EVAL
@@ -188,8 +190,13 @@ void HeaderWidget::contextMenuEvent( QContextMenuEvent* event )
 }
 
 GraphicsView::Private::Private( GraphicsView* _q )
-  : q( _q ), rowcontroller(nullptr), headerwidget( _q )
+  : q( _q ), rowcontroller(nullptr), headerwidget( _q ),
+    maximumUpdateRate( 0 ),
+    droppedUpdates( 0 ),
+    mergedUpdates( 0 ),
+    timeLineX( 0. )
 {
+    updateTimer.setSingleShot( true );
 }
 
 void GraphicsView::Private::updateHeaderGeometry()
@@ -203,6 +210,7 @@ void GraphicsView::Private::updateHeaderGeometry()
 
 void GraphicsView::Private::slotGridChanged()
 {
+    connectTimeLine();
     updateHeaderGeometry();
     headerwidget.update();
     q->updateSceneRect();
@@ -240,9 +248,18 @@ void GraphicsView::Private::slotDataChanged( const QModelIndex& topLeft, const Q
 {
     //qDebug() << "GraphicsView::slotDataChanged("<<topLeft<<bottomRight<<")";
     const QModelIndex parent = topLeft.parent();
+    if ( maximumUpdateRate > 0 ) {
+        for ( int row = topLeft.row(); row <= bottomRight.row(); ++row ) {
+            scheduleRowUpdate( scene.summaryHandlingModel()->index( row, 0, parent ) );
+        }
+        return;
+    }
+    const bool batch = bottomRight.row() > topLeft.row();
+    if ( batch ) scene.beginBatchUpdate();
     for ( int row = topLeft.row(); row <= bottomRight.row(); ++row ) {
         scene.updateRow( scene.summaryHandlingModel()->index( row, 0, parent ) );
     }
+    if ( batch ) scene.endBatchUpdate();
 }
 
 void GraphicsView::Private::slotLayoutChanged()
@@ -327,6 +344,75 @@ void GraphicsView::Private::slotHeaderContextMenuRequested( const QPoint& pt )
     emit q->headerContextMenuRequested( headerwidget.mapToGlobal( pt ) );
 }
 
+/* Queues \a idx to be updated by the next GraphicsView::flushUpdates().
+ * A row that is already queued is only updated once.
+ */
+void GraphicsView::Private::scheduleRowUpdate( const QModelIndex& idx )
+{
+    if ( pendingRows.contains( idx ) ) {
+        ++droppedUpdates;
+        return;
+    }
+    pendingRows.insert( idx );
+    startUpdateTimer();
+}
+
+/* Queues the scene rectangle \a rect to be invalidated by the next
+ * GraphicsView::flushUpdates(), or invalidates it right away if
+ * updates are not coalesced.
+ */
+void GraphicsView::Private::scheduleInvalidate( const QRectF& rect )
+{
+    if ( maximumUpdateRate <= 0 ) {
+        scene.invalidate( rect );
+        return;
+    }
+    pendingRects.append( rect );
+    startUpdateTimer();
+}
+
+/* Starts the flush timer so that flushes are at least
+ * 1000/maximumUpdateRate milliseconds apart.
+ */
+void GraphicsView::Private::startUpdateTimer()
+{
+    if ( updateTimer.isActive() ) return;
+    const qint64 interval = 1000 / maximumUpdateRate;
+    const qint64 elapsed = lastUpdate.isValid() ? lastUpdate.elapsed() : interval;
+    updateTimer.start( static_cast<int>( qMax<qint64>( 0, interval - elapsed ) ) );
+}
+
+/* Follows the DateTimeTimeLine of the current grid, if any, so a moving
+ * time line only invalidates the strips it left and entered.
+ */
+void GraphicsView::Private::connectTimeLine()
+{
+    DateTimeGrid* grid = qobject_cast<DateTimeGrid*>( scene.grid() );
+    DateTimeTimeLine* tl = grid ? grid->timeLine() : nullptr;
+    if ( tl != timeLine ) {
+        if ( timeLine ) {
+            QObject::disconnect( timeLine, SIGNAL(updated()), q, SLOT(slotTimeLineUpdated()) );
+        }
+        timeLine = tl;
+        if ( tl ) {
+            QObject::connect( tl, SIGNAL(updated()), q, SLOT(slotTimeLineUpdated()) );
+        }
+    }
+    if ( tl ) timeLineX = grid->mapFromDateTime( tl->dateTime() );
+}
+
+void GraphicsView::Private::slotTimeLineUpdated()
+{
+    DateTimeGrid* grid = qobject_cast<DateTimeGrid*>( scene.grid() );
+    if ( !grid || timeLine.isNull() ) return;
+    const qreal x = grid->mapFromDateTime( timeLine->dateTime() );
+    const qreal w = qMax<qreal>( timeLine->pen().widthF(), 1. ) + 2.;
+    const QRectF scn = scene.sceneRect();
+    scheduleInvalidate( QRectF( timeLineX - w, scn.top(), 2 * w, scn.height() ) );
+    scheduleInvalidate( QRectF( x - w, scn.top(), 2 * w, scn.height() ) );
+    timeLineX = x;
+}
+
 /*!\class KGantt::GraphicsView kganttgraphicsview.h KGanttGraphicsView
  * \ingroup KGantt
  * \brief The GraphicsView class provides a model/view implementation of a gantt chart.
@@ -369,8 +455,12 @@ GraphicsView::GraphicsView( QWidget* parent )
              this, SLOT(slotItemDoubleClicked(QModelIndex)) );
     connect( &_d->scene, SIGNAL(sceneRectChanged(QRectF)),
              this, SLOT(updateSceneRect()) );
+    connect( &_d->scene, SIGNAL(printProgress(int,int)),
+             this, SIGNAL(printProgress(int,int)) );
     connect( &_d->headerwidget, SIGNAL(customContextMenuRequested(QPoint)),
              this, SLOT(slotHeaderContextMenuRequested(QPoint)) );
+    connect( &_d->updateTimer, SIGNAL(timeout()),
+             this, SLOT(flushUpdates()) );
     setScene( &_d->scene );
 
     // HACK!
@@ -381,6 +471,8 @@ GraphicsView::GraphicsView( QWidget* parent )
     setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
 
     //setCacheMode( CacheBackground );
+
+    _d->connectTimeLine();
 }
 
 /*! Destroys this view. */
@@ -709,19 +801,134 @@ void GraphicsView::updateSceneRect()
  */
 void GraphicsView::updateScene()
 {
+    /* Everything is rebuilt, so queued rows are not needed anymore */
+    d->droppedUpdates += d->pendingRows.count();
+    d->pendingRows.clear();
     clearItems();
     if ( !model()) return;
     if ( !rowController()) return;
     QModelIndex idx = model()->index( 0, 0, rootIndex() );
+    d->scene.beginBatchUpdate();
     do {
         updateRow( idx );
     } while ( ( idx = rowController()->indexBelow( idx ) ) != QModelIndex() && rowController()->isRowVisible(idx) );
+    d->scene.endBatchUpdate();
     //constraintModel()->cleanup();
     //qDebug() << constraintModel();
     updateSceneRect();
     if ( scene() ) scene()->invalidate( QRectF(), QGraphicsScene::BackgroundLayer );
 }
 
+/*! Sets the maximum number of times per second that model changes are
+ * applied to the scene to \a fps.
+ *
+ * If \a fps is greater than 0, rows changed by the dataChanged() signal
+ * of the model are not updated right away but collected, and updated
+ * together at most \a fps times per second. A row that changes several
+ * times in between is only updated once. Repaints caused by the
+ * DateTimeTimeLine of a DateTimeGrid are coalesced the same way, with
+ * overlapping rectangles merged.
+ *
+ * If \a fps is 0 (the default), every change is applied immediately.
+ *
+ * \see flushUpdates(), droppedUpdateCount(), mergedUpdateCount()
+ */
+void GraphicsView::setMaximumUpdateRate( int fps )
+{
+    d->maximumUpdateRate = qMax( 0, fps );
+    if ( d->maximumUpdateRate == 0 ) flushUpdates();
+}
+
+/*! \returns the maximum number of times per second that model
+ * changes are applied to the scene, or 0 if they are applied
+ * immediately.
+ */
+int GraphicsView::maximumUpdateRate() const
+{
+    return d->maximumUpdateRate;
+}
+
+/*! \returns the number of row updates that were dropped because the
+ * row was already waiting to be updated, or because the whole scene
+ * was rebuilt before the row was updated.
+ */
+int GraphicsView::droppedUpdateCount() const
+{
+    return d->droppedUpdates;
+}
+
+/*! \returns the number of invalidated rectangles that were merged
+ * into an overlapping one instead of being invalidated separately.
+ */
+int GraphicsView::mergedUpdateCount() const
+{
+    return d->mergedUpdates;
+}
+
+/*! Resets droppedUpdateCount() and mergedUpdateCount() to 0.
+ */
+void GraphicsView::resetUpdateCounts()
+{
+    d->droppedUpdates = 0;
+    d->mergedUpdates = 0;
+}
+
+static bool topLessThan( const QRectF& r1, const QRectF& r2 )
+{
+    return r1.top() < r2.top();
+}
+
+/* Merges overlapping rectangles of \a rects in place and
+ * returns the number of rectangles merged away.
+ */
+static int mergeRects( QVector<QRectF>& rects )
+{
+    int merged = 0;
+    std::sort( rects.begin(), rects.end(), topLessThan );
+    for ( int i = 0; i < rects.count(); ++i ) {
+        int j = i + 1;
+        while ( j < rects.count() ) {
+            if ( rects.at( i ).intersects( rects.at( j ) ) ) {
+                rects[ i ] |= rects.at( j );
+                rects.remove( j );
+                ++merged;
+                j = i + 1;
+            } else {
+                ++j;
+            }
+        }
+    }
+    return merged;
+}
+
+/*! Applies all model changes that are waiting because of
+ * setMaximumUpdateRate() to the scene right away.
+ */
+void GraphicsView::flushUpdates()
+{
+    d->updateTimer.stop();
+    d->lastUpdate.start();
+
+    if ( !d->pendingRows.isEmpty() ) {
+        const QSet<QPersistentModelIndex> rows = d->pendingRows;
+        d->pendingRows.clear();
+        d->scene.beginBatchUpdate();
+        Q_FOREACH( const QPersistentModelIndex& idx, rows ) {
+            if ( idx.isValid() ) d->scene.updateRow( idx );
+        }
+        d->scene.endBatchUpdate();
+    }
+
+    if ( !d->pendingRects.isEmpty() ) {
+        QVector<QRectF> rects = d->pendingRects;
+        d->pendingRects.clear();
+        d->mergedUpdates += mergeRects( rects );
+        Q_FOREACH( const QRectF& r, rects ) {
+            d->scene.invalidate( r );
+        }
+    }
+}
+
 /*! \internal */
 GraphicsItem* GraphicsView::createItem( ItemType type ) const
 {
@@ -744,6 +951,7 @@ void GraphicsView::deleteSubtree( const QModelIndex& idx )
  */
 void GraphicsView::print( QPrinter* printer, bool drawRowLabels, bool drawColumnLabels )
 {
+    flushUpdates();
     d->scene.print( printer, drawRowLabels, drawColumnLabels );
 }
 
@@ -761,6 +969,7 @@ void GraphicsView::print( QPrinter* printer, bool drawRowLabels, bool drawColumn
  */
 void GraphicsView::print( QPrinter* printer,  qreal start, qreal end, bool drawRowLabels, bool drawColumnLabels )
 {
+    flushUpdates();
     d->scene.print( printer, start, end, drawRowLabels, drawColumnLabels );
 }
 
@@ -772,6 +981,7 @@ void GraphicsView::print( QPrinter* printer,  qreal start, qreal end, bool drawR
  */
 void GraphicsView::print( QPainter* painter, const QRectF& targetRect, bool drawRowLabels, bool drawColumnLabels )
 {
+  flushUpdates();
   d->scene.print(painter, targetRect, drawRowLabels, drawColumnLabels);
 }
 
@@ -788,8 +998,38 @@ void GraphicsView::print( QPainter* painter, const QRectF& targetRect, bool draw
 void GraphicsView::print( QPainter* painter, qreal start, qreal end,
                           const QRectF& targetRect, bool drawRowLabels, bool drawColumnLabels )
 {
+  flushUpdates();
   d->scene.print(painter, start, end, targetRect, drawRowLabels, drawColumnLabels);
 }
 
 
+/*! Print the Gantt chart page by page to \a device, which can be
+ * a QPrinter or a QPdfWriter. Only the items needed for the page
+ * being printed are created, and printProgress() is emitted after
+ * every page.
+ *
+ * \see GraphicsScene::printPages
+ */
+void GraphicsView::printPages( QPagedPaintDevice* device, bool drawRowLabels, bool drawColumnLabels )
+{
+    flushUpdates();
+    d->scene.printPages( device, drawRowLabels, drawColumnLabels );
+}
+
+/*! Print part of the Gantt chart from \a start to \a end page by
+ * page to \a device.
+ *
+ * \see GraphicsScene::printPages
+ */
+void GraphicsView::printPages( QPagedPaintDevice* device, qreal start, qreal end, bool drawRowLabels, bool drawColumnLabels )
+{
+    flushUpdates();
+    d->scene.printPages( device, start, end, drawRowLabels, drawColumnLabels );
+}
+
+/*! \fn void GraphicsView::printProgress( int page, int pageCount )
+ * This signal is emitted by printPages() after \a page of \a pageCount
+ * pages has been printed.
+ */
+
 #include "moc_kganttgraphicsview.cpp"
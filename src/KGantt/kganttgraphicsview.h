@@ -25,6 +25,7 @@
 #include "kganttglobal.h"
 
 QT_BEGIN_NAMESPACE
+class QPagedPaintDevice;
 class QPrinter;
 class QModelIndex;
 class QAbstractItemModel;
@@ -60,6 +61,7 @@ namespace KGantt {
 
         Q_PRIVATE_SLOT( d, void slotItemClicked( const QModelIndex& idx ) )
         Q_PRIVATE_SLOT( d, void slotItemDoubleClicked( const QModelIndex& idx ) )
+        Q_PRIVATE_SLOT( d, void slotTimeLineUpdated() )
     public:
 
         explicit GraphicsView( QWidget* parent = nullptr );
@@ -88,8 +90,15 @@ namespace KGantt {
         void updateRow( const QModelIndex& );
         void updateScene();
 
+        void setMaximumUpdateRate( int fps );
+        int maximumUpdateRate() const;
+        int droppedUpdateCount() const;
+        int mergedUpdateCount() const;
+        void resetUpdateCounts();
+
     public Q_SLOTS:
         void updateSceneRect();
+        void flushUpdates();
 
     public:
         void deleteSubtree( const QModelIndex& );
@@ -99,6 +108,8 @@ namespace KGantt {
         void print( QPainter* painter, const QRectF& target = QRectF(), bool drawRowLabels = true, bool drawColumnLabels = true );
         void print( QPainter* painter, qreal start, qreal end,
                     const QRectF& target = QRectF(), bool drawRowLabels = true, bool drawColumnLabels = true );
+        void printPages( QPagedPaintDevice* device, bool drawRowLabels = true, bool drawColumnLabels = true );
+        void printPages( QPagedPaintDevice* device, qreal start, qreal end, bool drawRowLabels = true, bool drawColumnLabels = true );
 
     public Q_SLOTS:
         void setModel( QAbstractItemModel* );
@@ -118,6 +129,7 @@ namespace KGantt {
         void entered( const QModelIndex & index );
         void pressed( const QModelIndex & index );
         void headerContextMenuRequested( const QPoint& pt );
+        void printProgress( int page, int pageCount );
 
     protected:
         void clearItems();
@@ -24,7 +24,12 @@
 #include "kganttgraphicsscene.h"
 #include "kganttdatetimegrid.h"
 
+#include <QElapsedTimer>
+#include <QPersistentModelIndex>
 #include <QPointer>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
 
 namespace KGantt {
     class HeaderWidget : public QWidget {
@@ -72,10 +77,28 @@ namespace KGantt {
 
         void removeConstraintsRecursive( QAbstractProxyModel *summaryModel, const QModelIndex& index );
 
+        /* coalesced updates, see GraphicsView::setMaximumUpdateRate() */
+        void scheduleRowUpdate( const QModelIndex& idx );
+        void scheduleInvalidate( const QRectF& rect );
+        void startUpdateTimer();
+        void connectTimeLine();
+        void slotTimeLineUpdated();
+
         GraphicsView* q;
         AbstractRowController* rowcontroller;
         HeaderWidget headerwidget;
         GraphicsScene scene;
+
+        int maximumUpdateRate;
+        QTimer updateTimer;
+        QElapsedTimer lastUpdate;
+        QSet<QPersistentModelIndex> pendingRows;
+        QVector<QRectF> pendingRects;
+        int droppedUpdates;
+        int mergedUpdates;
+
+        QPointer<DateTimeTimeLine> timeLine;
+        qreal timeLineX;
     };
 }
 
@@ -20,10 +20,14 @@
 #include "kganttitemdelegate_p.h"
 #include "kganttglobal.h"
 #include "kganttstyleoptionganttitem.h"
+#include "kganttstyleoptionganttitem_p.h"
 #include "kganttconstraint.h"
+#include "kganttconstraintgraphicsitem.h"
+#include "kganttconstraintgraphicsitem_p.h"
 
 #include <QPainter>
 #include <QPainterPath>
+#include <QStyleOptionGraphicsItem>
 #include <QPen>
 #include <QModelIndex>
 #include <QAbstractItemModel>
@@ -68,6 +72,10 @@ using namespace KGantt;
  */
 
 ItemDelegate::Private::Private()
+    : lodWidth( 0. ),
+      lodConstraintMode( LodConstraintsAsLines ),
+      constraintBatching( false ),
+      batch( nullptr )
 {
     // Brushes
     QLinearGradient taskgrad( 0., 0., 0., QApplication::fontMetrics().height() );
@@ -116,6 +124,18 @@ QPen ItemDelegate::Private::constraintPen( const QPointF& start, const QPointF&
     return pen;
 }
 
+/* A flat color standing in for \a brush when items are too small
+ * for gradients to be visible.
+ */
+QColor ItemDelegate::Private::levelOfDetailColor( const QBrush& brush )
+{
+    const QGradient* gradient = brush.gradient();
+    if ( gradient && !gradient->stops().isEmpty() ) {
+        return gradient->stops().first().second;
+    }
+    return brush.color();
+}
+
 /*! Constructor. Creates an ItemDelegate with parent \a parent */
 ItemDelegate::ItemDelegate( QObject* parent )
     : QItemDelegate( parent ), _d( new Private )
@@ -170,6 +190,76 @@ QPen ItemDelegate::defaultPen( ItemType type ) const
     return d->defaultpen[type];
 }
 
+/*! Sets the level-of-detail width to \a width device pixels.
+ *
+ * Task and summary items narrower than \a width are not painted
+ * individually with paintGanttItem(). Instead the view collects the
+ * ones in the exposed area and paints them below the other items with
+ * paintLevelOfDetailItems(): per row and item type, items that touch
+ * or are less than a pixel apart are merged into one run, and every
+ * run is drawn as a flat rectangle at least one pixel wide.
+ * Constraints attached to such items are treated according to
+ * levelOfDetailConstraintMode(). Selected items and events are always
+ * painted in full, and printing is not affected.
+ *
+ * A width of 0 (the default) disables level-of-detail rendering.
+ * The width is checked whenever the items are painted, so the new
+ * width applies from the next repaint of the view.
+ */
+void ItemDelegate::setLevelOfDetailWidth( qreal width )
+{
+    d->lodWidth = qMax<qreal>( 0., width );
+}
+
+/*!\returns The level-of-detail width in device pixels.
+ * \see setLevelOfDetailWidth
+ */
+qreal ItemDelegate::levelOfDetailWidth() const
+{
+    return d->lodWidth;
+}
+
+/*! Sets how constraints attached to items painted with
+ * level of detail are drawn: either not at all, or as straight
+ * lines painted in one batch instead of routed arrows. The default
+ * is LodConstraintsAsLines.
+ *
+ * \see setLevelOfDetailWidth
+ */
+void ItemDelegate::setLevelOfDetailConstraintMode( LodConstraintMode mode )
+{
+    d->lodConstraintMode = mode;
+}
+
+/*!\returns How constraints are drawn with level of detail.
+ * \see setLevelOfDetailConstraintMode
+ */
+ItemDelegate::LodConstraintMode ItemDelegate::levelOfDetailConstraintMode() const
+{
+    return d->lodConstraintMode;
+}
+
+/*! If \a enabled is true, constraint items do not paint themselves.
+ * Instead the view paints all visible constraints together with
+ * paintConstraintItems(), below the items. Constraints painted by the
+ * default paintConstraintItem() are then drawn with one path per pen.
+ *
+ * Do not combine this with QGraphicsView::CacheBackground. The default
+ * is false.
+ */
+void ItemDelegate::setConstraintBatchingEnabled( bool enabled )
+{
+    d->constraintBatching = enabled;
+}
+
+/*!\returns Whether constraints are painted in batches.
+ * \see setConstraintBatchingEnabled
+ */
+bool ItemDelegate::isConstraintBatchingEnabled() const
+{
+    return d->constraintBatching;
+}
+
 /*!\returns The tooltip for index \a idx
  */
 QString ItemDelegate::toolTip( const QModelIndex &idx ) const
@@ -272,7 +362,10 @@ void ItemDelegate::paintGanttItem( QPainter* painter,
                                    const QModelIndex& idx )
 {
     if ( !idx.isValid() ) return;
-    const ItemType typ = static_cast<ItemType>( idx.model()->data( idx, ItemTypeRole ).toInt() );
+    // The model data GraphicsItem has cached, if it is the one painting
+    const StyleOptionGanttItemData* data = StyleOptionGanttItemData::find( opt );
+    const ItemType typ = data ? data->itemType
+                              : static_cast<ItemType>( idx.model()->data( idx, ItemTypeRole ).toInt() );
     const QString& txt = opt.text;
     QRectF itemRect = opt.itemRect;
     QRectF boundingRect = opt.boundingRect;
@@ -305,7 +398,8 @@ void ItemDelegate::paintGanttItem( QPainter* painter,
             painter->translate( 0.5, 0.5 );
             painter->drawRect( r );
             bool ok;
-            qreal completion = idx.model()->data( idx, KGantt::TaskCompletionRole ).toReal( &ok );
+            qreal completion = ( data ? data->taskCompletion
+                                      : idx.model()->data( idx, KGantt::TaskCompletionRole ) ).toReal( &ok );
             if ( ok ) {
                 qreal h = r.height();
                 QRectF cr( r.x(), r.y()+h/4.,
@@ -387,6 +481,67 @@ void ItemDelegate::paintGanttItem( QPainter* painter,
     painter->restore();
 }
 
+/*! Paints the items of type \a type below the level-of-detail width
+ * as flat rectangles. \a rects are item rectangles in scene coordinates,
+ * already merged per row.
+ *
+ * \see setLevelOfDetailWidth
+ */
+void ItemDelegate::paintLevelOfDetailItems( QPainter* painter, ItemType type, const QVector<QRectF>& rects )
+{
+    if ( rects.isEmpty() ) return;
+
+    QVector<QRectF> shapes;
+    shapes.reserve( rects.size() );
+    for ( const QRectF& r : rects ) {
+        if ( type == TypeSummary ) {
+            // The top half, where the summary bar is thickest
+            shapes << QRectF( r.left(), r.top(), r.width(), r.height()/2. );
+        } else {
+            // Same band as the task bar in paintGanttItem()
+            shapes << QRectF( r.left(), r.top()+r.height()/6., r.width(), 2.*r.height()/3. );
+        }
+    }
+
+    painter->save();
+    painter->setPen( Qt::NoPen );
+    painter->setBrush( Private::levelOfDetailColor( defaultBrush( type ) ) );
+    painter->drawRects( shapes );
+    painter->restore();
+}
+
+/*! Paints the constraint \a items, which are attached to items below
+ * the level-of-detail width, as straight lines from start to end.
+ * Each constraint gets the same pen as in paintConstraintItem(), and
+ * lines with the same pen are drawn together.
+ *
+ * \see setLevelOfDetailConstraintMode
+ */
+void ItemDelegate::paintLevelOfDetailConstraints( QPainter* painter, const QVector<const ConstraintGraphicsItem*>& items )
+{
+    if ( items.isEmpty() ) return;
+
+    QVector<QPen> pens;
+    QVector<QVector<QLineF> > lines;
+    Q_FOREACH( const ConstraintGraphicsItem* item, items ) {
+        const QPen pen = d->constraintPen( item->start(), item->end(), item->constraint() );
+        int i = pens.indexOf( pen );
+        if ( i < 0 ) {
+            i = pens.count();
+            pens << pen;
+            lines << QVector<QLineF>();
+        }
+        lines[ i ] << QLineF( item->start(), item->end() );
+    }
+
+    painter->save();
+    for ( int i = 0; i < pens.count(); ++i ) {
+        painter->setPen( pens[ i ] );
+        painter->drawLines( lines[ i ] );
+    }
+    painter->restore();
+}
+
 static const qreal TURN = 10.;
 static const qreal PW = 1.5;
 
@@ -415,6 +570,130 @@ QRectF ItemDelegate::constraintBoundingRect( const QPointF& start, const QPointF
 }
 
 
+/*! \returns The line of the \a constraint between points \a start
+ * and \a end, without the arrow head.
+ */
+QPolygonF ItemDelegate::constraintLine( const QPointF& start, const QPointF& end, const Constraint &constraint ) const
+{
+    switch ( constraint.relationType() ) {
+        case Constraint::FinishStart: return finishStartLine( start, end );
+        case Constraint::FinishFinish: return finishFinishLine( start, end );
+        case Constraint::StartStart: return startStartLine( start, end );
+        case Constraint::StartFinish: return startFinishLine( start, end );
+    }
+    return QPolygonF();
+}
+
+/*! \returns The arrow head of the \a constraint between points
+ * \a start and \a end.
+ */
+QPolygonF ItemDelegate::constraintArrow( const QPointF& start, const QPointF& end, const Constraint &constraint ) const
+{
+    switch ( constraint.relationType() ) {
+        case Constraint::FinishStart: return finishStartArrow( start, end );
+        case Constraint::FinishFinish: return finishFinishArrow( start, end );
+        case Constraint::StartStart: return startStartArrow( start, end );
+        case Constraint::StartFinish: return startFinishArrow( start, end );
+    }
+    return QPolygonF();
+}
+
+/* \returns \a poly, reversed if needed so all arrow heads wind the same
+ * way and overlapping ones do not cancel out when filled as one path.
+ */
+static QPolygonF sameOrientation( const QPolygonF& poly )
+{
+    qreal area = 0.;
+    for ( int i = 0; i < poly.count(); ++i ) {
+        const QPointF& p1 = poly.at( i );
+        const QPointF& p2 = poly.at( ( i + 1 ) % poly.count() );
+        area += p1.x()*p2.y() - p2.x()*p1.y();
+    }
+    if ( area >= 0. ) return poly;
+    QPolygonF reversed;
+    reversed.reserve( poly.count() );
+    for ( int i = poly.count() - 1; i >= 0; --i ) reversed << poly.at( i );
+    return reversed;
+}
+
+void ConstraintBatch::add( const QPen& pen, const QPolygonF& line, const QPolygonF& arrow )
+{
+    int i = pens.indexOf( pen );
+    if ( i < 0 ) {
+        i = pens.count();
+        pens << pen;
+        lines << QPainterPath();
+        arrows << QPainterPath();
+        arrows.last().setFillRule( Qt::WindingFill );
+    }
+    lines[ i ].addPolygon( line );
+    arrows[ i ].addPolygon( sameOrientation( arrow ) );
+    arrows[ i ].closeSubpath();
+}
+
+void ConstraintBatch::paint( QPainter* painter ) const
+{
+    for ( int i = 0; i < pens.count(); ++i ) {
+        painter->setPen( pens.at( i ) );
+        painter->setBrush( Qt::NoBrush );
+        painter->drawPath( lines.at( i ) );
+        painter->setBrush( pens.at( i ).color() );
+        painter->drawPath( arrows.at( i ) );
+    }
+}
+
+/* Paints the \a constraint with the geometry its item attached to \a opt,
+ * or adds it to the current batch. \returns false if no geometry for
+ * \a start and \a end is attached, e.g. when a reimplementation of
+ * paintConstraintItem() passes points of its own.
+ */
+bool ItemDelegate::Private::paintRoutedConstraint( QPainter* painter, const QStyleOptionGraphicsItem& opt,
+                                                   const QPointF& start, const QPointF& end, const Constraint& constraint )
+{
+    const ConstraintGeometry* geometry = ConstraintGeometry::find( opt );
+    if ( !geometry || geometry->start != start || geometry->end != end
+         || geometry->relationType != constraint.relationType() ) return false;
+
+    const QPen pen = constraintPen( start, end, constraint );
+    if ( batch ) {
+        batch->add( pen, geometry->line, geometry->arrow );
+        return true;
+    }
+    painter->setPen( pen );
+    painter->setBrush( pen.color() );
+    painter->drawPolyline( geometry->line );
+    painter->drawPolygon( geometry->arrow );
+    return true;
+}
+
+/*! Paints the constraint \a items using \a painter. Each item is
+ * passed to paintConstraintItem(), so reimplementations are honored.
+ * The constraints painted by the default implementation are collected
+ * into one path for their lines and one for their arrow heads per pen,
+ * and each pen is set and drawn only once after all items.
+ *
+ * \see setConstraintBatchingEnabled
+ */
+void ItemDelegate::paintConstraintItems( QPainter* painter, const QVector<ConstraintGraphicsItem*>& items )
+{
+    if ( items.isEmpty() ) return;
+
+    ConstraintBatch batch;
+    const QStyleOptionGraphicsItem opt;
+    painter->save();
+    d->batch = &batch;
+    Q_FOREACH( const ConstraintGraphicsItem* item, items ) {
+        const ConstraintGeometryAttacher attacher( opt, ConstraintGeometry::of( item ) );
+        paintConstraintItem( painter, opt, item->start(), item->end(), item->constraint() );
+    }
+    d->batch = nullptr;
+    painter->restore();
+
+    painter->save();
+    batch.paint( painter );
+    painter->restore();
+}
+
 /*! Paints the \a constraint between points \a start and \a end
  * using \a painter and \a opt.
  *
@@ -424,6 +703,8 @@ void ItemDelegate::paintConstraintItem( QPainter* painter, const QStyleOptionGra
                                         const QPointF& start, const QPointF& end, const Constraint &constraint )
 {
     //qDebug()<<"ItemDelegate::paintConstraintItem"<<start<<end<<constraint;
+    // Use the geometry kept by the constraint item instead of routing again
+    if ( d->paintRoutedConstraint( painter, opt, start, end, constraint ) ) return;
     switch ( constraint.relationType() ) {
         case Constraint::FinishStart:
             paintFinishStartConstraint( painter, opt, start, end, constraint );
@@ -23,6 +23,8 @@
 #include <QItemDelegate>
 #include <QBrush>
 #include <QPen>
+#include <QLineF>
+#include <QVector>
 #include <QDebug>
 
 #include "kganttglobal.h"
@@ -30,6 +32,7 @@
 namespace KGantt {
     class StyleOptionGanttItem;
     class Constraint;
+    class ConstraintGraphicsItem;
 
     class KGANTT_EXPORT ItemDelegate : public QItemDelegate {
         Q_OBJECT
@@ -42,6 +45,10 @@ namespace KGantt {
                                 State_DragConstraint
         };
 
+        enum LodConstraintMode { LodConstraintsHidden,
+                                 LodConstraintsAsLines
+        };
+
         explicit ItemDelegate( QObject* parent = nullptr );
         virtual ~ItemDelegate();
 
@@ -51,6 +58,15 @@ namespace KGantt {
         void setDefaultPen( ItemType type, const QPen& pen );
         QPen defaultPen( ItemType type ) const;
 
+        void setLevelOfDetailWidth( qreal width );
+        qreal levelOfDetailWidth() const;
+
+        void setLevelOfDetailConstraintMode( LodConstraintMode mode );
+        LodConstraintMode levelOfDetailConstraintMode() const;
+
+        void setConstraintBatchingEnabled( bool enabled );
+        bool isConstraintBatchingEnabled() const;
+
         virtual Span itemBoundingSpan(const StyleOptionGanttItem& opt, const QModelIndex& idx) const;
         virtual QRectF constraintBoundingRect( const QPointF& start, const QPointF& end, const Constraint &constraint ) const;
         virtual InteractionState interactionStateFor( const QPointF& pos,
@@ -63,6 +79,13 @@ namespace KGantt {
         
         virtual QString toolTip( const QModelIndex &idx ) const;
 
+        void paintLevelOfDetailItems( QPainter* p, ItemType type, const QVector<QRectF>& rects );
+        void paintLevelOfDetailConstraints( QPainter* p, const QVector<const ConstraintGraphicsItem*>& items );
+
+        QPolygonF constraintLine( const QPointF& start, const QPointF& end, const Constraint &constraint ) const;
+        QPolygonF constraintArrow( const QPointF& start, const QPointF& end, const Constraint &constraint ) const;
+        void paintConstraintItems( QPainter* p, const QVector<ConstraintGraphicsItem*>& items );
+
     protected:
         void paintFinishStartConstraint( QPainter* p, const QStyleOptionGraphicsItem& opt,
                 const QPointF& start, const QPointF& end, const Constraint &constraint );
@@ -83,8 +106,6 @@ namespace KGantt {
                 const QPointF& start, const QPointF& end, const Constraint &constraint );
         QPolygonF startFinishLine( const QPointF& start, const QPointF& end ) const;
         QPolygonF startFinishArrow( const QPointF& start, const QPointF& end ) const;
-
-        
     };
 }
 
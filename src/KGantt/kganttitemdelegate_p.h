@@ -23,16 +23,38 @@
 #include "kganttitemdelegate.h"
 
 #include <QHash>
+#include <QPainterPath>
+#include <QPolygonF>
+#include <QVector>
 
 namespace KGantt {
+    /* Constraints collected by ItemDelegate::paintConstraintItems(),
+     * one path for the lines and one for the arrow heads per pen */
+    struct Q_DECL_HIDDEN ConstraintBatch {
+        void add( const QPen& pen, const QPolygonF& line, const QPolygonF& arrow );
+        void paint( QPainter* painter ) const;
+
+        QVector<QPen> pens;
+        QVector<QPainterPath> lines;
+        QVector<QPainterPath> arrows;
+    };
+
     class Q_DECL_HIDDEN ItemDelegate::Private {
     public:
         Private();
 
         QPen constraintPen( const QPointF& start, const QPointF& end, const Constraint& constraint );
+        bool paintRoutedConstraint( QPainter* painter, const QStyleOptionGraphicsItem& opt,
+                                    const QPointF& start, const QPointF& end, const Constraint& constraint );
+        static QColor levelOfDetailColor( const QBrush& brush );
 
         QHash<ItemType, QBrush> defaultbrush;
         QHash<ItemType, QPen> defaultpen;
+
+        qreal lodWidth;
+        LodConstraintMode lodConstraintMode;
+        bool constraintBatching;
+        ConstraintBatch* batch;
     };
 }
 
@@ -46,6 +46,29 @@ ListViewRowController::~ListViewRowController()
 
 #define d d_func()
 
+/*! Sets the height of every row in the list view to \a height
+ * pixels. Row geometries, indexAt() and totalHeight() are then
+ * computed from the row number instead of being queried from the
+ * QListView, which is much cheaper for large models. This requires
+ * the list view to lay out its items top to bottom without spacing
+ * or hidden rows, e.g. by setting QListView::setUniformItemSizes().
+ *
+ * A \a height of 0 (the default) turns this off.
+ */
+void ListViewRowController::setFixedRowHeight( int height )
+{
+    d->fixedRowHeight = qMax( 0, height );
+}
+
+/*! \returns the fixed row height, or 0 if row geometries are taken
+ * from the list view.
+ * \see setFixedRowHeight
+ */
+int ListViewRowController::fixedRowHeight() const
+{
+    return d->fixedRowHeight;
+}
+
 int ListViewRowController::headerHeight() const
 {
     return d->listview->viewport()->y()-d->listview->frameWidth();
@@ -58,6 +81,9 @@ int ListViewRowController::maximumItemHeight() const
 
 int ListViewRowController::totalHeight() const
 {
+    if ( d->fixedRowHeight > 0 && d->listview->model() ) {
+        return d->listview->model()->rowCount( d->listview->rootIndex() )*d->fixedRowHeight;
+    }
     return d->listview->verticalScrollBar()->maximum()+d->listview->viewport()->height();
 }
 
@@ -79,6 +105,9 @@ Span ListViewRowController::rowGeometry( const QModelIndex& _idx ) const
 {
     const QModelIndex idx = d->proxy->mapToSource( _idx );
     assert( idx.isValid() ? ( idx.model() == d->listview->model() ):( true ) );
+    if ( d->fixedRowHeight > 0 && idx.isValid() ) {
+        return Span( idx.row()*d->fixedRowHeight, d->fixedRowHeight );
+    }
     QRect r = d->listview->visualRect(idx).translated( QPoint( 0,
 		  static_cast<Private::HackListView*>(d->listview)->verticalOffset() ) );
     return Span( r.y(), r.height() );
@@ -86,6 +115,15 @@ Span ListViewRowController::rowGeometry( const QModelIndex& _idx ) const
 
 QModelIndex ListViewRowController::indexAt( int height ) const
 {
+    if ( d->fixedRowHeight > 0 ) {
+        const QAbstractItemModel* model = d->listview->model();
+        if ( !model ) return QModelIndex();
+        const int y = height + static_cast<Private::HackListView*>(d->listview)->verticalOffset();
+        if ( y < 0 ) return QModelIndex();
+        const int row = y/d->fixedRowHeight;
+        if ( row >= model->rowCount( d->listview->rootIndex() ) ) return QModelIndex();
+        return d->proxy->mapFromSource( model->index( row, 0, d->listview->rootIndex() ) );
+    }
     return d->proxy->mapFromSource( d->listview->indexAt( QPoint( 1,height ) ) );
 }
 
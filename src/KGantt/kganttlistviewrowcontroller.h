@@ -34,6 +34,9 @@ namespace KGantt {
 	ListViewRowController( QListView* lv, QAbstractProxyModel* proxy );
         ~ListViewRowController();
 
+        void setFixedRowHeight( int height );
+        int fixedRowHeight() const;
+
         /*reimp*/ int headerHeight() const Q_DECL_OVERRIDE;
         /*reimp*/ int maximumItemHeight() const Q_DECL_OVERRIDE;
         /*reimp*/ int totalHeight() const Q_DECL_OVERRIDE;
@@ -34,9 +34,10 @@ namespace KGantt {
         };
 
         Private(QListView* lv, QAbstractProxyModel* pm )
-            : listview(lv), proxy(pm) {}
+            : listview(lv), proxy(pm), fixedRowHeight(0) {}
         QListView* listview;
         QAbstractProxyModel* proxy;
+        int fixedRowHeight;
     };
 }
 
@@ -18,6 +18,9 @@
  */
 
 #include "kganttstyleoptionganttitem.h"
+#include "kganttstyleoptionganttitem_p.h"
+
+#include <QHash>
 
 using namespace KGantt;
 
@@ -57,6 +60,33 @@ StyleOptionGanttItem& StyleOptionGanttItem::operator=( const StyleOptionGanttIte
     return *this;
 }
 
+typedef QHash<const StyleOptionGanttItem*, const StyleOptionGanttItemData*> AttachedDataHash;
+
+static AttachedDataHash& attachedData()
+{
+    static AttachedDataHash s_attached;
+    return s_attached;
+}
+
+/* \returns The data attached to \a opt, or 0 if there is none. */
+const StyleOptionGanttItemData* StyleOptionGanttItemData::find( const StyleOptionGanttItem& opt )
+{
+    const AttachedDataHash& attached = attachedData();
+    return attached.isEmpty() ? nullptr : attached.value( &opt, nullptr );
+}
+
+/* Attaches \a data to \a opt until the attacher goes out of scope. */
+StyleOptionGanttItemDataAttacher::StyleOptionGanttItemDataAttacher( const StyleOptionGanttItem& opt, const StyleOptionGanttItemData& data )
+    : m_opt( opt )
+{
+    attachedData().insert( &opt, &data );
+}
+
+StyleOptionGanttItemDataAttacher::~StyleOptionGanttItemDataAttacher()
+{
+    attachedData().remove( &m_opt );
+}
+
 #ifndef QT_NO_DEBUG_STREAM
 QDebug operator<<( QDebug dbg, KGantt::StyleOptionGanttItem::Position p)
 {
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KGantt library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KGANTTSTYLEOPTIONGANTTITEM_P_H
+#define KGANTTSTYLEOPTIONGANTTITEM_P_H
+
+#include "kganttstyleoptionganttitem.h"
+
+#include <QVariant>
+
+namespace KGantt {
+    /* Model data of a gantt item that StyleOptionGanttItem has no
+     * members for. GraphicsItem caches it and attaches it to the option
+     * it passes to ItemDelegate::paintGanttItem(), which then does not
+     * need to query the model. The data is attached to that one option
+     * object for the duration of the paint call; copies of the option
+     * do not carry it.
+     */
+    struct Q_DECL_HIDDEN StyleOptionGanttItemData {
+        StyleOptionGanttItemData() : itemType( TypeNone ) {}
+
+        static const StyleOptionGanttItemData* find( const StyleOptionGanttItem& opt );
+
+        ItemType itemType;
+        QVariant taskCompletion;
+    };
+
+    class Q_DECL_HIDDEN StyleOptionGanttItemDataAttacher {
+        Q_DISABLE_COPY( StyleOptionGanttItemDataAttacher )
+    public:
+        StyleOptionGanttItemDataAttacher( const StyleOptionGanttItem& opt, const StyleOptionGanttItemData& data );
+        ~StyleOptionGanttItemDataAttacher();
+
+    private:
+        const StyleOptionGanttItem& m_opt;
+    };
+}
+
+#endif /* KGANTTSTYLEOPTIONGANTTITEM_P_H */
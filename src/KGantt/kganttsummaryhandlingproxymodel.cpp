@@ -48,59 +48,141 @@ bool SummaryHandlingProxyModel::Private::cacheLookup( const QModelIndex& idx,
                                                       QPair<QDateTime,QDateTime>* result ) const
 {
     //qDebug() << "cacheLookup("<<idx<<"), cache has " << cached_summary_items.count() << "items";
-    QHash<QModelIndex,QPair<QDateTime,QDateTime> >::const_iterator it =
+    QHash<QModelIndex,Extent>::const_iterator it =
         cached_summary_items.constFind( idx );
     if ( it != cached_summary_items.constEnd() ) {
-        *result = *it;
+        *result = qMakePair( it->start, it->end );
         return true;
     } else {
         return false;
     }
 }
 
-void SummaryHandlingProxyModel::Private::insertInCache( const SummaryHandlingProxyModel* model,
-                                                        const QModelIndex& sourceIdx ) const
+bool SummaryHandlingProxyModel::Private::childExtent( const SummaryHandlingProxyModel* model,
+                                                      const QModelIndex& sourceIdx,
+                                                      QDateTime* st, QDateTime* et ) const
+{
+    QModelIndex pdIdx = model->mapFromSource( sourceIdx );
+    /* The probably results in recursive calls here */
+    QVariant tmpsv = model->data( pdIdx, StartTimeRole );
+    QVariant tmpev = model->data( pdIdx, EndTimeRole );
+    if ( !tmpsv.canConvert( QVariant::DateTime ) ||
+        !tmpev.canConvert( QVariant::DateTime ) ) {
+        qDebug() << "Skipping item " << sourceIdx << " because it doesn't contain QDateTime";
+        return false;
+    }
+
+    // check for valid datetimes
+    if ( tmpsv.type() == QVariant::DateTime && !tmpsv.value<QDateTime>().isValid()) return false;
+    if ( tmpev.type() == QVariant::DateTime && !tmpev.value<QDateTime>().isValid()) return false;
+
+    // We need to test for empty strings to
+    // avoid a stupid Qt warning
+    if ( tmpsv.type() == QVariant::String && tmpsv.value<QString>().isEmpty()) return false;
+    if ( tmpev.type() == QVariant::String && tmpev.value<QString>().isEmpty()) return false;
+    *st = tmpsv.toDateTime();
+    *et = tmpev.toDateTime();
+    return true;
+}
+
+void SummaryHandlingProxyModel::Private::scanChildren( const SummaryHandlingProxyModel* model,
+                                                       const QModelIndex& sourceIdx,
+                                                       Extent* extent ) const
 {
     QAbstractItemModel* sourceModel = model->sourceModel();
-    const QModelIndex& mainIdx = sourceIdx;
-    QDateTime st;
-    QDateTime et;
-
-    for ( int r = 0; r < sourceModel->rowCount( mainIdx ); ++r ) {
-        QModelIndex pdIdx = model->mapFromSource( sourceModel->index( r, 0, mainIdx ) );
-        /* The probably results in recursive calls here */
-	QVariant tmpsv = model->data( pdIdx, StartTimeRole );
-	QVariant tmpev = model->data( pdIdx, EndTimeRole );
-	if ( !tmpsv.canConvert( QVariant::DateTime ) ||
-	    !tmpev.canConvert( QVariant::DateTime ) ) {
-            qDebug() << "Skipping item " << sourceIdx << " because it doesn't contain QDateTime";
-            continue;
+    *extent = Extent();
+
+    for ( int r = 0; r < sourceModel->rowCount( sourceIdx ); ++r ) {
+        QDateTime tmpst;
+        QDateTime tmpet;
+        if ( !childExtent( model, sourceModel->index( r, 0, sourceIdx ), &tmpst, &tmpet ) ) continue;
+        if ( extent->start.isNull() || extent->start > tmpst ) {
+            extent->start = tmpst;
+            extent->startRow = r;
+        }
+        if ( extent->end.isNull() || extent->end < tmpet ) {
+            extent->end = tmpet;
+            extent->endRow = r;
         }
-
-        // check for valid datetimes
-        if ( tmpsv.type() == QVariant::DateTime && !tmpsv.value<QDateTime>().isValid()) continue;
-        if ( tmpev.type() == QVariant::DateTime && !tmpev.value<QDateTime>().isValid()) continue;
-
-	// We need to test for empty strings to
-	// avoid a stupid Qt warning
-	if ( tmpsv.type() == QVariant::String && tmpsv.value<QString>().isEmpty()) continue;
-	if ( tmpev.type() == QVariant::String && tmpev.value<QString>().isEmpty()) continue;
-        QDateTime tmpst = tmpsv.toDateTime();
-        QDateTime tmpet = tmpev.toDateTime();
-        if ( st.isNull() || st > tmpst ) st = tmpst;
-        if ( et.isNull() || et < tmpet ) et = tmpet;
     }
+}
+
+void SummaryHandlingProxyModel::Private::writeBack( QAbstractItemModel* sourceModel,
+                                                    const QModelIndex& mainIdx,
+                                                    const Extent& extent ) const
+{
+    // The source model reports these changes back to us through
+    // sourceDataChanged(), which forwards them without touching the cache.
+    const bool wasUpdating = updatingSource;
+    updatingSource = true;
     QVariant tmpssv = sourceModel->data( mainIdx, StartTimeRole );
     QVariant tmpsev = sourceModel->data( mainIdx, EndTimeRole );
     if ( tmpssv.canConvert( QVariant::DateTime )
          && !( tmpssv.canConvert( QVariant::String ) && tmpssv.toString().isEmpty() )
-         && tmpssv.toDateTime() != st )
-        sourceModel->setData( mainIdx, st, StartTimeRole );
+         && tmpssv.toDateTime() != extent.start )
+        sourceModel->setData( mainIdx, extent.start, StartTimeRole );
     if ( tmpsev.canConvert( QVariant::DateTime )
          && !( tmpsev.canConvert( QVariant::String ) && tmpsev.toString().isEmpty() )
-         && tmpsev.toDateTime() != et )
-        sourceModel->setData( mainIdx, et, EndTimeRole );
-    cached_summary_items[sourceIdx]=qMakePair( st, et );
+         && tmpsev.toDateTime() != extent.end )
+        sourceModel->setData( mainIdx, extent.end, EndTimeRole );
+    updatingSource = wasUpdating;
+}
+
+SummaryHandlingProxyModel::Private::Extent
+SummaryHandlingProxyModel::Private::insertInCache( const SummaryHandlingProxyModel* model,
+                                                   const QModelIndex& sourceIdx ) const
+{
+    Extent extent;
+    scanChildren( model, sourceIdx, &extent );
+    cached_summary_items[sourceIdx] = extent;
+    writeBack( model->sourceModel(), sourceIdx, extent );
+    return extent;
+}
+
+/* Folds the children \a firstRow .. \a lastRow of the summary \a sourceIdx
+ * into its cached extent. Only when a child that defined the extent moved
+ * inwards are the siblings rescanned; summary children are read from the
+ * cache. Returns true if the extent of \a sourceIdx changed.
+ */
+bool SummaryHandlingProxyModel::Private::updateInCache( const SummaryHandlingProxyModel* model,
+                                                        const QModelIndex& sourceIdx,
+                                                        int firstRow, int lastRow ) const
+{
+    // A summary that was never computed will be computed on demand.
+    if ( !cached_summary_items.contains( sourceIdx ) ) return false;
+
+    // Copy, childExtent() may insert into the cache
+    const Extent old = cached_summary_items.value( sourceIdx );
+    Extent extent = old;
+    QAbstractItemModel* sourceModel = model->sourceModel();
+
+    bool rescan = false;
+    for ( int r = firstRow; r <= lastRow && !rescan; ++r ) {
+        QDateTime tmpst;
+        QDateTime tmpet;
+        if ( !childExtent( model, sourceModel->index( r, 0, sourceIdx ), &tmpst, &tmpet ) ) {
+            rescan = ( r == extent.startRow || r == extent.endRow );
+            continue;
+        }
+        if ( extent.start.isNull() || extent.start > tmpst ) {
+            extent.start = tmpst;
+            extent.startRow = r;
+        } else if ( r == extent.startRow && tmpst != extent.start ) {
+            rescan = true;
+        }
+        if ( extent.end.isNull() || extent.end < tmpet ) {
+            extent.end = tmpet;
+            extent.endRow = r;
+        } else if ( r == extent.endRow && tmpet != extent.end ) {
+            rescan = true;
+        }
+    }
+    if ( rescan ) scanChildren( model, sourceIdx, &extent );
+
+    cached_summary_items[sourceIdx] = extent;
+    if ( extent.start == old.start && extent.end == old.end ) return false;
+    writeBack( sourceModel, sourceIdx, extent );
+    return true;
 }
 
 void SummaryHandlingProxyModel::Private::removeFromCache( const QModelIndex& idx ) const
@@ -166,17 +248,36 @@ void SummaryHandlingProxyModel::sourceLayoutChanged()
 
 void SummaryHandlingProxyModel::sourceDataChanged( const QModelIndex& from, const QModelIndex& to )
 {
-    QAbstractItemModel* model = sourceModel();
-    QModelIndex parentIdx = from;
-    do {
-        const QModelIndex& dataIdx = parentIdx;
-        if ( model->data( dataIdx, ItemTypeRole )==TypeSummary ) {
-            //qDebug() << "removing " << parentIdx << "from cache";
-            d->removeFromCache( dataIdx );
-            QModelIndex proxyDataIdx = mapFromSource( dataIdx );
-            emit dataChanged( proxyDataIdx, proxyDataIdx );
+    // While a summary extent is written back into the source model the
+    // cache is up to date already, the change only has to be forwarded.
+    if ( !d->updatingSource ) {
+        QAbstractItemModel* model = sourceModel();
+        const QModelIndex sourceParent = model->parent( from );
+
+        // Changed summaries are recomputed from their (cached) children
+        for ( int r = from.row(); r <= to.row(); ++r ) {
+            for ( int c = from.column(); c <= to.column(); ++c ) {
+                d->removeFromCache( model->index( r, c, sourceParent ) );
+            }
         }
-    } while ( ( parentIdx=model->parent( parentIdx ) ) != QModelIndex() );
+
+        // Fold the changed rows into their ancestors bottom-up. Ancestors that
+        // are no summaries or were never computed are passed through, the walk
+        // stops as soon as a cached summary's extent is unaffected.
+        QModelIndex parentIdx = sourceParent;
+        int firstRow = from.row();
+        int lastRow = to.row();
+        while ( parentIdx.isValid() ) {
+            if ( d->isSummary( parentIdx ) && d->cached_summary_items.contains( parentIdx ) ) {
+                if ( !d->updateInCache( this, parentIdx, firstRow, lastRow ) ) break;
+                //qDebug() << "updated " << parentIdx << "in cache";
+                QModelIndex proxyParentIdx = mapFromSource( parentIdx );
+                emit dataChanged( proxyParentIdx, proxyParentIdx );
+            }
+            firstRow = lastRow = parentIdx.row();
+            parentIdx = model->parent( parentIdx );
+        }
+    }
 
     BASE::sourceDataChanged( from, to );
 }
@@ -238,8 +339,8 @@ QVariant SummaryHandlingProxyModel::data( const QModelIndex& proxyIndex, int rol
             default: /* fall thru */;
             }
         } else {
-            d->insertInCache( this, sidx );
-            return data( proxyIndex, role ); /* TODO: Optimize */
+            const Private::Extent extent = d->insertInCache( this, sidx );
+            return role == StartTimeRole ? extent.start : extent.end;
         }
     }
     return model->data( sidx, role );
@@ -248,18 +349,7 @@ QVariant SummaryHandlingProxyModel::data( const QModelIndex& proxyIndex, int rol
 /*! \see QAbstractItemModel::setData */
 bool SummaryHandlingProxyModel::setData( const QModelIndex& index, const QVariant& value, int role )
 {
-    QAbstractItemModel* model = sourceModel();
-    if ( role==StartTimeRole || role==EndTimeRole ) {
-        QModelIndex parentIdx = mapToSource( index );
-        do {
-            if ( d->isSummary(parentIdx) ) {
-	      //qDebug() << "removing " << parentIdx << "from cache";
-                d->removeFromCache( parentIdx );
-                QModelIndex proxyParentIdx = mapFromSource( parentIdx );
-                emit dataChanged( proxyParentIdx, proxyParentIdx );
-            }
-        } while ( ( parentIdx=model->parent( parentIdx ) ) != QModelIndex() );
-    }
+    // Summaries above \a index are updated in sourceDataChanged()
     return BASE::setData( index, value, role );
 }
 
@@ -30,18 +30,41 @@
 namespace KGantt {
     class Q_DECL_HIDDEN SummaryHandlingProxyModel::Private {
     public:
+        /* Cached extent of a summary item. startRow/endRow remember which
+         * direct child currently defines the extent, so that a change of
+         * any other child can be folded in without rescanning siblings. */
+        struct Extent {
+            Extent() : startRow( -1 ), endRow( -1 ) {}
+            QDateTime start;
+            QDateTime end;
+            int startRow;
+            int endRow;
+        };
+
+        Private() : updatingSource( false ) {}
+
         bool cacheLookup( const QModelIndex& idx,
                           QPair<QDateTime,QDateTime>* result ) const;
-        void insertInCache( const SummaryHandlingProxyModel* model, const QModelIndex& idx ) const;
+        Extent insertInCache( const SummaryHandlingProxyModel* model, const QModelIndex& idx ) const;
+        bool updateInCache( const SummaryHandlingProxyModel* model, const QModelIndex& idx,
+                            int firstRow, int lastRow ) const;
         void removeFromCache( const QModelIndex& idx ) const;
         void clearCache() const;
+
+        bool childExtent( const SummaryHandlingProxyModel* model, const QModelIndex& sourceIdx,
+                          QDateTime* st, QDateTime* et ) const;
+        void scanChildren( const SummaryHandlingProxyModel* model, const QModelIndex& sourceIdx,
+                           Extent* extent ) const;
+        void writeBack( QAbstractItemModel* sourceModel, const QModelIndex& sourceIdx,
+                        const Extent& extent ) const;
 		
 		inline bool isSummary( const QModelIndex& idx ) const {
 			int typ = idx.data( ItemTypeRole ).toInt();
 			return (typ==TypeSummary) || (typ==TypeMulti);
 		}
 
-        mutable QHash<QModelIndex, QPair<QDateTime, QDateTime> > cached_summary_items;
+        mutable QHash<QModelIndex, Extent> cached_summary_items;
+        mutable bool updatingSource;
     };
 }
 
@@ -21,6 +21,7 @@
 #include "kgantttreeviewrowcontroller_p.h"
 
 #include <QAbstractProxyModel>
+#include <QEvent>
 #include <QHeaderView>
 #include <QScrollBar>
 
@@ -28,6 +29,213 @@
 
 using namespace KGantt;
 
+namespace {
+    inline int lowestBit( int i ) { return i & -i; }
+}
+
+TreeViewRowIndex::TreeViewRowIndex( QTreeView* tv )
+    : m_treeview( static_cast<HackTreeView*>( tv ) ), m_tree( 1, 0 ), m_total( 0 ), m_complete( false )
+{
+    connect( tv, SIGNAL(expanded(QModelIndex)),
+             this, SLOT(invalidateFrom(QModelIndex)) );
+    connect( tv, SIGNAL(collapsed(QModelIndex)),
+             this, SLOT(invalidateFrom(QModelIndex)) );
+    // The tree view laid out its rows anew
+    connect( tv->verticalScrollBar(), SIGNAL(rangeChanged(int,int)),
+             this, SLOT(reset()) );
+    tv->installEventFilter( this );
+}
+
+/* Font and style changes change the row heights without changing
+ * the scroll range when the rows fit into the view.
+ */
+bool TreeViewRowIndex::eventFilter( QObject* watched, QEvent* event )
+{
+    if ( watched == m_treeview
+         && ( event->type() == QEvent::FontChange || event->type() == QEvent::StyleChange ) ) {
+        reset();
+    }
+    return QObject::eventFilter( watched, event );
+}
+
+/* Rebinds to the tree view's header, model and root index when they
+ * changed; QTreeView does not signal any of these.
+ */
+void TreeViewRowIndex::checkModel()
+{
+    if ( m_header != m_treeview->header() ) {
+        // Column widths change row heights of word wrapped items
+        if ( m_header ) m_header->disconnect( this );
+        m_header = m_treeview->header();
+        connect( m_header, SIGNAL(sectionResized(int,int,int)),
+                 this, SLOT(reset()) );
+        reset();
+    }
+    if ( m_model == m_treeview->model() && m_root == m_treeview->rootIndex() ) return;
+    if ( m_model ) m_model->disconnect( this );
+    m_model = m_treeview->model();
+    m_root = m_treeview->rootIndex();
+    reset();
+    if ( !m_model ) return;
+    connect( m_model, SIGNAL(rowsInserted(QModelIndex,int,int)),
+             this, SLOT(slotRowsChanged(QModelIndex,int,int)) );
+    connect( m_model, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)),
+             this, SLOT(slotRowsChanged(QModelIndex,int,int)) );
+    connect( m_model, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+             this, SLOT(slotRowsChanged(QModelIndex,int,int)) );
+    connect( m_model, SIGNAL(dataChanged(QModelIndex,QModelIndex)),
+             this, SLOT(slotDataChanged(QModelIndex,QModelIndex)) );
+    connect( m_model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+             this, SLOT(reset()) );
+    connect( m_model, SIGNAL(layoutChanged()),
+             this, SLOT(reset()) );
+    connect( m_model, SIGNAL(modelReset()),
+             this, SLOT(reset()) );
+}
+
+/* Runs a layout the tree view has pending, so that the scroll range
+ * signals moved rows now and not in the middle of appendRow(). With
+ * an invalid index this does not search the rows of the tree view.
+ */
+void TreeViewRowIndex::executePendingLayout()
+{
+    m_treeview->indexBelow( QModelIndex() );
+}
+
+void TreeViewRowIndex::reset()
+{
+    truncate( 0 );
+}
+
+/* Drops row \a row and all rows below it. Fenwick nodes up to \a row
+ * only cover rows above it, so the rest of the tree stays valid.
+ */
+void TreeViewRowIndex::truncate( int row )
+{
+    m_complete = false;
+    if ( row >= m_rows.size() ) return;
+    for ( int i = row; i < m_rows.size(); ++i ) {
+        m_rowOf.remove( m_rows[i] );
+    }
+    m_rows.resize( row );
+    m_heights.resize( row );
+    m_tree.resize( row+1 );
+    m_total = rowTop( row );
+}
+
+/* Everything below \a idx may have moved, \a idx itself did not. */
+void TreeViewRowIndex::invalidateFrom( const QModelIndex& idx )
+{
+    if ( !idx.isValid() || idx == m_root ) {
+        truncate( 0 );
+        return;
+    }
+    // Rows not indexed yet are either further down or not shown at all
+    const int r = m_rowOf.value( idx.sibling( idx.row(), 0 ), -1 );
+    if ( r >= 0 ) truncate( r+1 );
+}
+
+void TreeViewRowIndex::slotRowsChanged( const QModelIndex& parent, int first, int last )
+{
+    Q_UNUSED( first );
+    Q_UNUSED( last );
+    invalidateFrom( parent );
+}
+
+void TreeViewRowIndex::slotDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight )
+{
+    executePendingLayout();
+    for ( int row = topLeft.row(); row <= bottomRight.row(); ++row ) {
+        const int r = m_rowOf.value( topLeft.sibling( row, 0 ), -1 );
+        if ( r < 0 ) continue;
+        const int h = m_treeview->rowHeight( m_rows[r] );
+        if ( h != m_heights[r] ) addHeight( r, h-m_heights[r] );
+    }
+}
+
+void TreeViewRowIndex::addHeight( int row, int delta )
+{
+    m_heights[row] += delta;
+    m_total += delta;
+    for ( int i = row+1; i < m_tree.size(); i += lowestBit( i ) ) {
+        m_tree[i] += delta;
+    }
+}
+
+/* Indexes the row below the last indexed one. \returns false at the end. */
+bool TreeViewRowIndex::appendRow()
+{
+    if ( m_complete || !m_model ) return false;
+    const QModelIndex idx = m_rows.isEmpty()
+                            ? m_model->index( 0, 0, m_root )
+                            : m_treeview->indexBelow( m_rows.last() );
+    if ( !idx.isValid() ) {
+        m_complete = true;
+        return false;
+    }
+    const int h = m_treeview->rowHeight( idx );
+    const int i = m_rows.size()+1;
+    m_rowOf.insert( idx, m_rows.size() );
+    m_rows.append( idx );
+    m_heights.append( h );
+    m_tree.append( h + rowTop( i-1 ) - rowTop( i-lowestBit( i ) ) );
+    m_total += h;
+    return true;
+}
+
+/* \returns the visual row of \a idx, or -1 if it is not shown. */
+int TreeViewRowIndex::row( const QModelIndex& idx )
+{
+    checkModel();
+    executePendingLayout();
+    const QModelIndex idx0 = idx.sibling( idx.row(), 0 );
+    QHash<QModelIndex,int>::const_iterator it = m_rowOf.constFind( idx0 );
+    if ( it != m_rowOf.constEnd() ) return *it;
+    while ( appendRow() ) {
+        if ( m_rows.last() == idx0 ) return m_rows.size()-1;
+    }
+    return -1;
+}
+
+/* \returns the sum of the heights of the rows above \a row. */
+int TreeViewRowIndex::rowTop( int row ) const
+{
+    int y = 0;
+    for ( int i = row; i > 0; i -= lowestBit( i ) ) {
+        y += m_tree[i];
+    }
+    return y;
+}
+
+/* \returns the first row with its top at or below \a y,
+ * or -1 if there is none.
+ */
+int TreeViewRowIndex::rowAt( int y )
+{
+    checkModel();
+    executePendingLayout();
+    if ( y <= 0 ) return appendRow() || !m_rows.isEmpty() ? 0 : -1;
+    while ( m_total < y && appendRow() ) {}
+    if ( m_total < y ) return -1;
+
+    // Smallest count of rows with a total height >= y
+    const int n = m_rows.size();
+    int step = 1;
+    while ( step*2 <= n ) step *= 2;
+    int pos = 0;
+    int rest = y;
+    for ( ; step > 0; step /= 2 ) {
+        if ( pos+step <= n && m_tree[pos+step] < rest ) {
+            pos += step;
+            rest -= m_tree[pos];
+        }
+    }
+    const int r = pos+1;
+    if ( r < n || appendRow() ) return r;
+    return -1;
+}
+
+
 /*!\class TreeViewRowController
  * This is an implementation of AbstractRowController that
  * aligns a gantt view with a QTreeView.
@@ -35,9 +243,9 @@ using namespace KGantt;
 
 TreeViewRowController::TreeViewRowController( QTreeView* tv,
 					      QAbstractProxyModel* proxy )
-  : _d( new Private )
+  : _d( new Private( tv ) )
 {
-    _d->treeview = static_cast<Private::HackTreeView*>(tv);
+    _d->treeview = static_cast<HackTreeView*>(tv);
     _d->proxy = proxy;
 }
 
@@ -83,6 +291,10 @@ Span TreeViewRowController::rowGeometry( const QModelIndex& _idx ) const
 {
     const QModelIndex idx = d->proxy->mapToSource( _idx );
     assert( idx.isValid() ? ( idx.model() == d->treeview->model() ):( true ) );
+    const int row = idx.isValid() ? d->rows.row( idx ) : -1;
+    if ( row >= 0 ) {
+        return Span( d->rows.rowTop( row ), d->rows.rowHeight( row ) );
+    }
     QRect r = d->treeview->visualRect(idx).translated( QPoint( 0, d->treeview->verticalOffset() ) );
     return Span( r.y(), r.height() );
 }
@@ -93,18 +305,11 @@ QModelIndex TreeViewRowController::indexAt( int height ) const
    *   against the actual item text/icon, so we would return wrong values
    *   for items with no text etc.
    *
-   *   The code below could cache for performance, but currently it doesn't
-   *   seem to be the performance bottleneck at all.
+   *   Instead we look up the row offsets kept in d->rows.
    */
     if ( !d->treeview->model() ) return QModelIndex();
-    int y = d->treeview->verticalOffset();
-    QModelIndex idx = d->treeview->model()->index( 0, 0, d->treeview->rootIndex() );
-    do {
-        if ( y >= height ) break;
-        y += d->treeview->rowHeight( idx );
-        idx = d->treeview->indexBelow( idx );
-    } while ( idx.isValid() );
-    return d->proxy->mapFromSource( idx );
+    const int row = d->rows.rowAt( height - d->treeview->verticalOffset() );
+    return d->proxy->mapFromSource( row >= 0 ? d->rows.index( row ) : QModelIndex() );
 }
 
 QModelIndex TreeViewRowController::indexAbove( const QModelIndex& _idx ) const
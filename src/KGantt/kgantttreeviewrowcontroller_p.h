@@ -23,23 +23,80 @@
 #include "kgantttreeviewrowcontroller.h"
 
 #include <QTreeView>
+#include <QHeaderView>
+#include <QHash>
+#include <QPointer>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 class QAbstractProxyModel;
 QT_END_NAMESPACE
 
 namespace KGantt {
+    class Q_DECL_HIDDEN HackTreeView : public QTreeView {
+    public:
+        using QTreeView::verticalOffset;
+        using QTreeView::rowHeight;
+    };
+
+    /* Index of the rows shown by a QTreeView, in visual order, with
+     * a Fenwick tree over their heights. Rows are added lazily, only as
+     * far down as a query needs. Expanding or collapsing a row and
+     * changes signalled by the model drop the rows from the first
+     * affected one on, and height changes of single rows are folded
+     * into the tree, so rowTop() and rowAt() are O(log n).
+     * Hiding rows, expandAll() and collapseAll() are not signalled;
+     * like View, the index notices them by the changed range of the
+     * vertical scroll bar, and then starts over from the first row.
+     */
+    class Q_DECL_HIDDEN TreeViewRowIndex : public QObject {
+        Q_OBJECT
+    public:
+        explicit TreeViewRowIndex( QTreeView* tv );
+
+        int row( const QModelIndex& idx );
+        int rowTop( int row ) const;
+        int rowHeight( int row ) const { return m_heights[row]; }
+        int rowAt( int y );
+        QModelIndex index( int row ) const { return m_rows[row]; }
+
+        /*reimp*/ bool eventFilter( QObject* watched, QEvent* event ) Q_DECL_OVERRIDE;
+
+    public Q_SLOTS:
+        void reset();
+
+    private Q_SLOTS:
+        void invalidateFrom( const QModelIndex& idx );
+        void slotRowsChanged( const QModelIndex& parent, int first, int last );
+        void slotDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight );
+
+    private:
+        void checkModel();
+        void executePendingLayout();
+        bool appendRow();
+        void truncate( int row );
+        void addHeight( int row, int delta );
+
+        HackTreeView* m_treeview;
+        QPointer<QHeaderView> m_header;
+        QPointer<QAbstractItemModel> m_model;
+        QPersistentModelIndex m_root;
+        QVector<QModelIndex> m_rows;
+        QVector<int> m_heights;
+        QVector<int> m_tree; // 1-based, m_tree[0] is unused
+        QHash<QModelIndex,int> m_rowOf;
+        int m_total;
+        bool m_complete;
+    };
+
     class Q_DECL_HIDDEN TreeViewRowController::Private {
     public:
-        class HackTreeView : public QTreeView {
-        public:
-            using QTreeView::verticalOffset;
-            using QTreeView::rowHeight;
-        };
+        explicit Private( QTreeView* tv ) : rows( tv ) {}
+
         HackTreeView* treeview;
         QAbstractProxyModel* proxy;
+        TreeViewRowIndex rows;
     };
 }
 
 #endif /* KGANTTTREEVIEWROWCONTROLLER_P_H */
-
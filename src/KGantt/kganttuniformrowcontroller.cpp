@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2026 The KDiagram developers
+ *
+ * This file is part of the KGantt library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kganttuniformrowcontroller.h"
+#include "kganttuniformrowcontroller_p.h"
+
+using namespace KGantt;
+
+UniformRowIndex::UniformRowIndex()
+    : m_valid( false ), m_flat( true )
+{
+}
+
+void UniformRowIndex::setModel( QAbstractItemModel* model, const QModelIndex& root )
+{
+    if ( m_model ) m_model->disconnect( this );
+    m_model = model;
+    m_root = root;
+    invalidate();
+    if ( !model ) return;
+    connect( model, SIGNAL(rowsInserted(QModelIndex,int,int)),
+             this, SLOT(invalidate()) );
+    connect( model, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+             this, SLOT(invalidate()) );
+    connect( model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+             this, SLOT(invalidate()) );
+    connect( model, SIGNAL(layoutChanged()),
+             this, SLOT(invalidate()) );
+    connect( model, SIGNAL(modelReset()),
+             this, SLOT(invalidate()) );
+    connect( model, SIGNAL(dataChanged(QModelIndex,QModelIndex)),
+             this, SLOT(slotDataChanged(QModelIndex,QModelIndex)) );
+}
+
+void UniformRowIndex::invalidate()
+{
+    m_valid = false;
+    m_rows.clear();
+    m_rowOf.clear();
+    m_collapsed.clear();
+}
+
+/* Only a row that gets or loses TypeMulti changes the layout. */
+void UniformRowIndex::slotDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight )
+{
+    if ( !m_valid ) return;
+    for ( int row = topLeft.row(); row <= bottomRight.row(); ++row ) {
+        const QModelIndex idx = topLeft.sibling( row, 0 );
+        if ( m_model->hasChildren( idx ) && isMulti( idx ) != m_collapsed.contains( idx ) ) {
+            invalidate();
+            return;
+        }
+    }
+}
+
+bool UniformRowIndex::isMulti( const QModelIndex& idx )
+{
+    return idx.data( ItemTypeRole ).toInt() == TypeMulti;
+}
+
+void UniformRowIndex::build()
+{
+    if ( m_valid ) return;
+    m_valid = true;
+    m_flat = true;
+    if ( !m_model ) return;
+    const int count = m_model->rowCount( m_root );
+    for ( int i = 0; i < count; ++i ) {
+        if ( m_model->hasChildren( m_model->index( i, 0, m_root ) ) ) {
+            m_flat = false;
+            break;
+        }
+    }
+    if ( !m_flat ) appendRows( m_root );
+}
+
+void UniformRowIndex::appendRows( const QModelIndex& parent )
+{
+    const int count = m_model->rowCount( parent );
+    for ( int i = 0; i < count; ++i ) {
+        const QModelIndex idx = m_model->index( i, 0, parent );
+        m_rowOf.insert( idx, m_rows.size() );
+        m_rows.append( idx );
+        if ( !m_model->hasChildren( idx ) ) continue;
+        if ( isMulti( idx ) ) {
+            m_collapsed.insert( idx );
+        } else {
+            appendRows( idx );
+        }
+    }
+}
+
+int UniformRowIndex::rowCount()
+{
+    build();
+    if ( !m_model ) return 0;
+    return m_flat ? m_model->rowCount( m_root ) : m_rows.size();
+}
+
+/* \returns the row of \a idx, or -1 if it has no row of its own. */
+int UniformRowIndex::row( const QModelIndex& idx )
+{
+    build();
+    if ( !idx.isValid() || idx.model() != m_model ) return -1;
+    if ( m_flat ) return idx.parent() == m_root ? idx.row() : -1;
+    return m_rowOf.value( idx.sibling( idx.row(), 0 ), -1 );
+}
+
+QModelIndex UniformRowIndex::index( int row )
+{
+    if ( row < 0 || row >= rowCount() ) return QModelIndex();
+    return m_flat ? m_model->index( row, 0, m_root ) : m_rows[row];
+}
+
+/* \returns true if \a idx is a TypeMulti row with its children drawn in it. */
+bool UniformRowIndex::isCollapsed( const QModelIndex& idx )
+{
+    build();
+    return !m_flat && m_collapsed.contains( idx.sibling( idx.row(), 0 ) );
+}
+
+/*!\class KGantt::UniformRowController kganttuniformrowcontroller.h KGanttUniformRowController
+ * \ingroup KGantt
+ * \brief An AbstractRowController that lays out the rows of a model
+ * itself, without a companion item view.
+ *
+ * All rows have the same height, so row geometries are computed from the
+ * row number alone. This makes it suitable for rendering or printing very
+ * large plans with a GraphicsView that is never shown next to a QTreeView
+ * or QListView. The rows below rootIndex() are laid out as a QTreeView with
+ * every row expanded would show them, except for TypeMulti rows: they are
+ * collapsed, so their children are drawn in the row of the TypeMulti item.
+ *
+ * The model must be the one set on the GraphicsView.
+ */
+
+/*! Constructor. Creates a row controller for \a model with rows of
+ * \a rowHeight pixels.
+ */
+UniformRowController::UniformRowController( QAbstractItemModel* model, int rowHeight )
+    : _d( new Private( model, qMax( 1, rowHeight ) ) )
+{
+}
+
+/*! Destructor. */
+UniformRowController::~UniformRowController()
+{
+    delete _d; _d = nullptr;
+}
+
+#define d d_func()
+
+/* \returns the row \a idx is drawn in: its own, or the one of the
+ * collapsed TypeMulti row it is drawn in. -1 if there is none.
+ */
+int UniformRowController::Private::visibleRow( const QModelIndex& idx ) const
+{
+    for ( QModelIndex i = idx; i.isValid() && i != rows.rootIndex(); i = i.parent() ) {
+        const int r = rows.row( i );
+        if ( r >= 0 ) return r;
+    }
+    return -1;
+}
+
+/*! Sets the model whose rows are laid out to \a model. */
+void UniformRowController::setModel( QAbstractItemModel* model )
+{
+    d->rows.setModel( model, QModelIndex() );
+}
+
+/*! \returns the model whose rows are laid out. */
+QAbstractItemModel* UniformRowController::model() const
+{
+    return d->rows.model();
+}
+
+/*! Lays out the descendants of \a idx instead of all rows. */
+void UniformRowController::setRootIndex( const QModelIndex& idx )
+{
+    d->rows.setModel( d->rows.model(), idx );
+}
+
+/*! \returns the index whose children are laid out. */
+QModelIndex UniformRowController::rootIndex() const
+{
+    return d->rows.rootIndex();
+}
+
+/*! Sets the height of every row to \a height pixels. */
+void UniformRowController::setRowHeight( int height )
+{
+    d->rowHeight = qMax( 1, height );
+}
+
+/*! \returns the height of every row. */
+int UniformRowController::rowHeight() const
+{
+    return d->rowHeight;
+}
+
+/*! Reserves \a height pixels at the top of the view for a header.
+ * The default is 0.
+ */
+void UniformRowController::setHeaderHeight( int height )
+{
+    d->headerHeight = qMax( 0, height );
+}
+
+/*! Limits the height of items within their row to \a height pixels.
+ * A negative value (the default) makes items as high as the row.
+ */
+void UniformRowController::setMaximumItemHeight( int height )
+{
+    d->maximumItemHeight = height;
+}
+
+int UniformRowController::headerHeight() const
+{
+    return d->headerHeight;
+}
+
+int UniformRowController::maximumItemHeight() const
+{
+    return d->maximumItemHeight < 0 ? d->rowHeight : d->maximumItemHeight;
+}
+
+int UniformRowController::totalHeight() const
+{
+    return d->rows.rowCount()*d->rowHeight;
+}
+
+bool UniformRowController::isRowVisible( const QModelIndex& idx ) const
+{
+    return d->rows.row( idx ) >= 0;
+}
+
+bool UniformRowController::isRowExpanded( const QModelIndex& idx ) const
+{
+    return d->rows.row( idx ) >= 0 && !d->rows.isCollapsed( idx )
+        && d->rows.model()->hasChildren( idx.sibling( idx.row(), 0 ) );
+}
+
+Span UniformRowController::rowGeometry( const QModelIndex& idx ) const
+{
+    const int row = d->visibleRow( idx );
+    if ( row < 0 ) return Span();
+    return Span( row*d->rowHeight, d->rowHeight );
+}
+
+QModelIndex UniformRowController::indexAt( int height ) const
+{
+    if ( height < 0 ) return QModelIndex();
+    return d->rows.index( height/d->rowHeight );
+}
+
+QModelIndex UniformRowController::indexAbove( const QModelIndex& idx ) const
+{
+    const int row = d->visibleRow( idx );
+    return row > 0 ? d->rows.index( row-1 ) : QModelIndex();
+}
+
+QModelIndex UniformRowController::indexBelow( const QModelIndex& idx ) const
+{
+    const int row = d->visibleRow( idx );
+    return row >= 0 ? d->rows.index( row+1 ) : QModelIndex();
+}
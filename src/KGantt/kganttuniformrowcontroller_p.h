@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 The KDiagram developers
+ *
+ * This file is part of the KGantt library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KGANTTUNIFORMROWCONTROLLER_P_H
+#define KGANTTUNIFORMROWCONTROLLER_P_H
+
+#include "kganttuniformrowcontroller.h"
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QPersistentModelIndex>
+#include <QPointer>
+#include <QSet>
+#include <QVector>
+
+namespace KGantt {
+    /* The rows a UniformRowController lays out: the rows below the
+     * root index in preorder, as a QTreeView shows them with all rows
+     * expanded, except that TypeMulti rows stay collapsed and their
+     * children are drawn in the row of the TypeMulti item. The index
+     * is built in one pass on the first query after a change of the
+     * model. While no row has children, the rows are the ones directly
+     * below the root index and nothing is stored.
+     */
+    class Q_DECL_HIDDEN UniformRowIndex : public QObject {
+        Q_OBJECT
+    public:
+        UniformRowIndex();
+
+        void setModel( QAbstractItemModel* model, const QModelIndex& root );
+        QAbstractItemModel* model() const { return m_model; }
+        QModelIndex rootIndex() const { return m_root; }
+
+        int rowCount();
+        int row( const QModelIndex& idx );
+        QModelIndex index( int row );
+        bool isCollapsed( const QModelIndex& idx );
+
+    private Q_SLOTS:
+        void invalidate();
+        void slotDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight );
+
+    private:
+        static bool isMulti( const QModelIndex& idx );
+        void build();
+        void appendRows( const QModelIndex& parent );
+
+        QPointer<QAbstractItemModel> m_model;
+        QPersistentModelIndex m_root;
+        QVector<QModelIndex> m_rows;
+        QHash<QModelIndex,int> m_rowOf;
+        QSet<QModelIndex> m_collapsed; // TypeMulti rows with children
+        bool m_valid;
+        bool m_flat;
+    };
+
+    class Q_DECL_HIDDEN UniformRowController::Private {
+    public:
+        Private( QAbstractItemModel* m, int h )
+            : rowHeight( h ), headerHeight( 0 ), maximumItemHeight( -1 )
+        {
+            rows.setModel( m, QModelIndex() );
+        }
+
+        int visibleRow( const QModelIndex& idx ) const;
+
+        mutable UniformRowIndex rows;
+        int rowHeight;
+        int headerHeight;
+        int maximumItemHeight; // -1: same as rowHeight
+    };
+}
+
+#endif /* KGANTTUNIFORMROWCONTROLLER_P_H */
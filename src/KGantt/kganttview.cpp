@@ -622,6 +622,27 @@ void View::print( QPainter* painter, qreal start, qreal end, const QRectF& targe
               drawColumnLabels);
 }
 
+/*! Print the Gantt chart page by page to \a device, which can be
+ * a QPrinter or a QPdfWriter. Progress is reported through
+ * GraphicsView::printProgress().
+ *
+ * \see GraphicsScene::printPages
+ */
+void View::printPages( QPagedPaintDevice* device, bool drawRowLabels, bool drawColumnLabels )
+{
+    graphicsView()->printPages( device, drawRowLabels, drawColumnLabels );
+}
+
+/*! Print part of the Gantt chart from \a start to \a end page by
+ * page to \a device.
+ *
+ * \see GraphicsScene::printPages
+ */
+void View::printPages( QPagedPaintDevice* device, qreal start, qreal end, bool drawRowLabels, bool drawColumnLabels )
+{
+    graphicsView()->printPages( device, start, end, drawRowLabels, drawColumnLabels );
+}
+
 
 #include "moc_kganttview.cpp"
 
@@ -29,6 +29,7 @@ class QAbstractItemModel;
 class QAbstractProxyModel;
 class QAbstractItemView;
 class QItemSelectionModel;
+class QPagedPaintDevice;
 class QPrinter;
 class QSplitter;
 QT_END_NAMESPACE
@@ -88,6 +89,8 @@ namespace KGantt {
         void print( QPainter* painter, const QRectF& target = QRectF(), bool drawRowLabels=true, bool drawColumnLabels=true);
         void print( QPainter* painter, qreal start, qreal end,
                     const QRectF& target = QRectF(), bool drawRowLabels=true, bool drawColumnLabels=true);
+        void printPages( QPagedPaintDevice* device, bool drawRowLabels=true, bool drawColumnLabels=true );
+        void printPages( QPagedPaintDevice* device, qreal start, qreal end, bool drawRowLabels=true, bool drawColumnLabels=true );
 
     public Q_SLOTS:
         void setModel(QAbstractItemModel* model);
@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2026 The KDiagram developers
+ *
+ * This file is part of the KGantt library.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "BenchmarkKGantt.h"
+
+#include "kganttglobal.h"
+#include "kganttview.h"
+#include "kganttgraphicsview.h"
+#include "kganttconstraintmodel.h"
+#include "kganttdatetimegrid.h"
+
+#include <QBuffer>
+#include <QImage>
+#include <QPdfWriter>
+#include <QScrollBar>
+
+#include <cmath>
+
+using namespace KGantt;
+
+static void initView(View *view, QStandardItemModel *model, const QDateTime &start)
+{
+    view->resize(1200, 800);
+    DateTimeGrid *grid = qobject_cast<DateTimeGrid*>(view->grid());
+    if (grid) {
+        grid->setStartDateTime(start);
+        grid->setDayWidth(50.);
+    }
+    view->setModel(model);
+    view->expandAll();
+}
+
+BenchmarkKGantt::BenchmarkKGantt()
+    : m_depth(2),
+      m_density(10),
+      m_start(QDate(2026, 1, 5), QTime(8, 0))
+{
+    const QList<QByteArray> sizes = qgetenv("KGANTT_BENCHMARK_SIZES").split(',');
+    Q_FOREACH(const QByteArray &size, sizes) {
+        bool ok;
+        const int tasks = size.trimmed().toInt(&ok);
+        if (ok && tasks > 0)
+            m_sizes << tasks;
+    }
+    if (m_sizes.isEmpty())
+        m_sizes << 1000;
+    if (qEnvironmentVariableIsSet("KGANTT_BENCHMARK_DEPTH"))
+        m_depth = qMax(1, qEnvironmentVariableIntValue("KGANTT_BENCHMARK_DEPTH"));
+    if (qEnvironmentVariableIsSet("KGANTT_BENCHMARK_CONSTRAINT_DENSITY"))
+        m_density = qMax(0, qEnvironmentVariableIntValue("KGANTT_BENCHMARK_CONSTRAINT_DENSITY"));
+}
+
+void BenchmarkKGantt::addSizes()
+{
+    QTest::addColumn<int>("tasks");
+    Q_FOREACH(int tasks, m_sizes) {
+        QTest::newRow(QByteArray::number(tasks).constData()) << tasks;
+    }
+}
+
+/* Fills model with tasks items in a hierarchy m_depth levels deep.
+ * Items on the lowest level are tasks, all others are summaries.
+ */
+void BenchmarkKGantt::populate(QStandardItemModel *model, int tasks)
+{
+    m_leaves.clear();
+    m_leaves.reserve(tasks);
+    const int fanout = qMax(2, static_cast<int>(std::ceil(std::pow(tasks, 1. / m_depth))));
+    int created = 0;
+    addChildren(model->invisibleRootItem(), 1, fanout, tasks, created);
+}
+
+void BenchmarkKGantt::addChildren(QStandardItem *parent, int level, int fanout, int tasks, int &created)
+{
+    for (int i = 0; i < fanout && created < tasks; ++i) {
+        QStandardItem *item = new QStandardItem(QString::fromLatin1("Task %1").arg(created));
+        const QDateTime start = m_start.addSecs(3600 * (created % 2000));
+        ++created;
+        if (level < m_depth) {
+            item->setData(TypeSummary, ItemTypeRole);
+            // Build the subtree before it is attached, so the model only signals once
+            addChildren(item, level + 1, fanout, tasks, created);
+        } else {
+            item->setData(TypeTask, ItemTypeRole);
+            item->setData(start, StartTimeRole);
+            item->setData(start.addSecs(8 * 3600), EndTimeRole);
+            item->setData(created % 100, TaskCompletionRole);
+            m_leaves << item;
+        }
+        parent->appendRow(item);
+    }
+}
+
+/* Adds m_density constraints per 100 tasks between the leaves created
+ * by the last populate(), spread over the whole plan.
+ */
+void BenchmarkKGantt::addConstraints(ConstraintModel *constraintModel)
+{
+    const int leaves = m_leaves.count();
+    if (leaves < 2)
+        return;
+    const int count = static_cast<int>(qint64(leaves) * m_density / 100);
+    for (int i = 0; i < count; ++i) {
+        const int from = static_cast<int>((qint64(i) * 7) % leaves);
+        const int to = (from + 1 + i % 5) % leaves;
+        if (from == to)
+            continue;
+        constraintModel->addConstraint(Constraint(m_leaves.at(from)->index(), m_leaves.at(to)->index()));
+    }
+}
+
+void BenchmarkKGantt::benchmarkModelLoad_data()
+{
+    addSizes();
+}
+
+void BenchmarkKGantt::benchmarkModelLoad()
+{
+    QFETCH(int, tasks);
+
+    QBENCHMARK_ONCE {
+        QStandardItemModel model;
+        populate(&model, tasks);
+        View view;
+        initView(&view, &model, m_start);
+        addConstraints(view.constraintModel());
+    }
+}
+
+void BenchmarkKGantt::benchmarkUpdateScene_data()
+{
+    addSizes();
+}
+
+void BenchmarkKGantt::benchmarkUpdateScene()
+{
+    QFETCH(int, tasks);
+    QStandardItemModel model;
+    populate(&model, tasks);
+    View view;
+    initView(&view, &model, m_start);
+    addConstraints(view.constraintModel());
+
+    QBENCHMARK {
+        view.graphicsView()->updateScene();
+    }
+    QVERIFY(!view.graphicsView()->scene()->items().isEmpty());
+}
+
+void BenchmarkKGantt::benchmarkScrollRepaint_data()
+{
+    addSizes();
+}
+
+void BenchmarkKGantt::benchmarkScrollRepaint()
+{
+    QFETCH(int, tasks);
+    QStandardItemModel model;
+    populate(&model, tasks);
+    View view;
+    initView(&view, &model, m_start);
+    addConstraints(view.constraintModel());
+
+    GraphicsView *gv = view.graphicsView();
+    QImage image(gv->viewport()->size(), QImage::Format_ARGB32_Premultiplied);
+    QScrollBar *sb = gv->verticalScrollBar();
+    QBENCHMARK {
+        for (int i = 0; i < 10; ++i) {
+            sb->setValue(sb->minimum() + (sb->maximum() - sb->minimum()) * i / 9);
+            gv->viewport()->render(&image);
+        }
+    }
+}
+
+void BenchmarkKGantt::benchmarkZoomRepaint_data()
+{
+    addSizes();
+}
+
+void BenchmarkKGantt::benchmarkZoomRepaint()
+{
+    QFETCH(int, tasks);
+    QStandardItemModel model;
+    populate(&model, tasks);
+    View view;
+    initView(&view, &model, m_start);
+    addConstraints(view.constraintModel());
+
+    DateTimeGrid *grid = qobject_cast<DateTimeGrid*>(view.grid());
+    QVERIFY(grid);
+    GraphicsView *gv = view.graphicsView();
+    QImage image(gv->viewport()->size(), QImage::Format_ARGB32_Premultiplied);
+    QBENCHMARK {
+        for (qreal dayWidth = 5.; dayWidth <= 160.; dayWidth *= 2.) {
+            grid->setDayWidth(dayWidth);
+            gv->viewport()->render(&image);
+        }
+    }
+}
+
+void BenchmarkKGantt::benchmarkExpandCollapse_data()
+{
+    addSizes();
+}
+
+void BenchmarkKGantt::benchmarkExpandCollapse()
+{
+    QFETCH(int, tasks);
+    QStandardItemModel model;
+    populate(&model, tasks);
+    View view;
+    initView(&view, &model, m_start);
+    addConstraints(view.constraintModel());
+
+    QBENCHMARK {
+        view.collapseAll();
+        view.expandAll();
+    }
+}
+
+void BenchmarkKGantt::benchmarkConstraintInsertion_data()
+{
+    addSizes();
+}
+
+void BenchmarkKGantt::benchmarkConstraintInsertion()
+{
+    QFETCH(int, tasks);
+    QStandardItemModel model;
+    populate(&model, tasks);
+    View view;
+    initView(&view, &model, m_start);
+
+    QBENCHMARK_ONCE {
+        addConstraints(view.constraintModel());
+    }
+    QVERIFY(m_density == 0 || !view.constraintModel()->constraints().isEmpty());
+}
+
+void BenchmarkKGantt::benchmarkPrint_data()
+{
+    addSizes();
+}
+
+void BenchmarkKGantt::benchmarkPrint()
+{
+    QFETCH(int, tasks);
+    QStandardItemModel model;
+    populate(&model, tasks);
+    View view;
+    initView(&view, &model, m_start);
+    addConstraints(view.constraintModel());
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QBENCHMARK_ONCE {
+        QPdfWriter writer(&buffer);
+        view.printPages(&writer);
+    }
+    QVERIFY(buffer.size() > 0);
+}
+
+QTEST_MAIN(BenchmarkKGantt)
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 The KDiagram developers
+ *
+ * This file is part of the KGantt library.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef BENCHMARKKGANTT_H
+#define BENCHMARKKGANTT_H
+
+#include <QtTest>
+#include <QStandardItemModel>
+
+namespace KGantt {
+    class ConstraintModel;
+}
+
+/*
+ * Scalability benchmarks for KGantt::View.
+ *
+ * The plan sizes, hierarchy depth and constraint density are taken
+ * from the environment:
+ *   KGANTT_BENCHMARK_SIZES               comma separated task counts (default 1000)
+ *   KGANTT_BENCHMARK_DEPTH               levels of the task hierarchy (default 2)
+ *   KGANTT_BENCHMARK_CONSTRAINT_DENSITY  constraints per 100 tasks (default 10)
+ *
+ * For machine readable results use the QtTest output formats, e.g.
+ *   KGANTT_BENCHMARK_SIZES=1000,10000,100000,1000000 BenchmarkKGantt -o results.xml,xml
+ */
+class BenchmarkKGantt : public QObject
+{
+    Q_OBJECT
+public:
+    BenchmarkKGantt();
+
+private:
+    void addSizes();
+    void populate(QStandardItemModel *model, int tasks);
+    void addChildren(QStandardItem *parent, int level, int fanout, int tasks, int &created);
+    void addConstraints(KGantt::ConstraintModel *constraintModel);
+
+    QList<int> m_sizes;
+    int m_depth;
+    int m_density;
+    QDateTime m_start;
+    QVector<QStandardItem*> m_leaves;
+
+private Q_SLOTS:
+    void benchmarkModelLoad_data();
+    void benchmarkModelLoad();
+
+    void benchmarkUpdateScene_data();
+    void benchmarkUpdateScene();
+
+    void benchmarkScrollRepaint_data();
+    void benchmarkScrollRepaint();
+
+    void benchmarkZoomRepaint_data();
+    void benchmarkZoomRepaint();
+
+    void benchmarkExpandCollapse_data();
+    void benchmarkExpandCollapse();
+
+    void benchmarkConstraintInsertion_data();
+    void benchmarkConstraintInsertion();
+
+    void benchmarkPrint_data();
+    void benchmarkPrint();
+};
+#endif
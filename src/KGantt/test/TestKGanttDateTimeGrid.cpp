@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2026 The KDiagram developers
+ *
+ * This file is part of the KGantt library.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "TestKGanttDateTimeGrid.h"
+
+#include "kganttglobal.h"
+#include "kganttdatetimegrid.h"
+
+#include <QTimeZone>
+
+using namespace KGantt;
+
+// The mapping as done with QDateTime arithmetic
+static qreal referenceToChart(const QDateTime &start, qreal dayWidth, const QDateTime &dt)
+{
+    qreal result = start.date().daysTo(dt.date())*24.*60.*60.;
+    result += start.time().msecsTo(dt.time())/1000.;
+    result *= dayWidth/(24.*60.*60.);
+    return result;
+}
+
+static QDateTime referenceFromChart(const QDateTime &start, qreal dayWidth, qreal x)
+{
+    int days = static_cast<int>(x/dayWidth);
+    qreal secs = x*(24.*60.*60.)/dayWidth;
+    return start.addDays(days)
+                .addSecs(static_cast<int>(secs-(days*24.*60.*60.)))
+                .addMSecs(qRound((secs-static_cast<int>(secs))*1000.));
+}
+
+void TestKGanttDateTimeGrid::testMapping_data()
+{
+    QTest::addColumn<QDateTime>("start");
+    QTest::addColumn<qreal>("dayWidth");
+
+    const QDate date(2019, 1, 7);
+    const QTime time(9, 30);
+    QTest::newRow("utc") << QDateTime(date, time, Qt::UTC) << qreal(100.);
+    QTest::newRow("offset") << QDateTime(date, time, Qt::OffsetFromUTC, 3600) << qreal(33.3);
+    QTest::newRow("local") << QDateTime(date, time, Qt::LocalTime) << qreal(100.);
+    const QTimeZone berlin("Europe/Berlin");
+    if (berlin.isValid()) {
+        QTest::newRow("europe/berlin") << QDateTime(date, time, berlin) << qreal(100.);
+        QTest::newRow("europe/berlin hours") << QDateTime(date, time, berlin) << qreal(24*60.);
+    }
+    const QTimeZone sydney("Australia/Sydney");
+    if (sydney.isValid()) {
+        QTest::newRow("australia/sydney") << QDateTime(date, time, sydney) << qreal(7.5);
+    }
+}
+
+void TestKGanttDateTimeGrid::testMapping()
+{
+    QFETCH(QDateTime, start);
+    QFETCH(qreal, dayWidth);
+
+    DateTimeGrid grid;
+    grid.setStartDateTime(start);
+    grid.setDayWidth(dayWidth);
+
+    // two years in both directions, crossing several DST transitions
+    const qreal range = 2*366*dayWidth;
+    for (qreal x = -range; x < range; x += dayWidth/7.3) {
+        const QDateTime expected = referenceFromChart(start, dayWidth, x);
+        const QDateTime dt = grid.mapToDateTime(x);
+        QCOMPARE(dt, expected);
+        QCOMPARE(dt.timeSpec(), start.timeSpec());
+        QVERIFY(qAbs(grid.mapFromDateTime(dt) - referenceToChart(start, dayWidth, dt)) < 1e-6);
+    }
+    QCOMPARE(grid.mapToDateTime(grid.mapFromDateTime(start)), start);
+}
+
+void TestKGanttDateTimeGrid::benchmarkMapToChart()
+{
+    const int rows = 10000;
+    const QDateTime start(QDate(2019, 1, 1), QTime(8, 0));
+    QStandardItemModel model(rows, 1);
+    for (int row = 0; row < rows; ++row) {
+        const QModelIndex idx = model.index(row, 0);
+        model.setData(idx, TypeTask, ItemTypeRole);
+        model.setData(idx, start.addSecs(row*3600), StartTimeRole);
+        model.setData(idx, start.addSecs(row*3600 + 8*3600), EndTimeRole);
+    }
+
+    DateTimeGrid grid;
+    grid.setModel(&model);
+    grid.setStartDateTime(start);
+
+    qreal sum = 0.;
+    QBENCHMARK {
+        for (int row = 0; row < rows; ++row) {
+            sum += grid.mapToChart(model.index(row, 0)).length();
+        }
+    }
+    QVERIFY(sum > 0.);
+}
+
+void TestKGanttDateTimeGrid::benchmarkMapFromChart()
+{
+    DateTimeGrid grid;
+    grid.setStartDateTime(QDateTime(QDate(2019, 1, 1), QTime(8, 0)));
+
+    int valid = 0;
+    QBENCHMARK {
+        for (int x = 0; x < 100000; x += 10) {
+            valid += grid.mapToDateTime(x).isValid();
+        }
+    }
+    QVERIFY(valid > 0);
+}
+
+QTEST_GUILESS_MAIN(TestKGanttDateTimeGrid)
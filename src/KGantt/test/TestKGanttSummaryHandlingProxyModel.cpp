@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2026 The KDiagram developers
+ *
+ * This file is part of the KGantt library.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#undef QT_NO_CAST_FROM_ASCII
+
+#include "TestKGanttSummaryHandlingProxyModel.h"
+
+#include "kganttglobal.h"
+#include "kganttsummaryhandlingproxymodel.h"
+
+using namespace KGantt;
+
+static QStandardItem *createItem(const QString &name, ItemType type)
+{
+    QStandardItem *item = new QStandardItem(name);
+    item->setData(type, ItemTypeRole);
+    return item;
+}
+
+static void setTimes(QStandardItem *item, const QDateTime &st, const QDateTime &et)
+{
+    item->setData(st, StartTimeRole);
+    item->setData(et, EndTimeRole);
+}
+
+// summary
+//   subSummary
+//     task1
+//     task2
+//   task3
+void TestKGanttSummaryHandlingProxyModel::init()
+{
+    start = QDateTime(QDate(2020, 1, 1), QTime(8, 0));
+
+    itemModel = new QStandardItemModel();
+    proxyModel = new SummaryHandlingProxyModel();
+    proxyModel->setSourceModel(itemModel);
+
+    summary = createItem("Summary", TypeSummary);
+    subSummary = createItem("SubSummary", TypeSummary);
+    task1 = createItem("Task1", TypeTask);
+    task2 = createItem("Task2", TypeTask);
+    task3 = createItem("Task3", TypeTask);
+    setTimes(task1, start, start.addDays(1));
+    setTimes(task2, start.addDays(1), start.addDays(3));
+    setTimes(task3, start.addDays(2), start.addDays(4));
+
+    subSummary->appendRow(task1);
+    subSummary->appendRow(task2);
+    summary->appendRow(subSummary);
+    summary->appendRow(task3);
+    itemModel->appendRow(summary);
+}
+
+void TestKGanttSummaryHandlingProxyModel::cleanup()
+{
+    delete proxyModel;
+    delete itemModel;
+}
+
+void TestKGanttSummaryHandlingProxyModel::testExtents()
+{
+    const QModelIndex summaryIdx = proxyModel->mapFromSource(summary->index());
+    const QModelIndex subSummaryIdx = proxyModel->mapFromSource(subSummary->index());
+
+    QCOMPARE(proxyModel->data(subSummaryIdx, StartTimeRole).toDateTime(), start);
+    QCOMPARE(proxyModel->data(subSummaryIdx, EndTimeRole).toDateTime(), start.addDays(3));
+    QCOMPARE(proxyModel->data(summaryIdx, StartTimeRole).toDateTime(), start);
+    QCOMPARE(proxyModel->data(summaryIdx, EndTimeRole).toDateTime(), start.addDays(4));
+}
+
+void TestKGanttSummaryHandlingProxyModel::testGrow()
+{
+    const QModelIndex summaryIdx = proxyModel->mapFromSource(summary->index());
+    const QModelIndex subSummaryIdx = proxyModel->mapFromSource(subSummary->index());
+    // fill the cache
+    QCOMPARE(proxyModel->data(summaryIdx, StartTimeRole).toDateTime(), start);
+
+    task2->setData(start.addDays(-1), StartTimeRole);
+    QCOMPARE(proxyModel->data(subSummaryIdx, StartTimeRole).toDateTime(), start.addDays(-1));
+    QCOMPARE(proxyModel->data(summaryIdx, StartTimeRole).toDateTime(), start.addDays(-1));
+
+    task1->setData(start.addDays(5), EndTimeRole);
+    QCOMPARE(proxyModel->data(subSummaryIdx, EndTimeRole).toDateTime(), start.addDays(5));
+    QCOMPARE(proxyModel->data(summaryIdx, EndTimeRole).toDateTime(), start.addDays(5));
+}
+
+void TestKGanttSummaryHandlingProxyModel::testShrink()
+{
+    const QModelIndex summaryIdx = proxyModel->mapFromSource(summary->index());
+    const QModelIndex subSummaryIdx = proxyModel->mapFromSource(subSummary->index());
+    QCOMPARE(proxyModel->data(summaryIdx, EndTimeRole).toDateTime(), start.addDays(4));
+
+    // task1 defines the start of both summaries, moving it inwards
+    // must pick up task2 and task3 respectively
+    setTimes(task1, start.addDays(3), start.addDays(3));
+    QCOMPARE(proxyModel->data(subSummaryIdx, StartTimeRole).toDateTime(), start.addDays(1));
+    QCOMPARE(proxyModel->data(summaryIdx, StartTimeRole).toDateTime(), start.addDays(1));
+
+    task3->setData(start.addDays(2), EndTimeRole);
+    QCOMPARE(proxyModel->data(summaryIdx, EndTimeRole).toDateTime(), start.addDays(3));
+}
+
+void TestKGanttSummaryHandlingProxyModel::testUnaffectedAncestors()
+{
+    const QModelIndex summaryIdx = proxyModel->mapFromSource(summary->index());
+    const QModelIndex subSummaryIdx = proxyModel->mapFromSource(subSummary->index());
+    QCOMPARE(proxyModel->data(summaryIdx, StartTimeRole).toDateTime(), start);
+
+    QSignalSpy spy(proxyModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+
+    // within the extent of subSummary: only the task itself changes
+    task2->setData(start.addSecs(3600), StartTimeRole);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toModelIndex(), proxyModel->mapFromSource(task2->index()));
+    spy.clear();
+
+    // grows subSummary, but not summary
+    task2->setData(start.addDays(4), EndTimeRole);
+    QList<QModelIndex> changed;
+    for (const QList<QVariant> &args : spy) {
+        changed << args.at(0).toModelIndex();
+    }
+    QVERIFY(changed.contains(subSummaryIdx));
+    QVERIFY(!changed.contains(summaryIdx));
+    QCOMPARE(proxyModel->data(summaryIdx, EndTimeRole).toDateTime(), start.addDays(4));
+}
+
+static QList<QModelIndex> changedIndexes(const QSignalSpy &spy)
+{
+    QList<QModelIndex> changed;
+    for (const QList<QVariant> &args : spy) {
+        changed << args.at(0).toModelIndex();
+    }
+    return changed;
+}
+
+void TestKGanttSummaryHandlingProxyModel::testWriteBack()
+{
+    // summaries with times of their own get their extent written back
+    setTimes(summary, start.addDays(10), start.addDays(11));
+    setTimes(subSummary, start.addDays(10), start.addDays(11));
+    const QModelIndex summaryIdx = proxyModel->mapFromSource(summary->index());
+    const QModelIndex subSummaryIdx = proxyModel->mapFromSource(subSummary->index());
+
+    // and the proxy announces the written back values
+    QSignalSpy spy(proxyModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    QCOMPARE(proxyModel->data(summaryIdx, StartTimeRole).toDateTime(), start);
+    QCOMPARE(summary->data(StartTimeRole).toDateTime(), start);
+    QCOMPARE(summary->data(EndTimeRole).toDateTime(), start.addDays(4));
+    QCOMPARE(subSummary->data(EndTimeRole).toDateTime(), start.addDays(3));
+    QVERIFY(changedIndexes(spy).contains(summaryIdx));
+    QVERIFY(changedIndexes(spy).contains(subSummaryIdx));
+    spy.clear();
+
+    task3->setData(start.addDays(6), EndTimeRole);
+    QCOMPARE(summary->data(EndTimeRole).toDateTime(), start.addDays(6));
+    QCOMPARE(proxyModel->data(summaryIdx, EndTimeRole).toDateTime(), start.addDays(6));
+    QVERIFY(changedIndexes(spy).contains(summaryIdx));
+}
+
+void TestKGanttSummaryHandlingProxyModel::testNonSummaryAncestors()
+{
+    // summary
+    //   group (a task with children)
+    //     innerSummary
+    //       task4
+    QStandardItem *group = createItem("Group", TypeTask);
+    QStandardItem *innerSummary = createItem("InnerSummary", TypeSummary);
+    QStandardItem *task4 = createItem("Task4", TypeTask);
+    setTimes(group, start.addDays(1), start.addDays(2));
+    setTimes(task4, start.addDays(1), start.addDays(2));
+    innerSummary->appendRow(task4);
+    group->appendRow(innerSummary);
+    summary->appendRow(group);
+
+    const QModelIndex summaryIdx = proxyModel->mapFromSource(summary->index());
+    const QModelIndex innerSummaryIdx = proxyModel->mapFromSource(innerSummary->index());
+    QCOMPARE(proxyModel->data(summaryIdx, EndTimeRole).toDateTime(), start.addDays(4));
+    QCOMPARE(proxyModel->data(innerSummaryIdx, EndTimeRole).toDateTime(), start.addDays(2));
+
+    // the group itself is what summary sees of it
+    QSignalSpy spy(proxyModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    task4->setData(start.addDays(8), EndTimeRole);
+    QVERIFY(changedIndexes(spy).contains(innerSummaryIdx));
+    QVERIFY(!changedIndexes(spy).contains(summaryIdx));
+    QCOMPARE(proxyModel->data(innerSummaryIdx, EndTimeRole).toDateTime(), start.addDays(8));
+    QCOMPARE(proxyModel->data(summaryIdx, EndTimeRole).toDateTime(), start.addDays(4));
+
+    group->setData(start.addDays(7), EndTimeRole);
+    QCOMPARE(proxyModel->data(summaryIdx, EndTimeRole).toDateTime(), start.addDays(7));
+    QCOMPARE(proxyModel->data(innerSummaryIdx, EndTimeRole).toDateTime(), start.addDays(8));
+}
+
+QTEST_GUILESS_MAIN(TestKGanttSummaryHandlingProxyModel)
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2026 The KDiagram developers
+ *
+ * This file is part of the KGantt library.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef TESTKGANTTSUMMARYHANDLINGPROXYMODEL_H
+#define TESTKGANTTSUMMARYHANDLINGPROXYMODEL_H
+
+#include <QtTest>
+#include <QStandardItemModel>
+
+namespace KGantt {
+    class SummaryHandlingProxyModel;
+}
+
+class TestKGanttSummaryHandlingProxyModel : public QObject
+{
+    Q_OBJECT
+private:
+    QStandardItemModel *itemModel;
+    KGantt::SummaryHandlingProxyModel *proxyModel;
+    QStandardItem *summary;
+    QStandardItem *subSummary;
+    QStandardItem *task1;
+    QStandardItem *task2;
+    QStandardItem *task3;
+    QDateTime start;
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void testExtents();
+    void testGrow();
+    void testShrink();
+    void testUnaffectedAncestors();
+    void testWriteBack();
+    void testNonSummaryAncestors();
+};
+#endif
@@ -27,15 +27,22 @@
 #include "kganttgraphicsview.h"
 #include "kganttgraphicsscene.h"
 #include "kganttgraphicsitem.h"
+#include "kganttconstraintgraphicsitem.h"
 #include "kganttconstraintmodel.h"
 #include "kgantttreeviewrowcontroller.h"
 #include "kganttlistviewrowcontroller.h"
+#include "kganttuniformrowcontroller.h"
 #include "kganttforwardingproxymodel.h"
 #include "kganttitemdelegate.h"
 #include "kganttdatetimegrid.h"
+#include "kganttdatetimetimeline.h"
 
 #include <QListView>
 #include <QTreeView>
+#include <QScrollBar>
+#include <QBuffer>
+#include <QPdfWriter>
+#include <QPainter>
 
 
 using namespace KGantt;
@@ -232,6 +239,73 @@ void TestKGanttView::testTreeView()
     QCOMPARE(view->graphicsView()->scene()->items().count(), 1);
 }
 
+// Compare the row controller against what the tree view reports itself
+static void verifyRowGeometry( QTreeView *treeview, AbstractRowController *rc, QAbstractProxyModel *proxy )
+{
+    const int offset = treeview->verticalScrollBar()->value();
+    int y = 0;
+    for (QModelIndex idx = treeview->model()->index(0, 0); idx.isValid(); idx = treeview->indexBelow(idx)) {
+        const QRect r = treeview->visualRect(idx);
+        const Span s = rc->rowGeometry(proxy->mapFromSource(idx));
+        QCOMPARE(s.start(), qreal(r.y() + offset));
+        QCOMPARE(s.length(), qreal(r.height()));
+        QCOMPARE(proxy->mapToSource(rc->indexAt(y + offset)), idx);
+        QCOMPARE(proxy->mapToSource(rc->indexAt(y + offset - 1)), idx);
+        y += r.height();
+    }
+    QVERIFY(!rc->indexAt(y + offset + 1).isValid());
+}
+
+void TestKGanttView::testTreeViewRowController()
+{
+    for (int i = 0; i < 20; ++i) {
+        QStandardItem *item = new QStandardItem(QString("Summary %1").arg(i));
+        for (int j = 0; j < 5; ++j) {
+            item->appendRow(new QStandardItem(QString("Task %1.%2").arg(i).arg(j)));
+        }
+        itemModel->appendRow(item);
+    }
+    QTreeView *treeview = qobject_cast<QTreeView*>(view->leftView());
+    QVERIFY(treeview);
+    AbstractRowController *rc = view->rowController();
+    QAbstractProxyModel *proxy = view->ganttProxyModel();
+    verifyRowGeometry(treeview, rc, proxy);
+
+    treeview->expand(itemModel->index(3, 0));
+    treeview->expand(itemModel->index(15, 0));
+    verifyRowGeometry(treeview, rc, proxy);
+
+    itemModel->item(15)->insertRow(2, new QStandardItem("Inserted"));
+    itemModel->insertRow(0, new QStandardItem("First"));
+    verifyRowGeometry(treeview, rc, proxy);
+
+    QVERIFY(itemModel->removeRows(1, 2, itemModel->index(4, 0)));
+    treeview->collapse(itemModel->index(4, 0));
+    verifyRowGeometry(treeview, rc, proxy);
+
+    itemModel->item(10)->setText("A\nTaller\nrow");
+    verifyRowGeometry(treeview, rc, proxy);
+
+    // QTreeView does not signal any of these
+    treeview->setRowHidden(2, QModelIndex(), true);
+    treeview->setRowHidden(1, itemModel->index(15, 0), true);
+    verifyRowGeometry(treeview, rc, proxy);
+
+    treeview->setRowHidden(2, QModelIndex(), false);
+    verifyRowGeometry(treeview, rc, proxy);
+
+    treeview->expandAll();
+    verifyRowGeometry(treeview, rc, proxy);
+
+    QFont font = treeview->font();
+    font.setPointSize(font.pointSize() * 2);
+    treeview->setFont(font);
+    verifyRowGeometry(treeview, rc, proxy);
+
+    treeview->collapseAll();
+    verifyRowGeometry(treeview, rc, proxy);
+}
+
 void TestKGanttView::initListModel()
 {
     QList<QStandardItem*> items;
@@ -269,6 +343,413 @@ void TestKGanttView::testListView()
     initListModel();
 }
 
+void TestKGanttView::testListViewFixedRowHeight()
+{
+    QListView *listview = new QListView(view);
+    listview->setUniformItemSizes(true);
+    view->setLeftView(listview);
+    KGantt::ListViewRowController *rc = new KGantt::ListViewRowController(listview, view->ganttProxyModel());
+    view->setRowController(rc);
+    view->setModel(itemModel); // must be set again
+    initListModel();
+
+    const int h = listview->visualRect(itemModel->index(0, 0)).height();
+    QVERIFY(h > 0);
+    const QModelIndex idx = view->ganttProxyModel()->mapFromSource(itemModel->index(1, 0));
+    const Span span = rc->rowGeometry(idx);
+    const QModelIndex at = rc->indexAt(h + 1);
+
+    rc->setFixedRowHeight(h);
+    QCOMPARE(rc->fixedRowHeight(), h);
+    QCOMPARE(rc->rowGeometry(idx), span);
+    QCOMPARE(rc->indexAt(h + 1), at);
+    QCOMPARE(rc->totalHeight(), 2 * h);
+    QVERIFY(!rc->indexAt(2 * h).isValid());
+}
+
+void TestKGanttView::testUniformRowController()
+{
+    QStandardItemModel model;
+    const QDateTime start = QDateTime::currentDateTime();
+    for (int i = 0; i < 100; ++i) {
+        QStandardItem *item = new QStandardItem(QString("Task %1").arg(i));
+        item->setData(KGantt::TypeTask, KGantt::ItemTypeRole);
+        item->setData(start.addDays(i), KGantt::StartTimeRole);
+        item->setData(start.addDays(i + 1), KGantt::EndTimeRole);
+        model.appendRow(item);
+    }
+    KGantt::UniformRowController rc(&model, 10);
+    QCOMPARE(rc.totalHeight(), 1000);
+    QCOMPARE(rc.rowGeometry(model.index(42, 0)), Span(420, 10));
+    QCOMPARE(rc.indexAt(425), model.index(42, 0));
+    QVERIFY(!rc.indexAt(1000).isValid());
+    QCOMPARE(rc.indexBelow(model.index(42, 0)), model.index(43, 0));
+    QCOMPARE(rc.indexAbove(model.index(42, 0)), model.index(41, 0));
+    QVERIFY(!rc.indexBelow(model.index(99, 0)).isValid());
+    QCOMPARE(rc.maximumItemHeight(), 10);
+
+    // No item view needed to lay out a scene
+    KGantt::GraphicsView gv;
+    gv.setRowController(&rc);
+    gv.setModel(&model);
+    KGantt::GraphicsScene *scene = qobject_cast<KGantt::GraphicsScene*>(gv.scene());
+    QVERIFY(scene);
+    KGantt::GraphicsItem *item = scene->findItem(scene->summaryHandlingModel()->mapFromSource(gv.model()->index(42, 0)));
+    QVERIFY(item);
+    QCOMPARE(item->pos().y(), 420.0);
+}
+
+void TestKGanttView::testUniformRowControllerChildren()
+{
+    QStandardItemModel model;
+    const QDateTime start = QDateTime::currentDateTime();
+    QStandardItem *multi = new QStandardItem(QString("Multi"));
+    multi->setData(KGantt::TypeMulti, KGantt::ItemTypeRole);
+    QStandardItem *task = new QStandardItem(QString("Task"));
+    task->setData(KGantt::TypeTask, KGantt::ItemTypeRole);
+    task->setData(start, KGantt::StartTimeRole);
+    task->setData(start.addDays(4), KGantt::EndTimeRole);
+    for (int i = 0; i < 2; ++i) {
+        QStandardItem *multiChild = new QStandardItem(QString("Multi child %1").arg(i));
+        multiChild->setData(KGantt::TypeTask, KGantt::ItemTypeRole);
+        multiChild->setData(start.addDays(2 * i), KGantt::StartTimeRole);
+        multiChild->setData(start.addDays(2 * i + 1), KGantt::EndTimeRole);
+        multi->appendRow(multiChild);
+        QStandardItem *taskChild = new QStandardItem(QString("Task child %1").arg(i));
+        taskChild->setData(KGantt::TypeTask, KGantt::ItemTypeRole);
+        taskChild->setData(start.addDays(2 * i), KGantt::StartTimeRole);
+        taskChild->setData(start.addDays(2 * i + 1), KGantt::EndTimeRole);
+        task->appendRow(taskChild);
+    }
+    model.appendRow(multi);
+    model.appendRow(task);
+
+    KGantt::UniformRowController rc(&model, 10);
+    QCOMPARE(rc.totalHeight(), 40);
+    QCOMPARE(rc.rowGeometry(model.index(1, 0, model.index(0, 0))), Span(0, 10));
+    QCOMPARE(rc.rowGeometry(model.index(1, 0, model.index(1, 0))), Span(30, 10));
+    QVERIFY(!rc.isRowExpanded(model.index(0, 0)));
+    QVERIFY(rc.isRowExpanded(model.index(1, 0)));
+    QVERIFY(!rc.isRowVisible(model.index(0, 0, model.index(0, 0))));
+    QCOMPARE(rc.indexBelow(model.index(0, 0)), model.index(1, 0));
+    QCOMPARE(rc.indexBelow(model.index(1, 0)), model.index(0, 0, model.index(1, 0)));
+    QCOMPARE(rc.indexAbove(model.index(0, 0, model.index(1, 0))), model.index(1, 0));
+    QCOMPARE(rc.indexAt(35), model.index(1, 0, model.index(1, 0)));
+    QVERIFY(!rc.indexAt(40).isValid());
+
+    KGantt::GraphicsView gv;
+    gv.setRowController(&rc);
+    gv.setModel(&model);
+    KGantt::GraphicsScene *scene = qobject_cast<KGantt::GraphicsScene*>(gv.scene());
+    QVERIFY(scene);
+
+    // The children of a TypeMulti row are drawn in that row
+    for (int i = 0; i < 2; ++i) {
+        const QModelIndex idx = gv.model()->index(i, 0, gv.model()->index(0, 0));
+        KGantt::GraphicsItem *item = scene->findItem(scene->summaryHandlingModel()->mapFromSource(idx));
+        QVERIFY(item);
+        QCOMPARE(item->pos().y(), 0.0);
+    }
+
+    // A TypeTask row is drawn, and its children below it
+    KGantt::GraphicsItem *item = scene->findItem(scene->summaryHandlingModel()->mapFromSource(gv.model()->index(1, 0)));
+    QVERIFY(item);
+    QCOMPARE(item->pos().y(), 10.0);
+    for (int i = 0; i < 2; ++i) {
+        const QModelIndex idx = gv.model()->index(i, 0, gv.model()->index(1, 0));
+        KGantt::GraphicsItem *child = scene->findItem(scene->summaryHandlingModel()->mapFromSource(idx));
+        QVERIFY(child);
+        QCOMPARE(child->pos().y(), 20.0 + 10 * i);
+    }
+
+    // Inserted rows and a row that becomes TypeMulti change the layout
+    QStandardItem *inserted = new QStandardItem(QString("Inserted"));
+    inserted->setData(KGantt::TypeTask, KGantt::ItemTypeRole);
+    task->insertRow(0, inserted);
+    QCOMPARE(rc.totalHeight(), 50);
+    QCOMPARE(rc.rowGeometry(model.index(2, 0, model.index(1, 0))), Span(40, 10));
+    task->setData(KGantt::TypeMulti, KGantt::ItemTypeRole);
+    QCOMPARE(rc.totalHeight(), 20);
+    QCOMPARE(rc.rowGeometry(model.index(2, 0, model.index(1, 0))), Span(10, 10));
+}
+
+void TestKGanttView::testPrintPages()
+{
+    QStandardItemModel model;
+    const QDateTime start = QDateTime::currentDateTime();
+    for (int i = 0; i < 500; ++i) {
+        QStandardItem *item = new QStandardItem(QString("Task %1").arg(i));
+        item->setData(KGantt::TypeTask, KGantt::ItemTypeRole);
+        item->setData(start.addDays(i), KGantt::StartTimeRole);
+        item->setData(start.addDays(i + 1), KGantt::EndTimeRole);
+        model.appendRow(item);
+    }
+    KGantt::UniformRowController rc(&model, 20);
+    KGantt::GraphicsView gv;
+    gv.setRowController(&rc);
+    gv.setModel(&model);
+    gv.constraintModel()->addConstraint(Constraint(gv.model()->index(0, 0), gv.model()->index(499, 0)));
+    const int itemCount = gv.scene()->items().count();
+    const QRectF sceneRect = gv.scene()->sceneRect();
+
+    // Every page is printed from a scene that only holds the items of its rows
+    KGantt::GraphicsScene *scene = qobject_cast<KGantt::GraphicsScene*>(gv.scene());
+    QVERIFY(scene);
+    int maxPageItems = 0;
+    int liveItems = -1;
+    connect(scene, &KGantt::GraphicsScene::printProgress, this, [&]() {
+        const QList<KGantt::GraphicsScene*> pages = scene->findChildren<KGantt::GraphicsScene*>();
+        if (pages.count() == 1)
+            maxPageItems = qMax(maxPageItems, pages.first()->items().count());
+        liveItems = qMax(liveItems, scene->items().count());
+    });
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QPdfWriter writer(&buffer);
+    QSignalSpy spy(&gv, SIGNAL(printProgress(int,int)));
+    gv.printPages(&writer);
+
+    QVERIFY(spy.count() > 1);
+    QVERIFY(maxPageItems > 0);
+    QVERIFY(maxPageItems < 100);
+    QCOMPARE(liveItems, itemCount);
+    const QList<QVariant> last = spy.last();
+    QCOMPARE(last.at(0).toInt(), spy.count());
+    QCOMPARE(last.at(1).toInt(), spy.count());
+    QVERIFY(buffer.size() > 0);
+
+    // The scene is left as it was
+    QCOMPARE(gv.scene()->items().count(), itemCount);
+    QCOMPARE(gv.scene()->sceneRect(), sceneRect);
+}
+
+void TestKGanttView::testCoalescedUpdates()
+{
+    QStandardItemModel model;
+    const QDateTime start = QDateTime::currentDateTime();
+    for (int i = 0; i < 10; ++i) {
+        QStandardItem *item = new QStandardItem(QString("Task %1").arg(i));
+        item->setData(KGantt::TypeTask, KGantt::ItemTypeRole);
+        item->setData(start.addDays(i), KGantt::StartTimeRole);
+        item->setData(start.addDays(i + 1), KGantt::EndTimeRole);
+        model.appendRow(item);
+    }
+    KGantt::UniformRowController rc(&model, 20);
+    KGantt::GraphicsView gv;
+    gv.setRowController(&rc);
+    gv.setModel(&model);
+    gv.setMaximumUpdateRate(30);
+    QCOMPARE(gv.maximumUpdateRate(), 30);
+
+    KGantt::GraphicsScene *scene = qobject_cast<KGantt::GraphicsScene*>(gv.scene());
+    const QModelIndex idx = scene->summaryHandlingModel()->mapFromSource(gv.model()->index(3, 0));
+    KGantt::GraphicsItem *item = scene->findItem(idx);
+    QVERIFY(item);
+    const qreal x = item->pos().x();
+
+    // Three changes of the same row are applied once
+    for (int i = 1; i <= 3; ++i) {
+        model.item(3)->setData(start.addDays(3 + i), KGantt::StartTimeRole);
+        model.item(3)->setData(start.addDays(4 + i), KGantt::EndTimeRole);
+    }
+    QCOMPARE(item->pos().x(), x);
+    QVERIFY(gv.droppedUpdateCount() >= 5);
+    gv.flushUpdates();
+    QVERIFY(item->pos().x() > x);
+
+    // Overlapping time line strips are merged
+    KGantt::DateTimeGrid *grid = qobject_cast<KGantt::DateTimeGrid*>(gv.grid());
+    QVERIFY(grid);
+    grid->timeLine()->setDateTime(start);
+    grid->timeLine()->setDateTime(start);
+    gv.flushUpdates();
+    QVERIFY(gv.mergedUpdateCount() > 0);
+
+    gv.resetUpdateCounts();
+    QCOMPARE(gv.droppedUpdateCount(), 0);
+    QCOMPARE(gv.mergedUpdateCount(), 0);
+}
+
+namespace {
+// Counts the constraints it is asked to paint, and paints them red if asked to
+class ConstraintDelegate : public KGantt::ItemDelegate
+{
+public:
+    ConstraintDelegate() : painted(0), paintRed(false) {}
+
+    void paintConstraintItem(QPainter *painter, const QStyleOptionGraphicsItem &opt,
+                             const QPointF &start, const QPointF &end, const Constraint &constraint) Q_DECL_OVERRIDE
+    {
+        ++painted;
+        if (!paintRed) {
+            KGantt::ItemDelegate::paintConstraintItem(painter, opt, start, end, constraint);
+            return;
+        }
+        painter->setPen(QPen(Qt::red, 3));
+        painter->drawLine(start, end);
+    }
+
+    int painted;
+    bool paintRed;
+};
+
+int countPixels(QGraphicsScene *scene, const QRectF &exposed, const QColor &color)
+{
+    QImage image(exposed.size().toSize(), QImage::Format_ARGB32);
+    image.fill(Qt::white);
+    {
+        QPainter painter(&image);
+        scene->render(&painter, QRectF(image.rect()), exposed);
+    }
+    int pixels = 0;
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            if (image.pixel(x, y) == color.rgb())
+                ++pixels;
+        }
+    }
+    return pixels;
+}
+}
+
+void TestKGanttView::testConstraintGeometryCache()
+{
+    QStandardItemModel model;
+    const QDateTime start = QDateTime::currentDateTime();
+    for (int i = 0; i < 2; ++i) {
+        QStandardItem *item = new QStandardItem(QString("Task %1").arg(i));
+        item->setData(KGantt::TypeTask, KGantt::ItemTypeRole);
+        item->setData(start.addDays(2 * i), KGantt::StartTimeRole);
+        item->setData(start.addDays(2 * i + 1), KGantt::EndTimeRole);
+        model.appendRow(item);
+    }
+    KGantt::UniformRowController rc(&model, 20);
+    ConstraintDelegate delegate;
+    KGantt::GraphicsView gv;
+    gv.setRowController(&rc);
+    gv.setModel(&model);
+    gv.setItemDelegate(&delegate);
+    Constraint constraint(gv.model()->index(0, 0), gv.model()->index(1, 0));
+    constraint.setData(Constraint::ValidConstraintPen, QPen(Qt::magenta, 3));
+    gv.constraintModel()->addConstraint(constraint);
+
+    KGantt::ConstraintGraphicsItem *citem = nullptr;
+    Q_FOREACH(QGraphicsItem *item, gv.scene()->items()) {
+        if (item->type() == KGantt::ConstraintGraphicsItem::Type)
+            citem = static_cast<KGantt::ConstraintGraphicsItem*>(item);
+    }
+    QVERIFY(citem);
+    QCOMPARE(citem->boundingRect(), delegate.constraintBoundingRect(citem->start(), citem->end(), citem->constraint()));
+
+    // The default path paints the kept geometry
+    QVERIFY(countPixels(gv.scene(), citem->boundingRect(), Qt::magenta) > 0);
+    QCOMPARE(delegate.painted, 1);
+
+    // Moving the end item reroutes the constraint
+    const QPointF end = citem->end();
+    const QRectF rect = citem->boundingRect();
+    model.item(1)->setData(start.addDays(4), KGantt::StartTimeRole);
+    model.item(1)->setData(start.addDays(5), KGantt::EndTimeRole);
+    QVERIFY(citem->end() != end);
+    QVERIFY(citem->boundingRect() != rect);
+    QCOMPARE(citem->boundingRect(), delegate.constraintBoundingRect(citem->start(), citem->end(), citem->constraint()));
+
+    // With batching, only the scene paints the constraint, in its own pen
+    delegate.setConstraintBatchingEnabled(true);
+    QVERIFY(delegate.isConstraintBatchingEnabled());
+    delegate.painted = 0;
+    QVERIFY(countPixels(gv.scene(), citem->boundingRect(), Qt::magenta) > 0);
+    QCOMPARE(delegate.painted, 1);
+
+    // and a reimplementation of paintConstraintItem() is still used
+    delegate.paintRed = true;
+    delegate.painted = 0;
+    QCOMPARE(countPixels(gv.scene(), citem->boundingRect(), Qt::magenta), 0);
+    QVERIFY(countPixels(gv.scene(), citem->boundingRect(), Qt::red) > 0);
+    QCOMPARE(delegate.painted, 2);
+}
+
+namespace {
+// Paints the header of a DateTimeGrid onto a widget, where the grid caches it in tiles
+class GridHeaderWidget : public QWidget
+{
+public:
+    explicit GridHeaderWidget(KGantt::DateTimeGrid *grid) : m_grid(grid) { resize(400, 40); }
+
+protected:
+    void paintEvent(QPaintEvent *) Q_DECL_OVERRIDE
+    {
+        QPainter painter(this);
+        m_grid->paintHeader(&painter, rect(), rect(), 0, this);
+    }
+
+private:
+    KGantt::DateTimeGrid *m_grid;
+};
+
+// Paints the day scale header in one color of its own
+class ColoredHeaderGrid : public KGantt::DateTimeGrid
+{
+public:
+    ColoredHeaderGrid() : color(Qt::red), painted(0) {}
+
+    void setColor(const QColor &c)
+    {
+        color = c;
+        invalidateHeaderCache();
+    }
+
+    QColor color;
+    int painted;
+
+protected:
+    void paintDayScaleHeader(QPainter *painter, const QRectF &headerRect, const QRectF &exposedRect,
+                             qreal offset, QWidget *widget) Q_DECL_OVERRIDE
+    {
+        Q_UNUSED(offset);
+        Q_UNUSED(widget);
+        ++painted;
+        painter->fillRect(headerRect.intersected(exposedRect), color);
+    }
+};
+}
+
+void TestKGanttView::testHeaderTileCache()
+{
+    typedef KGantt::DateTimeScaleFormatter Formatter;
+    KGantt::DateTimeGrid grid;
+    grid.setStartDateTime(QDateTime(QDate(2020, 1, 1), QTime(0, 0)));
+    grid.setDayWidth(50);
+    grid.setScale(KGantt::DateTimeGrid::ScaleUserDefined);
+    grid.setUserDefinedUpperScale(new Formatter(Formatter::Month, QString("MMM")));
+    grid.setUserDefinedLowerScale(new Formatter(Formatter::Day, QString("d")));
+
+    GridHeaderWidget widget(&grid);
+    const QImage days = widget.grab().toImage();
+    QCOMPARE(widget.grab().toImage(), days);
+
+    // The formatter set in between is never painted. It frees the address of
+    // the first one, which the last one may get.
+    grid.setUserDefinedLowerScale(new Formatter(Formatter::Day, QString("'x'")));
+    grid.setUserDefinedLowerScale(new Formatter(Formatter::Day, QString("'#'")));
+    const QImage marks = widget.grab().toImage();
+    QVERIFY(marks != days);
+
+    // A reimplemented header is cached too, until the subclass invalidates it
+    ColoredHeaderGrid colored;
+    colored.setScale(KGantt::DateTimeGrid::ScaleDay);
+    GridHeaderWidget coloredWidget(&colored);
+    QCOMPARE(coloredWidget.grab().toImage().pixel(200, 20), QColor(Qt::red).rgb());
+    QVERIFY(colored.painted > 0);
+    const int painted = colored.painted;
+    coloredWidget.grab();
+    QCOMPARE(colored.painted, painted);
+    colored.setColor(Qt::blue);
+    QCOMPARE(coloredWidget.grab().toImage().pixel(200, 20), QColor(Qt::blue).rgb());
+    QVERIFY(colored.painted > painted);
+}
+
 void TestKGanttView::testConstraints()
 {
     initTreeModel();
@@ -52,8 +52,24 @@ private Q_SLOTS:
 
     void testTreeView();
 
+    void testTreeViewRowController();
+
     void testListView();
 
+    void testListViewFixedRowHeight();
+
+    void testUniformRowController();
+
+    void testUniformRowControllerChildren();
+
+    void testPrintPages();
+
+    void testCoalescedUpdates();
+
+    void testConstraintGeometryCache();
+
+    void testHeaderTileCache();
+
     void testConstraints();
 };
 #endif